@@ -0,0 +1,197 @@
+/*
+ * 合成多分本DCP的 libdms 桩实现
+ *
+ * @file    dms_stub_libdms.cpp
+ *
+ * 只实现播放器取帧、定位、切换分本用到的接口。每个分本的码流位置从16384字节开始，
+ * 数据单元长度在平均长度附近随机波动，PTS为分本内帧号；_dms_goto_pos 只接受真实存在的 Pos。
+ * 设置载荷后数据单元内容为真实码流，供解码与渲染用例使用。立体素材每帧两个数据单元（先左眼后右眼），
+ * 两者PTS均为帧号。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "../../include/libdms.h"
+#include "dms_stub_libdms.h"
+
+struct StubUnit
+{
+    int64_t pos;
+    uint32_t length;
+};
+
+static DmsStubConfig gConfig = { 1, 240, 262144, 0, 0, 0, 0 };
+static std::vector<std::vector<StubUnit>> gReels;
+static bool gOpened = false;
+static int gReel = 0;
+static size_t gCursor = 0;
+static bool gFirstUnit = true;
+static std::vector<const uint8_t*> gPayloads;
+static std::vector<uint32_t> gPayloadLengths;
+static int64_t gUnitReads = 0;
+
+/*
+ * 按微秒休眠，0表示不休眠
+ *
+ * @param[in] us 微秒
+ */
+static void StubSleep(int64_t us)
+{
+    if (us > 0) usleep((useconds_t)us);
+}
+
+void DmsStubConfigure(const DmsStubConfig* config)
+{
+    if (config) gConfig = *config;
+}
+
+void DmsStubSetPayloads(const uint8_t* const* payloads, const uint32_t* lengths, int count)
+{
+    gPayloads.assign(payloads, payloads + (count > 0 ? count : 0));
+    gPayloadLengths.assign(lengths, lengths + (count > 0 ? count : 0));
+}
+
+int64_t DmsStubUnitReads()
+{
+    return gUnitReads;
+}
+
+const char* _dms_get_library_version()
+{
+    return "stub";
+}
+
+int _dms_library_initialize(int iMode, GetLocationFun pGetLocation, bool bEnableLogFlag)
+{
+    return DMS_RESULT_SUCCESS;
+}
+
+void _dms_library_uninitialize()
+{
+}
+
+int _dms_bind_kdm(const char* szKdmPathname)
+{
+    return DMS_RESULT_SUCCESS;
+}
+
+int _dms_open_dcp(const char* szPathname, const char* szSessionId, bool bPreviewModeFlag)
+{
+    srand(1);
+    gReels.assign(gConfig.reelCount, std::vector<StubUnit>());
+    for (int r = 0; r < gConfig.reelCount; r++)
+    {
+        int64_t pos = 16384;
+        int units = gConfig.framesPerReel * (gConfig.stereo ? 2 : 1);
+        for (int i = 0; i < units; i++)
+        {
+            uint32_t length = gPayloads.empty()
+                ? gConfig.unitBytes / 2 + (uint32_t)(rand() % (int)gConfig.unitBytes)
+                : gPayloadLengths[i % gPayloads.size()];
+            gReels[r].push_back({ pos, length });
+            pos += length + 20;
+        }
+    }
+    gOpened = true;
+    gReel = 0;
+    gCursor = 0;
+    gFirstUnit = true;
+    return DMS_RESULT_SUCCESS;
+}
+
+void _dms_close_dcp()
+{
+    gOpened = false;
+    gReels.clear();
+}
+
+int _dms_get_reel_count()
+{
+    return gOpened ? (int)gReels.size() : (int)DMS_RESULT_NO_DCP_OPENED;
+}
+
+int _dms_select_reel(int iReelNumber)
+{
+    if (!gOpened) return DMS_RESULT_NO_DCP_OPENED;
+    if (iReelNumber < 1 || iReelNumber > (int)gReels.size()) return DMS_RESULT_REEL_NOT_EXIST;
+    StubSleep(gConfig.selectReelUs);
+    gReel = iReelNumber - 1;
+    gCursor = 0;
+    gFirstUnit = true;
+    return DMS_RESULT_SUCCESS;
+}
+
+const char* _dms_get_picture_mxf_id()
+{
+    static char id[64];
+    snprintf(id, sizeof(id), "urn:uuid:00000000-0000-0000-0000-%012d", gReel + 1);
+    return gOpened ? id : nullptr;
+}
+
+DmsMovieExtensionPtr _dms_get_movie_extension()
+{
+    return nullptr;
+}
+
+void _dms_free_movie_extension(DmsMovieExtensionPtr* ppDmsMovieExtension)
+{
+}
+
+int _dms_get_next_picture_unit(DmsDataUnitPtr* ppDmsDataUnit)
+{
+    *ppDmsDataUnit = nullptr;
+    if (!gOpened) return DMS_RESULT_NO_DCP_OPENED;
+    const std::vector<StubUnit>& units = gReels[gReel];
+    if (gCursor >= units.size()) return DMS_RESULT_PLAY_FINISHED;
+
+    StubSleep(gConfig.unitUs + (gFirstUnit ? gConfig.firstUnitUs : 0));
+    gFirstUnit = false;
+    const StubUnit& unit = units[gCursor];
+    DmsDataUnit* out = (DmsDataUnit*)malloc(sizeof(DmsDataUnit));
+    out->Pos = unit.pos;
+    out->PTS = (int64_t)(gConfig.stereo ? gCursor / 2 : gCursor);
+    out->Length = unit.length;
+    out->Data = (uint8_t*)malloc(unit.length);
+    if (gPayloads.empty())
+        memset(out->Data, (int)(gCursor & 0xff), unit.length);
+    else
+        memcpy(out->Data, gPayloads[gCursor % gPayloads.size()], unit.length);
+    gCursor++;
+    gUnitReads++;
+    *ppDmsDataUnit = out;
+    return DMS_RESULT_SUCCESS;
+}
+
+int _dms_goto_pos(int64_t iPos, bool bBreakpointFlag)
+{
+    if (!gOpened) return DMS_RESULT_NO_DCP_OPENED;
+    StubSleep(gConfig.seekUs);
+    const std::vector<StubUnit>& units = gReels[gReel];
+    size_t lo = 0, hi = units.size();
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (units[mid].pos < iPos) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo >= units.size() || units[lo].pos != iPos) return DMS_RESULT_UNKNOWN_ERROR;
+    gCursor = lo;
+    return DMS_RESULT_SUCCESS;
+}
+
+void _dms_free_data_unit(DmsDataUnitPtr* ppDmsDataUnit)
+{
+    if (ppDmsDataUnit && *ppDmsDataUnit)
+    {
+        free((*ppDmsDataUnit)->Data);
+        free(*ppDmsDataUnit);
+        *ppDmsDataUnit = nullptr;
+    }
+}
+
+int _dms_set_playback_break(const char* szDatetime)
+{
+    return DMS_RESULT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+/*
+ * 合成多分本DCP的 libdms 桩实现，供 dmsbench 在无真实影片、无 libdms 时驱动播放器
+ *
+ * @file    dms_stub_libdms.h
+ */
+#ifndef DMS_STUB_LIBDMS_H
+#define DMS_STUB_LIBDMS_H
+
+#include <stdint.h>
+
+/*
+ * 桩配置：耗时以微秒计，通过休眠模拟存储与解密等待
+ */
+struct DmsStubConfig
+{
+    int reelCount;            // 分本数量
+    int framesPerReel;        // 每个分本的帧数
+    uint32_t unitBytes;       // 数据单元平均长度
+    int64_t selectReelUs;     // _dms_select_reel 打开轨迹文件的耗时
+    int64_t firstUnitUs;      // 选择分本后读取第一个数据单元的额外耗时（建立解密上下文）
+    int64_t unitUs;           // 读取每个数据单元的耗时
+    int64_t seekUs;           // _dms_goto_pos 的耗时
+    bool stereo;              // 立体素材：每帧依次为左、右眼两个数据单元，PTS相同
+};
+
+void DmsStubConfigure(const DmsStubConfig* config);   // 设置桩配置，下一次 _dms_open_dcp 生效
+
+/*
+ * 设置数据单元内容：第 i 个数据单元（立体素材两眼各算一个）取 payloads[i % count]，长度即载荷长度；count 为0时恢复合成填充。
+ * 载荷由调用方持有，须在关闭DCP前保持有效。下一次 _dms_open_dcp 生效
+ */
+void DmsStubSetPayloads(const uint8_t* const* payloads, const uint32_t* lengths, int count);
+
+int64_t DmsStubUnitReads();                           // 累计读取的数据单元数（_dms_get_next_picture_unit 成功次数）
+
+#endif // DMS_STUB_LIBDMS_H
@@ -0,0 +1,3494 @@
+/*
+ * DMS Player 原生模块基准测试
+ *
+ * @file    dmsbench.cpp
+ *
+ * 不依赖 libdms 和真实影片，使用合成数据测试各原生模块的性能，可在设备或主机上运行：
+ *   设备：adb push 后执行 ./dmsbench <用例>
+ *   主机：g++ -O2 -std=c++17 -I../include demo/dmsbench.cpp demo/dms_stub_libdms.cpp dms_*.cpp \
+ *         -o dmsbench -lpthread   （排除 dms_jni_wrapper.cpp）
+ * 需要 libdms 的用例由 demo/dms_stub_libdms.cpp 提供合成的多分本影片。
+ * J2K解码用例需要 OpenJPEG：加 -DDMS_HAVE_OPENJPEG -lopenjp2 编译。
+ *
+ * 用例：
+ *   index    紧凑帧索引：每帧字节数、随机查询延迟
+ *   reel     分本切换：按帧率节奏取帧时每次切换分本的取帧延迟与掉帧数（首次播放、有帧索引、应用预读）
+ *   reverse  分块倒放：从片尾1倍速倒放到片头（跨越分本）的持续帧率、按24fps节奏取帧时的延后帧数，核对帧序
+ *   step     逐帧步进：跨越分本逐帧前进/后退与按帧号定位的p50/p99时延（目标30ms），核对落点帧号与PTS
+ *   thumb    进度条缩略图：图集生成耗时、任意悬停位置的出图延迟；有J2K解码器时以最低分辨率层解码码流，
+ *            不预先建立帧索引而由后台补全后生成全部样本，dmsbench thumb [码流目录]
+ *   j2k      J2K解码：不同线程数下2K码流的解码帧率，dmsbench j2k [码流目录] 可改用目录中的 .j2c 文件
+ *   pipeline 帧级并行解码：不同解码线程数下的帧率与各线程利用率、定位时取消在途帧的耗时，
+ *            dmsbench pipeline [码流目录]
+ *   color    X'Y'Z'到RGB色彩转换：各内核（标量/NEON/SSE4.1/AVX2）的吞吐（百万像素/秒）及与标量结果逐位比对
+ *   lut      3D LUT色域映射：P3到Rec.709色域压缩LUT（17³/33³/65³）与色彩转换合并后各内核的单帧耗时，
+ *            对照只做矩阵转换，与标量结果逐位比对；恒等.cube往返与灰阶不变、饱和色截断减少的检查
+ *   scale    缩放与加黑边：flat/scope画面适配各种屏幕尺寸时缩放、转换与加黑边的单帧耗时（双三次/Lanczos-3），
+ *            与标量结果逐位比对、黑边检查、平坦画面检查，分辨率层恰好适配时不缩放
+ *   render   原生渲染：解码、转换、按60Hz刷新节奏显示到无头输出端的掉帧、节奏滑移、端到端延迟、
+ *            起播/跳转耗时与CPU负载，
+ *            对照ExoPlayer路径（取帧后经JNI字节数组、数据源、采样队列三次复制），
+ *            dmsbench render [码流目录] [输出宽度]
+ *   quality  自适应解码质量：按指定帧率渲染，比较固定全质量、自适应、自适应且前半程有CPU干扰时的
+ *            掉帧、显示延后与降质帧数，自适应须显示全部帧且平均延后不超过一帧，
+ *            dmsbench quality [码流目录] [帧率] [输出宽度]
+ *   header   J2K主头解析：解析/指纹耗时、DCI档次检查、经播放器逐帧检测主头参数变化，
+ *            dmsbench header [码流目录]
+ *   cache    解码帧缓存：暂停后逐帧步进、继续播放的时延与命中率，对照不缓存，内存警告后的占用，
+ *            dmsbench cache [码流目录] [输出宽度]
+ *   ring     码流缓存：顺序播放后后退数秒重放，比较跳转到首帧的耗时与重放取帧耗时，核对每帧内容，
+ *            对照不缓存
+ *   clock    显示节奏调度：以模拟时钟驱动取帧与显示，在稳定、抖动、跟不上、卡顿、输出阻塞、2倍速与暂停/继续
+ *            各场景下统计丢帧、重复显示、时钟重同步与显示抖动，并检查各场景的预期
+ *   cadence  刷新节奏：各帧率/刷新率组合的节奏与长时间偏差；以合成的刷新序列比较按媒体时钟连续提交
+ *            与按节奏提交时每帧保持的刷新次数、滑移次数，以及漏掉刷新回调、提交卡顿时的检测
+ *   stereo   立体3D：按PTS识别与配对左右眼（顺序读取、定位、只显示左眼），两眼并行解码相对2D的帧率，
+ *            各输出方式（左眼/左右并排/帧序列单闪、双闪）渲染的立体帧数与眼图像数、播放中切换输出方式，
+ *            dmsbench stereo [码流目录] [输出宽度]
+ *   journal  断点续播：显示确认放映点的开销、取帧领先显示时的断点位置，撕裂记录与文件头损坏的恢复、
+ *            恢复耗时，合成影片断电后续播的各阶段时延（读取断点/打开/绑定/索引/登记/定位/缓冲）与落点
+ *   trick    快进/快退：有帧索引时各倍速的步长N、PTS、输出时间戳与每输出帧读取的数据单元数，
+ *            无帧索引时快进不顺读途经的帧，抽帧时并行解码不丢弃在途帧，dmsbench trick [码流目录]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
+#ifdef DMS_HAVE_OPENJPEG
+#include <openjpeg.h>
+#endif
+#include "../dms_breakpoint_journal.h"
+#include "../dms_frame_index.h"
+#include "../dms_index_builder.h"
+#include "../dms_frame_cache.h"
+#include "../dms_codestream_ring.h"
+#include "../dms_present_clock.h"
+#include "../dms_cadence.h"
+#include "../dms_color.h"
+#include "../dms_decode_pipeline.h"
+#include "../dms_j2k_decoder.h"
+#include "../dms_j2k_header.h"
+#include "../dms_player.h"
+#include "../dms_renderer.h"
+#include "../dms_reverse_play.h"
+#include "../dms_scaler.h"
+#include "../dms_stereo.h"
+#include "../dms_step_window.h"
+#include "../dms_video_sink.h"
+#include "../dms_thumbnail.h"
+#include "dms_stub_libdms.h"
+
+/*
+ * 获取单调时钟时间
+ *
+ * @return 纳秒
+ */
+static int64_t NowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * 读取进程常驻内存
+ *
+ * @return 常驻内存字节数，失败返回-1
+ */
+static long ReadRssBytes()
+{
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if (!fp) return -1;
+    long pages = 0, resident = 0;
+    int n = fscanf(fp, "%ld %ld", &pages, &resident);
+    fclose(fp);
+    return n == 2 ? resident * sysconf(_SC_PAGESIZE) : -1;
+}
+
+/*
+ * 紧凑帧索引基准：合成3小时48fps（518400帧）影片的索引，统计文件大小与随机查询延迟
+ *
+ * @return 返回0表示成功
+ */
+static int BenchIndex()
+{
+    const int64_t frameCount = 3LL * 3600 * 48;
+    const char* path = "dmsbench_index.bin";
+
+    // 合成码流：帧长在1MB附近随机波动，Pos为字节偏移（含KLV头），PTS按帧递增
+    srand(1);
+    DmsFrameIndexWriter* writer = dms_frame_index_writer_create(0, 1);
+    int64_t pos = 16384;
+    int64_t t0 = NowNs();
+    for (int64_t i = 0; i < frameCount; i++)
+    {
+        uint32_t size = 900000 + (uint32_t)(rand() % 250000);
+        dms_frame_index_writer_put(writer, i, pos, i, size);
+        pos += size + 20;
+    }
+    dms_frame_index_writer_set_frame_count(writer, frameCount);
+    int result = dms_frame_index_writer_save(writer, path);
+    int64_t buildNs = NowNs() - t0;
+    dms_frame_index_writer_destroy(writer);
+    if (result != 0)
+    {
+        printf("[Error][save index failed: %d]\n", result);
+        return -1;
+    }
+
+    // 随机查询目标
+    const int lookups = 1000000;
+    std::vector<int64_t> targets(lookups);
+    for (int i = 0; i < lookups; i++)
+        targets[i] = ((int64_t)rand() * RAND_MAX + rand()) % frameCount;
+
+    long rssBefore = ReadRssBytes();
+    DmsFrameIndex* index = nullptr;
+    if (dms_frame_index_open(path, &index) != 0)
+    {
+        printf("[Error][open index failed]\n");
+        return -1;
+    }
+
+    DmsFrameIndexStats stats;
+    dms_frame_index_get_stats(index, &stats);
+
+    DmsFrameEntry entry;
+    int64_t checksum = 0;
+    t0 = NowNs();
+    for (int i = 0; i < lookups; i++)
+    {
+        dms_frame_index_lookup(index, targets[i], &entry);
+        checksum += entry.pos;
+    }
+    int64_t lookupNs = NowNs() - t0;
+
+    // 按Pos反查
+    const int posLookups = 100000;
+    int misses = 0;
+    t0 = NowNs();
+    for (int i = 0; i < posLookups; i++)
+    {
+        dms_frame_index_lookup(index, targets[i], &entry);
+        if (dms_frame_index_find_pos(index, entry.pos) != targets[i]) misses++;
+    }
+    int64_t findNs = NowNs() - t0;
+    long rssAfter = ReadRssBytes();
+
+    printf("--> Frame index (%lld frames, 3h @ 48fps)\n", (long long)frameCount);
+    printf(" |->build+save:        %.1f ms\n", buildNs / 1e6);
+    printf(" |->file size:         %llu bytes (naive 32B/frame: %lld bytes)\n",
+        (unsigned long long)stats.fileBytes, (long long)frameCount * 32);
+    printf(" |->bytes per frame:   %.2f\n", stats.bytesPerFrame);
+    printf(" |->lookup(frame):     %.1f ns avg over %d random lookups\n", (double)lookupNs / lookups, lookups);
+    printf(" |->lookup+find(pos):  %.1f ns avg, %d mismatches\n", (double)findNs / posLookups, misses);
+    printf(" |->RSS growth:        %ld KB after touching whole index\n", (rssAfter - rssBefore) / 1024);
+    printf(" |->checksum:          %lld\n", (long long)checksum);
+
+    dms_frame_index_close(index);
+    unlink(path);
+    return misses == 0 ? 0 : -1;
+}
+
+/*
+ * 一次分本切换基准的结果
+ */
+struct ReelPassResult
+{
+    int frames;               // 取到的帧数
+    int transitions;          // 分本切换次数
+    double maxGapMs;          // 切换处取帧超出节奏的最大延迟
+    int lateFrames;           // 超出节奏一帧以上（显示端会掉帧）的帧数
+    int positionMismatches;   // 当前帧号与刚取到的帧号不一致的次数（预读与预取下一分本时）
+};
+
+/*
+ * 按帧率节奏从头播放整部合成影片，统计分本切换处的延迟
+ *
+ * @param[in]  indexDir        帧索引目录
+ * @param[in]  readaheadFrames 预读帧数，0为默认（多分本影片至少预读48帧）
+ * @param[in]  frameRate       帧率
+ * @param[out] out             结果
+ * @return                     返回0表示成功
+ */
+static int RunReelPass(const char* indexDir, int readaheadFrames, float frameRate, ReelPassResult* out)
+{
+    memset(out, 0, sizeof(*out));
+    DmsContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    if (dms_player_init(&ctx) != 0) return -1;
+    ctx.frameRate = frameRate;
+    ctx.readaheadFrames = readaheadFrames;
+    dms_player_set_index_dir(&ctx, indexDir);
+    if (_dms_open_dcp("stub", "", false) != DMS_RESULT_SUCCESS) return -1;
+    ctx.hasActiveMxf = true;
+    dms_player_open_timeline(&ctx);
+
+    // 第一帧包含打开分本的耗时，不计入统计
+    DmsFrame frame;
+    if (dms_player_next_frame(&ctx, &frame) != DMS_RESULT_SUCCESS) return -1;
+    dms_player_release_frame(&frame);
+    out->frames = 1;
+
+    const int64_t intervalNs = (int64_t)(1e9 / frameRate);
+    int reel = ctx.reel;
+    int64_t t0 = NowNs();
+    for (int i = 1; ; i++)
+    {
+        int64_t deadline = t0 + i * intervalNs;
+        int64_t now = NowNs();
+        if (now < deadline) usleep((useconds_t)((deadline - now) / 1000));
+
+        if (dms_player_next_frame(&ctx, &frame) != DMS_RESULT_SUCCESS) break;
+        if (dms_player_get_current_frame(&ctx) != frame.frame) out->positionMismatches++;
+        dms_player_release_frame(&frame);
+        int64_t lateNs = NowNs() - deadline;
+        out->frames++;
+        if (lateNs > intervalNs) out->lateFrames++;
+        if (ctx.reel != reel)
+        {
+            reel = ctx.reel;
+            out->transitions++;
+            double gapMs = lateNs > 0 ? lateNs / 1e6 : 0.0;
+            if (gapMs > out->maxGapMs) out->maxGapMs = gapMs;
+        }
+    }
+
+    dms_player_close_index(&ctx);
+    _dms_close_dcp();
+    ctx.hasActiveMxf = false;
+    dms_player_uninit(&ctx);
+    return 0;
+}
+
+/*
+ * 分本切换基准：合成3个分本的影片，按48fps节奏取帧，统计三种情形下分本切换处的延迟：
+ * 首次播放（无帧索引，分本帧数未知）、再次播放（帧索引完整）、应用设置24帧预读。
+ * 多分本影片始终预读，当前分本读完即在后台预取下一分本，各情形下切换处都不应延后
+ *
+ * @return 返回0表示成功，分本切换处延后超过一帧返回-1
+ */
+static int BenchReel()
+{
+    const char* indexDir = "dmsbench_reels";
+    DmsStubConfig config = { 3, 120, 262144, 80000, 40000, 4000, 1000 };
+    DmsStubConfigure(&config);
+    mkdir(indexDir, 0755);
+
+    // 同步切换的实际耗时：选择分本 + 读取第一个数据单元
+    _dms_open_dcp("stub", "", false);
+    int64_t t0 = NowNs();
+    _dms_select_reel(2);
+    DmsDataUnitPtr unit = nullptr;
+    _dms_get_next_picture_unit(&unit);
+    int64_t switchNs = NowNs() - t0;
+    _dms_free_data_unit(&unit);
+    _dms_close_dcp();
+
+    const float frameRate = 48.0f;
+    ReelPassResult first, indexed, readahead;
+    int result = RunReelPass(indexDir, 0, frameRate, &first);
+    result |= RunReelPass(indexDir, 0, frameRate, &indexed);
+    result |= RunReelPass(indexDir, 24, frameRate, &readahead);
+
+    printf("--> Reel transitions (%d reels x %d frames @ %.0ffps, select %lldms + first unit %lldms)\n",
+        config.reelCount, config.framesPerReel, frameRate,
+        (long long)config.selectReelUs / 1000, (long long)config.firstUnitUs / 1000);
+    printf(" |->sync switch cost:  %.1f ms (frame interval %.1f ms)\n", switchNs / 1e6, 1000.0 / frameRate);
+    const ReelPassResult* passes[] = { &first, &indexed, &readahead };
+    const char* labels[] = { "first play", "indexed", "readahead 24" };
+    for (int i = 0; i < 3; i++)
+    {
+        printf(" |->%-13s       %d frames, %d transitions, max gap %.1f ms, %d late frames, %d position mismatches\n",
+            labels[i], passes[i]->frames, passes[i]->transitions, passes[i]->maxGapMs, passes[i]->lateFrames,
+            passes[i]->positionMismatches);
+        // 分本切换处的延迟须在一个帧间隔内；其余帧的延后来自系统调度，只做统计
+        if (passes[i]->maxGapMs * frameRate >= 1000.0 || passes[i]->transitions != config.reelCount - 1 ||
+            passes[i]->positionMismatches > 0)
+        {
+            result = -1;
+        }
+    }
+
+    // 清理帧索引
+    for (int r = 1; r <= config.reelCount; r++)
+    {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/urn_uuid_00000000-0000-0000-0000-%012d.dmsidx", indexDir, r);
+        unlink(path);
+    }
+
+    // 刚打开、帧索引尚无覆盖时定位：近处目标从读取位置顺读；远处目标先被拒绝，待后台从分本开头
+    // 补全覆盖到目标后再定位。两种情形都必须落在目标帧上
+    DmsContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    if (dms_player_init(&ctx) != 0) return -1;
+    ctx.frameRate = frameRate;
+    dms_player_set_index_dir(&ctx, indexDir);
+    if (_dms_open_dcp("stub", "", false) != DMS_RESULT_SUCCESS) return -1;
+    ctx.hasActiveMxf = true;
+    dms_player_open_timeline(&ctx);
+    const int64_t targets[] = { 110, 60 };
+    for (int64_t target : targets)
+    {
+        int seek = dms_player_seek_frame(&ctx, target);
+        int64_t waitNs = 0;
+        if (seek != 0)
+        {
+            // 后台补全只在取帧空闲时进行，最多等待10秒
+            int64_t t0 = NowNs();
+            DmsFrameEntry entry;
+            while (dms_index_builder_lookup(ctx.indexBuilder, target, &entry) != 0 && NowNs() - t0 < 10000000000LL)
+            {
+                usleep(10000);
+            }
+            waitNs = NowNs() - t0;
+            seek = dms_player_seek_frame(&ctx, target);
+        }
+        DmsFrame frame;
+        frame.frame = -1;
+        int64_t pts = -1;
+        if (seek == 0 && dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS)
+        {
+            pts = frame.unit->PTS;
+            dms_player_release_frame(&frame);
+        }
+        bool ok = seek == 0 && frame.frame == target && pts == target;
+        char waited[64] = "";
+        if (waitNs > 0) snprintf(waited, sizeof(waited), "after walker covered it (%.0f ms), ", waitNs / 1e6);
+        printf(" |->unindexed seek %-4lld %s%s  %s\n", (long long)target, waited,
+            seek == 0 ? (frame.frame == target ? "landed on target" : "landed on WRONG frame") : "refused",
+            ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+    }
+    dms_player_close_index(&ctx);
+    _dms_close_dcp();
+    ctx.hasActiveMxf = false;
+    dms_player_uninit(&ctx);
+    for (int r = 1; r <= config.reelCount; r++)
+    {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/urn_uuid_00000000-0000-0000-0000-%012d.dmsidx", indexDir, r);
+        unlink(path);
+    }
+    rmdir(indexDir);
+    return result;
+}
+
+/*
+ * 打开合成的多分本影片并顺序读一遍建立完整的帧索引，之后读取位置回到片头
+ *
+ * @param[out] ctx       播放器上下文
+ * @param[in]  indexDir  帧索引目录
+ * @param[in]  frameRate 帧率
+ * @return               影片总帧数，失败返回-1
+ */
+static int64_t OpenIndexedStub(DmsContext* ctx, const char* indexDir, float frameRate)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    if (dms_player_init(ctx) != 0) return -1;
+    ctx->frameRate = frameRate;
+    dms_player_set_index_dir(ctx, indexDir);
+    if (_dms_open_dcp("stub", "", false) != DMS_RESULT_SUCCESS) return -1;
+    ctx->hasActiveMxf = true;
+    if (dms_player_open_timeline(ctx) != 0) return -1;
+    int64_t frames = 0;
+    DmsFrame frame;
+    while (dms_player_next_frame(ctx, &frame) == DMS_RESULT_SUCCESS)
+    {
+        dms_player_release_frame(&frame);
+        frames++;
+    }
+    return dms_player_seek_frame(ctx, 0) == 0 ? frames : -1;
+}
+
+/*
+ * 关闭合成影片并删除各分本的帧索引
+ *
+ * @param[in] ctx       播放器上下文
+ * @param[in] indexDir  帧索引目录
+ * @param[in] reelCount 分本数量
+ */
+static void CloseIndexedStub(DmsContext* ctx, const char* indexDir, int reelCount)
+{
+    dms_player_close_index(ctx);
+    _dms_close_dcp();
+    ctx->hasActiveMxf = false;
+    dms_player_uninit(ctx);
+    for (int r = 1; r <= reelCount; r++)
+    {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/urn_uuid_00000000-0000-0000-0000-%012d.dmsidx", indexDir, r);
+        unlink(path);
+    }
+    rmdir(indexDir);
+}
+
+/*
+ * 时延样本的百分位数
+ *
+ * @param[in] ns      时延样本（纳秒），会被排序
+ * @param[in] percent 百分位（0~100）
+ * @return            毫秒，无样本返回0
+ */
+static double PercentileMs(std::vector<int64_t>* ns, double percent)
+{
+    if (ns->empty()) return 0.0;
+    std::sort(ns->begin(), ns->end());
+    size_t index = (size_t)(percent / 100.0 * (double)(ns->size() - 1) + 0.5);
+    return (*ns)[index] / 1e6;
+}
+
+/*
+ * 分块倒放基准：合成2个分本的影片并建立帧索引，从片尾1倍速倒放到片头（跨越分本），
+ * 不限速时统计持续倒放帧率，按24fps节奏取帧时统计延后帧数；逐帧核对帧号与PTS
+ *
+ * @return 返回0表示成功
+ */
+static int BenchReverse()
+{
+    const char* indexDir = "dmsbench_reverse";
+    const float frameRate = 24.0f;
+    DmsStubConfig config = { 2, 240, 1048576, 80000, 40000, 8000, 10000 };
+    DmsStubConfigure(&config);
+    mkdir(indexDir, 0755);
+    printf("--> Reverse playback (%d reels x %d frames, ~%u KB/frame, read %lld ms/frame, seek %lld ms, "
+        "reel switch %lld ms)\n", config.reelCount, config.framesPerReel, config.unitBytes / 1024,
+        (long long)config.unitUs / 1000, (long long)config.seekUs / 1000,
+        (long long)(config.selectReelUs + config.firstUnitUs) / 1000);
+
+    DmsContext ctx;
+    int64_t total = OpenIndexedStub(&ctx, indexDir, frameRate);
+    if (total <= 0)
+    {
+        CloseIndexedStub(&ctx, indexDir, config.reelCount);
+        return -1;
+    }
+    const int64_t intervalNs = (int64_t)(1e9 / frameRate);
+    int result = 0;
+    for (int paced = 0; paced < 2; paced++)
+    {
+        if (dms_player_seek_frame(&ctx, total - 1) != 0 || dms_player_set_speed(&ctx, -1.0f) != 0)
+        {
+            result = -1;
+            break;
+        }
+        int64_t expected = total - 1;
+        int frames = 0, wrong = 0, late = 0;
+        int64_t t0 = NowNs(), firstNs = 0, lastNs = 0;
+        DmsReversePlayStats stats;
+        memset(&stats, 0, sizeof(stats));
+        for (;;)
+        {
+            if (paced && frames > 0)
+            {
+                int64_t deadline = firstNs + frames * intervalNs;
+                int64_t now = NowNs();
+                if (now < deadline) usleep((useconds_t)((deadline - now) / 1000));
+            }
+            DmsFrame frame;
+            if (dms_player_next_frame(&ctx, &frame) != DMS_RESULT_SUCCESS) break;
+            lastNs = NowNs();
+            if (frames == 0) firstNs = lastNs;
+            else if (paced && lastNs - (firstNs + frames * intervalNs) > intervalNs) late++;
+            int64_t local = expected % config.framesPerReel;
+            if (frame.frame != expected || frame.unit->PTS != local) wrong++;
+            dms_player_release_frame(&frame);
+            if (ctx.reversePlay) dms_reverse_play_get_stats(ctx.reversePlay, &stats);
+            frames++;
+            if (frame.frame <= 0 || expected <= 0) break;
+            expected--;
+        }
+        dms_player_set_speed(&ctx, 1.0f);
+        double fps = frames > 1 ? (frames - 1) / ((lastNs - firstNs) / 1e9) : 0.0;
+        // 倒放跨越分本时同步切换，按节奏取帧时的延后帧只做统计
+        bool ok = frames == total && wrong == 0 && (paced ? true : fps >= frameRate);
+        if (!paced)
+        {
+            printf(" |->unpaced:          %d frames in reverse, %d out of order, first frame %.1f ms, "
+                "sustained %.1f fps (%s 1x real time), chunk %d frames, %lld stalls  %s\n", frames, wrong,
+                (firstNs - t0) / 1e6, fps, fps >= frameRate ? "above" : "BELOW", stats.chunkFrames,
+                (long long)stats.stalls, ok ? "ok" : "FAILED");
+        }
+        else
+        {
+            printf(" |->paced %.0f fps:     %d frames in reverse, %d out of order, %d late frames  %s\n", frameRate,
+                frames, wrong, late, ok ? "ok" : "FAILED");
+        }
+        if (!ok) result = -1;
+    }
+    CloseIndexedStub(&ctx, indexDir, config.reelCount);
+    return result;
+}
+
+/*
+ * 逐帧步进基准：合成2个分本的影片并建立帧索引，跨越分本边界逐帧前进、后退各120帧，
+ * 再按帧号精确定位到分本边界等位置，逐次核对帧号与PTS，统计各类操作的p50/p99时延；
+ * 分本内的步进应在30ms以内，跨越分本的步进包含切换分本的耗时，单独统计
+ *
+ * @return 返回0表示成功
+ */
+static int BenchStep()
+{
+    const char* indexDir = "dmsbench_step";
+    const float frameRate = 24.0f;
+    DmsStubConfig config = { 2, 240, 1048576, 80000, 40000, 8000, 10000 };
+    DmsStubConfigure(&config);
+    mkdir(indexDir, 0755);
+    printf("--> Frame stepping (%d reels x %d frames, ~%u KB/frame, read %lld ms/frame, seek %lld ms, "
+        "target %d ms)\n", config.reelCount, config.framesPerReel, config.unitBytes / 1024,
+        (long long)config.unitUs / 1000, (long long)config.seekUs / 1000, DMS_STEP_LATENCY_TARGET_US / 1000);
+
+    DmsContext ctx;
+    int64_t total = OpenIndexedStub(&ctx, indexDir, frameRate);
+    if (total <= 0)
+    {
+        CloseIndexedStub(&ctx, indexDir, config.reelCount);
+        return -1;
+    }
+    const DmsDataUnit* unit = nullptr;
+    int64_t current = 180;
+    if (dms_player_seek_to_frame(&ctx, current, &unit) != DMS_RESULT_SUCCESS)
+    {
+        CloseIndexedStub(&ctx, indexDir, config.reelCount);
+        return -1;
+    }
+
+    // 前进、后退与按帧定位：分本内与跨越分本的时延分别统计
+    std::vector<int64_t> forward, backward, seeks, crossing;
+    int wrong = 0;
+    const int directions[] = { 1, -1 };
+    for (int direction : directions)
+    {
+        for (int i = 0; i < 120; i++)
+        {
+            int64_t expected = current + direction;
+            int64_t frame = -1;
+            int64_t t0 = NowNs();
+            int step = dms_player_step_frame(&ctx, direction, &unit, &frame);
+            int64_t ns = NowNs() - t0;
+            if (step != DMS_RESULT_SUCCESS || frame != expected || unit->PTS != expected % config.framesPerReel)
+            {
+                wrong++;
+            }
+            if (expected / config.framesPerReel != current / config.framesPerReel) crossing.push_back(ns);
+            else (direction > 0 ? forward : backward).push_back(ns);
+            current = expected;
+        }
+    }
+    const int64_t targets[] = { 239, 240, 241, 238, 0, 479, 100, 360, 120, 300, 299, 180 };
+    for (int64_t target : targets)
+    {
+        int64_t t0 = NowNs();
+        int seek = dms_player_seek_to_frame(&ctx, target, &unit);
+        int64_t ns = NowNs() - t0;
+        if (seek != DMS_RESULT_SUCCESS || dms_player_get_current_frame(&ctx) != target ||
+            unit->PTS != target % config.framesPerReel)
+        {
+            wrong++;
+        }
+        if (target / config.framesPerReel != current / config.framesPerReel) crossing.push_back(ns);
+        else seeks.push_back(ns);
+        current = target;
+    }
+    DmsStepStats stats;
+    memset(&stats, 0, sizeof(stats));
+    dms_step_window_get_stats(ctx.stepWindow, &stats);
+    CloseIndexedStub(&ctx, indexDir, config.reelCount);
+
+    double target = DMS_STEP_LATENCY_TARGET_US / 1000.0;
+    struct { const char* name; std::vector<int64_t>* ns; bool checked; } groups[] = {
+        { "step +1", &forward, true }, { "step -1", &backward, true }, { "seek to frame", &seeks, false },
+        { "across reels", &crossing, false },
+    };
+    int result = wrong == 0 ? 0 : -1;
+    for (auto& group : groups)
+    {
+        double p50 = PercentileMs(group.ns, 50), p99 = PercentileMs(group.ns, 99);
+        double maxMs = group.ns->empty() ? 0.0 : group.ns->back() / 1e6;
+        bool ok = !group.checked || p99 < target;
+        printf(" |->%-14s   %3zu ops, p50 %6.2f ms, p99 %6.2f ms, max %6.2f ms%s\n", group.name, group.ns->size(),
+            p50, p99, maxMs, group.checked ? (ok ? "  ok" : "  OVER TARGET") : "");
+        if (!ok) result = -1;
+    }
+    printf(" |->window:           %lld/%lld served from window, %lld over target, %d wrong frames  %s\n",
+        (long long)stats.hits, (long long)stats.steps, (long long)stats.overTarget, wrong,
+        wrong == 0 ? "ok" : "FAILED");
+    return result;
+}
+
+/*
+ * 模拟以最低分辨率层解码缩略图：按码流首字节生成灰度渐变，并空转约decodeUs微秒
+ *
+ * @param[in]  user    指向模拟解码耗时（微秒）的指针
+ * @param[in]  unit    数据单元
+ * @param[in]  width   缩略图宽度
+ * @param[in]  height  缩略图高度
+ * @param[out] outArgb 输出像素
+ * @return             返回0表示成功
+ */
+static int FakeThumbnailDecode(void* user, const DmsDataUnit* unit, int width, int height, uint32_t* outArgb)
+{
+    int64_t until = NowNs() + *(const int64_t*)user * 1000;
+    uint32_t seed = unit->Data[0];
+    while (NowNs() < until)
+    {
+        seed = seed * 1103515245u + 12345u;
+    }
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            uint32_t v = (unit->Data[0] + x + y) & 0xFF;
+            outArgb[y * width + x] = 0xFF000000u | (v << 16) | (v << 8) | (v ^ (seed & 1));
+        }
+    }
+    return 0;
+}
+
+/*
+ * 进度条缩略图基准：合成50秒影片并先读一遍建立帧索引，每秒取一个样本，
+ * 统计整个图集的生成耗时，以及在生成过程中悬停到随机位置后该位置缩略图就绪的延迟
+ *
+ * @return 返回0表示成功
+ */
+static int BenchThumb()
+{
+    const char* indexDir = "dmsbench_thumbs";
+    DmsStubConfig stub = { 1, 1200, 262144, 0, 0, 2000, 2000 };
+    DmsStubConfigure(&stub);
+    mkdir(indexDir, 0755);
+
+    DmsContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    dms_player_init(&ctx);
+    ctx.frameRate = 24.0f;
+    dms_player_set_index_dir(&ctx, indexDir);
+    _dms_open_dcp("stub", "", false);
+    ctx.hasActiveMxf = true;
+    dms_player_open_timeline(&ctx);
+    DmsFrame frame;
+    while (dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS)
+    {
+        dms_player_release_frame(&frame);
+    }
+    dms_player_seek_frame(&ctx, 0);
+
+    int64_t decodeUs = 15000;
+    DmsThumbnailConfig config = { 24, DMS_THUMBNAIL_DEFAULT_WIDTH, DMS_THUMBNAIL_DEFAULT_HEIGHT, 0 };
+    std::vector<uint32_t> pixels((size_t)config.width * config.height);
+    printf("--> Thumbnails (%d frames every %d, %dx%d, simulated decode %lld ms, seek %lld ms)\n",
+        stub.framesPerReel, config.intervalFrames, config.width, config.height,
+        (long long)decodeUs / 1000, (long long)stub.seekUs / 1000);
+
+    // 整个图集的生成耗时
+    int result = 0;
+    DmsThumbnailAtlas* atlas = dms_thumbnail_create(&ctx, &config, FakeThumbnailDecode, &decodeUs);
+    if (!atlas) result = -1;
+    DmsThumbnailStats stats;
+    memset(&stats, 0, sizeof(stats));
+    int64_t t0 = NowNs();
+    while (atlas && dms_thumbnail_get_stats(atlas, &stats) == 0 && stats.readyCount + stats.failedCount + stats.skippedCount < stats.sampleCount)
+    {
+        usleep(1000);
+    }
+    int64_t fillNs = NowNs() - t0;
+    printf(" |->atlas:            %d samples, %d failed, %lld bytes, %d threads, %.1f ms total\n",
+        stats.sampleCount, stats.failedCount, (long long)stats.atlasBytes, stats.threads, fillNs / 1e6);
+    printf(" |->per sample:       fetch %.2f ms, decode %.2f ms\n", stats.fetchCostUs / 1000, stats.decodeCostUs / 1000);
+    dms_thumbnail_destroy(atlas);
+
+    // 生成过程中悬停到随机位置：从查询到该位置的样本就绪
+    srand(7);
+    std::vector<double> latencies;
+    atlas = dms_thumbnail_create(&ctx, &config, FakeThumbnailDecode, &decodeUs);
+    for (int i = 0; atlas && i < 10; i++)
+    {
+        int64_t frame = rand() % stub.framesPerReel;
+        int64_t expected = (frame + config.intervalFrames / 2) / config.intervalFrames * config.intervalFrames;
+        int64_t got = -1;
+        t0 = NowNs();
+        while (NowNs() - t0 < 1000000000LL)
+        {
+            if (dms_thumbnail_get(atlas, frame, pixels.data(), &got) == 0 && got == expected) break;
+            usleep(500);
+        }
+        latencies.push_back(got == expected ? (NowNs() - t0) / 1e6 : 1000.0);
+        usleep(30000);
+    }
+    dms_thumbnail_destroy(atlas);
+    double maxMs = 0, sumMs = 0;
+    for (double ms : latencies)
+    {
+        sumMs += ms;
+        if (ms > maxMs) maxMs = ms;
+    }
+    printf(" |->hover to ready:   avg %.1f ms, max %.1f ms over %zu positions\n",
+        latencies.empty() ? 0.0 : sumMs / latencies.size(), maxMs, latencies.size());
+
+    // 已生成位置的查询
+    atlas = dms_thumbnail_create(&ctx, &config, FakeThumbnailDecode, &decodeUs);
+    while (atlas && dms_thumbnail_get_stats(atlas, &stats) == 0 && stats.readyCount + stats.failedCount + stats.skippedCount < stats.sampleCount)
+    {
+        usleep(1000);
+    }
+    t0 = NowNs();
+    const int lookups = 10000;
+    for (int i = 0; atlas && i < lookups; i++)
+    {
+        dms_thumbnail_get(atlas, rand() % stub.framesPerReel, pixels.data(), nullptr);
+    }
+    printf(" |->ready lookup:     %.1f us\n", (NowNs() - t0) / 1e3 / lookups);
+    dms_thumbnail_destroy(atlas);
+
+    dms_player_close_index(&ctx);
+    _dms_close_dcp();
+    ctx.hasActiveMxf = false;
+    dms_player_uninit(&ctx);
+    unlink("dmsbench_thumbs/urn_uuid_00000000-0000-0000-0000-000000000001.dmsidx");
+    rmdir(indexDir);
+    return result;
+}
+
+#ifdef DMS_HAVE_OPENJPEG
+/*
+ * 编码输出的内存码流
+ */
+struct CodestreamBuffer
+{
+    std::vector<uint8_t> data;
+    size_t offset;
+};
+
+static OPJ_SIZE_T CodestreamWrite(void* buffer, OPJ_SIZE_T bytes, void* user)
+{
+    CodestreamBuffer* out = (CodestreamBuffer*)user;
+    if (out->offset + bytes > out->data.size()) out->data.resize(out->offset + bytes);
+    memcpy(out->data.data() + out->offset, buffer, bytes);
+    out->offset += bytes;
+    return bytes;
+}
+
+static OPJ_OFF_T CodestreamSkip(OPJ_OFF_T bytes, void* user)
+{
+    CodestreamBuffer* out = (CodestreamBuffer*)user;
+    out->offset += (size_t)bytes;
+    if (out->offset > out->data.size()) out->data.resize(out->offset);
+    return bytes;
+}
+
+static OPJ_BOOL CodestreamSeek(OPJ_OFF_T offset, void* user)
+{
+    CodestreamBuffer* out = (CodestreamBuffer*)user;
+    out->offset = (size_t)offset;
+    if (out->offset > out->data.size()) out->data.resize(out->offset);
+    return OPJ_TRUE;
+}
+
+/*
+ * 合成一帧12位三分量图像（渐变叠加噪声，接近真实画面的码率），按DCI 2K的编码参数编码：
+ * 5级9/7小波、32x32码块、CPRL顺序，压缩到约每帧1.2MB（24fps下约230Mbps）
+ *
+ * @param[in]  width  宽度
+ * @param[in]  height 高度
+ * @param[in]  seed   随机种子，不同种子得到不同画面
+ * @param[out] out    输出码流
+ * @return            返回true表示成功
+ */
+static bool EncodeSyntheticFrame(int width, int height, int seed, std::vector<uint8_t>* out)
+{
+    opj_image_cmptparm_t comps[3];
+    memset(comps, 0, sizeof(comps));
+    for (int c = 0; c < 3; c++)
+    {
+        comps[c].dx = 1;
+        comps[c].dy = 1;
+        comps[c].w = (OPJ_UINT32)width;
+        comps[c].h = (OPJ_UINT32)height;
+        comps[c].prec = 12;
+        comps[c].sgnd = 0;
+    }
+    opj_image_t* image = opj_image_create(3, comps, OPJ_CLRSPC_UNSPECIFIED);
+    if (!image) return false;
+    image->x0 = 0;
+    image->y0 = 0;
+    image->x1 = (OPJ_UINT32)width;
+    image->y1 = (OPJ_UINT32)height;
+    uint32_t state = (uint32_t)seed * 2654435761u + 1;
+    for (int c = 0; c < 3; c++)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                state = state * 1664525u + 1013904223u;
+                int v = (x * 3000 / width + y * 1000 / height + c * 200 + seed * 37) % 3600 + (int)(state >> 26);
+                image->comps[c].data[y * width + x] = v;
+            }
+        }
+    }
+
+    opj_cparameters_t params;
+    opj_set_default_encoder_parameters(&params);
+    params.numresolution = 6;
+    params.cblockw_init = 32;
+    params.cblockh_init = 32;
+    params.prog_order = OPJ_CPRL;
+    params.irreversible = 1;
+    params.tcp_mct = 0;
+    params.tcp_numlayers = 1;
+    params.tcp_rates[0] = (float)width * height * 3 * 12 / 8 / 1200000.0f;
+    params.cp_disto_alloc = 1;
+
+    opj_codec_t* codec = opj_create_compress(OPJ_CODEC_J2K);
+    CodestreamBuffer buffer;
+    buffer.offset = 0;
+    opj_stream_t* stream = opj_stream_create(1 << 20, OPJ_FALSE);
+    opj_stream_set_user_data(stream, &buffer, nullptr);
+    opj_stream_set_write_function(stream, CodestreamWrite);
+    opj_stream_set_skip_function(stream, CodestreamSkip);
+    opj_stream_set_seek_function(stream, CodestreamSeek);
+    bool ok = opj_setup_encoder(codec, &params, image) &&
+              opj_start_compress(codec, image, stream) &&
+              opj_encode(codec, stream) &&
+              opj_end_compress(codec, stream);
+    opj_stream_destroy(stream);
+    opj_destroy_codec(codec);
+    opj_image_destroy(image);
+    if (ok) out->swap(buffer.data);
+    return ok;
+}
+#endif
+
+/*
+ * 读取目录中的 .j2c 码流文件
+ *
+ * @param[in]  dir  目录
+ * @param[out] out  码流
+ * @return          读取的文件数
+ */
+static int LoadCodestreams(const char* dir, std::vector<std::vector<uint8_t>>* out)
+{
+    DIR* d = opendir(dir);
+    if (!d) return 0;
+    struct dirent* entry;
+    while ((entry = readdir(d)) != nullptr)
+    {
+        size_t len = strlen(entry->d_name);
+        if (len < 4 || strcmp(entry->d_name + len - 4, ".j2c") != 0) continue;
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+        FILE* fp = fopen(path, "rb");
+        if (!fp) continue;
+        fseek(fp, 0, SEEK_END);
+        long size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        std::vector<uint8_t> data(size > 0 ? (size_t)size : 0);
+        if (size > 0 && fread(data.data(), 1, data.size(), fp) == data.size()) out->push_back(data);
+        fclose(fp);
+    }
+    closedir(d);
+    return (int)out->size();
+}
+
+/*
+ * 准备解码用例的码流：读取目录中的 .j2c 文件，未指定目录时合成DCI 2K码流
+ *
+ * @param[in]  dir  码流目录，可为空
+ * @param[out] out  码流
+ * @return          码流个数
+ */
+static int PrepareCodestreams(const char* dir, std::vector<std::vector<uint8_t>>* out)
+{
+    if (dir) return LoadCodestreams(dir, out);
+#ifdef DMS_HAVE_OPENJPEG
+    for (int i = 0; i < 4; i++)
+    {
+        std::vector<uint8_t> data;
+        if (EncodeSyntheticFrame(2048, 1080, i, &data)) out->push_back(data);
+    }
+#endif
+    return (int)out->size();
+}
+
+/*
+ * J2K解码基准：在1、2、4线程及全部核心下循环解码2K码流，统计每帧耗时与帧率，判断能否实时解码2K/24
+ *
+ * @param[in] dir 码流目录，为空时合成DCI 2K码流
+ * @return        返回0表示成功
+ */
+static int BenchJ2k(const char* dir)
+{
+    if (!dms_j2k_decoder_available())
+    {
+        printf("--> J2K decode: built without OpenJPEG (-DDMS_HAVE_OPENJPEG -lopenjp2), skipped\n");
+        return 0;
+    }
+    std::vector<std::vector<uint8_t>> streams;
+    if (PrepareCodestreams(dir, &streams) == 0)
+    {
+        printf("--> J2K decode: no codestream\n");
+        return -1;
+    }
+    size_t bytes = 0;
+    for (const std::vector<uint8_t>& data : streams) bytes += data.size();
+
+    int cores = (int)std::thread::hardware_concurrency();
+    std::vector<int> threadCounts = { 1, 2, 4 };
+    if (cores > 4) threadCounts.push_back(cores);
+    printf("--> J2K decode (%zu codestreams, avg %.0f KB, %d cores)\n", streams.size(), bytes / 1024.0 / streams.size(), cores);
+
+    int result = 0;
+    for (int threads : threadCounts)
+    {
+        DmsJ2kDecoderConfig config = { threads, 0 };
+        DmsJ2kDecoder* decoder = dms_j2k_decoder_create(&config);
+        DmsPicture picture;
+        int frames = 0;
+        int64_t t0 = NowNs();
+        while (frames < 24 || NowNs() - t0 < 2000000000LL)
+        {
+            const std::vector<uint8_t>& data = streams[frames % streams.size()];
+            if (dms_j2k_decoder_decode(decoder, data.data(), (uint32_t)data.size(), &picture) != 0)
+            {
+                result = -1;
+                break;
+            }
+            if (frames == 0 && threads == threadCounts[0]) printf(" |->picture:          %dx%d, %d components, %d bits\n",
+                picture.width, picture.height, picture.components, picture.precision);
+            dms_picture_release(&picture);
+            frames++;
+        }
+        double seconds = (NowNs() - t0) / 1e9;
+        printf(" |->%d threads:        %.1f ms/frame, %.1f fps%s\n", threads, seconds * 1000 / frames,
+            frames / seconds, frames / seconds >= 24.0 ? " (real time 24fps)" : "");
+        dms_j2k_decoder_destroy(decoder);
+        if (result != 0) break;
+    }
+    if (result != 0) return result;
+
+    // 降分辨率解码：每级丢弃一层小波分解，被丢弃分辨率的码块不做熵解码
+    int levelThreads = threadCounts.back();
+    printf(" |->reduced resolution (%d threads):\n", levelThreads);
+    for (int reduce = 0; reduce <= DMS_J2K_MAX_REDUCE && result == 0; reduce++)
+    {
+        DmsJ2kDecoderConfig config = { levelThreads, reduce };
+        DmsJ2kDecoder* decoder = dms_j2k_decoder_create(&config);
+        DmsPicture picture;
+        int width = 0, height = 0, frames = 0;
+        int64_t t0 = NowNs();
+        while (frames < 24 || NowNs() - t0 < 2000000000LL)
+        {
+            const std::vector<uint8_t>& data = streams[frames % streams.size()];
+            if (dms_j2k_decoder_decode(decoder, data.data(), (uint32_t)data.size(), &picture) != 0)
+            {
+                result = -1;
+                break;
+            }
+            width = picture.width;
+            height = picture.height;
+            dms_picture_release(&picture);
+            frames++;
+        }
+        double seconds = (NowNs() - t0) / 1e9;
+        printf(" |    1/%-2d %4dx%-4d    %.1f ms/frame, %.1f fps%s\n", 1 << reduce, width, height,
+            seconds * 1000 / frames, frames / seconds, frames / seconds >= 24.0 ? " (real time 24fps)" : "");
+        dms_j2k_decoder_destroy(decoder);
+    }
+
+    // 按输出画面尺寸自动选择分辨率层
+    const int surfaces[][2] = { { 1920, 1080 }, { 1280, 720 }, { 960, 540 }, { 480, 270 }, { DMS_THUMBNAIL_DEFAULT_WIDTH, DMS_THUMBNAIL_DEFAULT_HEIGHT } };
+    DmsJ2kDecoderConfig config = { levelThreads, DMS_J2K_REDUCE_AUTO };
+    DmsJ2kDecoder* decoder = dms_j2k_decoder_create(&config);
+    for (const int* surface : surfaces)
+    {
+        DmsPicture picture;
+        dms_j2k_decoder_set_output_size(decoder, surface[0], surface[1]);
+        const std::vector<uint8_t>& data = streams[0];
+        if (result != 0 || dms_j2k_decoder_decode(decoder, data.data(), (uint32_t)data.size(), &picture) != 0)
+        {
+            result = -1;
+            break;
+        }
+        printf(" |->surface %4dx%-4d  decoded at 1/%d (%dx%d)\n", surface[0], surface[1], 1 << picture.reduce,
+            picture.width, picture.height);
+        dms_picture_release(&picture);
+    }
+    dms_j2k_decoder_destroy(decoder);
+    return result;
+}
+
+/*
+ * 按桩 libdms 的方式分配数据单元，由并行解码器经 _dms_free_data_unit 释放
+ *
+ * @param[in] data  码流
+ * @param[in] frame 帧号
+ * @param[out] out  输出帧
+ */
+static void MakeFrame(const std::vector<uint8_t>& data, int64_t frame, DmsFrame* out)
+{
+    DmsDataUnit* unit = (DmsDataUnit*)calloc(1, sizeof(DmsDataUnit));
+    unit->Data = (uint8_t*)malloc(data.size());
+    memcpy(unit->Data, data.data(), data.size());
+    unit->Length = (uint32_t)data.size();
+    unit->Pos = frame;
+    out->unit = unit;
+    out->frame = frame;
+    out->timeUs = frame * 1000000 / 24;
+    out->durationUs = 1000000 / 24;
+    out->cached = false;
+    out->rightUnit = nullptr;
+}
+
+/*
+ * 帧级并行解码基准：M个解码线程（单帧内单线程）同时解码相邻帧，按显示顺序取出，
+ * 统计帧率、各线程利用率与在途帧峰值；随后模拟定位，统计清空在途帧的耗时
+ *
+ * @param[in] dir 码流目录，为空时合成DCI 2K码流
+ * @return        返回0表示成功
+ */
+static int BenchPipeline(const char* dir)
+{
+    if (!dms_j2k_decoder_available())
+    {
+        printf("--> Frame-parallel decode: built without OpenJPEG (-DDMS_HAVE_OPENJPEG -lopenjp2), skipped\n");
+        return 0;
+    }
+    std::vector<std::vector<uint8_t>> streams;
+    if (PrepareCodestreams(dir, &streams) == 0)
+    {
+        printf("--> Frame-parallel decode: no codestream\n");
+        return -1;
+    }
+    int cores = (int)std::thread::hardware_concurrency();
+    std::vector<int> workerCounts = { 1, 2, 4 };
+    if (cores > 4) workerCounts.push_back(cores);
+    printf("--> Frame-parallel decode (%zu codestreams, %d cores, 1 thread per frame)\n", streams.size(), cores);
+
+    DmsJ2kDecoderConfig decoderConfig = { 1, 0 };
+    DmsJ2kDecoder* decoder = dms_j2k_decoder_create(&decoderConfig);
+    int result = 0;
+    for (int workers : workerCounts)
+    {
+        DmsDecodePipelineConfig config = { workers, 0 };
+        DmsDecodePipeline* pipeline = dms_decode_pipeline_create(decoder, &config);
+        int64_t submitted = 0, received = 0, expected = 0;
+        int64_t t0 = NowNs();
+        while (received < 24 || NowNs() - t0 < 3000000000LL)
+        {
+            // 取帧阶段：持有帧数未满时持续提交
+            while (!dms_decode_pipeline_full(pipeline))
+            {
+                DmsFrame frame;
+                MakeFrame(streams[submitted % streams.size()], submitted, &frame);
+                dms_decode_pipeline_submit(pipeline, &frame, -1);
+                submitted++;
+            }
+            DmsFrame frame;
+            DmsPicture picture;
+            if (dms_decode_pipeline_receive(pipeline, &frame, &picture, -1) != 0 || frame.frame != expected)
+            {
+                printf(" |->%d workers: frame %lld out of order or failed (expected %lld)\n", workers,
+                    (long long)frame.frame, (long long)expected);
+                result = -1;
+                break;
+            }
+            dms_picture_release(&picture);
+            expected++;
+            received++;
+        }
+        double seconds = (NowNs() - t0) / 1e9;
+        DmsDecodePipelineStats stats;
+        dms_decode_pipeline_get_stats(pipeline, &stats);
+        printf(" |->%d workers:        %.1f fps%s, peak %d in flight, %lld head-of-line waits, utilization",
+            workers, received / seconds, received / seconds >= 24.0 ? " (real time 24fps)" : "",
+            stats.peakInFlight, (long long)stats.headOfLineWaits);
+        for (int i = 0; i < stats.workers; i++) printf(" %.0f%%", stats.utilization[i] * 100);
+        printf("\n");
+        dms_decode_pipeline_destroy(pipeline);
+        if (result != 0) break;
+    }
+
+    // 定位：清空在途帧后从新位置提交，第一帧应为新位置的帧
+    if (result == 0)
+    {
+        DmsDecodePipelineConfig config = { workerCounts.back(), 0 };
+        DmsDecodePipeline* pipeline = dms_decode_pipeline_create(decoder, &config);
+        int64_t frameNo = 0;
+        while (!dms_decode_pipeline_full(pipeline))
+        {
+            DmsFrame frame;
+            MakeFrame(streams[frameNo % streams.size()], frameNo, &frame);
+            dms_decode_pipeline_submit(pipeline, &frame, -1);
+            frameNo++;
+        }
+        int64_t t0 = NowNs();
+        int64_t first = dms_decode_pipeline_flush(pipeline, nullptr);
+        double flushMs = (NowNs() - t0) / 1e6;
+        DmsFrame frame;
+        MakeFrame(streams[0], 1000, &frame);
+        dms_decode_pipeline_submit(pipeline, &frame, -1);
+        DmsPicture picture;
+        int received = dms_decode_pipeline_receive(pipeline, &frame, &picture, -1);
+        double seekMs = (NowNs() - t0) / 1e6;
+        if (received == 0) dms_picture_release(&picture);
+        DmsDecodePipelineStats stats;
+        dms_decode_pipeline_get_stats(pipeline, &stats);
+        printf(" |->seek:             flush %.2f ms (first dropped frame %lld, %lld cancelled), first new frame %lld after %.1f ms\n",
+            flushMs, (long long)first, (long long)stats.cancelled, (long long)frame.frame, seekMs);
+        if (received != 0 || frame.frame != 1000) result = -1;
+        dms_decode_pipeline_destroy(pipeline);
+    }
+    dms_j2k_decoder_destroy(decoder);
+    return result;
+}
+
+/*
+ * 合成12位X'Y'Z'测试图像：渐变加噪声，含越界码值
+ *
+ * @param[in]  width  宽度
+ * @param[in]  height 高度
+ * @param[out] planes 三个分量平面
+ * @param[out] picture 引用各分量平面的解码图像
+ */
+static void MakeXyzPicture(int width, int height, std::vector<int32_t>* planes, DmsPicture* picture)
+{
+    uint32_t seed = 12345;
+    for (int c = 0; c < 3; c++)
+    {
+        planes[c].resize((size_t)width * height);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                int noise = (int)(seed >> 24) - 128;
+                planes[c][(size_t)y * width + x] = (x * 4096 / width + y * (c + 1)) % 4096 + noise;
+            }
+        }
+    }
+    memset(picture, 0, sizeof(*picture));
+    picture->width = width;
+    picture->height = height;
+    picture->components = 3;
+    picture->precision = 12;
+    for (int c = 0; c < 3; c++) picture->planes[c] = planes[c].data();
+}
+
+/*
+ * 色彩转换基准：合成2K的12位X'Y'Z'图像（渐变加噪声，含越界码值），对每种输出格式与色彩空间
+ * 用各可用内核转换，统计吞吐并与标量参考实现的输出逐位比对
+ *
+ * @return 返回0表示成功且各内核输出一致
+ */
+static int BenchColor()
+{
+    const int width = 2048, height = 1080;
+    std::vector<int32_t> planes[3];
+    DmsPicture picture;
+    MakeXyzPicture(width, height, planes, &picture);
+
+    const int kernels[] = { DMS_COLOR_KERNEL_SCALAR, DMS_COLOR_KERNEL_NEON, DMS_COLOR_KERNEL_SSE41, DMS_COLOR_KERNEL_AVX2 };
+    const struct { int colorSpace; int format; const char* name; } cases[] = {
+        { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, "sRGB RGBA_8888" },
+        { DMS_COLOR_P3_D65, DMS_COLOR_RGBA_1010102, "P3-D65 RGBA_1010102" },
+    };
+    printf("--> X'Y'Z' to RGB (%dx%d, 12-bit)\n", width, height);
+    int result = 0;
+    std::vector<uint32_t> reference((size_t)width * height), output((size_t)width * height);
+    for (const auto& item : cases)
+    {
+        printf(" |->%s:\n", item.name);
+        for (int kernel : kernels)
+        {
+            if (!dms_color_kernel_supported(kernel)) continue;
+            DmsColorConfig config = { item.colorSpace, item.format, 12, kernel };
+            DmsColorConverter* converter = dms_color_create(&config);
+            std::vector<uint32_t>& out = kernel == DMS_COLOR_KERNEL_SCALAR ? reference : output;
+            int frames = 0;
+            int64_t t0 = NowNs();
+            while (frames < 5 || NowNs() - t0 < 1000000000LL)
+            {
+                dms_color_convert(converter, &picture, 0, height, out.data(), width * 4);
+                frames++;
+            }
+            double seconds = (NowNs() - t0) / 1e9;
+            bool exact = kernel == DMS_COLOR_KERNEL_SCALAR ||
+                         memcmp(reference.data(), output.data(), output.size() * sizeof(uint32_t)) == 0;
+            if (!exact) result = -1;
+            printf(" |    %-8s %8.1f MP/s, %6.2f ms/frame%s\n", dms_color_kernel_name(kernel),
+                frames * (double)width * height / seconds / 1e6, seconds * 1000 / frames,
+                kernel == DMS_COLOR_KERNEL_SCALAR ? " (reference)" : (exact ? ", bit-exact" : ", MISMATCH"));
+            dms_color_destroy(converter);
+        }
+    }
+    return result;
+}
+
+/*
+ * 以指定配置转换若干遍，统计单帧耗时
+ *
+ * @param[in]  config  转换配置
+ * @param[in]  picture 解码图像
+ * @param[out] out     输出图像
+ * @return             单帧耗时（毫秒），创建转换器失败返回-1
+ */
+static double TimeColorConvert(const DmsColorConfig* config, const DmsPicture* picture, std::vector<uint32_t>* out)
+{
+    DmsColorConverter* converter = dms_color_create(config);
+    if (converter == nullptr) return -1;
+    out->resize((size_t)picture->width * picture->height);
+    int frames = 0;
+    int64_t t0 = NowNs();
+    while (frames < 5 || NowNs() - t0 < 500000000LL)
+    {
+        dms_color_convert(converter, picture, 0, picture->height, out->data(), picture->width * 4);
+        frames++;
+    }
+    double ms = (NowNs() - t0) / 1e6 / frames;
+    dms_color_destroy(converter);
+    return ms;
+}
+
+/*
+ * 两幅RGBA_8888图像各分量的最大差值
+ */
+static int MaxChannelDiff(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+{
+    int maxDiff = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        for (int shift = 0; shift < 24; shift += 8)
+        {
+            int diff = abs((int)((a[i] >> shift) & 0xFF) - (int)((b[i] >> shift) & 0xFF));
+            if (diff > maxDiff) maxDiff = diff;
+        }
+    }
+    return maxDiff;
+}
+
+/*
+ * 3D LUT色域映射基准：
+ *   1. 内置P3到Rec.709色域压缩LUT在17³、33³、65³下各内核的单帧耗时（2K），对照只做矩阵转换的耗时，
+ *      并与标量参考实现逐位比对；
+ *   2. 恒等LUT写成.cube文件再载入，输出与P3-D65矩阵转换相差不超过1个码值；
+ *   3. 色域压缩LUT对消色（D65灰阶）不改变输出，对超出Rec.709的饱和P3颜色减少截断的分量
+ *
+ * @return 返回0表示成功且各项检查通过
+ */
+static int BenchLut()
+{
+    const int width = 2048, height = 1080;
+    std::vector<int32_t> planes[3];
+    DmsPicture picture;
+    MakeXyzPicture(width, height, planes, &picture);
+    const int kernels[] = { DMS_COLOR_KERNEL_SCALAR, DMS_COLOR_KERNEL_NEON, DMS_COLOR_KERNEL_SSE41, DMS_COLOR_KERNEL_AVX2 };
+    int result = 0;
+    std::vector<uint32_t> reference, output;
+
+    printf("--> 3D LUT gamut map P3 to sRGB (%dx%d, 12-bit, RGBA_8888), ms/frame\n", width, height);
+    printf(" |    %-8s %10s", "kernel", "matrix");
+    const int sizes[] = { 17, 33, 65 };
+    for (int size : sizes) printf("   LUT %2d^3", size);
+    printf("\n");
+    DmsColorLut* luts[3];
+    for (int i = 0; i < 3; i++) luts[i] = dms_color_lut_create_gamut_map(sizes[i], DMS_COLOR_SRGB);
+    std::vector<std::vector<uint32_t>> references(3);
+    for (int kernel : kernels)
+    {
+        if (!dms_color_kernel_supported(kernel)) continue;
+        DmsColorConfig config = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, 12, kernel, nullptr };
+        printf(" |    %-8s %10.2f", dms_color_kernel_name(kernel), TimeColorConvert(&config, &picture, &output));
+        bool exact = true;
+        for (int i = 0; i < 3; i++)
+        {
+            config.lut = luts[i];
+            std::vector<uint32_t>& out = kernel == DMS_COLOR_KERNEL_SCALAR ? references[i] : output;
+            printf(" %11.2f", TimeColorConvert(&config, &picture, &out));
+            if (kernel != DMS_COLOR_KERNEL_SCALAR && out != references[i]) exact = false;
+        }
+        if (!exact) result = -1;
+        printf("%s\n", kernel == DMS_COLOR_KERNEL_SCALAR ? "  (reference)" : (exact ? "  bit-exact" : "  MISMATCH"));
+    }
+
+    // 恒等LUT经.cube文件往返：与矩阵转换只差插值与定点舍入
+    {
+        const int size = 33;
+        char path[] = "/tmp/dmsbench_identity.cube";
+        FILE* file = fopen(path, "w");
+        if (file == nullptr) return -1;
+        fprintf(file, "# identity\nTITLE \"identity\"\nLUT_3D_SIZE %d\n", size);
+        for (int b = 0; b < size; b++)
+            for (int g = 0; g < size; g++)
+                for (int r = 0; r < size; r++)
+                    fprintf(file, "%.6f %.6f %.6f\n", r / (size - 1.0), g / (size - 1.0), b / (size - 1.0));
+        fclose(file);
+        DmsColorLut* identity = dms_color_lut_load(path, DMS_COLOR_P3_D65);
+        unlink(path);
+        if (identity == nullptr) return -1;
+        DmsColorConfig config = { DMS_COLOR_P3_D65, DMS_COLOR_RGBA_8888, 12, DMS_COLOR_KERNEL_AUTO, nullptr };
+        TimeColorConvert(&config, &picture, &reference);
+        config.lut = identity;
+        TimeColorConvert(&config, &picture, &output);
+        int maxDiff = MaxChannelDiff(reference, output);
+        bool ok = maxDiff <= 1;
+        printf(" |->identity .cube %d^3 vs matrix: max diff %d code  %s\n", size, maxDiff, ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+        dms_color_lut_destroy(identity);
+    }
+
+    // 消色不变；饱和P3颜色（各色相，满饱和度）按矩阵转换截断，经色域压缩后截断的分量减少
+    {
+        const int count = 4096;
+        std::vector<int32_t> gray[3], vivid[3];
+        const double d65[3] = { 0.9505, 1.0, 1.089 };
+        const double p3ToXyz[9] = { 0.4865709, 0.2656677, 0.1982173, 0.2289746, 0.6917385, 0.0792869,
+                                    0.0000000, 0.0451134, 1.0439444 };
+        for (int c = 0; c < 3; c++)
+        {
+            gray[c].resize(count);
+            vivid[c].resize(count);
+        }
+        for (int i = 0; i < count; i++)
+        {
+            double t = (double)i / (count - 1);
+            // 六个色相区段之间线性过渡的满饱和P3颜色，亮度0.6
+            double h = t * 6.0, f = h - floor(h);
+            double rgb[6][3] = { { 1, f, 0 }, { 1 - f, 1, 0 }, { 0, 1, f }, { 0, 1 - f, 1 }, { f, 0, 1 }, { 1, 0, 1 - f } };
+            const double* p3 = rgb[std::min((int)h, 5)];
+            for (int c = 0; c < 3; c++)
+            {
+                double xyz = 0.6 * (p3ToXyz[c * 3] * p3[0] + p3ToXyz[c * 3 + 1] * p3[1] + p3ToXyz[c * 3 + 2] * p3[2]);
+                vivid[c][i] = (int32_t)lround(4095.0 * pow(xyz * 48.0 / 52.37, 1.0 / 2.6));
+                gray[c][i] = (int32_t)lround(4095.0 * pow(t * d65[c] * 48.0 / 52.37, 1.0 / 2.6));
+            }
+        }
+        DmsPicture strip;
+        memset(&strip, 0, sizeof(strip));
+        strip.width = count;
+        strip.height = 1;
+        strip.components = 3;
+        strip.precision = 12;
+        DmsColorConfig config = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, 12, DMS_COLOR_KERNEL_AUTO, nullptr };
+        DmsColorConverter* matrix = dms_color_create(&config);
+        config.lut = luts[1];
+        DmsColorConverter* mapped = dms_color_create(&config);
+        std::vector<uint32_t> a(count), b(count);
+        for (int c = 0; c < 3; c++) strip.planes[c] = gray[c].data();
+        dms_color_convert(matrix, &strip, 0, 1, a.data(), count * 4);
+        dms_color_convert(mapped, &strip, 0, 1, b.data(), count * 4);
+        int grayDiff = MaxChannelDiff(a, b);
+        for (int c = 0; c < 3; c++) strip.planes[c] = vivid[c].data();
+        dms_color_convert(matrix, &strip, 0, 1, a.data(), count * 4);
+        dms_color_convert(mapped, &strip, 0, 1, b.data(), count * 4);
+        int clipped[2] = { 0, 0 };
+        for (int i = 0; i < count; i++)
+        {
+            for (int shift = 0; shift < 24; shift += 8)
+            {
+                clipped[0] += ((a[i] >> shift) & 0xFF) == 0;
+                clipped[1] += ((b[i] >> shift) & 0xFF) == 0;
+            }
+        }
+        bool ok = grayDiff <= 1 && clipped[1] < clipped[0];
+        printf(" |->gamut map 33^3: gray ramp max diff %d code, vivid P3 channels clipped to 0: matrix %d, mapped %d  %s\n",
+            grayDiff, clipped[0], clipped[1], ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+        dms_color_destroy(matrix);
+        dms_color_destroy(mapped);
+    }
+    for (DmsColorLut* lut : luts) dms_color_lut_destroy(lut);
+    return result;
+}
+
+/*
+ * 以指定缩放器与转换器输出整幅目标图像若干遍，统计单帧耗时
+ *
+ * @param[in]  scaler    缩放器
+ * @param[in]  converter 色彩转换器
+ * @param[in]  picture   解码图像
+ * @param[in]  width     目标宽度
+ * @param[in]  height    目标高度
+ * @param[out] out       目标图像
+ * @return               单帧耗时（毫秒），处理失败返回-1
+ */
+static double TimeScale(DmsScaler* scaler, DmsColorConverter* converter, const DmsPicture* picture, int width,
+    int height, std::vector<uint32_t>* out)
+{
+    out->assign((size_t)width * height, 0x12345678u);
+    int frames = 0;
+    int64_t t0 = NowNs();
+    while (frames < 5 || NowNs() - t0 < 500000000LL)
+    {
+        if (dms_scaler_process(scaler, picture, converter, 0, height, out->data(), width * 4) != 0) return -1;
+        frames++;
+    }
+    return (NowNs() - t0) / 1e6 / frames;
+}
+
+/*
+ * 检查画面区域以外（上下、左右黑边）全为黑色
+ *
+ * @param[in] out     目标图像
+ * @param[in] width   目标宽度
+ * @param[in] height  目标高度
+ * @param[in] fitW    画面区域宽度
+ * @param[in] fitH    画面区域高度
+ * @param[in] black   黑色像素
+ * @return            黑边全为黑色返回true
+ */
+static bool CheckLetterbox(const std::vector<uint32_t>& out, int width, int height, int fitW, int fitH, uint32_t black)
+{
+    int left = (width - fitW) / 2, top = (height - fitH) / 2;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            bool inside = y >= top && y < top + fitH && x >= left && x < left + fitW;
+            if (!inside && out[(size_t)y * width + x] != black) return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * 缩放与加黑边基准：
+ *   1. flat 1998x1080、scope 2048x858按原宽高比适配1920x1080、1280x800、1024x600屏幕，双三次与Lanczos-3
+ *      下缩放、转换与加黑边的单帧耗时，对照源尺寸只做色彩转换的耗时；各内核与标量参考实现逐位比对，
+ *      黑边全为黑色；
+ *   2. 平坦画面缩放后保持平坦（系数归一化）；
+ *   3. 分辨率层恰好适配屏幕（1024x540放入1024x600）时不缩放，画面区域与直接转换逐位一致
+ *
+ * @return 返回0表示成功且各项检查通过
+ */
+static int BenchScale()
+{
+    const int kernels[] = { DMS_COLOR_KERNEL_SCALAR, DMS_COLOR_KERNEL_NEON, DMS_COLOR_KERNEL_SSE41, DMS_COLOR_KERNEL_AVX2 };
+    const struct { const char* name; int width; int height; } sources[] = {
+        { "flat", 1998, 1080 },
+        { "scope", 2048, 858 },
+    };
+    const struct { int width; int height; } panels[] = { { 1920, 1080 }, { 1280, 800 }, { 1024, 600 } };
+    const struct { int filter; const char* name; } filters[] = {
+        { DMS_SCALE_BICUBIC, "bicubic" },
+        { DMS_SCALE_LANCZOS3, "lanczos3" },
+    };
+    int result = 0;
+    std::vector<uint32_t> reference, output;
+
+    printf("--> Scale + letterbox + X'Y'Z' to sRGB RGBA_8888 (12-bit), ms/frame\n");
+    for (const auto& source : sources)
+    {
+        std::vector<int32_t> planes[3];
+        DmsPicture picture;
+        MakeXyzPicture(source.width, source.height, planes, &picture);
+        DmsColorConfig plain = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, 12, DMS_COLOR_KERNEL_AUTO, nullptr };
+        printf(" |->%s %dx%d, convert at source size %.2f\n", source.name, source.width, source.height,
+            TimeColorConvert(&plain, &picture, &output));
+        for (const auto& panel : panels)
+        {
+            int fitW, fitH;
+            dms_scaler_fit(source.width, source.height, panel.width, panel.height, &fitW, &fitH);
+            for (const auto& filter : filters)
+            {
+                printf(" |    %4dx%-4d (%4dx%-4d) %-8s", panel.width, panel.height, fitW, fitH, filter.name);
+                bool exact = true, black = true;
+                for (int kernel : kernels)
+                {
+                    if (!dms_color_kernel_supported(kernel)) continue;
+                    DmsScalerConfig config = { source.width, source.height, panel.width, panel.height, filter.filter,
+                                               kernel };
+                    DmsScaler* scaler = dms_scaler_create(&config);
+                    DmsColorConfig colorConfig = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, 12, kernel, nullptr };
+                    DmsColorConverter* converter = dms_color_create(&colorConfig);
+                    if (scaler == nullptr || converter == nullptr)
+                    {
+                        dms_scaler_destroy(scaler);
+                        dms_color_destroy(converter);
+                        printf("  %s FAILED\n", dms_color_kernel_name(kernel));
+                        return -1;
+                    }
+                    std::vector<uint32_t>& out = kernel == DMS_COLOR_KERNEL_SCALAR ? reference : output;
+                    printf("  %s %.2f", dms_color_kernel_name(kernel),
+                        TimeScale(scaler, converter, &picture, panel.width, panel.height, &out));
+                    if (kernel != DMS_COLOR_KERNEL_SCALAR && out != reference) exact = false;
+                    if (!CheckLetterbox(out, panel.width, panel.height, fitW, fitH, dms_color_black_pixel(converter)))
+                        black = false;
+                    dms_scaler_destroy(scaler);
+                    dms_color_destroy(converter);
+                }
+                printf("  %s%s\n", exact ? "bit-exact" : "MISMATCH", black ? "" : ", BARS NOT BLACK");
+                if (!exact || !black) result = -1;
+            }
+        }
+    }
+
+    // 平坦画面：各滤波器缩放后仍为同一颜色
+    {
+        const int width = 2048, height = 858;
+        std::vector<int32_t> planes[3];
+        DmsPicture picture;
+        MakeXyzPicture(width, height, planes, &picture);
+        for (int c = 0; c < 3; c++) std::fill(planes[c].begin(), planes[c].end(), 1500 + c * 300);
+        DmsColorConfig colorConfig = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, 12, DMS_COLOR_KERNEL_AUTO, nullptr };
+        DmsColorConverter* converter = dms_color_create(&colorConfig);
+        std::vector<uint32_t> flat;
+        TimeColorConvert(&colorConfig, &picture, &flat);
+        bool ok = true;
+        for (const auto& filter : filters)
+        {
+            DmsScalerConfig config = { width, height, 1280, 800, filter.filter, DMS_COLOR_KERNEL_AUTO };
+            DmsScaler* scaler = dms_scaler_create(&config);
+            output.assign((size_t)1280 * 800, 0);
+            if (scaler == nullptr || dms_scaler_process(scaler, &picture, converter, 0, 800, output.data(), 1280 * 4) != 0)
+            {
+                ok = false;
+            }
+            else
+            {
+                int fitW, fitH;
+                dms_scaler_fit(width, height, 1280, 800, &fitW, &fitH);
+                int top = (800 - fitH) / 2;
+                for (int y = top; y < top + fitH && ok; y++)
+                {
+                    for (int x = 0; x < fitW && ok; x++) ok = output[(size_t)y * 1280 + x] == flat[0];
+                }
+            }
+            dms_scaler_destroy(scaler);
+        }
+        dms_color_destroy(converter);
+        printf(" |->flat field 2048x858 -> 1280x800: %s\n", ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+    }
+
+    // 分辨率层恰好适配：不缩放，画面区域与源尺寸直接转换一致
+    {
+        const int width = 1024, height = 540, panelW = 1024, panelH = 600;
+        std::vector<int32_t> planes[3];
+        DmsPicture picture;
+        MakeXyzPicture(width, height, planes, &picture);
+        DmsColorConfig colorConfig = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, 12, DMS_COLOR_KERNEL_AUTO, nullptr };
+        double convertMs = TimeColorConvert(&colorConfig, &picture, &reference);
+        DmsColorConverter* converter = dms_color_create(&colorConfig);
+        DmsScalerConfig config = { width, height, panelW, panelH, DMS_SCALE_BICUBIC, DMS_COLOR_KERNEL_AUTO };
+        DmsScaler* scaler = dms_scaler_create(&config);
+        bool ok = scaler != nullptr && dms_scaler_is_identity(scaler);
+        double scaleMs = ok ? TimeScale(scaler, converter, &picture, panelW, panelH, &output) : -1;
+        int top = (panelH - height) / 2;
+        ok = ok && scaleMs >= 0 && CheckLetterbox(output, panelW, panelH, width, height, dms_color_black_pixel(converter)) &&
+             memcmp(output.data() + (size_t)top * panelW, reference.data(), reference.size() * sizeof(uint32_t)) == 0;
+        printf(" |->level fits 1024x540 in 1024x600: identity, %.2f ms (convert only %.2f ms)  %s\n", scaleMs,
+            convertMs, ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+        dms_scaler_destroy(scaler);
+        dms_color_destroy(converter);
+    }
+    return result;
+}
+
+/*
+ * 进程占用的CPU时间
+ *
+ * @return 纳秒
+ */
+static int64_t ProcessCpuNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * 删除桩影片的帧索引：各用例的影片帧数与数据单元布局不同，而CPL标识相同，须重新建立索引
+ */
+static void RemoveStubIndex()
+{
+    unlink("dmsbench_render/urn_uuid_00000000-0000-0000-0000-000000000001.dmsidx");
+}
+
+/*
+ * 用桩实现打开一部以指定码流为内容的单分本影片
+ *
+ * @param[out] ctx       播放器上下文
+ * @param[in]  streams   码流，按帧循环使用
+ * @param[in]  frames    帧数
+ * @param[in]  frameRate 帧率
+ * @param[in]  stereo    是否为立体素材（每帧左、右眼各一个数据单元，依次取码流）
+ * @return               返回0表示成功
+ */
+static int OpenStubMovie(DmsContext* ctx, const std::vector<std::vector<uint8_t>>& streams, int frames,
+    float frameRate, bool stereo)
+{
+    std::vector<const uint8_t*> payloads;
+    std::vector<uint32_t> lengths;
+    for (const auto& stream : streams)
+    {
+        payloads.push_back(stream.data());
+        lengths.push_back((uint32_t)stream.size());
+    }
+    DmsStubConfig stub = { 1, frames, 0, 0, 0, 0, 0, stereo };
+    DmsStubConfigure(&stub);
+    DmsStubSetPayloads(payloads.data(), lengths.data(), (int)payloads.size());
+
+    memset(ctx, 0, sizeof(*ctx));
+    if (dms_player_init(ctx) != 0) return -1;
+    ctx->frameRate = frameRate;
+    dms_player_set_index_dir(ctx, "dmsbench_render");
+    if (_dms_open_dcp("stub", "", false) != DMS_RESULT_SUCCESS) return -1;
+    ctx->hasActiveMxf = true;
+    return dms_player_open_timeline(ctx) == 0 ? 0 : -1;
+}
+
+/*
+ * 关闭桩影片并释放播放器
+ *
+ * @param[in] ctx 播放器上下文
+ */
+static void CloseStubMovie(DmsContext* ctx)
+{
+    dms_player_close_index(ctx);
+    _dms_close_dcp();
+    ctx->hasActiveMxf = false;
+    dms_player_uninit(ctx);
+    DmsStubSetPayloads(nullptr, nullptr, 0);
+}
+
+/*
+ * 原生渲染基准：渲染器解码、转换并按24fps时刻显示到无头输出端，统计掉帧、端到端延迟、
+ * 起播与跳转耗时、CPU负载；对照ExoPlayer路径按同样节奏取帧并做三次复制（JNI字节数组、
+ * 数据源读缓冲、采样队列）。ExoPlayer路径没有J2K解码器，不含解码与显示，两者的CPU差值
+ * 主要为解码本身
+ *
+ * @param[in] dir         码流目录，为空时合成DCI 2K码流
+ * @param[in] outputWidth 输出宽度，决定解码丢弃的分辨率层，0为原图
+ * @return                返回0表示成功
+ */
+static int BenchRender(const char* dir, int outputWidth)
+{
+    if (!dms_j2k_decoder_available())
+    {
+        printf("--> Native render: built without OpenJPEG (-DDMS_HAVE_OPENJPEG -lopenjp2), skipped\n");
+        return 0;
+    }
+    std::vector<std::vector<uint8_t>> streams;
+    if (PrepareCodestreams(dir, &streams) == 0)
+    {
+        printf("--> Native render: no codestream\n");
+        return -1;
+    }
+    const int frames = 120;
+    const int64_t intervalNs = 1000000000LL / 24;
+    mkdir("dmsbench_render", 0755);
+    printf("--> Native render (%d frames at 24fps, output width %d, %d cores)\n", frames, outputWidth,
+        (int)std::thread::hardware_concurrency());
+
+    // ExoPlayer路径：取帧 -> JNI复制到4MB字节数组 -> 数据源复制到读缓冲 -> 提取器复制到采样队列
+    DmsContext ctx;
+    if (OpenStubMovie(&ctx, streams, frames, 24.0f, false) != 0) return -1;
+    std::vector<uint8_t> jniBuffer(4 * 1024 * 1024), readBuffer(4 * 1024 * 1024), sampleQueue(4 * 1024 * 1024);
+    int64_t copyLatencyNs = 0, copiedBytes = 0;
+    int exoFrames = 0;
+    int64_t cpu0 = ProcessCpuNs(), t0 = NowNs();
+    for (;; exoFrames++)
+    {
+        int64_t deadline = t0 + exoFrames * intervalNs;
+        int64_t now = NowNs();
+        if (now < deadline) usleep((useconds_t)((deadline - now) / 1000));
+        int64_t fetchNs = NowNs();
+        DmsFrame frame;
+        if (dms_player_next_frame(&ctx, &frame) != DMS_RESULT_SUCCESS) break;
+        size_t length = frame.unit->Length < jniBuffer.size() ? frame.unit->Length : jniBuffer.size();
+        memcpy(jniBuffer.data(), frame.unit->Data, length);
+        memcpy(readBuffer.data(), jniBuffer.data(), length);
+        memcpy(sampleQueue.data(), readBuffer.data(), length);
+        dms_player_release_frame(&frame);
+        copyLatencyNs += NowNs() - fetchNs;
+        copiedBytes += 3 * (int64_t)length;
+    }
+    double exoSeconds = (NowNs() - t0) / 1e9;
+    double exoLoad = (ProcessCpuNs() - cpu0) / 1e9 / exoSeconds;
+    CloseStubMovie(&ctx);
+    printf(" |->ExoPlayer route:  %d frames queued (not decoded: no J2K decoder), %.2f ms fetch+copy/frame, "
+        "%.1f MB copied/frame, CPU %.0f%%\n", exoFrames, exoFrames ? copyLatencyNs / 1e6 / exoFrames : 0.0,
+        exoFrames ? copiedBytes / 1048576.0 / exoFrames : 0.0, exoLoad * 100);
+
+    // 原生路径：渲染器解码、转换并显示；播放2秒后跳回第24帧
+    if (OpenStubMovie(&ctx, streams, frames, 24.0f, false) != 0) return -1;
+    dms_player_set_output_size(&ctx, outputWidth, outputWidth * 1080 / 2048);
+    DmsVideoSink* sink = dms_video_sink_create_memory(nullptr, 2048, 1080, DMS_COLOR_RGBA_8888);
+    // 与视图尺寸一致：帧按原宽高比缩放到输出尺寸并加黑边
+    DmsRendererConfig config = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, true, 0, outputWidth, outputWidth * 1080 / 2048,
+                                 DMS_SCALE_BICUBIC };
+    DmsRenderer* renderer = dms_renderer_create(&ctx, sink, &config);
+    if (!renderer)
+    {
+        dms_video_sink_destroy(sink);
+        CloseStubMovie(&ctx);
+        return -1;
+    }
+    // 模拟60Hz屏幕的刷新回调，显示线程按2:3节奏提交
+    dms_renderer_set_display_refresh(renderer, 60.0f);
+    std::atomic<bool> vsyncStop(false);
+    std::thread vsyncThread([renderer, &vsyncStop]()
+    {
+        const int64_t base = NowNs();
+        for (int64_t n = 1; !vsyncStop.load(); n++)
+        {
+            int64_t target = base + n * 1000000000LL / 60;
+            int64_t now = NowNs();
+            if (now < target) usleep((useconds_t)((target - now) / 1000));
+            dms_renderer_on_vsync(renderer, target / 1000);
+        }
+    });
+    DmsRendererStats stats;
+    int result = 0;
+    do
+    {
+        usleep(10000);
+        dms_renderer_get_stats(renderer, &stats);
+    } while (stats.presented == 0);
+    dms_renderer_play(renderer);
+    usleep(2000000);
+    dms_renderer_get_stats(renderer, &stats);
+    int64_t startLatencyUs = stats.startLatencyUs;
+    dms_renderer_seek(renderer, 1000000);
+    t0 = NowNs();
+    do
+    {
+        usleep(10000);
+        dms_renderer_get_stats(renderer, &stats);
+    } while (!stats.ended && NowNs() - t0 < 30000000000LL);
+    if (!stats.ended) result = -1;
+    vsyncStop = true;
+    vsyncThread.join();
+    DmsMemorySinkStats sinkStats;
+    dms_video_sink_get_memory_stats(sink, &sinkStats);
+    DmsJ2kDecoderStats decoderStats;
+    dms_j2k_decoder_get_stats(ctx.decoder, &decoderStats);
+    int reduce = 0;
+    for (int i = 0; i <= DMS_J2K_MAX_REDUCE; i++)
+    {
+        if (decoderStats.levelFrames[i] > 0) reduce = i;
+    }
+    printf(" |->native route:     %lld presented, %lld dropped, decoded at 1/%d, latency %.1f ms fetch-to-present, "
+        "late %.1f ms, convert %.2f ms, present %.2f ms, CPU %.0f%%\n",
+        (long long)stats.presented, (long long)stats.dropped, 1 << reduce, stats.latencyUs / 1000,
+        stats.lateUs / 1000, stats.convertCostUs / 1000, stats.presentCostUs / 1000, stats.cpuLoad * 100);
+    printf(" |->native control:   start %.1f ms, seek %.1f ms, last frame at %.2f s, sink %lld frames\n",
+        startLatencyUs / 1000.0, stats.seekLatencyUs / 1000.0, stats.positionUs / 1e6, (long long)sinkStats.frames);
+    printf(" |->native cadence:   60 Hz 2:3, %lld slips, %lld relocks, %lld missed vsyncs, jitter %.2f ms\n",
+        (long long)stats.cadenceSlips, (long long)stats.cadenceRelocks, (long long)stats.missedVsyncs,
+        stats.jitterUs / 1000);
+    printf(" |->native scaling:   %lld frames scaled, %lld letterboxed only\n", (long long)stats.scaledFrames,
+        (long long)stats.unscaledFrames);
+    // 渲染期间解码流水线由生产线程独占，并行解码统计取渲染器保存的副本
+    DmsDecodePipelineStats decodeStats;
+    bool decodeOk = dms_renderer_get_decode_stats(renderer, &decodeStats) == 0 && decodeStats.emitted > 0;
+    printf(" |->native decode:    %d workers, %lld frames emitted, %lld cancelled  %s\n",
+        decodeOk ? decodeStats.workers : 0, decodeOk ? (long long)decodeStats.emitted : 0LL,
+        decodeOk ? (long long)decodeStats.cancelled : 0LL, decodeOk ? "ok" : "FAILED");
+    if (stats.presented != sinkStats.frames || stats.seekLatencyUs < 0 || !decodeOk) result = -1;
+    dms_renderer_destroy(renderer);
+    CloseStubMovie(&ctx);
+    return result;
+}
+
+/*
+ * 自适应解码质量的一次渲染：按帧率渲染整部影片到无头输出端，可在前半程用忙循环线程占满各核
+ *
+ * @param[in]  streams     码流
+ * @param[in]  frameRate   帧率
+ * @param[in]  outputWidth 输出宽度
+ * @param[in]  frames      影片帧数
+ * @param[in]  adaptive    是否自适应解码质量
+ * @param[in]  loadSeconds 前半程CPU干扰的秒数，0表示无干扰
+ * @param[out] out         渲染统计
+ * @return                 返回0表示播完，1表示连续10秒没有显示新帧（放弃），-1表示失败
+ */
+static int RunQualityPass(const std::vector<std::vector<uint8_t>>& streams, float frameRate, int outputWidth,
+    int frames, bool adaptive, double loadSeconds, DmsRendererStats* out)
+{
+    DmsContext ctx;
+    if (OpenStubMovie(&ctx, streams, frames, frameRate, false) != 0) return -1;
+    dms_player_set_output_size(&ctx, outputWidth, outputWidth * 1080 / 2048);
+    dms_player_set_adaptive_quality(&ctx, adaptive);
+    DmsVideoSink* sink = dms_video_sink_create_memory(nullptr, 2048, 1080, DMS_COLOR_RGBA_8888);
+    DmsRenderer* renderer = dms_renderer_create(&ctx, sink, nullptr);
+    if (!renderer)
+    {
+        dms_video_sink_destroy(sink);
+        CloseStubMovie(&ctx);
+        return -1;
+    }
+
+    std::atomic<bool> loading(loadSeconds > 0);
+    std::vector<std::thread> hogs;
+    if (loading)
+    {
+        int cores = (int)std::thread::hardware_concurrency();
+        for (int i = 0; i < (cores > 0 ? cores : 1); i++)
+        {
+            hogs.emplace_back([&loading]() { while (loading) { } });
+        }
+    }
+    dms_renderer_play(renderer);
+    // 全质量在慢设备上远慢于实时，只要仍在显示新帧就等它播完
+    int64_t t0 = NowNs();
+    int64_t progressNs = t0;
+    int64_t presented = 0;
+    do
+    {
+        usleep(10000);
+        int64_t now = NowNs();
+        if (loading && now - t0 > (int64_t)(loadSeconds * 1e9)) loading = false;
+        dms_renderer_get_stats(renderer, out);
+        if (out->presented != presented)
+        {
+            presented = out->presented;
+            progressNs = now;
+        }
+    } while (!out->ended && NowNs() - progressNs < 10000000000LL);
+    loading = false;
+    for (auto& hog : hogs) hog.join();
+    dms_renderer_destroy(renderer);
+    CloseStubMovie(&ctx);
+    return out->ended ? 0 : 1;
+}
+
+/*
+ * 自适应解码质量基准：固定全质量时赶不上帧率的设备会持续落后（画面放慢、卡顿），
+ * 自适应时降低质量保持帧率；前半程有CPU干扰时应先降档、干扰消失后逐步恢复。
+ * 全质量（2秒内容，作对照）须播完；自适应（8秒内容）须显示全部帧，且平均延后不超过一帧时长
+ *
+ * @param[in] dir         码流目录，为空时合成DCI 2K码流
+ * @param[in] frameRate   帧率
+ * @param[in] outputWidth 输出宽度，0为原图
+ * @return                返回0表示成功
+ */
+static int BenchQuality(const char* dir, float frameRate, int outputWidth)
+{
+    if (!dms_j2k_decoder_available())
+    {
+        printf("--> Adaptive decode quality: built without OpenJPEG (-DDMS_HAVE_OPENJPEG -lopenjp2), skipped\n");
+        return 0;
+    }
+    std::vector<std::vector<uint8_t>> streams;
+    if (PrepareCodestreams(dir, &streams) == 0)
+    {
+        printf("--> Adaptive decode quality: no codestream\n");
+        return -1;
+    }
+    mkdir("dmsbench_render", 0755);
+    printf("--> Adaptive decode quality (%.0f fps, output width %d, %d cores)\n", frameRate, outputWidth,
+        (int)std::thread::hardware_concurrency());
+    const struct { bool adaptive; double contentSeconds; double loadSeconds; const char* name; } passes[] = {
+        { false, 2, 0, "full quality" },
+        { true, 8, 0, "adaptive" },
+        { true, 8, 4, "adaptive, 4 s load" },
+    };
+    const double frameUs = 1e6 / frameRate;
+    int result = 0;
+    for (const auto& pass : passes)
+    {
+        const int frames = (int)(frameRate * pass.contentSeconds);
+        RemoveStubIndex();
+        DmsRendererStats stats;
+        int64_t t0 = NowNs();
+        int passResult = RunQualityPass(streams, frameRate, outputWidth, frames, pass.adaptive, pass.loadSeconds,
+            &stats);
+        if (passResult < 0)
+        {
+            printf(" |->%-20s failed\n", pass.name);
+            result = -1;
+            continue;
+        }
+        double seconds = (NowNs() - t0) / 1e9;
+        // 全质量只作对照，不限延后，但须播完；自适应须显示全部帧且不持续落后
+        bool ok = passResult == 0 && stats.presented > 0;
+        if (pass.adaptive) ok = ok && stats.presented == frames && stats.lateUs <= frameUs;
+        printf(" |->%-20s %s%.1f s for %.1f s of content, %lld/%d presented, %lld dropped, late %.1f ms "
+            "(max %.1f ms), %lld degraded, final level %d  %s\n", pass.name, passResult ? "gave up after " : "",
+            seconds, pass.contentSeconds, (long long)stats.presented, frames, (long long)stats.dropped,
+            stats.lateUs / 1000, stats.maxLateUs / 1000.0, (long long)stats.degradedFrames, stats.qualityLevel,
+            ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+    }
+    return result;
+}
+
+/*
+ * 按DCI 2K档次手工构造主头：SOC、SIZ、COD、QCD、TLM，之后为一个空tile-part
+ *
+ * @param[in]  levels   小波分解级数
+ * @param[in]  tlmSeed  TLM中记录的tile-part长度（DCI码流逐帧不同）
+ * @param[out] out      码流
+ */
+static void BuildCinemaHeader(int levels, uint32_t tlmSeed, std::vector<uint8_t>* out)
+{
+    std::vector<uint8_t>& b = *out;
+    b.clear();
+    auto put16 = [&b](uint32_t v) { b.push_back((uint8_t)(v >> 8)); b.push_back((uint8_t)v); };
+    auto put32 = [&put16](uint32_t v) { put16(v >> 16); put16(v & 0xFFFF); };
+    put16(0xFF4F);
+    // SIZ：Rsiz 3（DCI 2K），2048x1080，单tile，3个无符号12位分量
+    put16(0xFF51); put16(38 + 3 * 3); put16(3);
+    put32(2048); put32(1080); put32(0); put32(0); put32(2048); put32(1080); put32(0); put32(0);
+    put16(3);
+    for (int c = 0; c < 3; c++) { b.push_back(11); b.push_back(1); b.push_back(1); }
+    // COD：显式分区，CPRL，1层，MCT，32x32码块，9/7小波
+    put16(0xFF52); put16(12 + levels + 1);
+    b.push_back(1); b.push_back(4); put16(1); b.push_back(1);
+    b.push_back((uint8_t)levels); b.push_back(3); b.push_back(3); b.push_back(0); b.push_back(0);
+    for (int r = 0; r <= levels; r++) b.push_back(r == 0 ? 0x77 : 0x88);
+    // QCD：标量显式量化，1个保护位
+    int subbands = 3 * levels + 1;
+    put16(0xFF5C); put16(3 + 2 * subbands);
+    b.push_back(0x22);
+    for (int i = 0; i < subbands; i++) put16(0x4000 + (uint32_t)i * 64);
+    // TLM：3个tile-part的长度
+    put16(0xFF55); put16(4 + 3 * 4);
+    b.push_back(0); b.push_back(0x40);
+    for (int i = 0; i < 3; i++) put32(tlmSeed + (uint32_t)i);
+    // SOT
+    put16(0xFF90); put16(10); put16(0); put32(14); b.push_back(0); b.push_back(1);
+    put16(0xFF93);
+    put16(0xFFD9);
+}
+
+#ifdef DMS_HAVE_OPENJPEG
+// 供OpenJPEG读取主头的内存流
+struct HeaderStream
+{
+    const uint8_t* data;
+    size_t length;
+    size_t offset;
+};
+
+static OPJ_SIZE_T ReadHeaderStream(void* buffer, OPJ_SIZE_T bytes, void* user)
+{
+    HeaderStream* stream = (HeaderStream*)user;
+    if (stream->offset >= stream->length) return (OPJ_SIZE_T)-1;
+    size_t remain = stream->length - stream->offset;
+    if (bytes > remain) bytes = remain;
+    memcpy(buffer, stream->data + stream->offset, bytes);
+    stream->offset += bytes;
+    return bytes;
+}
+#endif
+
+/*
+ * J2K主头解析基准：解析/指纹耗时（对照OpenJPEG读取主头）、DCI档次检查，
+ * 以及经播放器逐帧检测主头参数变化（TLM变化不计）
+ *
+ * @param[in] dir 码流目录，为空时合成DCI 2K码流
+ * @return        返回0表示成功
+ */
+static int BenchHeader(const char* dir)
+{
+    static const char* const kViolations[] = { "rsiz", "size", "components", "tiling", "progression", "layers",
+        "levels", "codeblock", "transform", "precincts", "quantization" };
+    std::vector<std::vector<uint8_t>> streams(1);
+    BuildCinemaHeader(5, 1000, &streams[0]);
+    PrepareCodestreams(dir, &streams);
+    printf("--> J2K header (%zu codestreams, first is a hand-built DCI 2K header)\n", streams.size());
+
+    int result = 0;
+    for (size_t i = 0; i < streams.size() && i < 4; i++)
+    {
+        DmsJ2kStreamInfo info;
+        if (dms_j2k_parse_header(streams[i].data(), (uint32_t)streams[i].size(), &info) != 0)
+        {
+            printf(" |->#%zu: not parsed\n", i);
+            result = -1;
+            continue;
+        }
+        uint32_t violations = dms_j2k_check_dci(&info);
+        printf(" |->#%zu: %ux%u %dx%d-bit, %ux%u tiles, %d levels, %d layers, cb %dx%d, %s, %s, header %u bytes, ",
+            i, info.width, info.height, info.components, info.precision[0], info.tilesX, info.tilesY, info.levels,
+            info.layers, info.codeBlockWidth, info.codeBlockHeight, info.reversible ? "5/3" : "9/7",
+            dms_j2k_profile_name(info.rsiz), info.headerBytes);
+        if (violations == 0)
+        {
+            printf("DCI compliant\n");
+            continue;
+        }
+        printf("not DCI:");
+        for (int bit = 0; bit < (int)(sizeof(kViolations) / sizeof(kViolations[0])); bit++)
+        {
+            if (violations & (1u << bit)) printf(" %s", kViolations[bit]);
+        }
+        printf("\n");
+    }
+
+    // 解析与指纹耗时
+    const int iterations = 200000;
+    const std::vector<uint8_t>& data = streams.back();
+    DmsJ2kStreamInfo info;
+    uint32_t sink = 0;
+    int64_t t0 = NowNs();
+    for (int i = 0; i < iterations; i++)
+    {
+        dms_j2k_parse_header(data.data(), (uint32_t)data.size(), &info);
+        sink += info.width;
+    }
+    double parseNs = (double)(NowNs() - t0) / iterations;
+    t0 = NowNs();
+    for (int i = 0; i < iterations; i++) sink += dms_j2k_header_fingerprint(data.data(), (uint32_t)data.size());
+    double fingerprintNs = (double)(NowNs() - t0) / iterations;
+    printf(" |->parse:            %.3f us/call\n", parseNs / 1000);
+    printf(" |->fingerprint:      %.3f us/call%s\n", fingerprintNs / 1000, sink == 1 ? " " : "");
+#ifdef DMS_HAVE_OPENJPEG
+    // 对照：OpenJPEG读取主头（opj_read_header，需建立解码器与流）
+    {
+        const int opjIterations = 2000;
+        t0 = NowNs();
+        for (int i = 0; i < opjIterations; i++)
+        {
+            HeaderStream source = { data.data(), data.size(), 0 };
+            opj_stream_t* stream = opj_stream_create(64 * 1024, OPJ_TRUE);
+            opj_stream_set_user_data(stream, &source, nullptr);
+            opj_stream_set_user_data_length(stream, source.length);
+            opj_stream_set_read_function(stream, ReadHeaderStream);
+            opj_codec_t* codec = opj_create_decompress(OPJ_CODEC_J2K);
+            opj_dparameters_t params;
+            opj_set_default_decoder_parameters(&params);
+            opj_image_t* image = nullptr;
+            if (opj_setup_decoder(codec, &params) && opj_read_header(stream, codec, &image)) sink += image->x1;
+            opj_image_destroy(image);
+            opj_destroy_codec(codec);
+            opj_stream_destroy(stream);
+        }
+        printf(" |->OpenJPEG header:  %.3f us/call\n", (double)(NowNs() - t0) / opjIterations / 1000);
+    }
+#endif
+
+    // 指纹只覆盖参数段：TLM变化不影响指纹，分解级数变化则改变指纹
+    std::vector<uint8_t> otherTlm, otherLevels;
+    BuildCinemaHeader(5, 2000, &otherTlm);
+    BuildCinemaHeader(4, 1000, &otherLevels);
+    uint32_t base = dms_j2k_header_fingerprint(streams[0].data(), (uint32_t)streams[0].size());
+    bool tlmStable = base == dms_j2k_header_fingerprint(otherTlm.data(), (uint32_t)otherTlm.size());
+    bool levelsDetected = base != dms_j2k_header_fingerprint(otherLevels.data(), (uint32_t)otherLevels.size());
+    printf(" |->fingerprint:      TLM change %s, levels change %s\n", tlmStable ? "ignored" : "DETECTED",
+        levelsDetected ? "detected" : "MISSED");
+    if (!tlmStable || !levelsDetected) result = -1;
+
+    // 经播放器取帧：每4帧交替两种主头，TLM逐帧变化
+    std::vector<std::vector<uint8_t>> movie;
+    for (int i = 0; i < 8; i++)
+    {
+        std::vector<uint8_t> frame;
+        BuildCinemaHeader(i < 4 ? 5 : 4, 1000 + (uint32_t)i, &frame);
+        movie.push_back(frame);
+    }
+    mkdir("dmsbench_render", 0755);
+    DmsContext ctx;
+    if (OpenStubMovie(&ctx, movie, 16, 24.0f, false) != 0) return -1;
+    DmsJ2kStreamInfo probed;
+    int probe = dms_player_probe_stream(&ctx, &probed);
+    int frames = 0;
+    int64_t firstFrame = -1;
+    DmsFrame frame;
+    while (dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS)
+    {
+        if (frames == 0) firstFrame = frame.frame;
+        dms_player_release_frame(&frame);
+        frames++;
+    }
+    int64_t changes = ctx.headerChanges;
+    CloseStubMovie(&ctx);
+    bool ok = probe == 0 && probed.levels == 5 && firstFrame == 0 && frames == 16 && changes == 3;
+    printf(" |->player:           probe %s (%d levels), first frame %lld, %d frames, %lld header changes "
+        "(expected 3)%s\n", probe == 0 ? "ok" : "failed", probe == 0 ? probed.levels : 0, (long long)firstFrame,
+        frames, (long long)changes, ok ? "" : ", FAILED");
+    if (!ok) result = -1;
+    return result;
+}
+
+// 解码帧缓存用例一次渲染的结果
+struct CachePassResult
+{
+    double stepMs;           // 暂停后逐帧步进的平均时延
+    double stepMaxMs;        // 逐帧步进的最大时延
+    double resumeMs;         // 继续播放到首帧显示的时延
+    double resumeLateMs;     // 继续播放后1秒内的平均显示延后
+    int64_t resumeDropped;   // 继续播放后1秒内丢弃的帧数
+    DmsRendererStats stats;  // 结束时的渲染统计
+    int64_t trimmedBytes;    // 内存警告（RUNNING_CRITICAL）后的缓存占用
+};
+
+/*
+ * 等待渲染器显示的帧数超过指定值
+ *
+ * @param[in]  renderer  渲染器
+ * @param[in]  presented 当前已显示帧数
+ * @param[out] stats     渲染统计
+ * @return               返回true表示5秒内已显示
+ */
+static bool WaitPresented(DmsRenderer* renderer, int64_t presented, DmsRendererStats* stats)
+{
+    int64_t t0 = NowNs();
+    do
+    {
+        usleep(1000);
+        dms_renderer_get_stats(renderer, stats);
+    } while (stats->presented <= presented && NowNs() - t0 < 5000000000LL);
+    return stats->presented > presented;
+}
+
+/*
+ * 解码帧缓存的一次渲染：播放1秒后暂停3秒，逐帧后退、前进各6帧，继续播放1秒
+ *
+ * @param[in]  streams     码流
+ * @param[in]  outputWidth 输出宽度
+ * @param[in]  cacheBytes  缓存容量，小于0不缓存
+ * @param[out] out         结果
+ * @return                 返回0表示成功
+ */
+static int RunCachePass(const std::vector<std::vector<uint8_t>>& streams, int outputWidth, int64_t cacheBytes,
+    CachePassResult* out)
+{
+    const float frameRate = 24.0f;
+    const int64_t frameUs = (int64_t)(1000000 / frameRate);
+    memset(out, 0, sizeof(*out));
+    DmsContext ctx;
+    if (OpenStubMovie(&ctx, streams, 240, frameRate, false) != 0) return -1;
+    dms_player_set_output_size(&ctx, outputWidth, outputWidth * 1080 / 2048);
+    dms_player_set_adaptive_quality(&ctx, false);
+    DmsVideoSink* sink = dms_video_sink_create_memory(nullptr, 2048, 1080, DMS_COLOR_RGBA_8888);
+    DmsRendererConfig config = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, true, cacheBytes };
+    DmsRenderer* renderer = dms_renderer_create(&ctx, sink, &config);
+    if (!renderer)
+    {
+        dms_video_sink_destroy(sink);
+        CloseStubMovie(&ctx);
+        return -1;
+    }
+
+    int result = 0;
+    DmsRendererStats stats;
+    if (!WaitPresented(renderer, 0, &stats)) result = -1;
+    dms_renderer_play(renderer);
+    int64_t t0 = NowNs();
+    do
+    {
+        usleep(5000);
+        dms_renderer_get_stats(renderer, &stats);
+    } while (stats.positionUs < 1000000 && NowNs() - t0 < 20000000000LL);
+    dms_renderer_pause(renderer);
+    usleep(3000000);
+
+    // 逐帧步进：目标取帧中间时刻，避免时间戳取整落到相邻帧
+    double totalMs = 0;
+    for (int i = 0; i < 12 && result == 0; i++)
+    {
+        dms_renderer_get_stats(renderer, &stats);
+        int64_t target = stats.positionUs + (i < 6 ? -frameUs : frameUs) + frameUs / 2;
+        int64_t start = NowNs();
+        dms_renderer_seek(renderer, target);
+        if (!WaitPresented(renderer, stats.presented, &stats))
+        {
+            result = -1;
+            break;
+        }
+        double ms = (NowNs() - start) / 1e6;
+        totalMs += ms;
+        if (ms > out->stepMaxMs) out->stepMaxMs = ms;
+    }
+    out->stepMs = totalMs / 12;
+
+    // 继续播放
+    dms_renderer_get_stats(renderer, &stats);
+    int64_t presented = stats.presented;
+    int64_t dropped = stats.dropped;
+    int64_t start = NowNs();
+    dms_renderer_play(renderer);
+    if (!WaitPresented(renderer, presented, &stats)) result = -1;
+    out->resumeMs = (NowNs() - start) / 1e6;
+    double lateMs = 0;
+    int samples = 0;
+    while (NowNs() - start < 1000000000LL)
+    {
+        usleep(frameUs);
+        dms_renderer_get_stats(renderer, &stats);
+        lateMs += stats.lateUs / 1000;
+        samples++;
+    }
+    out->resumeLateMs = samples ? lateMs / samples : 0;
+    out->resumeDropped = stats.dropped - dropped;
+    dms_renderer_pause(renderer);
+
+    dms_renderer_trim_memory(renderer, DMS_TRIM_RUNNING_CRITICAL);
+    usleep(100000);
+    dms_renderer_get_stats(renderer, &out->stats);
+    out->trimmedBytes = out->stats.cacheBytes;
+    dms_renderer_destroy(renderer);
+    CloseStubMovie(&ctx);
+    return result;
+}
+
+/*
+ * 解码帧缓存基准：暂停后逐帧步进与继续播放的时延，对照不缓存（每次步进重新定位并解码）
+ *
+ * @param[in] dir         码流目录，为空时合成DCI 2K码流
+ * @param[in] outputWidth 输出宽度
+ * @return                返回0表示成功
+ */
+static int BenchCache(const char* dir, int outputWidth)
+{
+    if (!dms_j2k_decoder_available())
+    {
+        printf("--> Decoded-frame cache: built without OpenJPEG (-DDMS_HAVE_OPENJPEG -lopenjp2), skipped\n");
+        return 0;
+    }
+    std::vector<std::vector<uint8_t>> streams;
+    if (PrepareCodestreams(dir, &streams) == 0)
+    {
+        printf("--> Decoded-frame cache: no codestream\n");
+        return -1;
+    }
+    mkdir("dmsbench_render", 0755);
+    printf("--> Decoded-frame cache (24 fps, output width %d, %d cores)\n", outputWidth,
+        (int)std::thread::hardware_concurrency());
+    const struct { int64_t cacheBytes; const char* name; } passes[] = {
+        { -1, "no cache" },
+        { 0, "cache 96 MB" },
+    };
+    int result = 0;
+    for (const auto& pass : passes)
+    {
+        CachePassResult r;
+        if (RunCachePass(streams, outputWidth, pass.cacheBytes, &r) != 0)
+        {
+            printf(" |->%-12s failed\n", pass.name);
+            result = -1;
+            continue;
+        }
+        printf(" |->%-12s step %.1f ms avg / %.1f ms max, resume %.1f ms, late %.1f ms and %lld dropped "
+            "in the first second\n", pass.name, r.stepMs, r.stepMaxMs, r.resumeMs, r.resumeLateMs,
+            (long long)r.resumeDropped);
+        if (pass.cacheBytes >= 0)
+        {
+            printf(" |   hit rate %.0f%% (%lld/%lld), %lld evictions, %.1f MB held, %.1f MB after RUNNING_CRITICAL\n",
+                r.stats.cacheLookups ? 100.0 * r.stats.cacheHits / r.stats.cacheLookups : 0.0,
+                (long long)r.stats.cacheHits, (long long)r.stats.cacheLookups, (long long)r.stats.cacheEvictions,
+                r.stats.cacheBytes / 1048576.0, r.trimmedBytes / 1048576.0);
+            if (r.trimmedBytes > DMS_FRAME_CACHE_DEFAULT_BYTES / 4) result = -1;
+        }
+    }
+    return result;
+}
+
+/*
+ * 码流缓存单轮结果
+ */
+struct RingPassResult
+{
+    double seekMs;            // 跳转到取得首帧的平均耗时
+    double seekMaxMs;         // 跳转到取得首帧的最大耗时
+    double replayMs;          // 重放时单帧取帧的平均耗时
+    int frames;               // 取得的帧数
+    int mismatches;           // 帧号、Pos或内容与顺序读取不一致的帧数
+    int64_t ringSeeks;        // 未定位libdms的跳转次数
+    DmsCodestreamRingStats stats;
+};
+
+/*
+ * 取下一帧并核对：帧号应为expected，Pos与首次读取该帧时一致，内容为桩按帧号填充的字节
+ *
+ * @param[in]     ctx      播放器上下文
+ * @param[in]     expected 期望的帧号
+ * @param[in,out] posOf    各帧首次读取时的Pos，首次读取的帧追加在末尾
+ * @param[out]    out      结果，不一致时累加mismatches
+ * @return                 返回0表示取帧成功
+ */
+static int TakeRingFrame(DmsContext* ctx, int64_t expected, std::vector<int64_t>* posOf, RingPassResult* out)
+{
+    DmsFrame frame;
+    if (dms_player_next_frame(ctx, &frame) != DMS_RESULT_SUCCESS) return -1;
+    const DmsDataUnit* unit = frame.unit;
+    if (expected == (int64_t)posOf->size()) posOf->push_back(unit->Pos);
+    bool ok = frame.frame == expected && expected < (int64_t)posOf->size() && unit->Pos == (*posOf)[expected] &&
+        unit->Data[0] == (uint8_t)(expected & 0xff) && unit->Data[unit->Length - 1] == (uint8_t)(expected & 0xff);
+    if (!ok) out->mismatches++;
+    out->frames++;
+    dms_player_release_frame(&frame);
+    return 0;
+}
+
+/*
+ * 码流缓存一轮：顺序读取playFrames帧，之后依次后退1、3、5、8秒并重放到当前最远帧之后12帧，
+ * 统计每次跳转到取得首帧的耗时与重放的单帧取帧耗时
+ *
+ * @param[in]  indexDir     帧索引目录
+ * @param[in]  seconds      码流缓存保留的秒数，与bytes均为0时不缓存
+ * @param[in]  bytes        码流缓存的字节数上限
+ * @param[in]  frameRate    帧率
+ * @param[in]  playFrames   开始后退前顺序读取的帧数
+ * @param[out] out          结果
+ * @return                  返回0表示成功
+ */
+static int RunRingPass(const char* indexDir, float seconds, int64_t bytes, float frameRate, int playFrames,
+    RingPassResult* out)
+{
+    memset(out, 0, sizeof(*out));
+    DmsContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    if (dms_player_init(&ctx) != 0) return -1;
+    ctx.frameRate = frameRate;
+    ctx.readaheadFrames = 24;
+    dms_player_set_index_dir(&ctx, indexDir);
+    dms_player_set_codestream_cache(&ctx, seconds, bytes);
+    if (_dms_open_dcp("stub", "", false) != DMS_RESULT_SUCCESS) return -1;
+    ctx.hasActiveMxf = true;
+    dms_player_open_timeline(&ctx);
+
+    int result = 0;
+    std::vector<int64_t> posOf;
+    for (int i = 0; i < playFrames && result == 0; i++)
+    {
+        result = TakeRingFrame(&ctx, i, &posOf, out);
+    }
+
+    const int backSeconds[] = { 1, 3, 5, 8 };
+    int64_t seekNs = 0, replayNs = 0;
+    int replayFrames = 0;
+    for (int back : backSeconds)
+    {
+        if (result != 0) break;
+        int64_t end = (int64_t)posOf.size();
+        int64_t target = end - (int64_t)(back * frameRate);
+        int64_t t0 = NowNs();
+        if (dms_player_seek_frame(&ctx, target) != 0 || TakeRingFrame(&ctx, target, &posOf, out) != 0)
+        {
+            result = -1;
+            break;
+        }
+        int64_t ns = NowNs() - t0;
+        seekNs += ns;
+        if (ns / 1e6 > out->seekMaxMs) out->seekMaxMs = ns / 1e6;
+
+        // 重放到原位置，再越过缓存末尾回到libdms读取
+        t0 = NowNs();
+        for (int64_t f = target + 1; f < end && result == 0; f++)
+        {
+            result = TakeRingFrame(&ctx, f, &posOf, out);
+            replayFrames++;
+        }
+        replayNs += NowNs() - t0;
+        for (int64_t f = end; f < end + 12 && result == 0; f++)
+        {
+            result = TakeRingFrame(&ctx, f, &posOf, out);
+        }
+    }
+    int count = sizeof(backSeconds) / sizeof(backSeconds[0]);
+    out->seekMs = seekNs / 1e6 / count;
+    out->replayMs = replayFrames > 0 ? replayNs / 1e6 / replayFrames : 0.0;
+    out->ringSeeks = ctx.ringSeeks;
+    dms_player_get_codestream_cache_stats(&ctx, &out->stats);
+
+    dms_player_close_index(&ctx);
+    _dms_close_dcp();
+    ctx.hasActiveMxf = false;
+    dms_player_uninit(&ctx);
+    return result;
+}
+
+/*
+ * 码流缓存基准：合成约1MB/帧的影片（桩模拟读取每帧3ms、定位40ms），顺序播放10秒后多次后退重放，
+ * 比较不缓存、按秒数缓存（10秒）与按字节数缓存（64MB，约覆盖2.5秒）时跳转与重放的耗时，
+ * 并核对缓存取出的每帧帧号、Pos与内容
+ *
+ * @return 返回0表示成功
+ */
+static int BenchRing()
+{
+    const char* indexDir = "dmsbench_ring";
+    const float frameRate = 24.0f;
+    DmsStubConfig config = { 1, 720, 1048576, 0, 0, 3000, 40000 };
+    DmsStubConfigure(&config);
+    mkdir(indexDir, 0755);
+
+    printf("--> Codestream cache (%.0f fps, ~%u KB/frame, read %lld ms/frame, seek %lld ms)\n", frameRate,
+        config.unitBytes / 1024, (long long)config.unitUs / 1000, (long long)config.seekUs / 1000);
+    const struct { float seconds; int64_t bytes; const char* name; } passes[] = {
+        { 0.0f, 0, "no cache" },
+        { 10.0f, 0, "10 s" },
+        { 0.0f, 64LL * 1024 * 1024, "64 MB" },
+    };
+    int result = 0;
+    for (const auto& pass : passes)
+    {
+        RingPassResult r;
+        if (RunRingPass(indexDir, pass.seconds, pass.bytes, frameRate, (int)(10 * frameRate), &r) != 0)
+        {
+            printf(" |->%-9s failed\n", pass.name);
+            result = -1;
+            continue;
+        }
+        printf(" |->%-9s seek %.2f ms avg / %.2f ms max, replay %.2f ms/frame, %d cached seeks, "
+            "%d/%d frames mismatched\n", pass.name, r.seekMs, r.seekMaxMs, r.replayMs, (int)r.ringSeeks,
+            r.mismatches, r.frames);
+        if (pass.seconds > 0 || pass.bytes > 0)
+        {
+            printf(" |   %d frames / %.1f MB held (frames %lld-%lld), hit rate %.0f%% (%lld/%lld), %lld evictions\n",
+                r.stats.frames, r.stats.bytes / 1048576.0, (long long)r.stats.firstFrame,
+                (long long)r.stats.lastFrame, r.stats.lookups ? 100.0 * r.stats.hits / r.stats.lookups : 0.0,
+                (long long)r.stats.hits, (long long)r.stats.lookups, (long long)r.stats.evictions);
+        }
+        if (r.mismatches > 0) result = -1;
+    }
+
+    char path[128];
+    snprintf(path, sizeof(path), "%s/urn_uuid_00000000-0000-0000-0000-%012d.dmsidx", indexDir, 1);
+    unlink(path);
+    rmdir(indexDir);
+    return result;
+}
+
+/*
+ * 显示节奏场景：取帧（含解码、转换）耗时在[costUs - costJitterUs, costUs + costJitterUs]内均匀分布
+ */
+struct ClockScenario
+{
+    const char* name;
+    float rate;               // 播放速率
+    int64_t costUs;           // 单帧取帧耗时
+    int64_t costJitterUs;     // 取帧耗时的波动
+    int64_t wakeJitterUs;     // 显示线程唤醒的延迟上限，模拟调度与合成器的抖动
+    int stallFrame;           // 取该帧时额外卡顿，无为-1
+    int64_t stallUs;          // 卡顿时长
+    int hiccupFrame;          // 提交该帧时输出端阻塞，无为-1
+    int64_t hiccupUs;         // 输出端阻塞时长
+    int pauseFrame;           // 显示该帧后暂停，无为-1
+    int64_t pauseUs;          // 暂停时长
+};
+
+/*
+ * 模拟时钟下的取帧与显示：生产端取帧完成后放入待显示队列（最多2帧，其余帧槽在显示与转换中），
+ * 显示端按调度器的动作等待、丢弃或显示
+ */
+struct ClockSim
+{
+    const ClockScenario* scenario;
+    DmsFrameScheduler scheduler;
+    std::deque<int> ready;    // 待显示的帧号
+    int64_t nowUs;            // 模拟的系统时刻
+    int64_t doneUs;           // 正在取的帧完成的时刻，队列已满或已取完为-1
+    int nextFrame;            // 下一个要取的帧号
+    int frames;               // 总帧数
+    uint32_t seed;
+};
+
+static const int kClockQueueFrames = 2;
+
+/*
+ * 线性同余伪随机数，保证各次运行结果一致
+ *
+ * @param[in,out] seed 种子
+ * @param[in]     range 取值上限（不含）
+ * @return             [0, range)内的整数
+ */
+static int64_t ClockRandom(uint32_t* seed, int64_t range)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return range > 0 ? (int64_t)((*seed >> 8) % (uint32_t)range) : 0;
+}
+
+/*
+ * 队列有空位且还有帧时开始取下一帧
+ *
+ * @param[in,out] sim 模拟状态
+ */
+static void ClockStartFetch(ClockSim* sim)
+{
+    if (sim->doneUs >= 0 || sim->nextFrame >= sim->frames || (int)sim->ready.size() >= kClockQueueFrames) return;
+    const ClockScenario* sc = sim->scenario;
+    int64_t cost = sc->costUs - sc->costJitterUs + ClockRandom(&sim->seed, 2 * sc->costJitterUs + 1);
+    if (sim->nextFrame == sc->stallFrame) cost += sc->stallUs;
+    sim->doneUs = sim->nowUs + cost;
+}
+
+/*
+ * 模拟时刻推进到t，期间依次完成取帧
+ *
+ * @param[in,out] sim 模拟状态
+ * @param[in]     t   目标时刻
+ */
+static void ClockAdvance(ClockSim* sim, int64_t t)
+{
+    while (sim->doneUs >= 0 && sim->doneUs <= t)
+    {
+        sim->nowUs = sim->doneUs;
+        sim->ready.push_back(sim->nextFrame++);
+        sim->doneUs = -1;
+        ClockStartFetch(sim);
+    }
+    if (t > sim->nowUs) sim->nowUs = t;
+}
+
+/*
+ * 显示节奏单个场景的结果
+ */
+struct ClockPassResult
+{
+    DmsPaceStats stats;
+    double mediaRate;         // 首末显示帧的媒体时间差与系统时间差之比
+    int64_t pauseDriftUs;     // 暂停期间媒体时间的变化
+};
+
+/*
+ * 运行一个显示节奏场景
+ *
+ * @param[in]  scenario   场景
+ * @param[in]  frameRate  帧率
+ * @param[in]  frames     帧数
+ * @param[out] out        结果
+ */
+static void RunClockPass(const ClockScenario* scenario, float frameRate, int frames, ClockPassResult* out)
+{
+    memset(out, 0, sizeof(*out));
+    const int64_t durationUs = (int64_t)(1000000.0 / frameRate);
+    ClockSim sim;
+    sim.scenario = scenario;
+    dms_frame_scheduler_reset(&sim.scheduler, nullptr);
+    sim.nowUs = 1000000;
+    sim.doneUs = -1;
+    sim.nextFrame = 0;
+    sim.frames = frames;
+    sim.seed = 12345;
+    dms_frame_scheduler_set_rate(&sim.scheduler, scenario->rate, sim.nowUs);
+    dms_frame_scheduler_start(&sim.scheduler, sim.nowUs);
+    ClockStartFetch(&sim);
+
+    int consumed = 0;
+    int64_t firstTimeUs = -1, firstWallUs = 0, lastTimeUs = 0, lastWallUs = 0, pausedWallUs = 0;
+    while (consumed < frames)
+    {
+        if (sim.ready.empty())
+        {
+            dms_frame_scheduler_poll_starved(&sim.scheduler, sim.nowUs, nullptr);
+            ClockAdvance(&sim, sim.doneUs);
+            continue;
+        }
+        int frame = sim.ready.front();
+        int64_t timeUs = frame * durationUs;
+        int64_t dueUs = -1;
+        int action = dms_frame_scheduler_decide(&sim.scheduler, timeUs, durationUs, sim.ready.size() > 1,
+            sim.nowUs, &dueUs);
+        if (action == DMS_PACE_WAIT)
+        {
+            ClockAdvance(&sim, dueUs + ClockRandom(&sim.seed, scenario->wakeJitterUs + 1));
+            continue;
+        }
+        sim.ready.pop_front();
+        consumed++;
+        ClockStartFetch(&sim);
+        if (action == DMS_PACE_DROP) continue;
+
+        dms_frame_scheduler_presented(&sim.scheduler, durationUs, dueUs, sim.nowUs);
+        if (firstTimeUs < 0)
+        {
+            firstTimeUs = timeUs;
+            firstWallUs = sim.nowUs;
+        }
+        lastTimeUs = timeUs;
+        lastWallUs = sim.nowUs;
+        ClockAdvance(&sim, sim.nowUs + 500 + (frame == scenario->hiccupFrame ? scenario->hiccupUs : 0));
+
+        if (frame == scenario->pauseFrame)
+        {
+            int64_t before = dms_frame_scheduler_position(&sim.scheduler, sim.nowUs);
+            dms_frame_scheduler_pause(&sim.scheduler, sim.nowUs);
+            ClockAdvance(&sim, sim.nowUs + scenario->pauseUs);
+            out->pauseDriftUs = dms_frame_scheduler_position(&sim.scheduler, sim.nowUs) - before;
+            pausedWallUs += scenario->pauseUs;
+            dms_frame_scheduler_start(&sim.scheduler, sim.nowUs);
+        }
+    }
+    out->stats = sim.scheduler.stats;
+    int64_t wallUs = lastWallUs - firstWallUs - pausedWallUs;
+    out->mediaRate = wallUs > 0 ? (double)(lastTimeUs - firstTimeUs) / wallUs : 0.0;
+}
+
+/*
+ * 显示节奏调度基准：模拟时钟下24fps的各场景，检查稳定取帧时不丢帧不重复、2倍速按2倍推进媒体时间、
+ * 暂停期间媒体时间不变且不计重复显示、取帧卡顿后重复显示并重同步、输出端阻塞后丢弃落后帧追上时钟、
+ * 所有帧均被显示或丢弃
+ *
+ * @return 返回0表示所有场景符合预期
+ */
+static int BenchClock()
+{
+    const float frameRate = 24.0f;
+    const int frames = 24 * 60;
+    const int64_t periodUs = (int64_t)(1000000.0 / frameRate);
+    const ClockScenario scenarios[] = {
+        { "steady",  1.0f, 20000,     0,    0,  -1,      0,  -1,      0,  -1,      0 },
+        { "wakeup",  1.0f, 20000,     0, 4000,  -1,      0,  -1,      0,  -1,      0 },
+        { "jittery", 1.0f, 30000, 25000, 2000,  -1,      0,  -1,      0,  -1,      0 },
+        { "slow",    1.0f, 50000,  5000, 2000,  -1,      0,  -1,      0,  -1,      0 },
+        { "stall",   1.0f, 20000,  5000, 2000, 480, 400000,  -1,      0,  -1,      0 },
+        { "hiccup",  1.0f, 20000,  5000, 2000,  -1,      0, 300, 150000,  -1,      0 },
+        { "2x",      2.0f, 10000,  2000, 1000,  -1,      0,  -1,      0,  -1,      0 },
+        { "pause",   1.0f, 20000,  5000, 2000,  -1,      0,  -1,      0, 720, 500000 },
+    };
+
+    printf("--> Presentation pacing (simulated clock, %.0f fps, %d frames, queue %d)\n", frameRate, frames,
+        kClockQueueFrames);
+    int result = 0;
+    for (const ClockScenario& sc : scenarios)
+    {
+        ClockPassResult r;
+        RunClockPass(&sc, frameRate, frames, &r);
+        const DmsPaceStats& st = r.stats;
+        bool ok = st.presented + st.dropped == frames;
+        if (strcmp(sc.name, "steady") == 0) ok = ok && st.dropped == 0 && st.repeated == 0 && st.resyncs == 0;
+        if (strcmp(sc.name, "wakeup") == 0) ok = ok && st.dropped == 0 && st.repeated == 0;
+        if (strcmp(sc.name, "slow") == 0) ok = ok && st.repeated > 0;
+        if (strcmp(sc.name, "stall") == 0) ok = ok && st.repeated >= sc.stallUs / periodUs - 2 && st.resyncs > 0;
+        if (strcmp(sc.name, "hiccup") == 0) ok = ok && st.dropped > 0 && st.repeated >= sc.hiccupUs / periodUs - 1;
+        if (strcmp(sc.name, "2x") == 0) ok = ok && r.mediaRate > 1.95 && r.mediaRate < 2.05;
+        if (strcmp(sc.name, "pause") == 0) ok = ok && r.pauseDriftUs == 0 && st.repeated == 0;
+        printf(" |->%-8s presented %4lld, dropped %3lld, repeated %3lld, resyncs %2lld, late %6.0f us avg, "
+            "jitter %6.0f us, max %6lld us, media/wall %.3f  %s\n", sc.name, (long long)st.presented,
+            (long long)st.dropped, (long long)st.repeated, (long long)st.resyncs, st.meanLateUs, st.jitterUs,
+            (long long)st.maxLateUs, r.mediaRate, ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+    }
+    return result;
+}
+
+/*
+ * 刷新节奏模拟的参数
+ */
+struct CadenceSimConfig
+{
+    int32_t fps;              // 影片帧率
+    float refreshHz;          // 屏幕刷新率
+    bool paced;               // 按节奏提交，否则按媒体时钟连续提交
+    int64_t phaseUs;          // 连续提交时媒体时钟锚点相对刷新的偏移
+    int64_t wakeJitterUs;     // 提交时刻的随机延迟上限
+    int64_t stampNoiseUs;     // 刷新回调时间戳的随机误差上限
+    int skipEvery;            // 每隔多少次刷新漏掉回调，0为不漏
+    int skipCount;            // 每次漏掉的回调数
+    int stallFrame;           // 该帧提交卡顿，无为-1
+    int64_t stallUs;          // 卡顿时长
+};
+
+/*
+ * 刷新节奏模拟的结果
+ */
+struct CadenceSimResult
+{
+    int64_t holds[6];         // 保持1~5次及更多次刷新的帧数
+    int64_t skipped;          // 未显示的帧数
+    int64_t skippedCallbacks; // 漏掉的刷新回调数
+    DmsCadenceStats stats;    // 规划器（连续提交时仅用于观测）的统计
+};
+
+/*
+ * 刷新节奏模拟：刷新按固定周期发生，每次刷新显示此前最后提交的帧。按节奏提交时以规划器排定的刷新
+ * 提前半个周期提交；连续提交时在媒体时钟的显示时刻提交。规划器在首帧显示后的刷新上锁定，
+ * 连续提交时也用它核对节奏
+ *
+ * @param[in]  config  模拟参数
+ * @param[in]  frames  帧数
+ * @param[out] out     结果
+ * @return             返回0表示成功
+ */
+static int RunCadenceSim(const CadenceSimConfig* config, int frames, CadenceSimResult* out)
+{
+    memset(out, 0, sizeof(*out));
+    DmsCadence* cadence = new DmsCadence();
+    if (dms_cadence_plan(cadence, config->fps, 1, config->refreshHz) != 0)
+    {
+        delete cadence;
+        return -1;
+    }
+    const double periodUs = 1000000.0 / config->refreshHz;
+    const int64_t frameUs = 1000000 / config->fps;
+    const int64_t t0 = 1000000;
+    uint32_t seed = 4242;
+
+    int64_t nextFrame = 0;          // 下一个要提交的帧
+    int64_t submitted = -1;         // 最后提交的帧
+    int64_t shown = -1;             // 当前显示的帧
+    int64_t hold = 0;               // 当前显示的帧已保持的刷新次数
+    int64_t vsync = 0;
+    int64_t plannedUs = -1;         // 下一帧的提交时刻，-1为待计算
+    while (nextFrame < frames || submitted != shown)
+    {
+        int64_t vsyncUs = t0 + (int64_t)llround(vsync * periodUs);
+        if (plannedUs < 0 && nextFrame < frames)
+        {
+            int64_t dueUs;
+            if (!config->paced)
+                dueUs = t0 + config->phaseUs + nextFrame * frameUs;
+            else if (nextFrame == 0)
+                dueUs = t0 + config->phaseUs;
+            else
+                dueUs = dms_cadence_due_us(cadence, nextFrame) - (int64_t)(cadence->periodUs / 2);
+            if (dueUs >= 0)
+            {
+                plannedUs = dueUs + ClockRandom(&seed, config->wakeJitterUs + 1);
+                if (nextFrame == config->stallFrame) plannedUs += config->stallUs;
+            }
+        }
+        if (plannedUs >= 0 && plannedUs < vsyncUs)
+        {
+            submitted = nextFrame++;
+            plannedUs = -1;
+            continue;
+        }
+
+        // 刷新：显示最后提交的帧，回调规划器
+        if (submitted != shown)
+        {
+            if (shown >= 0) out->holds[hold < 6 ? hold - 1 : 5]++;
+            out->skipped += shown >= 0 ? submitted - shown - 1 : 0;
+            shown = submitted;
+            hold = 0;
+        }
+        if (shown >= 0) hold++;
+        bool skip = config->skipEvery > 0 && vsync % config->skipEvery < config->skipCount && vsync > config->skipEvery;
+        if (skip)
+        {
+            out->skippedCallbacks++;
+        }
+        else
+        {
+            int64_t stampUs = vsyncUs - config->stampNoiseUs + ClockRandom(&seed, 2 * config->stampNoiseUs + 1);
+            dms_cadence_vsync(cadence, stampUs, shown);
+            if (!cadence->locked && shown >= 0) dms_cadence_lock(cadence, shown, stampUs);
+        }
+        vsync++;
+        if (vsync > (int64_t)frames * 8) break;
+    }
+    out->stats = cadence->stats;
+    delete cadence;
+    return 0;
+}
+
+/*
+ * 刷新节奏基准：列出常见帧率/刷新率组合的节奏及按节奏播放2小时与理想帧数的偏差；
+ * 以合成刷新序列比较连续提交与按节奏提交（刷新时间戳±0.2ms、提交延迟0~3ms）时各帧保持的刷新次数，
+ * 并检查漏掉刷新回调与提交卡顿时的统计
+ *
+ * @return 返回0表示所有检查通过
+ */
+static int BenchCadence()
+{
+    int result = 0;
+    printf("--> Display cadence patterns (drift after 2 h of playback)\n");
+    const struct { int32_t num; int32_t den; float hz; const char* expect; } plans[] = {
+        { 24, 1, 60.0f, "2:3" }, { 25, 1, 50.0f, "2" }, { 48, 1, 120.0f, "2:3" }, { 24, 1, 120.0f, "5" },
+        { 48, 1, 60.0f, "1:1:1:2" }, { 25, 1, 60.0f, "2:2:3:2:3" }, { 24, 1, 50.0f, nullptr },
+        { 24, 1, 59.94f, nullptr }, { 24000, 1001, 59.94f, "2:3" }, { 25, 1, 59.94f, nullptr },
+        { 48, 1, 50.0f, nullptr }, { 60, 1, 50.0f, nullptr },
+    };
+    DmsCadence* cadence = new DmsCadence();
+    for (const auto& plan : plans)
+    {
+        char pattern[40];
+        if (dms_cadence_plan(cadence, plan.num, plan.den, plan.hz) != 0 ||
+            dms_cadence_pattern_string(cadence, pattern, sizeof(pattern)) != 0)
+        {
+            printf(" |->%g fps @ %g Hz: plan failed\n", (double)plan.num / plan.den, plan.hz);
+            result = -1;
+            continue;
+        }
+        dms_cadence_lock(cadence, 0, 0);
+        double fps = (double)plan.num / plan.den;
+        int64_t vsyncs = (int64_t)(7200.0 * plan.hz);
+        double drift = (double)dms_cadence_frame_at(cadence, vsyncs) - 7200.0 * fps;
+        bool ok = !plan.expect || strcmp(pattern, plan.expect) == 0;
+        printf(" |->%7.3f fps @ %6.2f Hz: %-28s %4d frames / %4d vsyncs %s, drift %+.2f frames  %s\n", fps,
+            plan.hz, pattern, cadence->patternFrames, cadence->patternVsyncs, cadence->exact ? "exact " : "approx",
+            drift, ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+    }
+    delete cadence;
+
+    const int frames = 24 * 120;
+    printf("--> Cadence on synthetic vsync (%d frames, vsync stamps +/-0.2 ms, submit delay 0-3 ms)\n", frames);
+    const struct { int32_t fps; float hz; } displays[] = { { 24, 60.0f }, { 25, 50.0f }, { 48, 120.0f } };
+    for (const auto& d : displays)
+    {
+        for (int paced = 0; paced < 2; paced++)
+        {
+            // 连续提交时媒体时钟的锚点恰在刷新前1ms，提交延迟决定赶上哪一次刷新
+            CadenceSimConfig config = { d.fps, d.hz, paced != 0, -1000, 3000, 200, 0, 0, -1, 0 };
+            CadenceSimResult r;
+            if (RunCadenceSim(&config, frames, &r) != 0) return -1;
+            int64_t planned = 0;
+            for (int h = 0; h < 6; h++) planned += r.holds[h];
+            bool ok = true;
+            if (paced) ok = r.stats.slips == 0 && r.skipped == 0;
+            printf(" |->%d fps @ %3.0f Hz %-10s holds 1:%lld 2:%lld 3:%lld 4:%lld 5+:%lld, skipped %lld, "
+                "slips %lld, relocks %lld  %s\n", d.fps, d.hz, paced ? "paced" : "continuous",
+                (long long)r.holds[0], (long long)r.holds[1], (long long)r.holds[2], (long long)r.holds[3],
+                (long long)(r.holds[4] + r.holds[5]), (long long)r.skipped, (long long)r.stats.slips,
+                (long long)r.stats.relocks, ok ? "ok" : "FAILED");
+            if (!ok) result = -1;
+        }
+    }
+
+    // 漏掉刷新回调：节奏保持锁定，漏掉的刷新按间隔推算
+    CadenceSimConfig missed = { 24, 60.0f, true, 0, 3000, 200, 240, 2, -1, 0 };
+    CadenceSimResult m;
+    if (RunCadenceSim(&missed, frames, &m) != 0) return -1;
+    bool missedOk = m.stats.missedVsyncs == m.skippedCallbacks && m.stats.slips == 0;
+    printf(" |->missed callbacks: %lld skipped, %lld detected, slips %lld  %s\n", (long long)m.skippedCallbacks,
+        (long long)m.stats.missedVsyncs, (long long)m.stats.slips, missedOk ? "ok" : "FAILED");
+    if (!missedOk) result = -1;
+
+    // 提交卡顿：检测到滑移，之后回到节奏
+    CadenceSimConfig stall = { 24, 60.0f, true, 0, 3000, 200, 0, 0, 1200, 60000 };
+    CadenceSimResult st;
+    if (RunCadenceSim(&stall, frames, &st) != 0) return -1;
+    bool stallOk = st.stats.slips > 0 && st.holds[3] + st.holds[4] + st.holds[5] > 0;
+    printf(" |->submit stall 60 ms: slips %lld, relocks %lld, skipped %lld  %s\n", (long long)st.stats.slips,
+        (long long)st.stats.relocks, (long long)st.skipped, stallOk ? "ok" : "FAILED");
+    if (!stallOk) result = -1;
+    return result;
+}
+
+/*
+ * 进度条缩略图的J2K解码：不预先建立帧索引，由后台从分本开头补全覆盖后生成全部样本，
+ * 以最低分辨率层解码真实码流，检查样本全部生成且画面不是单色
+ *
+ * @param[in] dir 码流目录，为空时合成DCI 2K码流
+ * @return        返回0表示成功
+ */
+static int BenchThumbDecode(const char* dir)
+{
+    if (!dms_j2k_decoder_available())
+    {
+        printf(" |->J2K decode:       built without OpenJPEG (-DDMS_HAVE_OPENJPEG -lopenjp2), skipped\n");
+        return 0;
+    }
+    std::vector<std::vector<uint8_t>> streams;
+    if (PrepareCodestreams(dir, &streams) == 0)
+    {
+        printf(" |->J2K decode:       no codestream\n");
+        return -1;
+    }
+    RemoveStubIndex();
+    const int frames = 240;
+    DmsContext ctx;
+    if (OpenStubMovie(&ctx, streams, frames, 24.0f, false) != 0) return -1;
+    DmsThumbnailConfig config = { 24, DMS_THUMBNAIL_DEFAULT_WIDTH, DMS_THUMBNAIL_DEFAULT_HEIGHT, 0 };
+    int64_t t0 = NowNs();
+    DmsThumbnailAtlas* atlas = dms_thumbnail_create_j2k(&ctx, &config);
+    DmsThumbnailStats stats;
+    memset(&stats, 0, sizeof(stats));
+    while (atlas && dms_thumbnail_get_stats(atlas, &stats) == 0 &&
+           stats.readyCount + stats.failedCount + stats.skippedCount < stats.sampleCount && NowNs() - t0 < 60000000000LL)
+    {
+        usleep(10000);
+    }
+    int64_t fillNs = NowNs() - t0;
+    std::vector<uint32_t> pixels((size_t)config.width * config.height);
+    int64_t got = -1;
+    int colors = 0;
+    if (atlas && dms_thumbnail_get(atlas, 120, pixels.data(), &got) == 0)
+    {
+        std::sort(pixels.begin(), pixels.end());
+        colors = (int)(std::unique(pixels.begin(), pixels.end()) - pixels.begin());
+    }
+    // 片长未知时按估算时长取样，补全到码流结尾后超出的样本跳过
+    bool ok = atlas && stats.readyCount == frames / config.intervalFrames && stats.failedCount == 0 &&
+              stats.readyCount + stats.skippedCount == stats.sampleCount && got == 120 && colors > 1;
+    printf(" |->J2K decode:       %d/%d samples without a prebuilt index (%d past the end), %.1f ms decode/sample, "
+        "%.1f s total, %d colors  %s\n", stats.readyCount, frames / config.intervalFrames, stats.skippedCount,
+        stats.decodeCostUs / 1000, fillNs / 1e9, colors, ok ? "ok" : "FAILED");
+    dms_thumbnail_destroy(atlas);
+    CloseStubMovie(&ctx);
+    RemoveStubIndex();
+    return ok ? 0 : -1;
+}
+
+/*
+ * 立体渲染的一次播放：按指定输出方式渲染立体影片到无头输出端，可在播放中途切换输出方式
+ *
+ * @param[in]  streams     码流
+ * @param[in]  frames      帧数
+ * @param[in]  outputWidth 输出宽度
+ * @param[in]  mode        输出方式，DmsStereoMode
+ * @param[in]  switchMode  显示24帧后切换到的输出方式，-1表示不切换
+ * @param[out] out         渲染统计
+ * @return                 返回0表示播完，-1表示失败或60秒内未播完
+ */
+static int RunStereoPass(const std::vector<std::vector<uint8_t>>& streams, int frames, int outputWidth, int mode,
+    int switchMode, DmsRendererStats* out)
+{
+    DmsContext ctx;
+    RemoveStubIndex();
+    if (OpenStubMovie(&ctx, streams, frames, 24.0f, true) != 0) return -1;
+    int outputHeight = outputWidth * 1080 / 2048;
+    dms_player_set_output_size(&ctx, outputWidth, outputHeight);
+    DmsVideoSink* sink = dms_video_sink_create_memory(nullptr, 2048, 1080, DMS_COLOR_RGBA_8888);
+    DmsRendererConfig config = { DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, false, -1, outputWidth, outputHeight,
+                                 DMS_SCALE_BICUBIC, mode };
+    DmsRenderer* renderer = dms_renderer_create(&ctx, sink, &config);
+    if (!renderer)
+    {
+        dms_video_sink_destroy(sink);
+        CloseStubMovie(&ctx);
+        return -1;
+    }
+    int result = 0;
+    if (!WaitPresented(renderer, 0, out)) result = -1;
+    dms_renderer_play(renderer);
+    if (result == 0 && switchMode >= 0)
+    {
+        if (!WaitPresented(renderer, 24, out) || dms_renderer_set_stereo_mode(renderer, switchMode) != 0) result = -1;
+    }
+    int64_t t0 = NowNs();
+    do
+    {
+        usleep(10000);
+        dms_renderer_get_stats(renderer, out);
+    } while (result == 0 && !out->ended && NowNs() - t0 < 60000000000LL);
+    if (!out->ended) result = -1;
+    dms_renderer_destroy(renderer);
+    CloseStubMovie(&ctx);
+    return result;
+}
+
+/*
+ * 立体3D基准：按PTS识别立体素材与配对左右眼（顺序读取与定位后），两眼并行解码相对2D的帧率，
+ * 各输出方式（只显示左眼、左右并排、帧序列单闪/双闪）渲染时的立体帧数、眼图像数与缺眼帧数，
+ * 以及播放中切换输出方式
+ *
+ * @param[in] dir         码流目录，为空时合成DCI 2K码流
+ * @param[in] outputWidth 输出宽度
+ * @return                返回0表示成功
+ */
+static int BenchStereo(const char* dir, int outputWidth)
+{
+    const int frames = 96;
+    mkdir("dmsbench_render", 0755);
+    printf("--> Stereoscopic 3D (%d frames, left/right units paired by PTS)\n", frames);
+
+    // 识别与配对：左眼单元内容为0xA0，右眼为0xB0，每帧两眼PTS相同
+    std::vector<std::vector<uint8_t>> tagged = { std::vector<uint8_t>(64, 0xA0), std::vector<uint8_t>(64, 0xB0) };
+    DmsContext ctx;
+    RemoveStubIndex();
+    if (OpenStubMovie(&ctx, tagged, frames, 24.0f, false) != 0) return -1;
+    bool monoDetected = dms_player_is_stereo(&ctx);
+    CloseStubMovie(&ctx);
+    RemoveStubIndex();
+    if (OpenStubMovie(&ctx, tagged, frames, 24.0f, true) != 0) return -1;
+    bool stereoDetected = dms_player_is_stereo(&ctx);
+    int result = 0;
+    int paired = 0, count = 0;
+    int64_t expected = 0;
+    bool ordered = true;
+    dms_player_set_stereo_mode(&ctx, DMS_STEREO_SIDE_BY_SIDE);
+    DmsFrame frame;
+    while (dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS)
+    {
+        if (frame.frame != expected++) ordered = false;
+        if (frame.unit->Data[0] == 0xA0 && frame.rightUnit && frame.rightUnit->Data[0] == 0xB0 &&
+            frame.rightUnit->PTS == frame.unit->PTS)
+        {
+            paired++;
+        }
+        dms_player_release_frame(&frame);
+        count++;
+    }
+    printf(" |->detection:        2D %s, 3D %s\n", monoDetected ? "STEREO" : "mono", stereoDetected ? "stereo" : "MONO");
+    printf(" |->sequential:       %d frames, %d paired%s\n", count, paired, ordered ? "" : ", out of order");
+    if (monoDetected || !stereoDetected || count != frames || paired != frames || !ordered) result = -1;
+
+    // 定位后从目标帧的左眼开始配对；切换为只显示左眼后不再附带右眼
+    bool seekOk = dms_player_seek_frame(&ctx, 37) == 0 && dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS;
+    if (seekOk)
+    {
+        seekOk = frame.frame == 37 && frame.unit->Data[0] == 0xA0 && frame.rightUnit &&
+                 frame.rightUnit->Data[0] == 0xB0 && frame.rightUnit->PTS == frame.unit->PTS;
+        dms_player_release_frame(&frame);
+    }
+    bool leftOnlyOk = dms_player_set_stereo_mode(&ctx, DMS_STEREO_LEFT_ONLY) == 0 &&
+                      dms_player_seek_frame(&ctx, 50) == 0 && dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS;
+    if (leftOnlyOk)
+    {
+        leftOnlyOk = frame.frame == 50 && frame.unit->Data[0] == 0xA0 && !frame.rightUnit;
+        dms_player_release_frame(&frame);
+    }
+    CloseStubMovie(&ctx);
+    printf(" |->seek:             frame 37 %s, left only at frame 50 %s\n", seekOk ? "paired" : "FAILED",
+        leftOnlyOk ? "ok" : "FAILED");
+    if (!seekOk || !leftOnlyOk) result = -1;
+
+    if (!dms_j2k_decoder_available())
+    {
+        printf(" |->decode/render:    built without OpenJPEG (-DDMS_HAVE_OPENJPEG -lopenjp2), skipped\n");
+        return result;
+    }
+    std::vector<std::vector<uint8_t>> streams;
+    if (PrepareCodestreams(dir, &streams) == 0)
+    {
+        printf(" |->decode/render:    no codestream\n");
+        return -1;
+    }
+
+    // 两眼并行解码：与2D对比每秒输出的帧数与眼图像数
+    int cores = (int)std::thread::hardware_concurrency();
+    int workers = cores > 2 ? cores : 2;
+    DmsJ2kDecoderConfig decoderConfig = { 1, 0 };
+    DmsJ2kDecoder* decoder = dms_j2k_decoder_create(&decoderConfig);
+    for (int eyes = 1; eyes <= 2 && result == 0; eyes++)
+    {
+        DmsDecodePipelineConfig config = { workers, 0 };
+        DmsDecodePipeline* pipeline = dms_decode_pipeline_create(decoder, &config);
+        int64_t submitted = 0, received = 0, rightEyes = 0;
+        int64_t t0 = NowNs();
+        while (received < 12 || NowNs() - t0 < 3000000000LL)
+        {
+            while (!dms_decode_pipeline_full(pipeline))
+            {
+                DmsFrame job;
+                MakeFrame(streams[submitted % streams.size()], submitted, &job);
+                if (eyes == 2)
+                {
+                    DmsFrame right;
+                    MakeFrame(streams[(submitted + 1) % streams.size()], submitted, &right);
+                    job.rightUnit = right.unit;
+                }
+                dms_decode_pipeline_submit(pipeline, &job, -1);
+                submitted++;
+            }
+            DmsFrame out;
+            DmsPicture left, right;
+            if (dms_decode_pipeline_receive_stereo(pipeline, &out, &left, &right, -1) != 0 || out.frame != received)
+            {
+                printf(" |->%s decode: frame %lld out of order or failed\n", eyes == 2 ? "3D" : "2D",
+                    (long long)out.frame);
+                result = -1;
+                break;
+            }
+            if (right.planes[0]) rightEyes++;
+            dms_picture_release(&left);
+            dms_picture_release(&right);
+            received++;
+        }
+        double seconds = (NowNs() - t0) / 1e9;
+        DmsDecodePipelineStats stats;
+        dms_decode_pipeline_get_stats(pipeline, &stats);
+        printf(" |->%s decode:          %.1f fps, %.1f eye images/s (%d workers, %lld stereo frames, peak %d in flight)\n",
+            eyes == 2 ? "3D" : "2D", received / seconds, (received + rightEyes) / seconds, workers,
+            (long long)stats.stereoFrames, stats.peakInFlight);
+        if (eyes == 2 && rightEyes != received) result = -1;
+        dms_decode_pipeline_destroy(pipeline);
+    }
+    dms_j2k_decoder_destroy(decoder);
+
+    // 各输出方式逐帧渲染：立体帧数、帧序列的眼图像数与缺眼帧数
+    const int modes[] = { DMS_STEREO_LEFT_ONLY, DMS_STEREO_SIDE_BY_SIDE, DMS_STEREO_FRAME_SEQUENTIAL,
+                          DMS_STEREO_FRAME_SEQUENTIAL_DOUBLE };
+    for (int mode : modes)
+    {
+        if (result != 0) break;
+        DmsRendererStats stats;
+        int64_t t0 = NowNs();
+        int pass = RunStereoPass(streams, 48, outputWidth, mode, -1, &stats);
+        double seconds = (NowNs() - t0) / 1e9;
+        bool bothEyes = dms_stereo_mode_both_eyes(mode);
+        // 首帧是开始播放前的静止画面，只显示左眼
+        int64_t fields = (stats.presented - 1) * (dms_stereo_mode_fields(mode) - 1);
+        bool ok = pass == 0 && stats.presented == 48 && stats.missingEyeFrames == 0 &&
+                  stats.stereoFrames == (bothEyes ? stats.presented : 0) && stats.eyeFields == fields;
+        printf(" |->%-24s %lld presented, %lld stereo, %lld extra eye fields, %lld missing eye, %.1f s  %s\n",
+            dms_stereo_mode_name(mode), (long long)stats.presented, (long long)stats.stereoFrames,
+            (long long)stats.eyeFields, (long long)stats.missingEyeFrames, seconds, ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+    }
+
+    // 播放中从左右并排切换为只显示左眼
+    if (result == 0)
+    {
+        DmsRendererStats stats;
+        int pass = RunStereoPass(streams, 96, outputWidth, DMS_STEREO_SIDE_BY_SIDE, DMS_STEREO_LEFT_ONLY, &stats);
+        bool ok = pass == 0 && stats.stereoFrames >= 24 && stats.stereoFrames < stats.presented;
+        printf(" |->switch to left:   %lld presented, %lld stereo before switch  %s\n", (long long)stats.presented,
+            (long long)stats.stereoFrames, ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+    }
+    return result;
+}
+
+/*
+ * 断点日志基准：显示确认的吞吐与取帧领先时的记录位置、撕裂记录与损坏文件头的恢复、整环恢复耗时，
+ * 以及在合成影片上模拟断电后续播的各阶段时延与落点
+ *
+ * @return 返回0表示成功
+ */
+static int BenchJournal()
+{
+    const char* dir = "dmsbench_journal";
+    char path[128];
+    snprintf(path, sizeof(path), "%s/breakpoint.journal", dir);
+    mkdir(dir, 0755);
+    unlink(path);
+    int result = 0;
+    char sessionId[DMS_BREAKPOINT_SESSION_ID_LEN];
+    dms_breakpoint_make_session_id(sessionId, sizeof(sessionId));
+    printf("--> Breakpoint journal (%d slots x %d bytes)\n", DMS_BREAKPOINT_DEFAULT_CAPACITY,
+        (int)sizeof(DmsBreakpointRecord));
+
+    // 取帧时登记、显示后确认的每帧开销，显示落后取帧240帧（ExoPlayer缓冲约5秒）
+    DmsBreakpointJournal* journal = dms_breakpoint_journal_open(path, DMS_BREAKPOINT_DEFAULT_CAPACITY, 1000);
+    if (!journal) return -1;
+    dms_breakpoint_journal_begin_session(journal, sessionId);
+    const int frames = 200000, behind = 240;
+    int64_t t0 = NowNs();
+    for (int i = 0; i < frames + behind; i++)
+    {
+        if (i < frames) dms_breakpoint_journal_stage(journal, i * 20833LL, 0, 16384 + i * 4096LL, i, i);
+        if (i >= behind) dms_breakpoint_journal_presented(journal, (i - behind) * 20833LL);
+    }
+    int64_t perFrameNs = (NowNs() - t0) / frames;
+    printf(" |->stage + present:  %lld ns/frame (%d frames behind)\n", (long long)perFrameNs, behind);
+
+    // 取帧领先显示240帧时，断点停在最后显示的帧；未登记的时间戳不记录
+    for (int i = 0; i < 240; i++)
+        dms_breakpoint_journal_stage(journal, 10000000000LL + i * 20833LL, 1, 16384 + i * 4096LL, i, i);
+    for (int i = 0; i < 100; i++)
+        dms_breakpoint_journal_presented(journal, 10000000000LL + i * 20833LL);
+    int unknown = dms_breakpoint_journal_presented(journal, 1);
+    DmsBreakpointRecord record;
+    bool ok = dms_breakpoint_journal_recover(journal, &record) == 0 && record.frame == 99 &&
+              DMS_BREAKPOINT_REEL(record.flags) == 1 && unknown == 1;
+    printf(" |->240 fetched, 100 presented: breakpoint at frame %lld  %s\n", (long long)record.frame,
+        ok ? "ok" : "FAILED");
+    if (!ok) result = -1;
+    dms_breakpoint_journal_close(journal);
+
+    // 写了一半的最后一条记录：恢复到上一条；整环扫描的耗时
+    journal = dms_breakpoint_journal_open(path, DMS_BREAKPOINT_DEFAULT_CAPACITY, 1000);
+    if (!journal) return -1;
+    dms_breakpoint_journal_recover(journal, &record);
+    uint64_t lastSequence = record.sequence;
+    dms_breakpoint_journal_close(journal);
+    FILE* fp = fopen(path, "r+b");
+    if (!fp) return -1;
+    long slot = (long)(lastSequence % DMS_BREAKPOINT_DEFAULT_CAPACITY);
+    uint8_t torn[32];
+    memset(torn, 0x5a, sizeof(torn));
+    fseek(fp, (long)sizeof(DmsBreakpointHeader) + slot * (long)sizeof(DmsBreakpointRecord) + 32, SEEK_SET);
+    fwrite(torn, 1, sizeof(torn), fp);
+    fclose(fp);
+    t0 = NowNs();
+    journal = dms_breakpoint_journal_open(path, DMS_BREAKPOINT_DEFAULT_CAPACITY, 1000);
+    int64_t openNs = NowNs() - t0;
+    if (!journal) return -1;
+    const int recoveries = 1000;
+    int found = 0;
+    t0 = NowNs();
+    for (int i = 0; i < recoveries; i++)
+        found += dms_breakpoint_journal_recover(journal, &record) == 0;
+    int64_t recoverNs = (NowNs() - t0) / recoveries;
+    ok = found == recoveries && record.sequence == lastSequence - 1 && record.frame == 98;
+    printf(" |->torn last record: recovered sequence %llu frame %lld (open %.1f us, recover %.1f us)  %s\n",
+        (unsigned long long)record.sequence, (long long)record.frame, openNs / 1e3, recoverNs / 1e3,
+        ok ? "ok" : "FAILED");
+    if (!ok) result = -1;
+    dms_breakpoint_journal_close(journal);
+
+    // 文件头损坏：重新创建，没有可续播的断点
+    fp = fopen(path, "r+b");
+    if (!fp) return -1;
+    fwrite("XXXX", 1, 4, fp);
+    fclose(fp);
+    journal = dms_breakpoint_journal_open(path, DMS_BREAKPOINT_DEFAULT_CAPACITY, 1000);
+    ok = journal != nullptr && dms_breakpoint_journal_recover(journal, &record) == 1;
+    printf(" |->corrupt header:   journal recreated, %s  %s\n", ok ? "no breakpoint" : "stale breakpoint",
+        ok ? "ok" : "FAILED");
+    if (!ok) result = -1;
+    dms_breakpoint_journal_close(journal);
+    unlink(path);
+
+    // 续播：两个分本的合成影片，取帧领先显示24帧，显示150帧后断电（不结束场次），
+    // 续播必须从最后显示的帧开始
+    DmsStubConfig config = { 2, 120, 4096, 20000, 5000, 0, 1000 };
+    DmsStubConfigure(&config);
+    const float frameRate = 48.0f;
+    const int presented = 150, lead = 24;
+    DmsContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    if (dms_player_init(&ctx) != 0) return -1;
+    ctx.frameRate = frameRate;
+    dms_player_set_index_dir(&ctx, dir);
+    dms_player_open_journal(&ctx, path, 1000);
+    const char* session = dms_player_begin_session(&ctx);
+    if (_dms_open_dcp("stub", session ? session : "", false) != DMS_RESULT_SUCCESS) return -1;
+    ctx.hasActiveMxf = true;
+    dms_player_open_timeline(&ctx);
+    std::deque<int64_t> pending;
+    int64_t lastFrame = -1;
+    DmsFrame frame;
+    while (lastFrame + 1 < presented && dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS)
+    {
+        pending.push_back(frame.timeUs);
+        if (pending.size() > (size_t)lead)
+        {
+            dms_player_frame_presented(&ctx, pending.front());
+            pending.pop_front();
+            lastFrame++;
+        }
+        dms_player_release_frame(&frame);
+    }
+    int64_t fetched = lastFrame + 1 + (int64_t)pending.size();
+    dms_player_close_index(&ctx);
+    _dms_close_dcp();
+    ctx.hasActiveMxf = false;
+    dms_player_uninit(&ctx);
+
+    memset(&ctx, 0, sizeof(ctx));
+    if (dms_player_init(&ctx) != 0) return -1;
+    ctx.frameRate = frameRate;
+    dms_player_set_index_dir(&ctx, dir);
+    dms_player_open_journal(&ctx, path, 1000);
+    DmsResumeStats stats;
+    int resume = dms_player_resume_breakpoint(&ctx, "stub", "", 1.0f, &stats);
+    int64_t resumedFrame = -1, resumedPts = -1;
+    if (resume == 0 && dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS)
+    {
+        resumedFrame = frame.frame;
+        resumedPts = frame.unit->PTS;
+        dms_player_release_frame(&frame);
+    }
+    // 第二个分本内的帧号即PTS
+    ok = resume == 0 && resumedFrame == lastFrame && resumedPts == lastFrame - config.framesPerReel;
+    printf(" |->resume after power loss: %lld fetched, %lld presented, resumed at frame %lld  %s\n",
+        (long long)fetched, (long long)lastFrame + 1, (long long)resumedFrame, ok ? "ok" : "FAILED");
+    printf(" |->resume latency:   recover %lld us, open %lld us, bind %lld us, index %lld us (parallel), "
+        "break %lld us,\n", (long long)stats.recoverUs, (long long)stats.openUs, (long long)stats.bindUs,
+        (long long)stats.indexUs, (long long)stats.breakUs);
+    printf("                      seek %lld us, buffer %lld us (%d frames), total %lld us\n",
+        (long long)stats.seekUs, (long long)stats.bufferUs, stats.bufferedFrames, (long long)stats.totalUs);
+    if (!ok) result = -1;
+    dms_player_end_session(&ctx);
+    CloseIndexedStub(&ctx, dir, config.reelCount);
+    unlink(path);
+    rmdir(dir);
+    return result;
+}
+
+// 快进/快退一次抽帧的统计
+struct TrickPassResult
+{
+    int outputs;              // 输出帧数
+    int64_t reads;            // 读取的数据单元数
+    int64_t first;            // 第一个输出帧号
+    int64_t last;             // 最后一个输出帧号
+    int32_t step;             // 最后使用的步长
+    int wrongSteps;           // 帧号之差不等于步长的帧数
+    int notMonotonic;         // 帧号未按方向前进的帧数
+    int wrongPts;             // PTS与帧号不符的帧数
+    int wrongTimestamps;      // 时间戳不连续或显示时长与步长不符的帧数
+};
+
+/*
+ * 按指定倍速抽帧取帧，逐帧核对步长、PTS与输出时间戳，统计每输出帧读取的数据单元数，结束后恢复正常速度
+ *
+ * @param[in]  ctx           播放器上下文，读取位置已在起点
+ * @param[in]  speed         倍速
+ * @param[in]  outputs       最多输出帧数，到达片头/片尾时提前结束
+ * @param[in]  framesPerReel 每个分本的帧数
+ * @param[out] out           统计
+ */
+static void RunTrickPass(DmsContext* ctx, float speed, int outputs, int framesPerReel, TrickPassResult* out)
+{
+    memset(out, 0, sizeof(*out));
+    out->first = out->last = -1;
+    dms_player_set_speed(ctx, speed);
+    int64_t reads = DmsStubUnitReads();
+    int64_t nextTimeUs = -1;
+    for (int i = 0; i < outputs && dms_trick_play_active(&ctx->trick); i++)
+    {
+        DmsFrame frame;
+        if (dms_player_next_frame(ctx, &frame) != DMS_RESULT_SUCCESS) break;
+        if (!dms_trick_play_active(&ctx->trick))
+        {
+            // 快退到片头后已恢复正常播放，该帧不计
+            dms_player_release_frame(&frame);
+            break;
+        }
+        int32_t step = ctx->trick.step;
+        int64_t expectedUs = (int64_t)((double)(step < 0 ? -step : step) * 1000000.0 /
+            ((double)fabsf(speed) * ctx->frameRate));
+        if (out->last >= 0)
+        {
+            // 快退到片头时落在第0帧
+            if (frame.frame != out->last + step && frame.frame != 0) out->wrongSteps++;
+            if ((frame.frame - out->last) * (speed > 0 ? 1 : -1) <= 0) out->notMonotonic++;
+        }
+        if (frame.unit->PTS != frame.frame % framesPerReel) out->wrongPts++;
+        if ((nextTimeUs >= 0 && frame.timeUs != nextTimeUs) || frame.durationUs != expectedUs) out->wrongTimestamps++;
+        nextTimeUs = frame.timeUs + frame.durationUs;
+        if (out->first < 0) out->first = frame.frame;
+        out->last = frame.frame;
+        out->step = step;
+        out->outputs++;
+        dms_player_release_frame(&frame);
+    }
+    out->reads = DmsStubUnitReads() - reads;
+    dms_player_set_speed(ctx, 1.0f);
+}
+
+/*
+ * 快进/快退基准：在已建立帧索引的合成影片上以2/8/32倍速快进、8倍速快退（跨越分本），核对每帧按步长N前进、
+ * PTS与帧号相符、输出时间戳连续且显示时长为N帧在倍速下的时长，每输出一帧只读取一个数据单元；
+ * 在尚无帧索引的影片上快进时不顺读途经的帧；有J2K解码器时核对抽帧并行解码不丢弃在途帧
+ *
+ * @param[in] dir 码流目录，为空时合成DCI 2K码流
+ * @return        返回0表示成功
+ */
+static int BenchTrick(const char* dir)
+{
+    const char* indexDir = "dmsbench_trick";
+    const float frameRate = 24.0f;
+    DmsStubConfig config = { 3, 240, 65536, 20000, 5000, 2000, 3000 };
+    DmsStubConfigure(&config);
+    mkdir(indexDir, 0755);
+    printf("--> Trick play (%d reels x %d frames @ %.0ffps, read %lld ms/frame, seek %lld ms)\n",
+        config.reelCount, config.framesPerReel, frameRate, (long long)config.unitUs / 1000,
+        (long long)config.seekUs / 1000);
+
+    DmsContext ctx;
+    if (OpenIndexedStub(&ctx, indexDir, frameRate) <= 0)
+    {
+        CloseIndexedStub(&ctx, indexDir, config.reelCount);
+        return -1;
+    }
+    int result = 0;
+    struct { float speed; int64_t start; } passes[] = { { 2.0f, 0 }, { 8.0f, 0 }, { 32.0f, 0 }, { -8.0f, 700 } };
+    for (const auto& pass : passes)
+    {
+        TrickPassResult trick;
+        dms_player_seek_frame(&ctx, pass.start);
+        RunTrickPass(&ctx, pass.speed, 120, config.framesPerReel, &trick);
+        // 跨越分本时选择分本后重新识别码流，多读少量数据单元
+        bool ok = trick.outputs >= 20 && trick.wrongSteps == 0 && trick.notMonotonic == 0 && trick.wrongPts == 0 &&
+                  trick.wrongTimestamps == 0 && trick.reads <= trick.outputs + 2 * config.reelCount;
+        printf(" |->%+5.0fx indexed     %3d frames %lld..%lld, step %d, %.2f reads/frame, %d wrong steps, "
+            "%d wrong timestamps  %s\n", pass.speed, trick.outputs, (long long)trick.first, (long long)trick.last,
+            trick.step, trick.outputs > 0 ? (double)trick.reads / trick.outputs : 0.0, trick.wrongSteps,
+            trick.wrongTimestamps, ok ? "ok" : "FAILED");
+        if (!ok) result = -1;
+    }
+    CloseIndexedStub(&ctx, indexDir, config.reelCount);
+
+    // 刚打开、没有帧索引：快进不顺读途经的帧，每输出一帧只读一个数据单元
+    mkdir(indexDir, 0755);
+    memset(&ctx, 0, sizeof(ctx));
+    if (dms_player_init(&ctx) != 0) return -1;
+    ctx.frameRate = frameRate;
+    dms_player_set_index_dir(&ctx, indexDir);
+    if (_dms_open_dcp("stub", "", false) != DMS_RESULT_SUCCESS) return -1;
+    ctx.hasActiveMxf = true;
+    dms_player_open_timeline(&ctx);
+    TrickPassResult trick;
+    RunTrickPass(&ctx, 8.0f, 60, config.framesPerReel, &trick);
+    bool ok = trick.outputs == 60 && trick.notMonotonic == 0 && trick.wrongPts == 0 && trick.wrongTimestamps == 0 &&
+              trick.reads <= trick.outputs + 2;
+    printf(" |->   +8x unindexed   %3d frames %lld..%lld, %.2f reads/frame, %d wrong timestamps  %s\n",
+        trick.outputs, (long long)trick.first, (long long)trick.last,
+        trick.outputs > 0 ? (double)trick.reads / trick.outputs : 0.0, trick.wrongTimestamps, ok ? "ok" : "FAILED");
+    if (!ok) result = -1;
+    CloseIndexedStub(&ctx, indexDir, config.reelCount);
+
+    // 抽帧时并行解码：定位不丢弃已提交的帧
+    std::vector<std::vector<uint8_t>> streams;
+    if (!dms_j2k_decoder_available() || PrepareCodestreams(dir, &streams) == 0)
+    {
+        printf(" |->parallel decode:   no J2K decoder or codestream, skipped\n");
+        return result;
+    }
+    RemoveStubIndex();
+    if (OpenStubMovie(&ctx, streams, 960, frameRate, false) != 0) return -1;
+    DmsFrame frame;
+    while (dms_player_next_frame(&ctx, &frame) == DMS_RESULT_SUCCESS) dms_player_release_frame(&frame);
+    dms_player_seek_frame(&ctx, 0);
+    ctx.decodeWorkers = 4;
+    dms_player_set_output_size(&ctx, 480, 253);
+    dms_player_set_speed(&ctx, 8.0f);
+    // 步长随解码耗时变化，取帧领先输出若干帧，只核对输出帧号递增
+    int decoded = 0, notMonotonic = 0;
+    int64_t last = -1;
+    while (decoded < 24)
+    {
+        DmsPicture picture;
+        if (dms_player_next_picture(&ctx, &frame, &picture) != DMS_RESULT_SUCCESS) break;
+        if (frame.frame <= last) notMonotonic++;
+        last = frame.frame;
+        dms_picture_release(&picture);
+        decoded++;
+    }
+    DmsDecodePipelineStats stats;
+    memset(&stats, 0, sizeof(stats));
+    dms_player_get_decode_stats(&ctx, &stats);
+    ok = decoded == 24 && notMonotonic == 0 && stats.cancelled == 0 && stats.peakInFlight > 1;
+    printf(" |->parallel decode:   %d frames at 8x, %d workers, peak %d in flight, %lld cancelled  %s\n", decoded,
+        stats.workers, stats.peakInFlight, (long long)stats.cancelled, ok ? "ok" : "FAILED");
+    if (!ok) result = -1;
+    CloseStubMovie(&ctx);
+    RemoveStubIndex();
+    return result;
+}
+
+/*
+ * 程序入口函数
+ *
+ * @param[in] argc 命令行参数个数
+ * @param[in] argv 命令行参数数组
+ * @return         返回0表示程序正常退出
+ */
+int main(int argc, char* argv[])
+{
+    const char* name = argc > 1 ? argv[1] : "all";
+    bool all = strcmp(name, "all") == 0;
+    int result = 0;
+
+    if (all || strcmp(name, "index") == 0) result |= BenchIndex();
+    if (all || strcmp(name, "reel") == 0) result |= BenchReel();
+    if (all || strcmp(name, "reverse") == 0) result |= BenchReverse();
+    if (all || strcmp(name, "step") == 0) result |= BenchStep();
+    if (all || strcmp(name, "thumb") == 0) result |= BenchThumb();
+    if (all || strcmp(name, "thumb") == 0) result |= BenchThumbDecode(argc > 2 ? argv[2] : nullptr);
+    if (all || strcmp(name, "j2k") == 0) result |= BenchJ2k(argc > 2 ? argv[2] : nullptr);
+    if (all || strcmp(name, "color") == 0) result |= BenchColor();
+    if (all || strcmp(name, "lut") == 0) result |= BenchLut();
+    if (all || strcmp(name, "scale") == 0) result |= BenchScale();
+    if (all || strcmp(name, "pipeline") == 0) result |= BenchPipeline(argc > 2 ? argv[2] : nullptr);
+    if (all || strcmp(name, "render") == 0)
+        result |= BenchRender(argc > 2 ? argv[2] : nullptr, argc > 3 ? atoi(argv[3]) : 960);
+    if (all || strcmp(name, "quality") == 0)
+        result |= BenchQuality(argc > 2 ? argv[2] : nullptr, argc > 3 ? (float)atof(argv[3]) : 48.0f,
+            argc > 4 ? atoi(argv[4]) : 1920);
+    if (all || strcmp(name, "header") == 0) result |= BenchHeader(argc > 2 ? argv[2] : nullptr);
+    if (all || strcmp(name, "cache") == 0)
+        result |= BenchCache(argc > 2 ? argv[2] : nullptr, argc > 3 ? atoi(argv[3]) : 480);
+    if (all || strcmp(name, "ring") == 0) result |= BenchRing();
+    if (all || strcmp(name, "clock") == 0) result |= BenchClock();
+    if (all || strcmp(name, "cadence") == 0) result |= BenchCadence();
+    if (all || strcmp(name, "stereo") == 0)
+        result |= BenchStereo(argc > 2 ? argv[2] : nullptr, argc > 3 ? atoi(argv[3]) : 960);
+    if (all || strcmp(name, "journal") == 0) result |= BenchJournal();
+    if (all || strcmp(name, "trick") == 0) result |= BenchTrick(argc > 2 ? argv[2] : nullptr);
+
+    return result == 0 ? 0 : 1;
+}
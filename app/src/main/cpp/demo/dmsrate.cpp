@@ -0,0 +1,367 @@
+/*
+ * DCP 图像码率分析工具
+ *
+ * @file    dmsrate.cpp
+ *
+ * 打开DCP后以存储最高速度依次读取所有分本的图像数据单元（不解码、不按帧率节奏），
+ * 记录每帧 DmsDataUnit::Length，输出JSON格式的码率统计，用于放映前判断存储卡能否支撑该影片：
+ *   单帧峰值码率、指定窗口的峰值码率、平均码率、最差1秒窗口，以及所需的持续读取吞吐量，
+ *   并与本次实测的读取吞吐量（含解密）比较。
+ *
+ * 用法：dmsrate [-k KDM文件] [-r 帧率] [-w 窗口秒数] [-f] [-v] DCP目录
+ *   -k  加密影片需要绑定的KDM
+ *   -r  帧率，libdms 不提供帧率信息，默认24
+ *   -w  统计窗口峰值码率的窗口长度，默认0.5秒
+ *   -f  以正式放映模式打开DCP读取全片（默认预览模式，不消耗KDM场次，但可能在预览结束时停止）
+ *   -v  输出每帧长度
+ *
+ * 设备：adb push 后执行 ./dmsrate -k /sdcard/dms_test/kdm/xxx.xml /sdcard/dms_test/dcp/xxx
+ * 主机：g++ -O2 -std=c++17 -I../include demo/dmsrate.cpp -L<libdms目录> -ldms -o dmsrate
+ *       （以 demo/dms_stub_libdms.cpp 代替 -ldms 可用合成影片试运行）
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "../../include/libdms.h"
+
+/*
+ * 命令行参数
+ */
+struct RateOptions
+{
+    const char* dcp;          // DCP目录
+    const char* kdm;          // KDM文件，可为空
+    double frameRate;         // 帧率
+    double windowSeconds;     // 窗口峰值码率的窗口长度（秒）
+    bool fullPlay;            // 以正式放映模式打开
+    bool perFrame;            // 输出每帧长度
+};
+
+/*
+ * 单个分本的读取结果
+ */
+struct ReelRate
+{
+    int number;               // 分本在libdms中的编号
+    int64_t startFrame;       // 在整部影片中的起始帧号
+    int64_t frames;           // 帧数
+    int64_t bytes;            // 图像数据总字节数
+    uint32_t peakBytes;       // 最大单帧字节数
+    int endResult;            // 读取结束时 _dms_get_next_picture_unit 的返回值
+};
+
+/*
+ * 窗口峰值：连续frames帧字节数之和的最大值
+ */
+struct WindowPeak
+{
+    int64_t frames;           // 窗口帧数
+    int64_t startFrame;       // 峰值窗口的起始帧号
+    int64_t bytes;            // 峰值窗口内的字节数
+};
+
+/*
+ * 获取单调时钟时间
+ *
+ * @return 纳秒
+ */
+static int64_t NowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*
+ * 打印用法
+ *
+ * @param[in] name 程序名
+ */
+static void PrintUsage(const char* name)
+{
+    fprintf(stderr, "Usage: %s [-k kdm] [-r fps] [-w seconds] [-f] [-v] <dcp>\n", name);
+}
+
+/*
+ * 解析命令行参数
+ *
+ * @param[in]  argc    命令行参数个数
+ * @param[in]  argv    命令行参数数组
+ * @param[out] options 解析结果
+ * @return             返回0表示成功
+ */
+static int ParseOptions(int argc, char* argv[], RateOptions* options)
+{
+    memset(options, 0, sizeof(*options));
+    options->frameRate = 24.0;
+    options->windowSeconds = 0.5;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "k:r:w:fv")) != -1)
+    {
+        switch (opt)
+        {
+        case 'k': options->kdm = optarg; break;
+        case 'r': options->frameRate = atof(optarg); break;
+        case 'w': options->windowSeconds = atof(optarg); break;
+        case 'f': options->fullPlay = true; break;
+        case 'v': options->perFrame = true; break;
+        default: return -1;
+        }
+    }
+    if (optind != argc - 1 || options->frameRate <= 0 || options->windowSeconds <= 0) return -1;
+    options->dcp = argv[optind];
+    return 0;
+}
+
+/*
+ * 读取当前分本的全部图像数据单元并记录每帧长度
+ *
+ * @param[out]    reel    分本读取结果
+ * @param[in,out] lengths 每帧长度，追加到末尾
+ * @return                返回0表示读到分本结尾，否则返回libdms错误代码
+ */
+static int WalkReel(ReelRate* reel, std::vector<uint32_t>& lengths)
+{
+    reel->startFrame = (int64_t)lengths.size();
+    for (;;)
+    {
+        DmsDataUnitPtr unit = nullptr;
+        int result = _dms_get_next_picture_unit(&unit);
+        if (result != DMS_RESULT_SUCCESS || !unit)
+        {
+            reel->endResult = result;
+            if (unit) _dms_free_data_unit(&unit);
+            // 分本结尾返回播放结束或找不到图像实体，预览模式在预览结束时停止
+            return (result == (int)DMS_RESULT_PLAY_FINISHED || result == (int)DMS_RESULT_NO_PICTURE_ESSENCE_FOUND ||
+                    result == (int)DMS_RESULT_PREVIEW_FINISHED) ? 0 : result;
+        }
+        lengths.push_back(unit->Length);
+        reel->frames++;
+        reel->bytes += unit->Length;
+        if (unit->Length > reel->peakBytes) reel->peakBytes = unit->Length;
+        _dms_free_data_unit(&unit);
+    }
+}
+
+/*
+ * 用前缀和求连续若干帧字节数之和的最大值，窗口超过总帧数时取全片
+ *
+ * @param[in] prefix 字节数前缀和，prefix[i]为前i帧之和
+ * @param[in] frames 窗口帧数
+ * @return           窗口峰值
+ */
+static WindowPeak FindWindowPeak(const std::vector<int64_t>& prefix, int64_t frames)
+{
+    WindowPeak peak = { 0, 0, 0 };
+    int64_t total = (int64_t)prefix.size() - 1;
+    if (frames < 1) frames = 1;
+    if (frames > total) frames = total;
+    peak.frames = frames;
+    for (int64_t i = 0; i + frames <= total; i++)
+    {
+        int64_t bytes = prefix[i + frames] - prefix[i];
+        if (bytes > peak.bytes)
+        {
+            peak.bytes = bytes;
+            peak.startFrame = i;
+        }
+    }
+    return peak;
+}
+
+/*
+ * 输出JSON字符串，转义引号、反斜杠与控制字符
+ *
+ * @param[in] text UTF-8字符串
+ */
+static void PrintJsonString(const char* text)
+{
+    putchar('"');
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++)
+    {
+        if (*p == '"' || *p == '\\') printf("\\%c", *p);
+        else if (*p < 0x20) printf("\\u%04x", *p);
+        else putchar(*p);
+    }
+    putchar('"');
+}
+
+/*
+ * 输出窗口峰值的JSON对象
+ *
+ * @param[in] name      字段名
+ * @param[in] peak      窗口峰值
+ * @param[in] frameRate 帧率
+ */
+static void PrintWindow(const char* name, const WindowPeak& peak, double frameRate)
+{
+    double seconds = peak.frames / frameRate;
+    printf("  \"%s\": {\"frames\": %lld, \"seconds\": %.3f, \"startFrame\": %lld, \"startSeconds\": %.3f, "
+           "\"bytes\": %lld, \"bitrate\": %.0f},\n",
+        name, (long long)peak.frames, seconds, (long long)peak.startFrame, peak.startFrame / frameRate,
+        (long long)peak.bytes, seconds > 0 ? peak.bytes * 8.0 / seconds : 0.0);
+}
+
+/*
+ * 打开DCP并读取所有分本，输出码率统计
+ *
+ * @param[in] options 命令行参数
+ * @return            返回0表示成功
+ */
+static int AnalyzeDcp(const RateOptions* options)
+{
+    int result = _dms_library_initialize(DMS_MODE_PLAY, nullptr, false);
+    if (result != DMS_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "[Error][_dms_library_initialize result: 0x%08x]\n", result);
+        return -1;
+    }
+    result = _dms_open_dcp(options->dcp, "", !options->fullPlay);
+    if (result != DMS_RESULT_SUCCESS)
+    {
+        fprintf(stderr, "[Error][_dms_open_dcp result: 0x%08x]\n", result);
+        _dms_library_uninitialize();
+        return -1;
+    }
+    if (options->kdm)
+    {
+        result = _dms_bind_kdm(options->kdm);
+        if (result != DMS_RESULT_SUCCESS)
+        {
+            fprintf(stderr, "[Error][_dms_bind_kdm result: 0x%08x]\n", result);
+            _dms_close_dcp();
+            _dms_library_uninitialize();
+            return -1;
+        }
+    }
+
+    // 分本编号的起点以能否选择0号分本判断，与播放器一致；只有一个分本时不切换
+    int reelCount = _dms_get_reel_count();
+    if (reelCount < 1) reelCount = 1;
+    int firstNumber = (reelCount > 1 && _dms_select_reel(0) != DMS_RESULT_SUCCESS) ? 1 : 0;
+
+    std::vector<ReelRate> reels(reelCount);
+    std::vector<uint32_t> lengths;
+    int walkResult = 0;
+    int64_t t0 = NowNs();
+    for (int i = 0; i < reelCount && walkResult == 0; i++)
+    {
+        memset(&reels[i], 0, sizeof(ReelRate));
+        reels[i].number = firstNumber + i;
+        if (reelCount > 1)
+        {
+            result = _dms_select_reel(reels[i].number);
+            if (result != DMS_RESULT_SUCCESS)
+            {
+                fprintf(stderr, "[Error][_dms_select_reel(%d) result: 0x%08x]\n", reels[i].number, result);
+                walkResult = result;
+                break;
+            }
+        }
+        walkResult = WalkReel(&reels[i], lengths);
+        if (walkResult != 0)
+        {
+            fprintf(stderr, "[Error][_dms_get_next_picture_unit result: 0x%08x]\n", walkResult);
+        }
+        if (reels[i].endResult == (int)DMS_RESULT_PREVIEW_FINISHED) break;
+    }
+    int64_t elapsedNs = NowNs() - t0;
+    _dms_close_dcp();
+    _dms_library_uninitialize();
+
+    if (lengths.empty())
+    {
+        fprintf(stderr, "[Error][No picture unit read]\n");
+        return -1;
+    }
+
+    const double frameRate = options->frameRate;
+    const int64_t frames = (int64_t)lengths.size();
+    std::vector<int64_t> prefix(frames + 1, 0);
+    int64_t peakFrame = 0;
+    for (int64_t i = 0; i < frames; i++)
+    {
+        prefix[i + 1] = prefix[i] + lengths[i];
+        if (lengths[i] > lengths[peakFrame]) peakFrame = i;
+    }
+    const int64_t bytes = prefix[frames];
+    const double seconds = frames / frameRate;
+    WindowPeak window = FindWindowPeak(prefix, (int64_t)(options->windowSeconds * frameRate + 0.5));
+    WindowPeak worstSecond = FindWindowPeak(prefix, (int64_t)(frameRate + 0.5));
+
+    // 播放时每秒必须读完最差1秒窗口内的数据，实测吞吐量包含解密与内存拷贝，与播放路径相同
+    double requiredBytesPerSecond = worstSecond.frames > 0 ? worstSecond.bytes * frameRate / worstSecond.frames : 0.0;
+    double elapsedSeconds = elapsedNs / 1e9;
+    double readBytesPerSecond = elapsedSeconds > 0 ? bytes / elapsedSeconds : 0.0;
+
+    printf("{\n");
+    printf("  \"dcp\": ");
+    PrintJsonString(options->dcp);
+    printf(",\n");
+    printf("  \"frameRate\": %.3f,\n", frameRate);
+    printf("  \"preview\": %s,\n", options->fullPlay ? "false" : "true");
+    printf("  \"complete\": %s,\n", walkResult == 0 ? "true" : "false");
+    printf("  \"frames\": %lld,\n", (long long)frames);
+    printf("  \"bytes\": %lld,\n", (long long)bytes);
+    printf("  \"seconds\": %.3f,\n", seconds);
+    printf("  \"averageBitrate\": %.0f,\n", bytes * 8.0 / seconds);
+    printf("  \"peakFrame\": {\"frame\": %lld, \"bytes\": %u, \"bitrate\": %.0f},\n",
+        (long long)peakFrame, lengths[peakFrame], lengths[peakFrame] * 8.0 * frameRate);
+    PrintWindow("window", window, frameRate);
+    PrintWindow("worstSecond", worstSecond, frameRate);
+    printf("  \"requiredBytesPerSecond\": %.0f,\n", requiredBytesPerSecond);
+    printf("  \"read\": {\"seconds\": %.3f, \"bytesPerSecond\": %.0f, \"realtimeFactor\": %.2f, \"sustainable\": %s},\n",
+        elapsedSeconds, readBytesPerSecond, elapsedSeconds > 0 ? seconds / elapsedSeconds : 0.0,
+        readBytesPerSecond >= requiredBytesPerSecond ? "true" : "false");
+
+    printf("  \"reels\": [");
+    bool first = true;
+    for (int i = 0; i < reelCount; i++)
+    {
+        const ReelRate& reel = reels[i];
+        // 预览结束或出错后未读取的分本不输出
+        if (reel.frames == 0 && reel.endResult == 0) continue;
+        double reelSeconds = reel.frames / frameRate;
+        printf("%s\n    {\"number\": %d, \"startFrame\": %lld, \"frames\": %lld, \"bytes\": %lld, "
+               "\"averageBitrate\": %.0f, \"peakBitrate\": %.0f, \"endResult\": \"0x%08x\"}",
+            first ? "" : ",", reel.number, (long long)reel.startFrame, (long long)reel.frames, (long long)reel.bytes,
+            reelSeconds > 0 ? reel.bytes * 8.0 / reelSeconds : 0.0, reel.peakBytes * 8.0 * frameRate,
+            (unsigned)reel.endResult);
+        first = false;
+    }
+    printf("\n  ]");
+
+    if (options->perFrame)
+    {
+        printf(",\n  \"frameBytes\": [");
+        for (int64_t i = 0; i < frames; i++)
+        {
+            printf("%s%u", i == 0 ? "" : (i % 16 == 0 ? ",\n    " : ", "), lengths[i]);
+        }
+        printf("]");
+    }
+    printf("\n}\n");
+    return walkResult == 0 ? 0 : -1;
+}
+
+/*
+ * 程序入口函数
+ *
+ * @param[in] argc 命令行参数个数
+ * @param[in] argv 命令行参数数组
+ * @return         返回0表示成功读完全部分本
+ */
+int main(int argc, char* argv[])
+{
+    RateOptions options;
+    if (ParseOptions(argc, argv, &options) != 0)
+    {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    return AnalyzeDcp(&options) == 0 ? 0 : 1;
+}
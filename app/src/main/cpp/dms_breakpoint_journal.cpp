@@ -0,0 +1,529 @@
+#include "dms_breakpoint_journal.h"
+#include "dms_log.h"
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#define LOG_TAG "DmsBreakpoint"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static_assert(sizeof(DmsBreakpointHeader) == 64, "DmsBreakpointHeader must be 64 bytes");
+static_assert(sizeof(DmsBreakpointRecord) == 64, "DmsBreakpointRecord must be 64 bytes");
+
+static const int kMinCapacity = 4;
+static const size_t kMaxStaged = 4096;       // 最多登记的未显示放映点（48fps约85秒，超过ExoPlayer的缓冲）
+
+// 已取出、尚未显示的放映点
+struct StagedPoint {
+    int64_t timeUs;
+    int reel;
+    int64_t pos;
+    int64_t pts;
+    int64_t frame;
+};
+
+struct DmsBreakpointJournal {
+    int fd;
+    uint8_t* base;                   // mmap起始地址
+    size_t size;
+    uint32_t capacity;
+    DmsBreakpointRecord* records;
+
+    uint8_t sessionId[16];
+    std::mutex recordMutex;          // 取帧线程登记、显示线程追加与结束场次互斥
+    std::deque<StagedPoint> staged;  // 已取出、尚未显示的放映点，按取帧顺序
+    std::atomic<uint64_t> sequence;  // 最近写入的序号
+    std::atomic<uint64_t> syncedSequence;
+
+    int syncIntervalMs;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping;
+};
+
+static uint32_t gCrcTable[256];
+static std::once_flag gCrcOnce;
+
+static void crc_init() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        gCrcTable[i] = c;
+    }
+}
+
+static uint32_t crc32(const void* data, size_t length) {
+    std::call_once(gCrcOnce, crc_init);
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        c = gCrcTable[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+static uint32_t record_checksum(const DmsBreakpointRecord* record) {
+    return crc32(record, offsetof(DmsBreakpointRecord, checksum));
+}
+
+static int64_t utc_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief 解析 urn:uuid:xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx 格式的场次标识
+ * @param text 场次标识，urn:uuid:前缀可省略
+ * @param out 输出16字节UUID
+ * @return 成功返回true
+ */
+static bool parse_uuid(const char* text, uint8_t out[16]) {
+    if (strncmp(text, "urn:uuid:", 9) == 0) {
+        text += 9;
+    }
+    int nibbles = 0;
+    for (const char* p = text; *p; p++) {
+        if (*p == '-') {
+            continue;
+        }
+        int v = hex_value(*p);
+        if (v < 0 || nibbles >= 32) {
+            return false;
+        }
+        if (nibbles % 2 == 0) {
+            out[nibbles / 2] = (uint8_t)(v << 4);
+        } else {
+            out[nibbles / 2] |= (uint8_t)v;
+        }
+        nibbles++;
+    }
+    return nibbles == 32;
+}
+
+static int do_sync(DmsBreakpointJournal* journal) {
+    uint64_t sequence = journal->sequence.load(std::memory_order_acquire);
+    if (msync(journal->base, journal->size, MS_SYNC) != 0 || fdatasync(journal->fd) != 0) {
+        LOGE("Failed to sync breakpoint journal");
+        return -3;
+    }
+    journal->syncedSequence.store(sequence, std::memory_order_release);
+    return 0;
+}
+
+static void sync_main(DmsBreakpointJournal* journal) {
+    std::unique_lock<std::mutex> lock(journal->mutex);
+    while (!journal->stopping) {
+        journal->cv.wait_for(lock, std::chrono::milliseconds(journal->syncIntervalMs));
+        if (journal->sequence.load(std::memory_order_acquire) !=
+            journal->syncedSequence.load(std::memory_order_acquire)) {
+            do_sync(journal);
+        }
+    }
+}
+
+/**
+ * @brief 初始化新日志文件：写入文件头并清空全部槽位
+ * @param journal 日志
+ */
+static void format_journal(DmsBreakpointJournal* journal) {
+    memset(journal->base, 0, journal->size);
+    DmsBreakpointHeader* header = (DmsBreakpointHeader*)journal->base;
+    memcpy(header->magic, DMS_BREAKPOINT_MAGIC, sizeof(header->magic));
+    header->version = DMS_BREAKPOINT_VERSION;
+    header->recordSize = sizeof(DmsBreakpointRecord);
+    header->capacity = journal->capacity;
+    header->checksum = crc32(header, offsetof(DmsBreakpointHeader, checksum));
+}
+
+static bool header_valid(const DmsBreakpointHeader* header, size_t fileSize) {
+    return memcmp(header->magic, DMS_BREAKPOINT_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == DMS_BREAKPOINT_VERSION &&
+           header->recordSize == sizeof(DmsBreakpointRecord) &&
+           header->capacity >= (uint32_t)kMinCapacity &&
+           header->checksum == crc32(header, offsetof(DmsBreakpointHeader, checksum)) &&
+           fileSize == sizeof(DmsBreakpointHeader) + (size_t)header->capacity * sizeof(DmsBreakpointRecord);
+}
+
+/**
+ * @brief 扫描全部槽位，找出序号最大的有效记录
+ * @param journal 日志
+ * @return 有效记录指针，没有时返回NULL
+ */
+static const DmsBreakpointRecord* find_last(DmsBreakpointJournal* journal) {
+    const DmsBreakpointRecord* last = nullptr;
+    for (uint32_t i = 0; i < journal->capacity; i++) {
+        const DmsBreakpointRecord* record = &journal->records[i];
+        if (record->sequence == 0 || record->sequence % journal->capacity != i) {
+            continue;
+        }
+        if (last && record->sequence <= last->sequence) {
+            continue;
+        }
+        if (record->checksum == record_checksum(record)) {
+            last = record;
+        }
+    }
+    return last;
+}
+
+/**
+ * @brief 打开断点日志，文件不存在或已损坏时重新创建
+ * @param path 日志文件路径
+ * @param capacity 新建时的记录槽位数，已有文件沿用其槽位数
+ * @param syncIntervalMs 落盘周期（毫秒），0表示每条记录同步落盘
+ * @return 成功返回日志指针，失败返回NULL
+ */
+struct DmsBreakpointJournal* dms_breakpoint_journal_open(const char* path, int capacity, int syncIntervalMs) {
+    if (!path || syncIntervalMs < 0) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    if (capacity < kMinCapacity) {
+        capacity = DMS_BREAKPOINT_DEFAULT_CAPACITY;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        LOGE("Failed to open breakpoint journal: %s", path);
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    // 先按已有文件头确定大小，文件头无效时按新容量重建
+    bool existing = false;
+    uint32_t slots = (uint32_t)capacity;
+    if ((size_t)st.st_size >= sizeof(DmsBreakpointHeader)) {
+        DmsBreakpointHeader header;
+        if (pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+            header_valid(&header, (size_t)st.st_size)) {
+            existing = true;
+            slots = header.capacity;
+        }
+    }
+    size_t size = sizeof(DmsBreakpointHeader) + (size_t)slots * sizeof(DmsBreakpointRecord);
+    if (!existing && ftruncate(fd, (off_t)size) != 0) {
+        LOGE("Failed to size breakpoint journal: %s", path);
+        close(fd);
+        return nullptr;
+    }
+
+    void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        LOGE("Failed to mmap breakpoint journal: %s", path);
+        close(fd);
+        return nullptr;
+    }
+
+    DmsBreakpointJournal* journal = new DmsBreakpointJournal();
+    journal->fd = fd;
+    journal->base = (uint8_t*)map;
+    journal->size = size;
+    journal->capacity = slots;
+    journal->records = (DmsBreakpointRecord*)(journal->base + sizeof(DmsBreakpointHeader));
+    memset(journal->sessionId, 0, sizeof(journal->sessionId));
+    journal->syncIntervalMs = syncIntervalMs;
+    journal->stopping = false;
+
+    uint64_t sequence = 0;
+    if (existing) {
+        const DmsBreakpointRecord* last = find_last(journal);
+        sequence = last ? last->sequence : 0;
+    } else {
+        format_journal(journal);
+    }
+    journal->sequence.store(sequence);
+    journal->syncedSequence.store(existing ? sequence : (uint64_t)-1);
+    if (!existing) {
+        do_sync(journal);
+    }
+
+    if (syncIntervalMs > 0) {
+        journal->thread = std::thread(sync_main, journal);
+    }
+    LOGI("Breakpoint journal %s: %u slots, sequence %llu, sync every %dms",
+         existing ? "opened" : "created", slots, (unsigned long long)sequence, syncIntervalMs);
+    return journal;
+}
+
+/**
+ * @brief 停止落盘线程，将未落盘的记录写入后关闭
+ * @param journal 日志
+ */
+void dms_breakpoint_journal_close(struct DmsBreakpointJournal* journal) {
+    if (!journal) {
+        return;
+    }
+    if (journal->thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(journal->mutex);
+            journal->stopping = true;
+        }
+        journal->cv.notify_all();
+        journal->thread.join();
+    }
+    if (journal->sequence.load() != journal->syncedSequence.load()) {
+        do_sync(journal);
+    }
+    munmap(journal->base, journal->size);
+    close(journal->fd);
+    delete journal;
+}
+
+/**
+ * @brief 设置后续记录的放映场次
+ * @param journal 日志
+ * @param sessionId 场次标识，格式为 urn:uuid:xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+ * @return 成功返回0，格式错误返回-1（后续记录的场次为全零）
+ */
+int dms_breakpoint_journal_begin_session(struct DmsBreakpointJournal* journal, const char* sessionId) {
+    if (!journal || !sessionId) {
+        return -1;
+    }
+    if (!parse_uuid(sessionId, journal->sessionId)) {
+        LOGE("Session id is not a UUID: %s", sessionId);
+        memset(journal->sessionId, 0, sizeof(journal->sessionId));
+        return -1;
+    }
+    return 0;
+}
+
+static void append_record(DmsBreakpointJournal* journal, int64_t pos, int64_t pts, int64_t frame, uint32_t flags) {
+    DmsBreakpointRecord record;
+    record.sequence = journal->sequence.load(std::memory_order_relaxed) + 1;
+    memcpy(record.sessionId, journal->sessionId, sizeof(record.sessionId));
+    record.pos = pos;
+    record.pts = pts;
+    record.frame = frame;
+    record.utcMs = utc_ms();
+    record.flags = flags;
+    record.checksum = record_checksum(&record);
+
+    // 整条记录一次写入映射内存，断电时写了一半的记录由校验和识别
+    memcpy(&journal->records[record.sequence % journal->capacity], &record, sizeof(record));
+    journal->sequence.store(record.sequence, std::memory_order_release);
+}
+
+/**
+ * @brief 追加放映点。只写入映射内存，由落盘线程按周期同步；落盘周期为0时同步落盘
+ * @param journal 日志
+ * @param reel 分本序号（从0开始）
+ * @param pos 数据单元Pos
+ * @param pts 数据单元PTS
+ * @param frame 分本内帧号，未知填-1
+ */
+void dms_breakpoint_journal_append(struct DmsBreakpointJournal* journal, int reel, int64_t pos, int64_t pts,
+                                   int64_t frame) {
+    if (!journal) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(journal->recordMutex);
+        append_record(journal, pos, pts, frame, (uint32_t)reel << DMS_BREAKPOINT_REEL_SHIFT);
+    }
+    if (journal->syncIntervalMs == 0) {
+        do_sync(journal);
+    }
+}
+
+/**
+ * @brief 登记已取出、尚未显示的放映点，显示后由dms_breakpoint_journal_presented追加为记录。
+ *        登记数超过上限时丢弃最早的登记
+ * @param journal 日志
+ * @param timeUs 该帧的输出时间戳，显示端以同一时间戳确认
+ * @param reel 分本序号（从0开始）
+ * @param pos 数据单元Pos
+ * @param pts 数据单元PTS
+ * @param frame 分本内帧号，未知填-1
+ */
+void dms_breakpoint_journal_stage(struct DmsBreakpointJournal* journal, int64_t timeUs, int reel, int64_t pos,
+                                  int64_t pts, int64_t frame) {
+    if (!journal) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(journal->recordMutex);
+    if (journal->staged.size() >= kMaxStaged) {
+        journal->staged.pop_front();
+    }
+    journal->staged.push_back({ timeUs, reel, pos, pts, frame });
+}
+
+/**
+ * @brief 帧已显示：追加该时间戳最近一次登记的放映点，并丢弃在它之前登记的（已显示、被丢弃或跳转作废的）
+ * @param journal 日志
+ * @param timeUs 已显示帧的输出时间戳
+ * @return 已追加返回0，没有该时间戳的登记返回1，参数错误返回-1
+ */
+int dms_breakpoint_journal_presented(struct DmsBreakpointJournal* journal, int64_t timeUs) {
+    if (!journal) {
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(journal->recordMutex);
+        // 从最新的登记找起：跳转后时间戳可能与作废的旧登记相同
+        size_t i = journal->staged.size();
+        while (i > 0 && journal->staged[i - 1].timeUs != timeUs) {
+            i--;
+        }
+        if (i == 0) {
+            return 1;
+        }
+        StagedPoint point = journal->staged[i - 1];
+        journal->staged.erase(journal->staged.begin(), journal->staged.begin() + i);
+        append_record(journal, point.pos, point.pts, point.frame, (uint32_t)point.reel << DMS_BREAKPOINT_REEL_SHIFT);
+    }
+    if (journal->syncIntervalMs == 0) {
+        do_sync(journal);
+    }
+    return 0;
+}
+
+/**
+ * @brief 记录放映结束（正常结束或主动停止）并立即落盘，之后恢复时不再续播
+ * @param journal 日志
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_breakpoint_journal_end_session(struct DmsBreakpointJournal* journal) {
+    if (!journal) {
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(journal->recordMutex);
+        journal->staged.clear();
+        const DmsBreakpointRecord* last = find_last(journal);
+        if (last && (last->flags & DMS_BREAKPOINT_FLAG_ENDED)) {
+            return 0;
+        }
+        append_record(journal, last ? last->pos : -1, last ? last->pts : -1, last ? last->frame : -1,
+                      (last ? last->flags : 0) | DMS_BREAKPOINT_FLAG_ENDED);
+    }
+    return do_sync(journal);
+}
+
+/**
+ * @brief 立即落盘
+ * @param journal 日志
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_breakpoint_journal_sync(struct DmsBreakpointJournal* journal) {
+    if (!journal) {
+        return -1;
+    }
+    return do_sync(journal);
+}
+
+/**
+ * @brief 取最后一条有效记录（只扫描固定大小的槽位区，耗时为微秒级）
+ * @param journal 日志
+ * @param outRecord 输出记录
+ * @return 找到返回0，日志为空返回1，参数错误返回-1
+ */
+int dms_breakpoint_journal_recover(struct DmsBreakpointJournal* journal, struct DmsBreakpointRecord* outRecord) {
+    if (!journal || !outRecord) {
+        return -1;
+    }
+    const DmsBreakpointRecord* last = find_last(journal);
+    if (!last) {
+        return 1;
+    }
+    *outRecord = *last;
+    return 0;
+}
+
+/**
+ * @brief 生成随机放映场次标识（UUID v4）
+ * @param out 输出缓冲区，至少DMS_BREAKPOINT_SESSION_ID_LEN字节
+ * @param size 缓冲区大小
+ * @return 成功返回0，失败返回-1
+ */
+int dms_breakpoint_make_session_id(char* out, int size) {
+    if (!out || size < DMS_BREAKPOINT_SESSION_ID_LEN) {
+        return -1;
+    }
+    uint8_t b[16];
+    bool random = false;
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        random = read(fd, b, sizeof(b)) == (ssize_t)sizeof(b);
+        close(fd);
+    }
+    if (!random) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        srand((unsigned)(ts.tv_sec ^ ts.tv_nsec ^ getpid()));
+        for (uint8_t& v : b) {
+            v = (uint8_t)(rand() & 0xFF);
+        }
+    }
+    b[6] = (uint8_t)((b[6] & 0x0F) | 0x40);
+    b[8] = (uint8_t)((b[8] & 0x3F) | 0x80);
+    snprintf(out, size, "urn:uuid:%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+             b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7],
+             b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
+    return 0;
+}
+
+/**
+ * @brief 将记录中的场次UUID转为 urn:uuid: 格式字符串
+ * @param record 断点记录
+ * @param out 输出缓冲区，至少DMS_BREAKPOINT_SESSION_ID_LEN字节
+ * @param size 缓冲区大小
+ * @return 成功返回0，失败返回-1
+ */
+int dms_breakpoint_format_session_id(const struct DmsBreakpointRecord* record, char* out, int size) {
+    if (!record || !out || size < DMS_BREAKPOINT_SESSION_ID_LEN) {
+        return -1;
+    }
+    const uint8_t* b = record->sessionId;
+    snprintf(out, size, "urn:uuid:%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+             b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7],
+             b[8], b[9], b[10], b[11], b[12], b[13], b[14], b[15]);
+    return 0;
+}
+
+/**
+ * @brief UTC毫秒转为 _dms_set_playback_break 所需的 yyyy-mm-dd HH:MM:SS 格式
+ * @param utcMs UTC时间（毫秒）
+ * @param out 输出缓冲区，至少20字节
+ * @param size 缓冲区大小
+ * @return 成功返回0，失败返回-1
+ */
+int dms_breakpoint_format_utc(int64_t utcMs, char* out, int size) {
+    if (!out || size < 20) {
+        return -1;
+    }
+    time_t seconds = (time_t)(utcMs / 1000);
+    struct tm tm;
+    if (!gmtime_r(&seconds, &tm)) {
+        return -1;
+    }
+    strftime(out, size, "%Y-%m-%d %H:%M:%S", &tm);
+    return 0;
+}
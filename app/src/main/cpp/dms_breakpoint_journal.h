@@ -0,0 +1,83 @@
+#ifndef DMS_BREAKPOINT_JOURNAL_H
+#define DMS_BREAKPOINT_JOURNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 断点续播日志
+ *
+ * libdms 要求正常播放时实时记录放映点，断电后再次开机时以记录的断点调用
+ * _dms_set_playback_break 与 _dms_goto_pos(pos, true)。日志文件为固定大小的
+ * 环形记录区，通过 mmap 映射：每显示一帧只向映射内存写入一条记录（不产生系统调用），
+ * 由后台线程按设定周期 msync + fdatasync 落盘。每条记录带 CRC32 校验，
+ * 断电时写了一半的记录会被识别并跳过，恢复时取序号最大的有效记录。
+ *
+ * 取帧领先于显示（预读、并行解码、渲染帧槽，ExoPlayer还会缓冲数十秒），取帧时只以输出时间戳
+ * 登记放映点，显示端在帧实际显示后以同一时间戳确认，才追加为记录，续播不会越过观众未看到的内容。
+ *
+ * 文件布局：64字节文件头 + capacity × 64字节记录，记录写入 sequence % capacity 号槽位
+ */
+
+#define DMS_BREAKPOINT_MAGIC "DMSBKJ01"
+#define DMS_BREAKPOINT_VERSION 1
+#define DMS_BREAKPOINT_DEFAULT_CAPACITY 256
+#define DMS_BREAKPOINT_SESSION_ID_LEN 46     // "urn:uuid:" + 36字符UUID + '\0'
+
+#define DMS_BREAKPOINT_FLAG_ENDED 0x1        // 放映正常结束（或主动停止），不需续播
+#define DMS_BREAKPOINT_REEL_SHIFT 16         // flags高16位为分本序号（pos与frame均为该分本内的值）
+#define DMS_BREAKPOINT_REEL(flags) ((int)((flags) >> DMS_BREAKPOINT_REEL_SHIFT))
+
+// 日志文件头
+struct DmsBreakpointHeader {
+    char magic[8];           // DMS_BREAKPOINT_MAGIC
+    uint32_t version;        // DMS_BREAKPOINT_VERSION
+    uint32_t recordSize;     // sizeof(DmsBreakpointRecord)
+    uint32_t capacity;       // 记录槽位数
+    uint32_t reserved[10];
+    uint32_t checksum;       // 以上字段的CRC32
+};
+
+// 断点记录
+struct DmsBreakpointRecord {
+    uint64_t sequence;       // 递增序号，0表示空槽位
+    uint8_t sessionId[16];   // 放映场次UUID
+    int64_t pos;             // 数据单元Pos
+    int64_t pts;             // 数据单元PTS
+    int64_t frame;           // 分本内帧号，未知为-1
+    int64_t utcMs;           // 记录时的UTC时间（毫秒）
+    uint32_t flags;          // DMS_BREAKPOINT_FLAG_*，高16位为分本序号
+    uint32_t checksum;       // 以上字段的CRC32
+};
+
+struct DmsBreakpointJournal;
+
+struct DmsBreakpointJournal* dms_breakpoint_journal_open(const char* path, int capacity,
+                                                         int syncIntervalMs); // 打开/创建日志，syncIntervalMs为0时每条记录同步落盘
+void dms_breakpoint_journal_close(struct DmsBreakpointJournal* journal);      // 落盘并关闭
+int dms_breakpoint_journal_begin_session(struct DmsBreakpointJournal* journal,
+                                         const char* sessionId);              // 设置后续记录的放映场次
+void dms_breakpoint_journal_append(struct DmsBreakpointJournal* journal, int reel, int64_t pos,
+                                   int64_t pts, int64_t frame);               // 追加放映点（只写内存）
+void dms_breakpoint_journal_stage(struct DmsBreakpointJournal* journal, int64_t timeUs, int reel,
+                                  int64_t pos, int64_t pts, int64_t frame);   // 登记已取出、尚未显示的放映点
+int dms_breakpoint_journal_presented(struct DmsBreakpointJournal* journal,
+                                     int64_t timeUs);                         // 帧已显示，追加其登记的放映点
+int dms_breakpoint_journal_end_session(struct DmsBreakpointJournal* journal); // 记录放映结束并立即落盘
+int dms_breakpoint_journal_sync(struct DmsBreakpointJournal* journal);        // 立即落盘
+int dms_breakpoint_journal_recover(struct DmsBreakpointJournal* journal,
+                                   struct DmsBreakpointRecord* outRecord);    // 取最后一条有效记录
+int dms_breakpoint_make_session_id(char* out, int size);                      // 生成随机放映场次标识
+int dms_breakpoint_format_session_id(const struct DmsBreakpointRecord* record, char* out,
+                                     int size);                               // 记录中的场次UUID转为字符串
+int dms_breakpoint_format_utc(int64_t utcMs, char* out, int size);            // UTC毫秒转为 yyyy-mm-dd HH:MM:SS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_BREAKPOINT_JOURNAL_H
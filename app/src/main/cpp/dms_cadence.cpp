@@ -0,0 +1,263 @@
+#include "dms_cadence.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+static const int32_t kRelockSlips = 3;     // 连续滑移达到此次数时重新锁定
+static const double kPeriodAlpha = 0.05;   // 刷新周期估计的滑动平均系数
+
+static int64_t gcd64(int64_t a, int64_t b) {
+    while (b != 0) {
+        int64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// 向下取整的整数除法，被除数可为负
+static int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/**
+ * @brief 分母不超过maxDen的最佳近似分数（连分数渐近分数）
+ * @param p 分子
+ * @param q 分母
+ * @param maxDen 分母上限
+ * @param outP 输出近似分数的分子
+ * @param outQ 输出近似分数的分母
+ */
+static void approximate(int64_t p, int64_t q, int64_t maxDen, int64_t* outP, int64_t* outQ) {
+    int64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+    int64_t num = p, den = q;
+    while (den != 0) {
+        int64_t a = num / den;
+        int64_t p2 = a * p1 + p0;
+        int64_t q2 = a * q1 + q0;
+        if (q2 > maxDen) {
+            break;
+        }
+        p0 = p1;
+        q0 = q1;
+        p1 = p2;
+        q1 = q2;
+        int64_t rem = num - a * den;
+        num = den;
+        den = rem;
+    }
+    *outP = p1;
+    *outQ = q1;
+}
+
+/**
+ * @brief 帧自锁定起开始显示的刷新序号
+ * @param cadence 节奏规划器
+ * @param frame 帧号
+ * @return 刷新序号，锁定帧为0
+ */
+static int64_t vsync_of(const struct DmsCadence* cadence, int64_t frame) {
+    int64_t k = frame - cadence->anchorFrame;
+    int64_t cycles = floor_div(k, cadence->patternFrames);
+    int64_t rem = k - cycles * cadence->patternFrames;
+    return cycles * cadence->patternVsyncs + cadence->starts[rem];
+}
+
+/**
+ * @brief 按帧率与刷新率计算节奏：一个周期内第i帧保持 floor((i+1)·R/F) - floor(i·R/F) 次刷新，
+ *        R/F为刷新率与帧率之比化简后的分数；周期超过DMS_CADENCE_MAX_PATTERN帧时取最接近的分数。
+ *        计算后处于未锁定状态，统计清零
+ * @param cadence 节奏规划器
+ * @param editRateNum 帧率分子（如24、24000）
+ * @param editRateDen 帧率分母（如1、1001）
+ * @param refreshHz 屏幕刷新率（Hz），59.94等按整数/1.001处理，其余按千分之一赫兹取整
+ * @return 成功返回0，参数错误返回-1，每帧保持的刷新次数超过255返回-3
+ */
+int dms_cadence_plan(struct DmsCadence* cadence, int32_t editRateNum, int32_t editRateDen, float refreshHz) {
+    if (!cadence || editRateNum <= 0 || editRateDen <= 0 || !(refreshHz > 0.0f)) {
+        return -1;
+    }
+    memset(cadence, 0, sizeof(*cadence));
+    // 刷新率化为分数：59.94、119.88等按惯例标称的刷新率实为整数/1.001，其余按千分之一赫兹取整
+    int64_t refreshNum = llround((double)refreshHz * 1000.0);
+    int64_t refreshDen = 1000;
+    double ntsc = (double)refreshHz * 1.001;
+    if (fabs(ntsc - floor(ntsc + 0.5)) < 0.005 && fabs(refreshHz - floorf(refreshHz + 0.5f)) > 0.01f) {
+        refreshNum = llround(ntsc) * 1000;
+        refreshDen = 1001;
+    }
+    if (refreshNum <= 0) {
+        return -1;
+    }
+    // 每帧的刷新次数 = 刷新率 / 帧率 = (refreshNum / refreshDen)·den / num
+    int64_t p = refreshNum * editRateDen;
+    int64_t q = refreshDen * editRateNum;
+    int64_t g = gcd64(p, q);
+    p /= g;
+    q /= g;
+    cadence->exact = q <= DMS_CADENCE_MAX_PATTERN;
+    if (!cadence->exact) {
+        approximate(p, q, DMS_CADENCE_MAX_PATTERN, &p, &q);
+    }
+    if (p / q + 1 > 255) {
+        return -3;
+    }
+
+    cadence->patternFrames = (int32_t)q;
+    cadence->patternVsyncs = (int32_t)p;
+    for (int64_t i = 0; i < q; i++) {
+        cadence->starts[i] = (int32_t)(i * p / q);
+        cadence->holds[i] = (uint8_t)((i + 1) * p / q - i * p / q);
+    }
+    cadence->starts[q] = (int32_t)p;
+    cadence->periodUs = 1000000.0 / refreshHz;
+    cadence->lastVsyncUs = -1;
+    cadence->stats.periodUs = (float)cadence->periodUs;
+    return 0;
+}
+
+/**
+ * @brief 节奏的文字形式，周期较长时截断并以"..."结尾
+ * @param cadence 节奏规划器
+ * @param buffer 输出缓冲区
+ * @param size 缓冲区字节数
+ * @return 成功返回0，参数错误或未规划返回-1
+ */
+int dms_cadence_pattern_string(const struct DmsCadence* cadence, char* buffer, int32_t size) {
+    if (!cadence || !buffer || size < 4 || cadence->patternFrames <= 0) {
+        return -1;
+    }
+    int32_t length = 0;
+    buffer[0] = '\0';
+    for (int32_t i = 0; i < cadence->patternFrames; i++) {
+        char item[8];
+        int n = snprintf(item, sizeof(item), i == 0 ? "%u" : ":%u", cadence->holds[i]);
+        if (length + n + 4 > size) {
+            strcpy(buffer + length, "...");
+            break;
+        }
+        memcpy(buffer + length, item, (size_t)n + 1);
+        length += n;
+    }
+    return 0;
+}
+
+/**
+ * @brief 锁定：该帧位于周期起点，在该次刷新开始显示
+ * @param cadence 节奏规划器
+ * @param frame 帧号
+ * @param vsyncUs 刷新时间戳（微秒）
+ */
+void dms_cadence_lock(struct DmsCadence* cadence, int64_t frame, int64_t vsyncUs) {
+    if (cadence->patternFrames <= 0) {
+        return;
+    }
+    cadence->locked = true;
+    cadence->anchorFrame = frame;
+    cadence->vsyncIndex = 0;
+    cadence->lastVsyncUs = vsyncUs;
+    cadence->slipRun = 0;
+}
+
+/**
+ * @brief 解除锁定，刷新周期的估计保留
+ * @param cadence 节奏规划器
+ */
+void dms_cadence_unlock(struct DmsCadence* cadence) {
+    cadence->locked = false;
+    cadence->slipRun = 0;
+}
+
+/**
+ * @brief 每次刷新调用：按间隔估计刷新周期并统计漏掉的刷新；已锁定时核对实际显示的帧，
+ *        连续kRelockSlips次不符合节奏时以实际显示的帧重新锁定
+ * @param cadence 节奏规划器
+ * @param vsyncUs 刷新时间戳（微秒）
+ * @param shownFrame 该次刷新上实际显示的帧号，未知为-1
+ * @return 符合节奏或未锁定返回0，滑移返回1
+ */
+int dms_cadence_vsync(struct DmsCadence* cadence, int64_t vsyncUs, int64_t shownFrame) {
+    if (cadence->patternFrames <= 0) {
+        return 0;
+    }
+    int64_t advance = 0;
+    if (cadence->lastVsyncUs >= 0) {
+        int64_t intervalUs = vsyncUs - cadence->lastVsyncUs;
+        if (intervalUs <= 0) {
+            return 0;
+        }
+        advance = llround((double)intervalUs / cadence->periodUs);
+        if (advance <= 1) {
+            advance = 1;
+            cadence->periodUs += kPeriodAlpha * ((double)intervalUs - cadence->periodUs);
+            cadence->stats.periodUs = (float)cadence->periodUs;
+        } else {
+            cadence->stats.missedVsyncs += advance - 1;
+        }
+    }
+    cadence->lastVsyncUs = vsyncUs;
+    cadence->stats.vsyncs++;
+    if (!cadence->locked) {
+        return 0;
+    }
+    cadence->vsyncIndex += advance;
+    if (shownFrame < 0 || shownFrame == dms_cadence_frame_at(cadence, cadence->vsyncIndex)) {
+        cadence->slipRun = 0;
+        return 0;
+    }
+    cadence->stats.slips++;
+    if (++cadence->slipRun >= kRelockSlips) {
+        dms_cadence_lock(cadence, shownFrame, vsyncUs);
+        cadence->stats.relocks++;
+    }
+    return 1;
+}
+
+/**
+ * @brief 锁定后第vsyncIndex次刷新应显示的帧
+ * @param cadence 节奏规划器
+ * @param vsyncIndex 自锁定起的刷新序号
+ * @return 帧号，未规划或未锁定返回-1
+ */
+int64_t dms_cadence_frame_at(const struct DmsCadence* cadence, int64_t vsyncIndex) {
+    if (cadence->patternFrames <= 0 || !cadence->locked) {
+        return -1;
+    }
+    int64_t cycles = floor_div(vsyncIndex, cadence->patternVsyncs);
+    int64_t rem = vsyncIndex - cycles * cadence->patternVsyncs;
+    // 开始刷新序号不超过rem的最后一帧；保持0次的帧与下一帧开始序号相同，被跳过
+    const int32_t* end = cadence->starts + cadence->patternFrames + 1;
+    int64_t index = std::upper_bound(cadence->starts, end, (int32_t)rem) - cadence->starts - 1;
+    return cadence->anchorFrame + cycles * cadence->patternFrames + index;
+}
+
+/**
+ * @brief 帧保持的刷新次数，0表示按节奏不显示（帧率高于刷新率时）
+ * @param cadence 节奏规划器
+ * @param frame 帧号
+ * @return 刷新次数，未规划或未锁定返回1
+ */
+int32_t dms_cadence_frame_hold(const struct DmsCadence* cadence, int64_t frame) {
+    if (cadence->patternFrames <= 0 || !cadence->locked) {
+        return 1;
+    }
+    int64_t k = frame - cadence->anchorFrame;
+    int64_t rem = k - floor_div(k, cadence->patternFrames) * cadence->patternFrames;
+    return cadence->holds[rem];
+}
+
+/**
+ * @brief 帧按节奏开始显示的预计刷新时刻，由最近一次刷新与估计的周期推算
+ * @param cadence 节奏规划器
+ * @param frame 帧号
+ * @return 刷新时刻（微秒），未锁定返回-1
+ */
+int64_t dms_cadence_due_us(const struct DmsCadence* cadence, int64_t frame) {
+    if (cadence->patternFrames <= 0 || !cadence->locked || cadence->lastVsyncUs < 0) {
+        return -1;
+    }
+    return cadence->lastVsyncUs +
+           llround((double)(vsync_of(cadence, frame) - cadence->vsyncIndex) * cadence->periodUs);
+}
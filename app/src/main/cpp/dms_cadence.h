@@ -0,0 +1,76 @@
+#ifndef DMS_CADENCE_H
+#define DMS_CADENCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 显示刷新节奏规划
+ *
+ * 24fps影片在60Hz屏幕上每帧只能显示整数个刷新周期，稳定的做法是2:3交替（3:2下拉）。按连续的
+ * 媒体时钟提交帧时，帧的显示时刻恰好落在刷新边界附近，唤醒的微小抖动就决定该帧赶上哪一次刷新，
+ * 每帧保持的刷新次数随机变为2、3、4，形成不均匀的抖动（judder）。
+ *
+ * 规划器按影片帧率与屏幕刷新率预先计算一个周期内每帧保持的刷新次数（如24fps@60Hz为2:3，
+ * 25fps@50Hz为2，48fps@120Hz为2:3，48fps@60Hz为1:1:1:2），锁定后按刷新时间戳把每帧排在
+ * 固定的刷新上：
+ *   - dms_cadence_vsync 在每次刷新时调用（Choreographer的帧回调时间戳），按间隔估计刷新周期、
+ *     统计漏掉的刷新，并核对该次刷新上实际显示的帧是否符合节奏，不符合计为一次滑移；
+ *     连续滑移时以实际显示的帧重新锁定；
+ *   - dms_cadence_due_us 给出帧应在哪次刷新时显示的预计时刻，提交端在此之前半个刷新周期提交。
+ * 59.94Hz等刷新率按整数/1.001处理（24fps@59.94Hz周期为1001帧）；刷新率与帧率之比的周期超过
+ * DMS_CADENCE_MAX_PATTERN帧时（如实测的60.02Hz）取最接近的较短周期，长时间播放的偏差由滑移检测
+ * 与重新锁定吸收。
+ *
+ * 所有函数都由调用者传入时间戳，不读取时钟，可用合成的刷新序列测试。规划器不加锁，由调用者串行访问。
+ */
+
+#define DMS_CADENCE_MAX_PATTERN 1024   // 一个节奏周期的最多帧数
+
+// 节奏统计信息
+struct DmsCadenceStats {
+    int64_t vsyncs;          // 收到的刷新次数
+    int64_t missedVsyncs;    // 按间隔推算漏掉的刷新次数
+    int64_t slips;           // 实际显示的帧不符合节奏的刷新次数
+    int64_t relocks;         // 连续滑移后重新锁定的次数
+    float periodUs;          // 估计的刷新周期（微秒）
+};
+
+// 节奏规划器
+struct DmsCadence {
+    int32_t patternFrames;   // 一个周期的帧数，未规划为0
+    int32_t patternVsyncs;   // 一个周期的刷新次数
+    bool exact;              // 周期与帧率、刷新率之比完全一致（未取近似）
+    uint8_t holds[DMS_CADENCE_MAX_PATTERN]; // 周期内每帧保持的刷新次数，0表示该帧不显示
+    int32_t starts[DMS_CADENCE_MAX_PATTERN + 1]; // 周期内每帧开始显示的刷新序号
+    double periodUs;         // 估计的刷新周期（微秒）
+    bool locked;             // 已锁定
+    int64_t anchorFrame;     // 锁定时的帧号，位于周期起点
+    int64_t vsyncIndex;      // 最近一次刷新自锁定起的序号
+    int64_t lastVsyncUs;     // 最近一次刷新的时间戳，无为-1
+    int32_t slipRun;         // 连续滑移的刷新次数
+    struct DmsCadenceStats stats;
+};
+
+int dms_cadence_plan(struct DmsCadence* cadence, int32_t editRateNum, int32_t editRateDen,
+                     float refreshHz);                              // 按帧率与刷新率计算节奏
+int dms_cadence_pattern_string(const struct DmsCadence* cadence, char* buffer,
+                               int32_t size);                       // 节奏的文字形式，如"2:3"
+void dms_cadence_lock(struct DmsCadence* cadence, int64_t frame, int64_t vsyncUs); // 以该帧在该次刷新开始显示锁定
+void dms_cadence_unlock(struct DmsCadence* cadence);                // 解除锁定（开始播放、暂停、跳转）
+int dms_cadence_vsync(struct DmsCadence* cadence, int64_t vsyncUs,
+                      int64_t shownFrame);                          // 每次刷新调用，返回1表示滑移
+int64_t dms_cadence_frame_at(const struct DmsCadence* cadence,
+                             int64_t vsyncIndex);                   // 锁定后第vsyncIndex次刷新应显示的帧
+int32_t dms_cadence_frame_hold(const struct DmsCadence* cadence, int64_t frame); // 帧保持的刷新次数
+int64_t dms_cadence_due_us(const struct DmsCadence* cadence, int64_t frame); // 帧开始显示的预计刷新时刻，未锁定返回-1
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_CADENCE_H
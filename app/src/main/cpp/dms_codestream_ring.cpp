@@ -0,0 +1,256 @@
+#include "dms_codestream_ring.h"
+#include "dms_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+
+#define LOG_TAG "DmsCodestreamRing"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+struct RingEntry {
+    int64_t pos;
+    int64_t pts;
+    uint32_t length;
+    uint8_t* data;
+};
+
+struct DmsCodestreamRing {
+    std::deque<RingEntry> entries;   // 帧号连续，表头最早
+    int32_t reel;                    // 所在分本，空时为-1
+    int64_t firstFrame;              // 表头的帧号
+    struct DmsCodestreamRingStats stats;
+};
+
+/**
+ * @brief 清零并释放一帧的码流
+ * @param entry 缓存项
+ */
+static void wipe_entry(RingEntry& entry) {
+    memset(entry.data, 0, entry.length);
+    free(entry.data);
+    entry.data = nullptr;
+}
+
+// 同步统计中的帧范围，空时复位分本与起始帧号
+static void update_range(DmsCodestreamRing* ring) {
+    ring->stats.frames = (int32_t)ring->entries.size();
+    if (ring->entries.empty()) {
+        ring->reel = -1;
+        ring->firstFrame = -1;
+    }
+    ring->stats.reel = ring->reel;
+    ring->stats.firstFrame = ring->firstFrame;
+    ring->stats.lastFrame = ring->entries.empty() ? -1 : ring->firstFrame + (int64_t)ring->entries.size() - 1;
+}
+
+/**
+ * @brief 淘汰最早的帧，直到帧数与字节数均不超过上限
+ * @param ring 缓存
+ * @param extraBytes 即将放入的字节数
+ * @param extraFrames 即将放入的帧数
+ */
+static void evict(DmsCodestreamRing* ring, int64_t extraBytes, int32_t extraFrames) {
+    while (!ring->entries.empty() &&
+           ((ring->stats.limitFrames > 0 && (int64_t)ring->entries.size() + extraFrames > ring->stats.limitFrames) ||
+            (ring->stats.limitBytes > 0 && ring->stats.bytes + extraBytes > ring->stats.limitBytes))) {
+        RingEntry& oldest = ring->entries.front();
+        ring->stats.bytes -= oldest.length;
+        wipe_entry(oldest);
+        ring->entries.pop_front();
+        ring->firstFrame++;
+        ring->stats.evictions++;
+    }
+    update_range(ring);
+}
+
+/**
+ * @brief 创建码流缓存
+ * @param limitBytes 字节数上限，0为不限
+ * @param limitFrames 帧数上限，0为不限
+ * @return 成功返回缓存指针，参数错误返回NULL
+ */
+struct DmsCodestreamRing* dms_codestream_ring_create(int64_t limitBytes, int32_t limitFrames) {
+    if (limitBytes < 0 || limitFrames < 0 || (limitBytes == 0 && limitFrames == 0)) {
+        LOGE("Invalid limits: %lld bytes, %d frames", (long long)limitBytes, limitFrames);
+        return nullptr;
+    }
+    DmsCodestreamRing* ring = new DmsCodestreamRing();
+    ring->stats = {};
+    ring->stats.limitBytes = limitBytes;
+    ring->stats.limitFrames = limitFrames;
+    update_range(ring);
+    return ring;
+}
+
+/**
+ * @brief 清零并释放缓存
+ * @param ring 缓存
+ */
+void dms_codestream_ring_destroy(struct DmsCodestreamRing* ring) {
+    if (!ring) {
+        return;
+    }
+    LOGI("Codestream ring: %lld lookups, %lld hits, %lld evictions", (long long)ring->stats.lookups,
+         (long long)ring->stats.hits, (long long)ring->stats.evictions);
+    dms_codestream_ring_clear(ring);
+    delete ring;
+}
+
+/**
+ * @brief 清零并清空缓存，统计保留
+ * @param ring 缓存
+ */
+void dms_codestream_ring_clear(struct DmsCodestreamRing* ring) {
+    if (!ring) {
+        return;
+    }
+    for (RingEntry& entry : ring->entries) {
+        wipe_entry(entry);
+    }
+    ring->entries.clear();
+    ring->stats.bytes = 0;
+    update_range(ring);
+}
+
+/**
+ * @brief 设置上限，超出时淘汰最早的帧
+ * @param ring 缓存
+ * @param limitBytes 字节数上限，0为不限
+ * @param limitFrames 帧数上限，0为不限
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_codestream_ring_set_limits(struct DmsCodestreamRing* ring, int64_t limitBytes, int32_t limitFrames) {
+    if (!ring || limitBytes < 0 || limitFrames < 0 || (limitBytes == 0 && limitFrames == 0)) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    ring->stats.limitBytes = limitBytes;
+    ring->stats.limitFrames = limitFrames;
+    evict(ring, 0, 0);
+    return 0;
+}
+
+/**
+ * @brief 放入帧并复制码流。与最新帧相接时追加在末尾，已有该帧时忽略，
+ *        否则（定位、切换分本后）先清空再从该帧开始；超出上限时淘汰最早的帧
+ * @param ring 缓存
+ * @param reel 分本序号
+ * @param frame 分本内帧号
+ * @param unit 数据单元
+ * @return 成功返回0，参数错误返回-1，单帧超过字节数上限或内存不足返回-3
+ */
+int dms_codestream_ring_put(struct DmsCodestreamRing* ring, int32_t reel, int64_t frame, const DmsDataUnit* unit) {
+    if (!ring || reel < 0 || frame < 0 || !unit || !unit->Data || unit->Length == 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    if (dms_codestream_ring_contains(ring, reel, frame)) {
+        return 0;
+    }
+    if (ring->stats.limitBytes > 0 && (int64_t)unit->Length > ring->stats.limitBytes) {
+        dms_codestream_ring_clear(ring);
+        return -3;
+    }
+    int64_t next = ring->entries.empty() ? -1 : ring->firstFrame + (int64_t)ring->entries.size();
+    if (reel != ring->reel || frame != next) {
+        dms_codestream_ring_clear(ring);
+    }
+
+    RingEntry entry;
+    entry.pos = unit->Pos;
+    entry.pts = unit->PTS;
+    entry.length = unit->Length;
+    entry.data = (uint8_t*)malloc(unit->Length);
+    if (!entry.data) {
+        LOGE("Out of memory: %u bytes", unit->Length);
+        dms_codestream_ring_clear(ring);
+        return -3;
+    }
+    memcpy(entry.data, unit->Data, unit->Length);
+    evict(ring, unit->Length, 1);
+    if (ring->entries.empty()) {
+        ring->reel = reel;
+        ring->firstFrame = frame;
+    }
+    ring->entries.push_back(entry);
+    ring->stats.bytes += unit->Length;
+    ring->stats.insertions++;
+    update_range(ring);
+    return 0;
+}
+
+/**
+ * @brief 是否有该帧，不计入统计
+ * @param ring 缓存
+ * @param reel 分本序号
+ * @param frame 分本内帧号
+ * @return 有返回true
+ */
+bool dms_codestream_ring_contains(struct DmsCodestreamRing* ring, int32_t reel, int64_t frame) {
+    return ring && !ring->entries.empty() && reel == ring->reel && frame >= ring->firstFrame &&
+           frame < ring->firstFrame + (int64_t)ring->entries.size();
+}
+
+/**
+ * @brief 取出帧的副本，缓存中的帧保留
+ * @param ring 缓存
+ * @param reel 分本序号
+ * @param frame 分本内帧号
+ * @param outUnit 输出数据单元，使用后由dms_codestream_ring_release_unit释放
+ * @return 成功返回0，参数错误返回-1，未命中返回1，内存不足返回-3
+ */
+int dms_codestream_ring_take(struct DmsCodestreamRing* ring, int32_t reel, int64_t frame, DmsDataUnitPtr* outUnit) {
+    if (!ring || !outUnit) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outUnit = nullptr;
+    ring->stats.lookups++;
+    if (!dms_codestream_ring_contains(ring, reel, frame)) {
+        return 1;
+    }
+    const RingEntry& entry = ring->entries[(size_t)(frame - ring->firstFrame)];
+    // 数据单元与码流一次分配，码流紧随其后
+    DmsDataUnit* unit = (DmsDataUnit*)malloc(sizeof(DmsDataUnit) + entry.length);
+    if (!unit) {
+        LOGE("Out of memory: %u bytes", entry.length);
+        return -3;
+    }
+    unit->Pos = entry.pos;
+    unit->PTS = entry.pts;
+    unit->Length = entry.length;
+    unit->Data = (uint8_t*)(unit + 1);
+    memcpy(unit->Data, entry.data, entry.length);
+    ring->stats.hits++;
+    *outUnit = unit;
+    return 0;
+}
+
+/**
+ * @brief 清零并释放dms_codestream_ring_take取出的数据单元
+ * @param unit 数据单元，释放后置空
+ */
+void dms_codestream_ring_release_unit(DmsDataUnitPtr* unit) {
+    if (!unit || !*unit) {
+        return;
+    }
+    memset((*unit)->Data, 0, (*unit)->Length);
+    free(*unit);
+    *unit = nullptr;
+}
+
+/**
+ * @brief 获取统计信息
+ * @param ring 缓存
+ * @param outStats 输出统计信息
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_codestream_ring_get_stats(struct DmsCodestreamRing* ring, struct DmsCodestreamRingStats* outStats) {
+    if (!ring || !outStats) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outStats = ring->stats;
+    return 0;
+}
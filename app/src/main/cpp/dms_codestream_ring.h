@@ -0,0 +1,66 @@
+#ifndef DMS_CODESTREAM_RING_H
+#define DMS_CODESTREAM_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "libdms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 码流缓存
+ *
+ * 保留正常播放时最近读取的一段连续帧的码流（DmsDataUnit的Data及其Pos、PTS），按帧数
+ * （秒数×帧率）与字节数两个上限淘汰最早的帧。一帧2K解码画面约12MB，而J2K码流约1MB，
+ * 同样的内存可保留约十倍时长的历史。小范围后退与重放落在缓存内时直接取码流，
+ * 不调用_dms_goto_pos、不读存储。
+ *
+ * 只保留单一分本内帧号连续的一段：放入的帧与最新帧不相接（定位、切换分本）时先清空。
+ * 码流为解密后的明文，淘汰与清空时清零。取出的数据单元是副本，
+ * 由dms_codestream_ring_release_unit释放（不能交给_dms_free_data_unit）。
+ * 缓存由播放器的取帧线程使用，不加锁。
+ */
+
+#define DMS_CODESTREAM_RING_DEFAULT_SECONDS 10.0f
+#define DMS_CODESTREAM_RING_DEFAULT_BYTES (96LL * 1024 * 1024)
+
+// 缓存统计信息
+struct DmsCodestreamRingStats {
+    int64_t lookups;         // 取帧次数
+    int64_t hits;            // 命中次数
+    int64_t insertions;      // 放入帧数
+    int64_t evictions;       // 因容量淘汰的帧数
+    int64_t bytes;           // 当前占用的字节数
+    int64_t limitBytes;      // 字节数上限，0为不限
+    int32_t limitFrames;     // 帧数上限，0为不限
+    int32_t frames;          // 当前帧数
+    int32_t reel;            // 所在分本，空时为-1
+    int64_t firstFrame;      // 最早一帧的分本内帧号，空时为-1
+    int64_t lastFrame;       // 最新一帧的分本内帧号，空时为-1
+};
+
+struct DmsCodestreamRing;
+
+struct DmsCodestreamRing* dms_codestream_ring_create(int64_t limitBytes,
+                                                     int32_t limitFrames); // 创建缓存，两个上限不能都为0
+void dms_codestream_ring_destroy(struct DmsCodestreamRing* ring);          // 清零并释放缓存
+void dms_codestream_ring_clear(struct DmsCodestreamRing* ring);            // 清零并清空缓存
+int dms_codestream_ring_set_limits(struct DmsCodestreamRing* ring, int64_t limitBytes,
+                                   int32_t limitFrames);                   // 设置上限，超出时淘汰最早的帧
+int dms_codestream_ring_put(struct DmsCodestreamRing* ring, int32_t reel, int64_t frame,
+                            const DmsDataUnit* unit);                      // 放入帧（复制码流）
+bool dms_codestream_ring_contains(struct DmsCodestreamRing* ring, int32_t reel,
+                                  int64_t frame);                          // 是否有该帧，不计入统计
+int dms_codestream_ring_take(struct DmsCodestreamRing* ring, int32_t reel, int64_t frame,
+                             DmsDataUnitPtr* outUnit);                     // 取出帧的副本
+void dms_codestream_ring_release_unit(DmsDataUnitPtr* unit);               // 释放取出的副本
+int dms_codestream_ring_get_stats(struct DmsCodestreamRing* ring,
+                                  struct DmsCodestreamRingStats* outStats); // 获取统计信息
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_CODESTREAM_RING_H
@@ -0,0 +1,1040 @@
+#include "dms_color.h"
+#include "dms_j2k_decoder.h"
+#include "dms_log.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DMS_COLOR_X86 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define DMS_COLOR_NEON 1
+#endif
+
+#define LOG_TAG "DmsColor"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int kLutSize = 4096;
+static const int kMatrixShift = 12;              // 矩阵系数为Q12定点
+static const int32_t kMatrixRound = 1 << (kMatrixShift - 1);
+static const int32_t kLinearMax = 65535;         // 线性值为16位定点
+static const int kEncodeShift = 4;               // 16位线性值取高12位查编码表
+static const double kDciNormalize = 52.37 / 48.0;
+static const int kGridShift = 12;                // 3D LUT网格坐标为Q12定点
+static const int kNodeShift = 6;                 // 3D LUT节点为显示码值乘64
+static const int kLutShift = kGridShift + kNodeShift;
+static const int32_t kLutRound = 1 << (kLutShift - 1);
+static const double kCompressThreshold = 0.8;    // 到消色轴的距离超过此值开始压缩
+static const double kCompressPower = 1.2;        // 压缩曲线的幂
+
+// 3D LUT：节点按.cube的顺序排列，红分量变化最快
+struct DmsColorLut {
+    int32_t size;
+    int32_t inputSpace;               // 输入色彩空间，DmsColorSpace
+    float domainMin[3];
+    float domainMax[3];
+    std::vector<float> nodes;         // size³个节点的R、G、B（0~1）
+};
+
+struct DmsColorConverter {
+    int32_t kernel;
+    int32_t format;
+    int32_t maxCode;                  // 输入码值上限
+    int32_t matrix[9];                // 行优先的XYZ到RGB矩阵（Q12）
+    int32_t linearize[kLutSize];      // 输入码值 -> 16位线性值
+    int32_t encode[kLutSize];         // 12位线性值 -> 显示码值（8位或10位）
+    int32_t encodeShift[3];           // R、G、B在像素中的位移
+    uint32_t alpha;                   // 不透明的Alpha位
+    int32_t lutSize;                  // 3D LUT每边的节点数，无LUT为0
+    int32_t lutStride[3];             // R、G、B方向相邻节点在lutNodes中的间隔
+    int32_t shaper[3][kLutSize];      // 12位线性值 -> 各分量的网格坐标（Q12）
+    std::vector<int32_t> lutNodes;    // 每节点4项：R、G、B的显示码值（乘64）与填充
+};
+
+// XYZ到线性RGB的矩阵，原色为Rec.709与P3，白点均为D65
+static const double kXyzToRec709[9] = {
+    3.2404542, -1.5371385, -0.4985314,
+    -0.9692660, 1.8760108, 0.0415560,
+    0.0556434, -0.2040259, 1.0572252,
+};
+static const double kXyzToP3D65[9] = {
+    2.4934969, -0.9313836, -0.4027108,
+    -0.8294890, 1.7626641, 0.0236247,
+    0.0358458, -0.0761724, 0.9568845,
+};
+
+/**
+ * @brief 线性值到显示信号的传递函数
+ * @param colorSpace 输出色彩空间
+ * @param linear 线性值（0~1）
+ * @return 显示信号（0~1）
+ */
+static double encode_transfer(int colorSpace, double linear) {
+    switch (colorSpace) {
+        case DMS_COLOR_SRGB:
+        case DMS_COLOR_DISPLAY_P3:
+            return linear <= 0.0031308 ? linear * 12.92 : 1.055 * pow(linear, 1.0 / 2.4) - 0.055;
+        case DMS_COLOR_BT709:
+            return pow(linear, 1.0 / 2.4);
+        default:
+            return pow(linear, 1.0 / 2.6);
+    }
+}
+
+/**
+ * @brief 显示信号到线性值的传递函数，encode_transfer的逆
+ * @param colorSpace 色彩空间
+ * @param signal 显示信号（0~1）
+ * @return 线性值（0~1）
+ */
+static double decode_transfer(int colorSpace, double signal) {
+    switch (colorSpace) {
+        case DMS_COLOR_SRGB:
+        case DMS_COLOR_DISPLAY_P3:
+            return signal <= 0.04045 ? signal / 12.92 : pow((signal + 0.055) / 1.055, 2.4);
+        case DMS_COLOR_BT709:
+            return pow(signal, 2.4);
+        default:
+            return pow(signal, 2.6);
+    }
+}
+
+// 色彩空间的XYZ到线性RGB矩阵
+static const double* xyz_to_rgb(int colorSpace) {
+    return (colorSpace == DMS_COLOR_SRGB || colorSpace == DMS_COLOR_BT709) ? kXyzToRec709 : kXyzToP3D65;
+}
+
+static inline int32_t clamp_i32(int32_t value, int32_t low, int32_t high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+// 标量参考实现：单个分量的矩阵行乘并截断，返回12位线性值
+static inline int32_t linear_channel(const int32_t* row, int32_t lx, int32_t ly, int32_t lz) {
+    int32_t value = (row[0] * lx + row[1] * ly + row[2] * lz + kMatrixRound) >> kMatrixShift;
+    return clamp_i32(value, 0, kLinearMax) >> kEncodeShift;
+}
+
+// 标量参考实现：单个分量的矩阵行乘、截断并查编码表
+static inline uint32_t encode_channel(const DmsColorConverter* c, const int32_t* row, int32_t lx, int32_t ly,
+                                      int32_t lz, int channel) {
+    return (uint32_t)c->encode[linear_channel(row, lx, ly, lz)] << c->encodeShift[channel];
+}
+
+static void convert_row_scalar(const DmsColorConverter* c, const int32_t* x, const int32_t* y, const int32_t* z,
+                               int width, uint32_t* out) {
+    for (int i = 0; i < width; i++) {
+        int32_t lx = c->linearize[clamp_i32(x[i], 0, c->maxCode)];
+        int32_t ly = c->linearize[clamp_i32(y[i], 0, c->maxCode)];
+        int32_t lz = c->linearize[clamp_i32(z[i], 0, c->maxCode)];
+        out[i] = c->alpha |
+                 encode_channel(c, c->matrix + 0, lx, ly, lz, 0) |
+                 encode_channel(c, c->matrix + 3, lx, ly, lz, 1) |
+                 encode_channel(c, c->matrix + 6, lx, ly, lz, 2);
+    }
+}
+
+/**
+ * @brief 标量参考实现：按三个分量的网格坐标做四面体插值。网格单元按分数从大到小的轴顺序分成
+ *        六个四面体，沿该顺序经过的四个顶点c0~c3插值：c0 + fmax(c1-c0) + fmid(c2-c1) + fmin(c3-c2)
+ * @param c 转换器
+ * @param pr R的网格坐标（Q12）
+ * @param pg G的网格坐标（Q12）
+ * @param pb B的网格坐标（Q12）
+ * @return 打包的像素
+ */
+static inline uint32_t lut_pixel(const DmsColorConverter* c, int32_t pr, int32_t pg, int32_t pb) {
+    const int32_t* s = c->lutStride;
+    int32_t last = c->lutSize - 2;
+    int32_t ir = std::min(pr >> kGridShift, last);
+    int32_t ig = std::min(pg >> kGridShift, last);
+    int32_t ib = std::min(pb >> kGridShift, last);
+    int32_t fr = pr - (ir << kGridShift);
+    int32_t fg = pg - (ig << kGridShift);
+    int32_t fb = pb - (ib << kGridShift);
+    bool rg = fr >= fg, gb = fg >= fb, rb = fr >= fb;
+    int32_t o1 = (rg && rb) ? s[0] : (gb ? s[1] : s[2]);            // 分数最大的轴
+    int32_t o2 = s[0] + s[1] + s[2] - ((rb && gb) ? s[2] : (rg ? s[1] : s[0])); // 除分数最小的轴外两轴
+    int32_t fmax = std::max(std::max(fr, fg), fb);
+    int32_t fmin = std::min(std::min(fr, fg), fb);
+    int32_t fmid = fr + fg + fb - fmax - fmin;
+    const int32_t* n0 = c->lutNodes.data() + ir * s[0] + ig * s[1] + ib * s[2];
+    const int32_t* n1 = n0 + o1;
+    const int32_t* n2 = n0 + o2;
+    const int32_t* n3 = n0 + s[0] + s[1] + s[2];
+    uint32_t pixel = c->alpha;
+    for (int ch = 0; ch < 3; ch++) {
+        int32_t v = (n0[ch] << kGridShift) + fmax * (n1[ch] - n0[ch]) + fmid * (n2[ch] - n1[ch]) +
+                    fmin * (n3[ch] - n2[ch]) + kLutRound;
+        pixel |= (uint32_t)(v >> kLutShift) << c->encodeShift[ch];
+    }
+    return pixel;
+}
+
+static void convert_row_lut_scalar(const DmsColorConverter* c, const int32_t* x, const int32_t* y, const int32_t* z,
+                                   int width, uint32_t* out) {
+    for (int i = 0; i < width; i++) {
+        int32_t lx = c->linearize[clamp_i32(x[i], 0, c->maxCode)];
+        int32_t ly = c->linearize[clamp_i32(y[i], 0, c->maxCode)];
+        int32_t lz = c->linearize[clamp_i32(z[i], 0, c->maxCode)];
+        out[i] = lut_pixel(c, c->shaper[0][linear_channel(c->matrix + 0, lx, ly, lz)],
+                           c->shaper[1][linear_channel(c->matrix + 3, lx, ly, lz)],
+                           c->shaper[2][linear_channel(c->matrix + 6, lx, ly, lz)]);
+    }
+}
+
+#ifdef DMS_COLOR_X86
+__attribute__((target("sse4.1")))
+static inline __m128i sse_channel(const __m128i* m, __m128i lx, __m128i ly, __m128i lz) {
+    __m128i v = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi32(m[0], lx), _mm_mullo_epi32(m[1], ly)),
+                              _mm_add_epi32(_mm_mullo_epi32(m[2], lz), _mm_set1_epi32(kMatrixRound)));
+    v = _mm_srai_epi32(v, kMatrixShift);
+    v = _mm_min_epi32(_mm_max_epi32(v, _mm_setzero_si128()), _mm_set1_epi32(kLinearMax));
+    return _mm_srli_epi32(v, kEncodeShift);
+}
+
+__attribute__((target("sse4.1")))
+static void convert_row_sse41(const DmsColorConverter* c, const int32_t* x, const int32_t* y, const int32_t* z,
+                              int width, uint32_t* out) {
+    __m128i m[9];
+    for (int k = 0; k < 9; k++) {
+        m[k] = _mm_set1_epi32(c->matrix[k]);
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i maxCode = _mm_set1_epi32(c->maxCode);
+    alignas(16) int32_t idx[3][4];
+    alignas(16) int32_t lin[3][4];
+    int i = 0;
+    for (; i + 4 <= width; i += 4) {
+        const int32_t* src[3] = {x + i, y + i, z + i};
+        for (int ch = 0; ch < 3; ch++) {
+            __m128i v = _mm_loadu_si128((const __m128i*)src[ch]);
+            _mm_store_si128((__m128i*)idx[ch], _mm_min_epi32(_mm_max_epi32(v, zero), maxCode));
+            for (int k = 0; k < 4; k++) {
+                lin[ch][k] = c->linearize[idx[ch][k]];
+            }
+        }
+        __m128i lx = _mm_load_si128((const __m128i*)lin[0]);
+        __m128i ly = _mm_load_si128((const __m128i*)lin[1]);
+        __m128i lz = _mm_load_si128((const __m128i*)lin[2]);
+        __m128i pixel = _mm_set1_epi32((int32_t)c->alpha);
+        for (int ch = 0; ch < 3; ch++) {
+            _mm_store_si128((__m128i*)idx[ch], sse_channel(m + ch * 3, lx, ly, lz));
+            for (int k = 0; k < 4; k++) {
+                lin[ch][k] = c->encode[idx[ch][k]] << c->encodeShift[ch];
+            }
+            pixel = _mm_or_si128(pixel, _mm_load_si128((const __m128i*)lin[ch]));
+        }
+        _mm_storeu_si128((__m128i*)(out + i), pixel);
+    }
+    convert_row_scalar(c, x + i, y + i, z + i, width - i, out + i);
+}
+
+__attribute__((target("sse4.1")))
+static void convert_row_lut_sse41(const DmsColorConverter* c, const int32_t* x, const int32_t* y, const int32_t* z,
+                                  int width, uint32_t* out) {
+    __m128i m[9];
+    for (int k = 0; k < 9; k++) {
+        m[k] = _mm_set1_epi32(c->matrix[k]);
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i maxCode = _mm_set1_epi32(c->maxCode);
+    const __m128i last = _mm_set1_epi32(c->lutSize - 2);
+    const __m128i sr = _mm_set1_epi32(c->lutStride[0]);
+    const __m128i sg = _mm_set1_epi32(c->lutStride[1]);
+    const __m128i sb = _mm_set1_epi32(c->lutStride[2]);
+    const __m128i sSum = _mm_set1_epi32(c->lutStride[0] + c->lutStride[1] + c->lutStride[2]);
+    const int32_t* nodes = c->lutNodes.data();
+    alignas(16) int32_t idx[3][4];
+    alignas(16) int32_t lin[3][4];
+    alignas(16) int32_t corner[4][4];
+    alignas(16) int32_t value[4][4];
+    int i = 0;
+    for (; i + 4 <= width; i += 4) {
+        const int32_t* src[3] = {x + i, y + i, z + i};
+        for (int ch = 0; ch < 3; ch++) {
+            __m128i v = _mm_loadu_si128((const __m128i*)src[ch]);
+            _mm_store_si128((__m128i*)idx[ch], _mm_min_epi32(_mm_max_epi32(v, zero), maxCode));
+            for (int k = 0; k < 4; k++) {
+                lin[ch][k] = c->linearize[idx[ch][k]];
+            }
+        }
+        __m128i lx = _mm_load_si128((const __m128i*)lin[0]);
+        __m128i ly = _mm_load_si128((const __m128i*)lin[1]);
+        __m128i lz = _mm_load_si128((const __m128i*)lin[2]);
+        for (int ch = 0; ch < 3; ch++) {
+            _mm_store_si128((__m128i*)idx[ch], sse_channel(m + ch * 3, lx, ly, lz));
+            for (int k = 0; k < 4; k++) {
+                lin[ch][k] = c->shaper[ch][idx[ch][k]];
+            }
+        }
+        // 网格单元与四面体：各分量的整数坐标与分数，按分数大小选出经过的顶点
+        __m128i pr = _mm_load_si128((const __m128i*)lin[0]);
+        __m128i pg = _mm_load_si128((const __m128i*)lin[1]);
+        __m128i pb = _mm_load_si128((const __m128i*)lin[2]);
+        __m128i ir = _mm_min_epi32(_mm_srai_epi32(pr, kGridShift), last);
+        __m128i ig = _mm_min_epi32(_mm_srai_epi32(pg, kGridShift), last);
+        __m128i ib = _mm_min_epi32(_mm_srai_epi32(pb, kGridShift), last);
+        __m128i fr = _mm_sub_epi32(pr, _mm_slli_epi32(ir, kGridShift));
+        __m128i fg = _mm_sub_epi32(pg, _mm_slli_epi32(ig, kGridShift));
+        __m128i fb = _mm_sub_epi32(pb, _mm_slli_epi32(ib, kGridShift));
+        __m128i gtGR = _mm_cmpgt_epi32(fg, fr);
+        __m128i gtBR = _mm_cmpgt_epi32(fb, fr);
+        __m128i gtBG = _mm_cmpgt_epi32(fb, fg);
+        __m128i o1 = _mm_blendv_epi8(sr, _mm_blendv_epi8(sg, sb, gtBG), _mm_or_si128(gtGR, gtBR));
+        __m128i oMin = _mm_blendv_epi8(sb, _mm_blendv_epi8(sg, sr, gtGR), _mm_or_si128(gtBR, gtBG));
+        __m128i fmax = _mm_max_epi32(_mm_max_epi32(fr, fg), fb);
+        __m128i fmin = _mm_min_epi32(_mm_min_epi32(fr, fg), fb);
+        __m128i fmid = _mm_sub_epi32(_mm_sub_epi32(_mm_add_epi32(_mm_add_epi32(fr, fg), fb), fmax), fmin);
+        __m128i base = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi32(ir, sr), _mm_mullo_epi32(ig, sg)),
+                                     _mm_mullo_epi32(ib, sb));
+        _mm_store_si128((__m128i*)corner[0], base);
+        _mm_store_si128((__m128i*)corner[1], _mm_add_epi32(base, o1));
+        _mm_store_si128((__m128i*)corner[2], _mm_add_epi32(base, _mm_sub_epi32(sSum, oMin)));
+        _mm_store_si128((__m128i*)corner[3], _mm_add_epi32(base, sSum));
+        __m128i pixel = _mm_set1_epi32((int32_t)c->alpha);
+        for (int ch = 0; ch < 3; ch++) {
+            for (int n = 0; n < 4; n++) {
+                for (int k = 0; k < 4; k++) {
+                    value[n][k] = nodes[corner[n][k] + ch];
+                }
+            }
+            __m128i c0 = _mm_load_si128((const __m128i*)value[0]);
+            __m128i c1 = _mm_load_si128((const __m128i*)value[1]);
+            __m128i c2 = _mm_load_si128((const __m128i*)value[2]);
+            __m128i c3 = _mm_load_si128((const __m128i*)value[3]);
+            __m128i v = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(c0, kGridShift), _mm_set1_epi32(kLutRound)),
+                                      _mm_mullo_epi32(fmax, _mm_sub_epi32(c1, c0)));
+            v = _mm_add_epi32(_mm_add_epi32(v, _mm_mullo_epi32(fmid, _mm_sub_epi32(c2, c1))),
+                              _mm_mullo_epi32(fmin, _mm_sub_epi32(c3, c2)));
+            v = _mm_srli_epi32(v, kLutShift);
+            pixel = _mm_or_si128(pixel, _mm_sll_epi32(v, _mm_cvtsi32_si128(c->encodeShift[ch])));
+        }
+        _mm_storeu_si128((__m128i*)(out + i), pixel);
+    }
+    convert_row_lut_scalar(c, x + i, y + i, z + i, width - i, out + i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_channel(const __m256i* m, __m256i lx, __m256i ly, __m256i lz) {
+    __m256i v = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(m[0], lx), _mm256_mullo_epi32(m[1], ly)),
+                                 _mm256_add_epi32(_mm256_mullo_epi32(m[2], lz), _mm256_set1_epi32(kMatrixRound)));
+    v = _mm256_srai_epi32(v, kMatrixShift);
+    v = _mm256_min_epi32(_mm256_max_epi32(v, _mm256_setzero_si256()), _mm256_set1_epi32(kLinearMax));
+    return _mm256_srli_epi32(v, kEncodeShift);
+}
+
+__attribute__((target("avx2")))
+static void convert_row_avx2(const DmsColorConverter* c, const int32_t* x, const int32_t* y, const int32_t* z,
+                             int width, uint32_t* out) {
+    __m256i m[9];
+    for (int k = 0; k < 9; k++) {
+        m[k] = _mm256_set1_epi32(c->matrix[k]);
+    }
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i maxCode = _mm256_set1_epi32(c->maxCode);
+    const __m256i alpha = _mm256_set1_epi32((int32_t)c->alpha);
+    int i = 0;
+    for (; i + 8 <= width; i += 8) {
+        __m256i vx = _mm256_min_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i*)(x + i)), zero), maxCode);
+        __m256i vy = _mm256_min_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i*)(y + i)), zero), maxCode);
+        __m256i vz = _mm256_min_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i*)(z + i)), zero), maxCode);
+        __m256i lx = _mm256_i32gather_epi32(c->linearize, vx, 4);
+        __m256i ly = _mm256_i32gather_epi32(c->linearize, vy, 4);
+        __m256i lz = _mm256_i32gather_epi32(c->linearize, vz, 4);
+        __m256i r = _mm256_i32gather_epi32(c->encode, avx2_channel(m + 0, lx, ly, lz), 4);
+        __m256i g = _mm256_i32gather_epi32(c->encode, avx2_channel(m + 3, lx, ly, lz), 4);
+        __m256i b = _mm256_i32gather_epi32(c->encode, avx2_channel(m + 6, lx, ly, lz), 4);
+        __m256i pixel = _mm256_or_si256(_mm256_or_si256(alpha, _mm256_sll_epi32(r, _mm_cvtsi32_si128(c->encodeShift[0]))),
+                                        _mm256_or_si256(_mm256_sll_epi32(g, _mm_cvtsi32_si128(c->encodeShift[1])),
+                                                        _mm256_sll_epi32(b, _mm_cvtsi32_si128(c->encodeShift[2]))));
+        _mm256_storeu_si256((__m256i*)(out + i), pixel);
+    }
+    convert_row_scalar(c, x + i, y + i, z + i, width - i, out + i);
+}
+
+__attribute__((target("avx2")))
+static void convert_row_lut_avx2(const DmsColorConverter* c, const int32_t* x, const int32_t* y, const int32_t* z,
+                                 int width, uint32_t* out) {
+    __m256i m[9];
+    for (int k = 0; k < 9; k++) {
+        m[k] = _mm256_set1_epi32(c->matrix[k]);
+    }
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i maxCode = _mm256_set1_epi32(c->maxCode);
+    const __m256i alpha = _mm256_set1_epi32((int32_t)c->alpha);
+    const __m256i last = _mm256_set1_epi32(c->lutSize - 2);
+    const __m256i sr = _mm256_set1_epi32(c->lutStride[0]);
+    const __m256i sg = _mm256_set1_epi32(c->lutStride[1]);
+    const __m256i sb = _mm256_set1_epi32(c->lutStride[2]);
+    const __m256i sSum = _mm256_set1_epi32(c->lutStride[0] + c->lutStride[1] + c->lutStride[2]);
+    const __m256i round = _mm256_set1_epi32(kLutRound);
+    const int32_t* nodes = c->lutNodes.data();
+    int i = 0;
+    for (; i + 8 <= width; i += 8) {
+        __m256i vx = _mm256_min_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i*)(x + i)), zero), maxCode);
+        __m256i vy = _mm256_min_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i*)(y + i)), zero), maxCode);
+        __m256i vz = _mm256_min_epi32(_mm256_max_epi32(_mm256_loadu_si256((const __m256i*)(z + i)), zero), maxCode);
+        __m256i lx = _mm256_i32gather_epi32(c->linearize, vx, 4);
+        __m256i ly = _mm256_i32gather_epi32(c->linearize, vy, 4);
+        __m256i lz = _mm256_i32gather_epi32(c->linearize, vz, 4);
+        __m256i pr = _mm256_i32gather_epi32(c->shaper[0], avx2_channel(m + 0, lx, ly, lz), 4);
+        __m256i pg = _mm256_i32gather_epi32(c->shaper[1], avx2_channel(m + 3, lx, ly, lz), 4);
+        __m256i pb = _mm256_i32gather_epi32(c->shaper[2], avx2_channel(m + 6, lx, ly, lz), 4);
+        // 网格单元与四面体：各分量的整数坐标与分数，按分数大小选出经过的顶点
+        __m256i ir = _mm256_min_epi32(_mm256_srai_epi32(pr, kGridShift), last);
+        __m256i ig = _mm256_min_epi32(_mm256_srai_epi32(pg, kGridShift), last);
+        __m256i ib = _mm256_min_epi32(_mm256_srai_epi32(pb, kGridShift), last);
+        __m256i fr = _mm256_sub_epi32(pr, _mm256_slli_epi32(ir, kGridShift));
+        __m256i fg = _mm256_sub_epi32(pg, _mm256_slli_epi32(ig, kGridShift));
+        __m256i fb = _mm256_sub_epi32(pb, _mm256_slli_epi32(ib, kGridShift));
+        __m256i gtGR = _mm256_cmpgt_epi32(fg, fr);
+        __m256i gtBR = _mm256_cmpgt_epi32(fb, fr);
+        __m256i gtBG = _mm256_cmpgt_epi32(fb, fg);
+        __m256i o1 = _mm256_blendv_epi8(sr, _mm256_blendv_epi8(sg, sb, gtBG), _mm256_or_si256(gtGR, gtBR));
+        __m256i oMin = _mm256_blendv_epi8(sb, _mm256_blendv_epi8(sg, sr, gtGR), _mm256_or_si256(gtBR, gtBG));
+        __m256i fmax = _mm256_max_epi32(_mm256_max_epi32(fr, fg), fb);
+        __m256i fmin = _mm256_min_epi32(_mm256_min_epi32(fr, fg), fb);
+        __m256i fmid = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_add_epi32(_mm256_add_epi32(fr, fg), fb), fmax), fmin);
+        __m256i i0 = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(ir, sr), _mm256_mullo_epi32(ig, sg)),
+                                      _mm256_mullo_epi32(ib, sb));
+        __m256i i1 = _mm256_add_epi32(i0, o1);
+        __m256i i2 = _mm256_add_epi32(i0, _mm256_sub_epi32(sSum, oMin));
+        __m256i i3 = _mm256_add_epi32(i0, sSum);
+        __m256i pixel = alpha;
+        for (int ch = 0; ch < 3; ch++) {
+            __m256i c0 = _mm256_i32gather_epi32(nodes + ch, i0, 4);
+            __m256i c1 = _mm256_i32gather_epi32(nodes + ch, i1, 4);
+            __m256i c2 = _mm256_i32gather_epi32(nodes + ch, i2, 4);
+            __m256i c3 = _mm256_i32gather_epi32(nodes + ch, i3, 4);
+            __m256i v = _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(c0, kGridShift), round),
+                                         _mm256_mullo_epi32(fmax, _mm256_sub_epi32(c1, c0)));
+            v = _mm256_add_epi32(_mm256_add_epi32(v, _mm256_mullo_epi32(fmid, _mm256_sub_epi32(c2, c1))),
+                                 _mm256_mullo_epi32(fmin, _mm256_sub_epi32(c3, c2)));
+            v = _mm256_srli_epi32(v, kLutShift);
+            pixel = _mm256_or_si256(pixel, _mm256_sll_epi32(v, _mm_cvtsi32_si128(c->encodeShift[ch])));
+        }
+        _mm256_storeu_si256((__m256i*)(out + i), pixel);
+    }
+    convert_row_lut_scalar(c, x + i, y + i, z + i, width - i, out + i);
+}
+#endif
+
+#ifdef DMS_COLOR_NEON
+static inline int32x4_t neon_channel(const int32_t* m, int32x4_t lx, int32x4_t ly, int32x4_t lz) {
+    int32x4_t v = vmlaq_n_s32(vmlaq_n_s32(vmlaq_n_s32(vdupq_n_s32(kMatrixRound), lx, m[0]), ly, m[1]), lz, m[2]);
+    v = vshrq_n_s32(v, kMatrixShift);
+    v = vminq_s32(vmaxq_s32(v, vdupq_n_s32(0)), vdupq_n_s32(kLinearMax));
+    return vshrq_n_s32(v, kEncodeShift);
+}
+
+static void convert_row_neon(const DmsColorConverter* c, const int32_t* x, const int32_t* y, const int32_t* z,
+                             int width, uint32_t* out) {
+    const int32x4_t zero = vdupq_n_s32(0);
+    const int32x4_t maxCode = vdupq_n_s32(c->maxCode);
+    int32_t idx[3][4];
+    int32_t lin[3][4];
+    int i = 0;
+    for (; i + 4 <= width; i += 4) {
+        const int32_t* src[3] = {x + i, y + i, z + i};
+        for (int ch = 0; ch < 3; ch++) {
+            vst1q_s32(idx[ch], vminq_s32(vmaxq_s32(vld1q_s32(src[ch]), zero), maxCode));
+            for (int k = 0; k < 4; k++) {
+                lin[ch][k] = c->linearize[idx[ch][k]];
+            }
+        }
+        int32x4_t lx = vld1q_s32(lin[0]);
+        int32x4_t ly = vld1q_s32(lin[1]);
+        int32x4_t lz = vld1q_s32(lin[2]);
+        uint32x4_t pixel = vdupq_n_u32(c->alpha);
+        for (int ch = 0; ch < 3; ch++) {
+            vst1q_s32(idx[ch], neon_channel(c->matrix + ch * 3, lx, ly, lz));
+            for (int k = 0; k < 4; k++) {
+                lin[ch][k] = c->encode[idx[ch][k]];
+            }
+            uint32x4_t v = vreinterpretq_u32_s32(vld1q_s32(lin[ch]));
+            pixel = vorrq_u32(pixel, vshlq_u32(v, vdupq_n_s32(c->encodeShift[ch])));
+        }
+        vst1q_u32(out + i, pixel);
+    }
+    convert_row_scalar(c, x + i, y + i, z + i, width - i, out + i);
+}
+
+static void convert_row_lut_neon(const DmsColorConverter* c, const int32_t* x, const int32_t* y, const int32_t* z,
+                                 int width, uint32_t* out) {
+    const int32x4_t zero = vdupq_n_s32(0);
+    const int32x4_t maxCode = vdupq_n_s32(c->maxCode);
+    const int32x4_t last = vdupq_n_s32(c->lutSize - 2);
+    const int32x4_t sr = vdupq_n_s32(c->lutStride[0]);
+    const int32x4_t sg = vdupq_n_s32(c->lutStride[1]);
+    const int32x4_t sb = vdupq_n_s32(c->lutStride[2]);
+    const int32x4_t sSum = vdupq_n_s32(c->lutStride[0] + c->lutStride[1] + c->lutStride[2]);
+    const int32_t* nodes = c->lutNodes.data();
+    int32_t idx[3][4];
+    int32_t lin[3][4];
+    int32_t corner[4][4];
+    int32_t value[4][4];
+    int i = 0;
+    for (; i + 4 <= width; i += 4) {
+        const int32_t* src[3] = {x + i, y + i, z + i};
+        for (int ch = 0; ch < 3; ch++) {
+            vst1q_s32(idx[ch], vminq_s32(vmaxq_s32(vld1q_s32(src[ch]), zero), maxCode));
+            for (int k = 0; k < 4; k++) {
+                lin[ch][k] = c->linearize[idx[ch][k]];
+            }
+        }
+        int32x4_t lx = vld1q_s32(lin[0]);
+        int32x4_t ly = vld1q_s32(lin[1]);
+        int32x4_t lz = vld1q_s32(lin[2]);
+        for (int ch = 0; ch < 3; ch++) {
+            vst1q_s32(idx[ch], neon_channel(c->matrix + ch * 3, lx, ly, lz));
+            for (int k = 0; k < 4; k++) {
+                lin[ch][k] = c->shaper[ch][idx[ch][k]];
+            }
+        }
+        // 网格单元与四面体：各分量的整数坐标与分数，按分数大小选出经过的顶点
+        int32x4_t pr = vld1q_s32(lin[0]);
+        int32x4_t pg = vld1q_s32(lin[1]);
+        int32x4_t pb = vld1q_s32(lin[2]);
+        int32x4_t ir = vminq_s32(vshrq_n_s32(pr, kGridShift), last);
+        int32x4_t ig = vminq_s32(vshrq_n_s32(pg, kGridShift), last);
+        int32x4_t ib = vminq_s32(vshrq_n_s32(pb, kGridShift), last);
+        int32x4_t fr = vsubq_s32(pr, vshlq_n_s32(ir, kGridShift));
+        int32x4_t fg = vsubq_s32(pg, vshlq_n_s32(ig, kGridShift));
+        int32x4_t fb = vsubq_s32(pb, vshlq_n_s32(ib, kGridShift));
+        uint32x4_t gtGR = vcgtq_s32(fg, fr);
+        uint32x4_t gtBR = vcgtq_s32(fb, fr);
+        uint32x4_t gtBG = vcgtq_s32(fb, fg);
+        int32x4_t o1 = vbslq_s32(vorrq_u32(gtGR, gtBR), vbslq_s32(gtBG, sb, sg), sr);
+        int32x4_t oMin = vbslq_s32(vorrq_u32(gtBR, gtBG), vbslq_s32(gtGR, sr, sg), sb);
+        int32x4_t fmax = vmaxq_s32(vmaxq_s32(fr, fg), fb);
+        int32x4_t fmin = vminq_s32(vminq_s32(fr, fg), fb);
+        int32x4_t fmid = vsubq_s32(vsubq_s32(vaddq_s32(vaddq_s32(fr, fg), fb), fmax), fmin);
+        int32x4_t base = vmlaq_s32(vmlaq_s32(vmulq_s32(ir, sr), ig, sg), ib, sb);
+        vst1q_s32(corner[0], base);
+        vst1q_s32(corner[1], vaddq_s32(base, o1));
+        vst1q_s32(corner[2], vaddq_s32(base, vsubq_s32(sSum, oMin)));
+        vst1q_s32(corner[3], vaddq_s32(base, sSum));
+        uint32x4_t pixel = vdupq_n_u32(c->alpha);
+        for (int ch = 0; ch < 3; ch++) {
+            for (int n = 0; n < 4; n++) {
+                for (int k = 0; k < 4; k++) {
+                    value[n][k] = nodes[corner[n][k] + ch];
+                }
+            }
+            int32x4_t c0 = vld1q_s32(value[0]);
+            int32x4_t c1 = vld1q_s32(value[1]);
+            int32x4_t c2 = vld1q_s32(value[2]);
+            int32x4_t c3 = vld1q_s32(value[3]);
+            int32x4_t v = vaddq_s32(vshlq_n_s32(c0, kGridShift), vdupq_n_s32(kLutRound));
+            v = vmlaq_s32(v, fmax, vsubq_s32(c1, c0));
+            v = vmlaq_s32(v, fmid, vsubq_s32(c2, c1));
+            v = vmlaq_s32(v, fmin, vsubq_s32(c3, c2));
+            uint32x4_t code = vshrq_n_u32(vreinterpretq_u32_s32(v), kLutShift);
+            pixel = vorrq_u32(pixel, vshlq_u32(code, vdupq_n_s32(c->encodeShift[ch])));
+        }
+        vst1q_u32(out + i, pixel);
+    }
+    convert_row_lut_scalar(c, x + i, y + i, z + i, width - i, out + i);
+}
+#endif
+
+/**
+ * @brief 当前CPU是否支持指定内核
+ * @param kernel 内核，DmsColorKernel
+ * @return 支持返回true
+ */
+bool dms_color_kernel_supported(int kernel) {
+    switch (kernel) {
+        case DMS_COLOR_KERNEL_AUTO:
+        case DMS_COLOR_KERNEL_SCALAR:
+            return true;
+#ifdef DMS_COLOR_X86
+        case DMS_COLOR_KERNEL_SSE41:
+            return __builtin_cpu_supports("sse4.1");
+        case DMS_COLOR_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#ifdef DMS_COLOR_NEON
+        case DMS_COLOR_KERNEL_NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 内核名称
+ * @param kernel 内核，DmsColorKernel
+ * @return 名称
+ */
+const char* dms_color_kernel_name(int kernel) {
+    switch (kernel) {
+        case DMS_COLOR_KERNEL_AUTO: return "auto";
+        case DMS_COLOR_KERNEL_SCALAR: return "scalar";
+        case DMS_COLOR_KERNEL_NEON: return "neon";
+        case DMS_COLOR_KERNEL_SSE41: return "sse4.1";
+        case DMS_COLOR_KERNEL_AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief 创建转换器：建立线性化表、编码表与定点矩阵，配置了3D LUT时另建整形表与定点节点
+ * @param config 转换配置，为空时输出sRGB的RGBA_8888
+ * @return 成功返回转换器指针，参数错误或内核不受支持返回NULL
+ */
+struct DmsColorConverter* dms_color_create(const struct DmsColorConfig* config) {
+    int colorSpace = config ? config->colorSpace : DMS_COLOR_SRGB;
+    int format = config ? config->format : DMS_COLOR_RGBA_8888;
+    int precision = (config && config->precision > 0) ? config->precision : 12;
+    int kernel = config ? config->kernel : DMS_COLOR_KERNEL_AUTO;
+    if (colorSpace < DMS_COLOR_SRGB || colorSpace > DMS_COLOR_P3_D65 ||
+        (format != DMS_COLOR_RGBA_8888 && format != DMS_COLOR_RGBA_1010102) || precision > 12) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    if (kernel == DMS_COLOR_KERNEL_AUTO) {
+        const int preferred[] = {DMS_COLOR_KERNEL_AVX2, DMS_COLOR_KERNEL_SSE41, DMS_COLOR_KERNEL_NEON};
+        kernel = DMS_COLOR_KERNEL_SCALAR;
+        for (int candidate : preferred) {
+            if (dms_color_kernel_supported(candidate)) {
+                kernel = candidate;
+                break;
+            }
+        }
+    } else if (!dms_color_kernel_supported(kernel)) {
+        LOGE("Color kernel %s not supported on this CPU", dms_color_kernel_name(kernel));
+        return nullptr;
+    }
+
+    DmsColorConverter* c = new DmsColorConverter();
+    c->kernel = kernel;
+    c->format = format;
+    c->maxCode = (1 << precision) - 1;
+
+    // 线性化表：码值 -> (码值/最大码值)^2.6，16位定点
+    memset(c->linearize, 0, sizeof(c->linearize));
+    for (int i = 0; i <= c->maxCode; i++) {
+        c->linearize[i] = (int32_t)lround(pow((double)i / c->maxCode, 2.6) * kLinearMax);
+    }
+
+    // 矩阵：并入52.37/48的归一化，使DCI参考白的Y为1；有3D LUT时转换到LUT的输入色彩空间
+    const DmsColorLut* lut = config ? config->lut : nullptr;
+    const double* xyzToRgb = xyz_to_rgb(lut ? lut->inputSpace : colorSpace);
+    for (int k = 0; k < 9; k++) {
+        c->matrix[k] = (int32_t)lround(xyzToRgb[k] * kDciNormalize * (1 << kMatrixShift));
+    }
+
+    // 编码表：12位线性值 -> 显示码值
+    int bits = format == DMS_COLOR_RGBA_8888 ? 8 : 10;
+    int maxOut = (1 << bits) - 1;
+    for (int i = 0; i < kLutSize; i++) {
+        c->encode[i] = (int32_t)lround(encode_transfer(colorSpace, (double)i / (kLutSize - 1)) * maxOut);
+    }
+    for (int ch = 0; ch < 3; ch++) {
+        c->encodeShift[ch] = ch * bits;
+    }
+    c->alpha = format == DMS_COLOR_RGBA_8888 ? 0xFF000000u : 0xC0000000u;
+
+    // 3D LUT：整形表把12位线性值经输入传递函数与定义域换算为网格坐标，节点换算为定点显示码值
+    if (lut) {
+        int32_t n = lut->size;
+        c->lutSize = n;
+        c->lutStride[0] = 4;
+        c->lutStride[1] = 4 * n;
+        c->lutStride[2] = 4 * n * n;
+        for (int ch = 0; ch < 3; ch++) {
+            double low = lut->domainMin[ch];
+            double range = (double)lut->domainMax[ch] - low;
+            for (int i = 0; i < kLutSize; i++) {
+                double t = (encode_transfer(lut->inputSpace, (double)i / (kLutSize - 1)) - low) / range;
+                t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+                c->shaper[ch][i] = (int32_t)lround(t * (n - 1) * (1 << kGridShift));
+            }
+        }
+        c->lutNodes.assign((size_t)n * n * n * 4, 0);
+        for (size_t node = 0; node < (size_t)n * n * n; node++) {
+            for (int ch = 0; ch < 3; ch++) {
+                double v = lut->nodes[node * 3 + ch];
+                v = v < 0.0 ? 0.0 : (v > 1.0 ? 1.0 : v);
+                c->lutNodes[node * 4 + ch] = (int32_t)lround(v * maxOut * (1 << kNodeShift));
+            }
+        }
+    }
+    LOGI("Color converter created: space %d, format %d, %d-bit input, kernel %s, 3D LUT %d",
+         colorSpace, format, precision, dms_color_kernel_name(kernel), c->lutSize);
+    return c;
+}
+
+/**
+ * @brief 销毁转换器
+ * @param converter 转换器
+ */
+void dms_color_destroy(struct DmsColorConverter* converter) {
+    delete converter;
+}
+
+/**
+ * @brief 实际使用的内核
+ * @param converter 转换器
+ * @return 内核，DmsColorKernel；参数错误返回-1
+ */
+int dms_color_get_kernel(struct DmsColorConverter* converter) {
+    return converter ? converter->kernel : -1;
+}
+
+typedef void (*ConvertRowFn)(const DmsColorConverter*, const int32_t*, const int32_t*, const int32_t*, int,
+                             uint32_t*);
+
+// 按内核与是否有3D LUT选择行转换函数
+static ConvertRowFn select_row_function(const DmsColorConverter* converter) {
+    bool lut = converter->lutSize > 0;
+    ConvertRowFn convert_row = lut ? convert_row_lut_scalar : convert_row_scalar;
+#ifdef DMS_COLOR_X86
+    if (converter->kernel == DMS_COLOR_KERNEL_AVX2) {
+        convert_row = lut ? convert_row_lut_avx2 : convert_row_avx2;
+    } else if (converter->kernel == DMS_COLOR_KERNEL_SSE41) {
+        convert_row = lut ? convert_row_lut_sse41 : convert_row_sse41;
+    }
+#endif
+#ifdef DMS_COLOR_NEON
+    if (converter->kernel == DMS_COLOR_KERNEL_NEON) {
+        convert_row = lut ? convert_row_lut_neon : convert_row_neon;
+    }
+#endif
+    return convert_row;
+}
+
+/**
+ * @brief 转换图像的[firstRow, firstRow + rowCount)行，可把一帧分成多段在多个线程中同时转换
+ * @param converter 转换器
+ * @param picture 解码图像（3分量X'Y'Z'，位数与创建时一致）
+ * @param firstRow 起始行
+ * @param rowCount 行数
+ * @param out 输出图像第0行的起始地址
+ * @param outStride 输出每行字节数（不小于width * 4）
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_color_convert(struct DmsColorConverter* converter, const struct DmsPicture* picture,
+                      int32_t firstRow, int32_t rowCount, void* out, int32_t outStride) {
+    if (!converter || !picture || picture->components < 3 || !out || firstRow < 0 || rowCount < 0 ||
+        firstRow + rowCount > picture->height || outStride < picture->width * 4) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    ConvertRowFn convert_row = select_row_function(converter);
+    for (int32_t row = firstRow; row < firstRow + rowCount; row++) {
+        size_t offset = (size_t)row * picture->width;
+        convert_row(converter, picture->planes[0] + offset, picture->planes[1] + offset, picture->planes[2] + offset,
+                    picture->width, (uint32_t*)((uint8_t*)out + (size_t)row * outStride));
+    }
+    return 0;
+}
+
+/**
+ * @brief 转换一行平面X'Y'Z'采样，供在转换前处理采样的模块（如缩放）逐行调用
+ * @param converter 转换器
+ * @param x X'分量
+ * @param y Y'分量
+ * @param z Z'分量
+ * @param width 像素数
+ * @param out 输出像素
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_color_convert_row(struct DmsColorConverter* converter, const int32_t* x, const int32_t* y, const int32_t* z,
+                          int32_t width, void* out) {
+    if (!converter || !x || !y || !z || width < 0 || !out) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    select_row_function(converter)(converter, x, y, z, width, (uint32_t*)out);
+    return 0;
+}
+
+/**
+ * @brief 输出格式的黑色像素（RGB为0，Alpha不透明），用于填充黑边
+ * @param converter 转换器
+ * @return 像素值，参数错误返回0
+ */
+uint32_t dms_color_black_pixel(const struct DmsColorConverter* converter) {
+    return converter ? converter->alpha : 0;
+}
+
+/**
+ * @brief 解析.cube文本：支持TITLE、LUT_3D_SIZE、DOMAIN_MIN、DOMAIN_MAX与LUT_3D_INPUT_RANGE，
+ *        节点为每行三个0~1的浮点数，红分量变化最快；不支持1D LUT
+ * @param text .cube文本，不要求以'\0'结尾
+ * @param length 文本字节数
+ * @param inputSpace LUT的输入色彩空间（DmsColorSpace），.cube不记录，由调用者指定
+ * @return 成功返回LUT指针，参数错误或格式错误返回NULL
+ */
+struct DmsColorLut* dms_color_lut_parse(const char* text, size_t length, int inputSpace) {
+    if (!text || inputSpace < DMS_COLOR_SRGB || inputSpace > DMS_COLOR_P3_D65) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    DmsColorLut* lut = new DmsColorLut();
+    lut->size = 0;
+    lut->inputSpace = inputSpace;
+    for (int ch = 0; ch < 3; ch++) {
+        lut->domainMin[ch] = 0.0f;
+        lut->domainMax[ch] = 1.0f;
+    }
+    const char* error = nullptr;
+    int32_t lineNo = 0;
+    size_t pos = 0;
+    while (pos < length && !error) {
+        size_t end = pos;
+        while (end < length && text[end] != '\n') {
+            end++;
+        }
+        std::string line(text + pos, end - pos);
+        pos = end + 1;
+        lineNo++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.resize(comment);
+        }
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            continue;
+        }
+        const char* p = line.c_str() + first;
+        float v[3];
+        if ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.') {
+            if (lut->size <= 0) {
+                error = "data before LUT_3D_SIZE";
+            } else if (sscanf(p, "%f %f %f", &v[0], &v[1], &v[2]) != 3) {
+                error = "malformed data";
+            } else if (lut->nodes.size() >= (size_t)lut->size * lut->size * lut->size * 3) {
+                error = "too many data lines";
+            } else {
+                lut->nodes.insert(lut->nodes.end(), v, v + 3);
+            }
+        } else if (strncmp(p, "LUT_3D_SIZE", 11) == 0) {
+            int size = 0;
+            if (sscanf(p + 11, "%d", &size) != 1 || size < 2 || size > DMS_COLOR_LUT_MAX_SIZE || lut->size > 0) {
+                error = "bad LUT_3D_SIZE";
+            } else {
+                lut->size = size;
+                lut->nodes.reserve((size_t)size * size * size * 3);
+            }
+        } else if (strncmp(p, "DOMAIN_MIN", 10) == 0 || strncmp(p, "DOMAIN_MAX", 10) == 0) {
+            float* domain = p[8] == 'I' ? lut->domainMin : lut->domainMax;
+            if (sscanf(p + 10, "%f %f %f", &domain[0], &domain[1], &domain[2]) != 3) {
+                error = "bad DOMAIN";
+            }
+        } else if (strncmp(p, "LUT_3D_INPUT_RANGE", 18) == 0) {
+            if (sscanf(p + 18, "%f %f", &v[0], &v[1]) != 2) {
+                error = "bad LUT_3D_INPUT_RANGE";
+            }
+            for (int ch = 0; ch < 3 && !error; ch++) {
+                lut->domainMin[ch] = v[0];
+                lut->domainMax[ch] = v[1];
+            }
+        } else if (strncmp(p, "LUT_1D_SIZE", 11) == 0) {
+            error = "1D LUT not supported";
+        }
+        // TITLE等其他关键字忽略
+    }
+    if (!error && (lut->size <= 0 || lut->nodes.size() != (size_t)lut->size * lut->size * lut->size * 3)) {
+        error = "incomplete data";
+        lineNo = 0;
+    }
+    for (int ch = 0; ch < 3 && !error; ch++) {
+        if (!(lut->domainMax[ch] > lut->domainMin[ch])) {
+            error = "empty domain";
+        }
+    }
+    if (error) {
+        LOGE("Invalid cube LUT: %s (line %d)", error, lineNo);
+        delete lut;
+        return nullptr;
+    }
+    return lut;
+}
+
+/**
+ * @brief 由.cube文件载入3D LUT
+ * @param path 文件路径
+ * @param inputSpace LUT的输入色彩空间（DmsColorSpace）
+ * @return 成功返回LUT指针，文件无法读取或格式错误返回NULL
+ */
+struct DmsColorLut* dms_color_lut_load(const char* path, int inputSpace) {
+    if (!path) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        LOGE("Failed to open cube LUT: %s", path);
+        return nullptr;
+    }
+    std::string text;
+    char buffer[65536];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, count);
+    }
+    fclose(file);
+    DmsColorLut* lut = dms_color_lut_parse(text.data(), text.size(), inputSpace);
+    if (lut) {
+        LOGI("Cube LUT loaded: %s, %d^3", path, lut->size);
+    }
+    return lut;
+}
+
+/**
+ * @brief 色域压缩曲线（与ACES参考色域压缩相同的幂函数形式）：距离不超过threshold时不变，
+ *        超过后平滑压缩，limit处恰为1（色域边界）
+ * @param distance 到消色轴的距离，0为消色，1为色域边界，大于1为超出色域
+ * @param limit 源色域中的最大距离
+ * @return 压缩后的距离
+ */
+static double compress_distance(double distance, double limit) {
+    if (distance <= kCompressThreshold || limit <= 1.0) {
+        return distance;
+    }
+    double span = limit - kCompressThreshold;
+    double scale = span / pow(pow((1.0 - kCompressThreshold) / span, -kCompressPower) - 1.0, 1.0 / kCompressPower);
+    double n = (distance - kCompressThreshold) / scale;
+    return kCompressThreshold + scale * n / pow(1.0 + pow(n, kCompressPower), 1.0 / kCompressPower);
+}
+
+/**
+ * @brief 3x3矩阵求逆
+ * @param m 行优先的矩阵
+ * @param out 输出逆矩阵
+ */
+static void invert3(const double* m, double* out) {
+    double det = m[0] * (m[4] * m[8] - m[5] * m[7]) - m[1] * (m[3] * m[8] - m[5] * m[6]) +
+                 m[2] * (m[3] * m[7] - m[4] * m[6]);
+    out[0] = (m[4] * m[8] - m[5] * m[7]) / det;
+    out[1] = (m[2] * m[7] - m[1] * m[8]) / det;
+    out[2] = (m[1] * m[5] - m[2] * m[4]) / det;
+    out[3] = (m[5] * m[6] - m[3] * m[8]) / det;
+    out[4] = (m[0] * m[8] - m[2] * m[6]) / det;
+    out[5] = (m[2] * m[3] - m[0] * m[5]) / det;
+    out[6] = (m[3] * m[7] - m[4] * m[6]) / det;
+    out[7] = (m[1] * m[6] - m[0] * m[7]) / det;
+    out[8] = (m[0] * m[4] - m[1] * m[3]) / det;
+}
+
+/**
+ * @brief 生成P3（伽马2.6）到输出色彩空间的色域压缩LUT：节点换算为输出原色的线性RGB，
+ *        各分量到消色轴（三分量最大值）的距离超过0.8后平滑压缩，源色域的最大距离恰好压到输出
+ *        色域边界，再截断高光并按输出传递函数编码。输出为P3原色时只换算传递函数
+ * @param size 每边的节点数（2~DMS_COLOR_LUT_MAX_SIZE），常用33
+ * @param outputSpace 输出色彩空间（DmsColorSpace），须与转换器配置的colorSpace一致
+ * @return 成功返回LUT指针，参数错误返回NULL
+ */
+struct DmsColorLut* dms_color_lut_create_gamut_map(int32_t size, int outputSpace) {
+    if (size < 2 || size > DMS_COLOR_LUT_MAX_SIZE || outputSpace < DMS_COLOR_SRGB || outputSpace > DMS_COLOR_P3_D65) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    // P3线性RGB -> 输出原色的线性RGB
+    double p3ToXyz[9];
+    invert3(kXyzToP3D65, p3ToXyz);
+    const double* xyzToOut = xyz_to_rgb(outputSpace);
+    double m[9];
+    for (int r = 0; r < 3; r++) {
+        for (int k = 0; k < 3; k++) {
+            m[r * 3 + k] = xyzToOut[r * 3] * p3ToXyz[k] + xyzToOut[r * 3 + 1] * p3ToXyz[3 + k] +
+                           xyzToOut[r * 3 + 2] * p3ToXyz[6 + k];
+        }
+    }
+    size_t count = (size_t)size * size * size;
+    std::vector<double> linear(count * 3);
+    double limit[3] = {1.0, 1.0, 1.0};
+    for (size_t node = 0; node < count; node++) {
+        int32_t index[3] = {(int32_t)(node % size), (int32_t)(node / size % size), (int32_t)(node / size / size)};
+        double p3[3];
+        for (int ch = 0; ch < 3; ch++) {
+            p3[ch] = decode_transfer(DMS_COLOR_P3_D65, (double)index[ch] / (size - 1));
+        }
+        double* rgb = &linear[node * 3];
+        double achromatic = 0.0;
+        for (int ch = 0; ch < 3; ch++) {
+            rgb[ch] = m[ch * 3] * p3[0] + m[ch * 3 + 1] * p3[1] + m[ch * 3 + 2] * p3[2];
+            achromatic = std::max(achromatic, rgb[ch]);
+        }
+        for (int ch = 0; ch < 3 && achromatic > 0.0; ch++) {
+            limit[ch] = std::max(limit[ch], (achromatic - rgb[ch]) / achromatic);
+        }
+    }
+
+    DmsColorLut* lut = new DmsColorLut();
+    lut->size = size;
+    lut->inputSpace = DMS_COLOR_P3_D65;
+    for (int ch = 0; ch < 3; ch++) {
+        lut->domainMin[ch] = 0.0f;
+        lut->domainMax[ch] = 1.0f;
+    }
+    lut->nodes.resize(count * 3);
+    for (size_t node = 0; node < count; node++) {
+        const double* rgb = &linear[node * 3];
+        double achromatic = std::max(std::max(rgb[0], rgb[1]), rgb[2]);
+        for (int ch = 0; ch < 3; ch++) {
+            double v = rgb[ch];
+            if (achromatic > 0.0) {
+                v = achromatic - compress_distance((achromatic - v) / achromatic, limit[ch]) * achromatic;
+            }
+            v = v < 0.0 ? 0.0 : (v > 1.0 ? 1.0 : v);
+            lut->nodes[node * 3 + ch] = (float)encode_transfer(outputSpace, v);
+        }
+    }
+    LOGI("Gamut map LUT created: %d^3, output space %d, limits %.3f %.3f %.3f", size, outputSpace,
+         limit[0], limit[1], limit[2]);
+    return lut;
+}
+
+/**
+ * @brief 保存为.cube文件
+ * @param lut 3D LUT
+ * @param path 文件路径
+ * @return 成功返回0，参数错误返回-1，写入失败返回-3
+ */
+int dms_color_lut_save(const struct DmsColorLut* lut, const char* path) {
+    if (!lut || !path) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        LOGE("Failed to create cube LUT: %s", path);
+        return -3;
+    }
+    fprintf(file, "TITLE \"DMS Player\"\nLUT_3D_SIZE %d\n", lut->size);
+    fprintf(file, "DOMAIN_MIN %.6f %.6f %.6f\n", lut->domainMin[0], lut->domainMin[1], lut->domainMin[2]);
+    fprintf(file, "DOMAIN_MAX %.6f %.6f %.6f\n", lut->domainMax[0], lut->domainMax[1], lut->domainMax[2]);
+    for (size_t i = 0; i < lut->nodes.size(); i += 3) {
+        fprintf(file, "%.6f %.6f %.6f\n", lut->nodes[i], lut->nodes[i + 1], lut->nodes[i + 2]);
+    }
+    bool ok = !ferror(file);
+    ok = fclose(file) == 0 && ok;
+    return ok ? 0 : -3;
+}
+
+/**
+ * @brief 销毁3D LUT
+ * @param lut 3D LUT
+ */
+void dms_color_lut_destroy(struct DmsColorLut* lut) {
+    delete lut;
+}
+
+/**
+ * @brief 每边的节点数
+ * @param lut 3D LUT
+ * @return 节点数，参数错误返回-1
+ */
+int32_t dms_color_lut_get_size(const struct DmsColorLut* lut) {
+    return lut ? lut->size : -1;
+}
@@ -0,0 +1,98 @@
+#ifndef DMS_COLOR_H
+#define DMS_COLOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * X'Y'Z' 到 RGB 的色彩转换
+ *
+ * DCI图像为12位 X'Y'Z'（伽马2.6，白点亮度按52.37/48归一化）。每像素的计算分三步：
+ *   1. 各分量查4096项线性化表得到16位定点线性值（含2.6次幂）；
+ *   2. 与Q12定点的3x3矩阵相乘得到线性RGB（矩阵已并入52.37/48的归一化），截断到16位；
+ *   3. 线性RGB取高12位查4096项编码表，得到8位或10位显示码值。
+ * 全部为整数运算，NEON、SSE4.1、AVX2内核与标量参考实现的输出逐位一致。
+ * 各SIMD内核并行完成矩阵、截断与打包；AVX2用gather查表，NEON与SSE4.1逐项查表。
+ *
+ * 编码表按4096级线性值取样，暗部的相邻码值间距大于按码值取样，低亮度渐变可能出现色阶。
+ *
+ * 3D LUT（色域映射）
+ *
+ * 配置了3D LUT时第2步的矩阵转换到LUT的输入色彩空间（如P3-D65），第3步改为：线性RGB取高12位
+ * 查各分量的整形表（输入传递函数与LUT定义域）得到网格坐标，在LUT网格上做四面体插值直接得到
+ * 显示码值，每像素只读写一次。LUT节点为按输出位数放大64倍的定点值，插值与舍入全为整数运算，
+ * 各内核输出逐位一致；AVX2用gather取四个顶点，NEON与SSE4.1逐项取顶点后并行插值。
+ * LUT可由.cube文件载入（仅3D，红分量变化最快），或按内置的色域压缩生成：P3中超出Rec.709色域的
+ * 颜色按到消色轴的距离平滑压缩到色域边界，而不是逐分量截断（截断会使饱和色的色相与层次丢失）。
+ */
+
+#define DMS_COLOR_LUT_MAX_SIZE 65    // 3D LUT每边的最多节点数
+
+struct DmsPicture;
+struct DmsColorLut;
+
+// 输出色彩空间
+enum DmsColorSpace {
+    DMS_COLOR_SRGB = 0,          // Rec.709原色，sRGB传递函数（Android默认数据空间）
+    DMS_COLOR_BT709 = 1,         // Rec.709原色，BT.1886伽马2.4
+    DMS_COLOR_DISPLAY_P3 = 2,    // P3原色D65白点，sRGB传递函数（Android Display P3）
+    DMS_COLOR_P3_D65 = 3,        // P3原色D65白点，伽马2.6
+};
+
+// 输出像素格式，按内存字节序与Android的同名格式一致
+enum DmsColorFormat {
+    DMS_COLOR_RGBA_8888 = 0,     // 每像素4字节：R、G、B、A（A=255）
+    DMS_COLOR_RGBA_1010102 = 1,  // 每像素32位小端：R在低10位，其后G、B各10位，A占最高2位（A=3）
+};
+
+// 转换内核
+enum DmsColorKernel {
+    DMS_COLOR_KERNEL_AUTO = 0,   // 按CPU选择最快的可用内核
+    DMS_COLOR_KERNEL_SCALAR = 1, // 标量参考实现
+    DMS_COLOR_KERNEL_NEON = 2,   // ARM NEON，每次4像素
+    DMS_COLOR_KERNEL_SSE41 = 3,  // x86 SSE4.1，每次4像素
+    DMS_COLOR_KERNEL_AVX2 = 4,   // x86 AVX2，每次8像素
+};
+
+// 转换配置
+struct DmsColorConfig {
+    int32_t colorSpace;      // 输出色彩空间，DmsColorSpace
+    int32_t format;          // 输出像素格式，DmsColorFormat
+    int32_t precision;       // 输入每分量位数（1~12），0表示12
+    int32_t kernel;          // 转换内核，DmsColorKernel
+    const struct DmsColorLut* lut; // 3D LUT，NULL为不用；输出为colorSpace的显示码值，创建时复制
+};
+
+struct DmsColorConverter;
+
+bool dms_color_kernel_supported(int kernel);                   // 当前CPU是否支持指定内核
+const char* dms_color_kernel_name(int kernel);                 // 内核名称
+struct DmsColorConverter* dms_color_create(const struct DmsColorConfig* config); // 创建转换器（建表）
+void dms_color_destroy(struct DmsColorConverter* converter);   // 销毁转换器
+int dms_color_get_kernel(struct DmsColorConverter* converter); // 实际使用的内核
+int dms_color_convert(struct DmsColorConverter* converter, const struct DmsPicture* picture,
+                      int32_t firstRow, int32_t rowCount, void* out,
+                      int32_t outStride);                      // 转换图像的若干行
+int dms_color_convert_row(struct DmsColorConverter* converter, const int32_t* x, const int32_t* y,
+                          const int32_t* z, int32_t width, void* out); // 转换一行平面采样
+uint32_t dms_color_black_pixel(const struct DmsColorConverter* converter); // 输出格式的黑色像素
+
+struct DmsColorLut* dms_color_lut_load(const char* path, int inputSpace); // 由.cube文件载入3D LUT
+struct DmsColorLut* dms_color_lut_parse(const char* text, size_t length,
+                                        int inputSpace);       // 解析.cube文本
+struct DmsColorLut* dms_color_lut_create_gamut_map(int32_t size,
+                                                   int outputSpace); // 生成P3到输出色彩空间的色域压缩LUT
+void dms_color_lut_destroy(struct DmsColorLut* lut);          // 销毁3D LUT
+int32_t dms_color_lut_get_size(const struct DmsColorLut* lut); // 每边的节点数
+int dms_color_lut_save(const struct DmsColorLut* lut, const char* path); // 保存为.cube文件
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_COLOR_H
@@ -0,0 +1,455 @@
+#include "dms_decode_pipeline.h"
+#include "dms_player.h"
+#include "dms_log.h"
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define LOG_TAG "DmsDecodePipeline"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// 待解码的帧（立体帧的一只眼）
+struct DecodeJob {
+    uint64_t seq;
+    int32_t eye;                       // 0为左眼（或2D），1为右眼
+    int32_t eyes;                      // 该帧的解码任务数，立体帧为2
+    DmsFrame frame;                    // 右眼任务的unit为右眼单元
+};
+
+// 已完成、等待按顺序输出的帧；立体帧两眼都完成后才可输出
+struct DecodeResult {
+    DmsFrame frame;
+    DmsPicture picture;
+    int result;
+    DmsPicture right;
+    int rightResult;
+    int32_t eyes;
+    int32_t done;
+};
+
+struct DmsDecodePipeline {
+    DmsJ2kDecoder* decoder;
+    int32_t workerCount;
+    int32_t maxInFlight;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable jobCv;     // 有新的待解码帧或停止
+    std::condition_variable resultCv;  // 有帧解码完成
+    std::condition_variable spaceCv;   // 持有帧数减少
+    std::deque<DecodeJob> jobs;
+    std::map<uint64_t, DecodeResult> results;
+    std::deque<std::pair<int64_t, int64_t>> pendingFrames; // 已提交未输出各帧的帧号与时间戳，按提交顺序
+    uint64_t nextSubmit;               // 下一个提交帧的序号
+    uint64_t nextEmit;                 // 下一个应输出帧的序号
+    uint64_t generation;               // 每次清空加一，解码中的帧据此判断结果是否已作废
+    int32_t inFlight;
+    bool stopping;
+
+    int64_t startUs;
+    int64_t busyUs[DMS_DECODE_MAX_WORKERS];
+    int32_t peakInFlight;
+    int64_t submitted;
+    int64_t emitted;
+    int64_t cancelled;
+    int64_t failures;
+    int64_t stereoFrames;
+    int64_t headOfLineWaits;
+};
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+// 当前线程占用的CPU时间：解码线程多于空闲核时，各线程的利用率随之下降
+static int64_t thread_cpu_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief 清零并释放帧的码流，解密后的码流不在内存中残留
+ * @param frame 帧
+ */
+static void wipe_frame(DmsFrame* frame) {
+    if (frame->unit && frame->unit->Data) {
+        memset(frame->unit->Data, 0, frame->unit->Length);
+    }
+    if (frame->rightUnit && frame->rightUnit->Data) {
+        memset(frame->rightUnit->Data, 0, frame->rightUnit->Length);
+    }
+    dms_player_release_frame(frame);
+    frame->unit = nullptr;
+    frame->rightUnit = nullptr;
+}
+
+/**
+ * @brief 该序号的帧是否已全部解码完成（立体帧两眼都完成），须持有pipeline->mutex
+ * @param pipeline 并行解码器
+ * @param seq 帧序号
+ * @return 可输出返回true
+ */
+static bool ready_locked(DmsDecodePipeline* pipeline, uint64_t seq) {
+    auto it = pipeline->results.find(seq);
+    return it != pipeline->results.end() && it->second.done == it->second.eyes;
+}
+
+/**
+ * @brief 等待条件成立
+ * @param cv 条件变量
+ * @param lock 已持有的锁
+ * @param timeoutUs 超时（微秒），小于0表示一直等待
+ * @param pred 条件
+ * @return 条件成立返回true，超时返回false
+ */
+template <typename Pred>
+static bool wait_for(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, int64_t timeoutUs, Pred pred) {
+    if (timeoutUs < 0) {
+        cv.wait(lock, pred);
+        return true;
+    }
+    return cv.wait_for(lock, std::chrono::microseconds(timeoutUs), pred);
+}
+
+/**
+ * @brief 解码线程：取出最早提交的帧解码，结果放入重排缓冲
+ * @param pipeline 并行解码器
+ * @param index 线程序号
+ */
+static void worker_main(DmsDecodePipeline* pipeline, int index) {
+    std::unique_lock<std::mutex> lock(pipeline->mutex);
+    while (true) {
+        pipeline->jobCv.wait(lock, [pipeline] { return pipeline->stopping || !pipeline->jobs.empty(); });
+        if (pipeline->stopping) {
+            break;
+        }
+        DecodeJob job = pipeline->jobs.front();
+        pipeline->jobs.pop_front();
+        uint64_t generation = pipeline->generation;
+        lock.unlock();
+
+        int64_t startUs = thread_cpu_us();
+        DmsPicture picture;
+        int decoded = dms_j2k_decoder_decode(pipeline->decoder, job.frame.unit->Data, job.frame.unit->Length,
+                                             &picture);
+        wipe_frame(&job.frame);
+        int64_t costUs = thread_cpu_us() - startUs;
+
+        lock.lock();
+        pipeline->busyUs[index] += costUs;
+        if (generation != pipeline->generation) {
+            // 解码期间发生了定位，结果作废
+            dms_picture_release(&picture);
+            pipeline->inFlight--;
+            pipeline->cancelled++;
+            pipeline->spaceCv.notify_all();
+            continue;
+        }
+        if (decoded != 0) {
+            pipeline->failures++;
+        }
+        // 立体帧的两眼由不同线程完成，先完成的一眼在缓冲中等待另一眼
+        DecodeResult& result = pipeline->results[job.seq];
+        if (job.eye == 0) {
+            result.frame = job.frame;
+            result.picture = picture;
+            result.result = decoded;
+        } else {
+            result.right = picture;
+            result.rightResult = decoded;
+        }
+        result.eyes = job.eyes;
+        if (++result.done == result.eyes) {
+            pipeline->resultCv.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief 创建并行解码器并启动解码线程
+ * @param decoder J2K解码器，由调用者持有，生命周期须长于并行解码器
+ * @param config 配置，为空时使用默认配置
+ * @return 成功返回并行解码器指针，失败返回NULL
+ */
+struct DmsDecodePipeline* dms_decode_pipeline_create(struct DmsJ2kDecoder* decoder,
+                                                    const struct DmsDecodePipelineConfig* config) {
+    if (!decoder) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    int workers = (config && config->workers > 0) ? config->workers : (int)std::thread::hardware_concurrency();
+    workers = workers < 1 ? 1 : (workers > DMS_DECODE_MAX_WORKERS ? DMS_DECODE_MAX_WORKERS : workers);
+    // 至少能让每个解码线程各持有一帧
+    int maxInFlight = (config && config->maxInFlight > 0) ? config->maxInFlight : workers * 2;
+    maxInFlight = maxInFlight < workers ? workers : maxInFlight;
+
+    DmsDecodePipeline* pipeline = new DmsDecodePipeline();
+    pipeline->decoder = decoder;
+    pipeline->workerCount = workers;
+    pipeline->maxInFlight = maxInFlight;
+    pipeline->nextSubmit = 0;
+    pipeline->nextEmit = 0;
+    pipeline->generation = 0;
+    pipeline->inFlight = 0;
+    pipeline->stopping = false;
+    pipeline->startUs = now_us();
+    memset(pipeline->busyUs, 0, sizeof(pipeline->busyUs));
+    pipeline->peakInFlight = 0;
+    pipeline->submitted = 0;
+    pipeline->emitted = 0;
+    pipeline->cancelled = 0;
+    pipeline->failures = 0;
+    pipeline->stereoFrames = 0;
+    pipeline->headOfLineWaits = 0;
+    for (int i = 0; i < workers; i++) {
+        pipeline->workers.emplace_back(worker_main, pipeline, i);
+    }
+    LOGI("Decode pipeline started: %d workers, %d frames in flight", workers, maxInFlight);
+    return pipeline;
+}
+
+/**
+ * @brief 丢弃全部未输出的帧，须持有pipeline->mutex
+ * @param pipeline 并行解码器
+ */
+static void flush_locked(DmsDecodePipeline* pipeline) {
+    for (DecodeJob& job : pipeline->jobs) {
+        wipe_frame(&job.frame);
+    }
+    int32_t dropped = (int32_t)pipeline->jobs.size();
+    for (auto& entry : pipeline->results) {
+        dms_picture_release(&entry.second.picture);
+        dms_picture_release(&entry.second.right);
+        dropped += entry.second.done;
+    }
+    pipeline->inFlight -= dropped;
+    pipeline->cancelled += dropped;
+    pipeline->jobs.clear();
+    pipeline->results.clear();
+    pipeline->pendingFrames.clear();
+    // 解码中的帧仍计入持有数，完成时按代数作废
+    pipeline->generation++;
+    pipeline->nextEmit = pipeline->nextSubmit;
+    pipeline->spaceCv.notify_all();
+}
+
+/**
+ * @brief 停止解码线程并释放全部帧
+ * @param pipeline 并行解码器
+ */
+void dms_decode_pipeline_destroy(struct DmsDecodePipeline* pipeline) {
+    if (!pipeline) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pipeline->mutex);
+        pipeline->stopping = true;
+        pipeline->jobCv.notify_all();
+    }
+    for (std::thread& worker : pipeline->workers) {
+        worker.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(pipeline->mutex);
+        flush_locked(pipeline);
+    }
+    LOGI("Decode pipeline stopped: %lld emitted, %lld cancelled, %lld failures, peak %d in flight",
+         (long long)pipeline->emitted, (long long)pipeline->cancelled, (long long)pipeline->failures,
+         pipeline->peakInFlight);
+    delete pipeline;
+}
+
+/**
+ * @brief 按显示顺序提交一帧码流，持有帧数已达上限时等待；立体帧拆为两眼两个解码任务
+ * @param pipeline 并行解码器
+ * @param frame 帧，提交成功后码流归并行解码器所有，frame->unit与frame->rightUnit被置空
+ * @param timeoutUs 等待上限（微秒），0表示不等待，小于0表示一直等待
+ * @return 成功返回0，参数错误返回-1，超时仍满返回1
+ */
+int dms_decode_pipeline_submit(struct DmsDecodePipeline* pipeline, struct DmsFrame* frame, int64_t timeoutUs) {
+    if (!pipeline || !frame || !frame->unit || !frame->unit->Data) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::unique_lock<std::mutex> lock(pipeline->mutex);
+    if (!wait_for(pipeline->spaceCv, lock, timeoutUs,
+                  [pipeline] { return pipeline->inFlight < pipeline->maxInFlight; })) {
+        return 1;
+    }
+    DecodeJob job;
+    job.seq = pipeline->nextSubmit++;
+    job.eye = 0;
+    job.eyes = frame->rightUnit ? 2 : 1;
+    job.frame = *frame;
+    job.frame.rightUnit = nullptr;
+    pipeline->jobs.push_back(job);
+    if (frame->rightUnit) {
+        // 右眼紧随左眼排队，空闲的解码线程各取一眼同时解码
+        DecodeJob right = job;
+        right.eye = 1;
+        right.frame.unit = frame->rightUnit;
+        right.frame.cached = false;
+        pipeline->jobs.push_back(right);
+        pipeline->stereoFrames++;
+    }
+    frame->unit = nullptr;
+    frame->rightUnit = nullptr;
+    pipeline->pendingFrames.emplace_back(job.frame.frame, job.frame.timeUs);
+    pipeline->inFlight += job.eyes;
+    pipeline->submitted++;
+    if (pipeline->inFlight > pipeline->peakInFlight) {
+        pipeline->peakInFlight = pipeline->inFlight;
+    }
+    if (job.eyes > 1) {
+        pipeline->jobCv.notify_all();
+    } else {
+        pipeline->jobCv.notify_one();
+    }
+    return 0;
+}
+
+/**
+ * @brief 按提交顺序取出下一帧的解码结果
+ * @param pipeline 并行解码器
+ * @param outFrame 输出帧信息（帧号与时间戳），码流已释放
+ * @param outPicture 输出图像，使用后由dms_picture_release释放；立体帧只输出左眼
+ * @param timeoutUs 等待上限（微秒），0表示不等待，小于0表示一直等待
+ * @return 成功返回0，参数错误返回-1，没有已提交的帧或超时返回1，
+ *         该帧解码失败返回-3（outFrame有效，outPicture为空）
+ */
+int dms_decode_pipeline_receive(struct DmsDecodePipeline* pipeline, struct DmsFrame* outFrame,
+                                struct DmsPicture* outPicture, int64_t timeoutUs) {
+    struct DmsPicture right;
+    memset(&right, 0, sizeof(right));
+    int result = dms_decode_pipeline_receive_stereo(pipeline, outFrame, outPicture, &right, timeoutUs);
+    dms_picture_release(&right);
+    return result;
+}
+
+/**
+ * @brief 按提交顺序取出下一帧两眼的解码结果，立体帧两眼都完成后才返回
+ * @param pipeline 并行解码器
+ * @param outFrame 输出帧信息（帧号与时间戳），码流已释放
+ * @param outLeft 输出左眼（2D帧即该帧）图像，使用后由dms_picture_release释放
+ * @param outRight 输出右眼图像，使用后由dms_picture_release释放；2D帧或右眼解码失败时为空
+ * @param timeoutUs 等待上限（微秒），0表示不等待，小于0表示一直等待
+ * @return 成功返回0，参数错误返回-1，没有已提交的帧或超时返回1，
+ *         左眼解码失败返回-3（outFrame有效，两眼图像均为空）
+ */
+int dms_decode_pipeline_receive_stereo(struct DmsDecodePipeline* pipeline, struct DmsFrame* outFrame,
+                                       struct DmsPicture* outLeft, struct DmsPicture* outRight,
+                                       int64_t timeoutUs) {
+    if (!pipeline || !outFrame || !outLeft || !outRight) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::unique_lock<std::mutex> lock(pipeline->mutex);
+    if (pipeline->nextEmit == pipeline->nextSubmit) {
+        return 1;
+    }
+    if (!ready_locked(pipeline, pipeline->nextEmit) &&
+        pipeline->results.size() > pipeline->results.count(pipeline->nextEmit)) {
+        // 后续帧已完成而下一帧仍在解码
+        pipeline->headOfLineWaits++;
+    }
+    uint64_t generation = pipeline->generation;
+    if (!wait_for(pipeline->resultCv, lock, timeoutUs, [pipeline, generation] {
+            return generation != pipeline->generation || ready_locked(pipeline, pipeline->nextEmit);
+        }) || generation != pipeline->generation) {
+        return 1;
+    }
+    auto it = pipeline->results.find(pipeline->nextEmit);
+    DecodeResult result = it->second;
+    pipeline->results.erase(it);
+    pipeline->nextEmit++;
+    pipeline->pendingFrames.pop_front();
+    pipeline->inFlight -= result.eyes;
+    pipeline->emitted++;
+    pipeline->spaceCv.notify_all();
+    lock.unlock();
+
+    if (result.result != 0 || (result.eyes > 1 && result.rightResult != 0)) {
+        // 左眼失败时整帧失败；右眼失败时只输出左眼，由显示端按2D处理
+        dms_picture_release(&result.right);
+    }
+    *outFrame = result.frame;
+    *outLeft = result.picture;
+    *outRight = result.right;
+    return result.result == 0 ? 0 : -3;
+}
+
+/**
+ * @brief 是否已达到持有帧数上限，取帧阶段据此决定是否继续读取
+ * @param pipeline 并行解码器
+ * @return 已满返回true
+ */
+bool dms_decode_pipeline_full(struct DmsDecodePipeline* pipeline) {
+    if (!pipeline) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    return pipeline->inFlight >= pipeline->maxInFlight;
+}
+
+/**
+ * @brief 丢弃全部未输出的帧，定位或变速时调用；之后提交的帧从头开始排序
+ * @param pipeline 并行解码器
+ * @param outTimeUs 输出被丢弃的第一帧的时间戳（微秒），可为空
+ * @return 被丢弃的第一帧（即下一应显示帧）的帧号，没有丢弃或帧号未知返回-1
+ */
+int64_t dms_decode_pipeline_flush(struct DmsDecodePipeline* pipeline, int64_t* outTimeUs) {
+    if (!pipeline) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    int64_t first = -1;
+    if (!pipeline->pendingFrames.empty()) {
+        first = pipeline->pendingFrames.front().first;
+        if (outTimeUs) {
+            *outTimeUs = pipeline->pendingFrames.front().second;
+        }
+    }
+    flush_locked(pipeline);
+    pipeline->resultCv.notify_all();
+    return first;
+}
+
+/**
+ * @brief 获取并行解码统计信息
+ * @param pipeline 并行解码器
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回-1
+ */
+int dms_decode_pipeline_get_stats(struct DmsDecodePipeline* pipeline, struct DmsDecodePipelineStats* outStats) {
+    if (!pipeline || !outStats) {
+        return -1;
+    }
+    memset(outStats, 0, sizeof(*outStats));
+    int64_t elapsedUs = now_us() - pipeline->startUs;
+    std::lock_guard<std::mutex> lock(pipeline->mutex);
+    outStats->workers = pipeline->workerCount;
+    outStats->inFlight = pipeline->inFlight;
+    outStats->peakInFlight = pipeline->peakInFlight;
+    outStats->reorderedFrames = (int32_t)(pipeline->results.size() - pipeline->results.count(pipeline->nextEmit));
+    outStats->submitted = pipeline->submitted;
+    outStats->emitted = pipeline->emitted;
+    outStats->cancelled = pipeline->cancelled;
+    outStats->failures = pipeline->failures;
+    outStats->stereoFrames = pipeline->stereoFrames;
+    outStats->headOfLineWaits = pipeline->headOfLineWaits;
+    for (int i = 0; i < pipeline->workerCount; i++) {
+        outStats->utilization[i] = elapsedUs > 0 ? (float)pipeline->busyUs[i] / (float)elapsedUs : 0.0f;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#ifndef DMS_DECODE_PIPELINE_H
+#define DMS_DECODE_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "libdms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 帧级并行解码
+ *
+ * DCI码流全部为帧内编码，相邻帧互不依赖。取帧阶段按显示顺序提交的码流分发给
+ * M个解码线程同时解码，结果放入重排缓冲，严格按提交顺序（即PTS顺序）输出；
+ * 某帧解码较慢时后续已完成的帧在缓冲中等待，不会越过它输出。
+ *
+ * 排队、解码中和已完成未取走的帧总数不超过maxInFlight，提交时满则等待，以此
+ * 限制解密码流和解码图像占用的内存。定位时清空：未开始的帧直接丢弃，正在解码
+ * 的帧完成后丢弃其结果（OpenJPEG不能中途中断，每个解码线程至多再解完一帧），
+ * 缓冲中已完成的帧立即释放。码流在解码后即清零释放。
+ *
+ * 立体素材的帧（DmsFrame::rightUnit非空）拆为左右眼两个解码任务，由不同的解码线程同时解码，
+ * 两眼都完成后该帧才可输出；持有数按眼计，一个立体帧占两个。
+ */
+
+struct DmsFrame;
+struct DmsPicture;
+struct DmsJ2kDecoder;
+
+#define DMS_DECODE_MAX_WORKERS 16
+
+// 并行解码配置
+struct DmsDecodePipelineConfig {
+    int32_t workers;         // 解码线程数M，0表示按CPU核数
+    int32_t maxInFlight;     // 同时持有的最大帧数（排队+解码中+待输出，立体帧按两帧计），0表示2M
+};
+
+// 并行解码统计信息
+struct DmsDecodePipelineStats {
+    int32_t workers;         // 解码线程数
+    int32_t inFlight;        // 当前持有的帧数
+    int32_t peakInFlight;    // 持有帧数的峰值
+    int32_t reorderedFrames; // 当前在重排缓冲中等待前序帧的帧数
+    int64_t submitted;       // 已提交的帧数
+    int64_t emitted;         // 已输出的帧数
+    int64_t cancelled;       // 因定位被丢弃的帧数
+    int64_t failures;        // 解码失败的帧数（立体帧按眼计）
+    int64_t stereoFrames;    // 已提交的立体帧数（两眼并行解码）
+    int64_t headOfLineWaits; // 取帧时下一帧未完成而后续帧已完成的次数
+    float utilization[DMS_DECODE_MAX_WORKERS]; // 各解码线程解码占用的CPU时间占比（0~1）
+};
+
+struct DmsDecodePipeline;
+
+struct DmsDecodePipeline* dms_decode_pipeline_create(struct DmsJ2kDecoder* decoder,
+                                                    const struct DmsDecodePipelineConfig* config); // 创建并启动解码线程
+void dms_decode_pipeline_destroy(struct DmsDecodePipeline* pipeline);      // 停止解码线程并释放全部帧
+int dms_decode_pipeline_submit(struct DmsDecodePipeline* pipeline, struct DmsFrame* frame,
+                               int64_t timeoutUs);                         // 按显示顺序提交一帧码流
+int dms_decode_pipeline_receive(struct DmsDecodePipeline* pipeline, struct DmsFrame* outFrame,
+                                struct DmsPicture* outPicture, int64_t timeoutUs); // 按提交顺序取出解码结果
+int dms_decode_pipeline_receive_stereo(struct DmsDecodePipeline* pipeline, struct DmsFrame* outFrame,
+                                       struct DmsPicture* outLeft, struct DmsPicture* outRight,
+                                       int64_t timeoutUs);                 // 按提交顺序取出两眼的解码结果
+bool dms_decode_pipeline_full(struct DmsDecodePipeline* pipeline);        // 是否已达到持有上限
+int64_t dms_decode_pipeline_flush(struct DmsDecodePipeline* pipeline,
+                                  int64_t* outTimeUs);      // 丢弃全部未输出的帧，返回其中第一帧的帧号
+int dms_decode_pipeline_get_stats(struct DmsDecodePipeline* pipeline,
+                                  struct DmsDecodePipelineStats* outStats); // 获取统计信息
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_DECODE_PIPELINE_H
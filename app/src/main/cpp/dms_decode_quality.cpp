@@ -0,0 +1,145 @@
+#include "dms_decode_quality.h"
+#include "dms_j2k_decoder.h"
+#include <string.h>
+
+static const float kEwmaAlpha = 0.3f;       // 耗时滑动平均系数，较大以便及时发现压力
+static const int32_t kDegradeFrames = 3;    // 连续超出预算的帧数达到此值时降档
+static const int64_t kRestoreUs = 2000000;  // 持续有余量2秒后升档
+static const int32_t kSettleFrames = 6;     // 切换档位后忽略的帧数
+static const float kRestoreMargin = 0.8f;   // 预测上一档耗时不超过预算的80%才升档
+
+/**
+ * @brief 重置为全质量并清空统计
+ * @param quality 解码质量策略
+ * @param enabled 是否自适应
+ */
+void dms_decode_quality_reset(struct DmsDecodeQuality* quality, bool enabled) {
+    memset(quality, 0, sizeof(*quality));
+    quality->enabled = enabled;
+    quality->maxLevel = DMS_J2K_MAX_REDUCE;
+}
+
+/**
+ * @brief 设置码流的质量层数：多于一层时第一档只丢弃质量层
+ * @param quality 解码质量策略
+ * @param layers 质量层数，未知为0
+ */
+void dms_decode_quality_set_layers(struct DmsDecodeQuality* quality, int32_t layers) {
+    bool multiLayer = layers > 1;
+    if (multiLayer == quality->multiLayer) {
+        return;
+    }
+    quality->multiLayer = multiLayer;
+    quality->maxLevel = DMS_J2K_MAX_REDUCE + (multiLayer ? 1 : 0);
+    if (quality->level > quality->maxLevel) {
+        quality->level = quality->maxLevel;
+    }
+}
+
+/**
+ * @brief 上报显示端的延后：帧实际显示时刻晚于计划时刻的时间
+ * @param quality 解码质量策略
+ * @param lateUs 延后（微秒）
+ */
+void dms_decode_quality_report_late(struct DmsDecodeQuality* quality, int64_t lateUs) {
+    float late = lateUs > 0 ? (float)lateUs : 0.0f;
+    // 降档前已排队的帧仍会延后显示，只有延后还在增加才说明跟不上
+    quality->lateRising = late > quality->lateUs;
+    quality->lateUs = late;
+}
+
+/**
+ * @brief 切换到新档位
+ * @param quality 解码质量策略
+ * @param level 新档位
+ */
+static void switch_level(struct DmsDecodeQuality* quality, int32_t level) {
+    if (level > quality->level) {
+        quality->pendingCostUs = quality->costUs;
+        quality->ratio[level] = 0.0f;
+        quality->degradeCount++;
+    } else {
+        quality->pendingCostUs = 0.0f;
+        quality->restoreCount++;
+    }
+    quality->level = level;
+    quality->costUs = 0.0f;
+    quality->lateUs = 0.0f;
+    quality->lateRising = false;
+    quality->settleFrames = kSettleFrames;
+    quality->overFrames = 0;
+    quality->slackFrames = 0;
+}
+
+/**
+ * @brief 上报一帧的解码耗时并调整档位
+ *        超出预算或显示延后超过半帧且仍在增加时计为压力，连续3帧降一档；
+ *        当前耗时×实测耗时比预测的上一档耗时不超过预算的80%且显示不延后，持续2秒升一档
+ * @param quality 解码质量策略
+ * @param costUs 该帧的解码耗时（微秒）
+ * @param budgetUs 单帧解码预算：帧显示时长×可并行解码的帧数（微秒）
+ * @param intervalUs 帧显示时长（微秒）
+ * @param degraded 该帧是否按降低的质量解码
+ * @return 新档位
+ */
+int32_t dms_decode_quality_report(struct DmsDecodeQuality* quality, int64_t costUs, int64_t budgetUs,
+                                  int64_t intervalUs, bool degraded) {
+    quality->frames++;
+    if (degraded) {
+        quality->degradedFrames++;
+    }
+    if (!quality->enabled || budgetUs <= 0 || costUs < 0) {
+        return quality->level;
+    }
+    if (quality->settleFrames > 0) {
+        quality->settleFrames--;
+        return quality->level;
+    }
+
+    float sample = (float)costUs;
+    quality->costUs = quality->costUs <= 0.0f ? sample : quality->costUs + kEwmaAlpha * (sample - quality->costUs);
+    if (quality->pendingCostUs > 0.0f && quality->ratio[quality->level] <= 0.0f) {
+        // 降档后第一个稳定的耗时：与降档前的耗时在同样的负载下测得
+        float ratio = quality->pendingCostUs / quality->costUs;
+        quality->ratio[quality->level] = ratio > 1.0f ? ratio : 1.0f;
+        quality->pendingCostUs = 0.0f;
+    }
+
+    bool late = quality->lateRising && quality->lateUs * 2 > (float)intervalUs;
+    if (quality->costUs > (float)budgetUs || late) {
+        quality->slackFrames = 0;
+        if (++quality->overFrames >= kDegradeFrames && quality->level < quality->maxLevel) {
+            switch_level(quality, quality->level + 1);
+        }
+        return quality->level;
+    }
+    quality->overFrames = 0;
+
+    if (quality->level > 0) {
+        float ratio = quality->ratio[quality->level] > 0.0f ? quality->ratio[quality->level] : 4.0f;
+        bool slack = quality->costUs * ratio <= (float)budgetUs * kRestoreMargin && quality->lateUs * 4 <= (float)intervalUs;
+        quality->slackFrames = slack ? quality->slackFrames + 1 : 0;
+        if ((int64_t)quality->slackFrames * intervalUs >= kRestoreUs) {
+            switch_level(quality, quality->level - 1);
+        }
+    }
+    return quality->level;
+}
+
+/**
+ * @brief 当前档位的解码参数
+ * @param quality 解码质量策略
+ * @param outLayers 输出解码的质量层数，0表示全部
+ * @param outExtraReduce 输出在按画面尺寸选择的分辨率层之上多丢弃的小波层数
+ */
+void dms_decode_quality_params(const struct DmsDecodeQuality* quality, int32_t* outLayers,
+                               int32_t* outExtraReduce) {
+    int32_t level = quality->enabled ? quality->level : 0;
+    if (quality->multiLayer) {
+        *outLayers = level > 0 ? 1 : 0;
+        *outExtraReduce = level > 1 ? level - 1 : 0;
+    } else {
+        *outLayers = 0;
+        *outExtraReduce = level;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef DMS_DECODE_QUALITY_H
+#define DMS_DECODE_QUALITY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 按显示时刻自适应的解码质量
+ *
+ * 每输出一帧，比较该帧的解码耗时与解码预算（帧显示时长×可并行解码的帧数），并参考显示端
+ * 上报的延后。连续超出预算时逐档降低质量，使慢设备以较低的画质按原帧率播放，而不是卡顿：
+ *   - 码流有多个质量层时，第一档只解码第一个质量层；
+ *   - 之后每档在按画面尺寸选择的分辨率层之上多丢弃一级小波分解（最多到1/8）。
+ * 降档快、升档慢（迟滞）：降档后按实测的两档耗时比预测上一档的耗时，持续有余量一段时间
+ * 后才升一档，避免在两档之间来回切换。
+ */
+
+#define DMS_QUALITY_MAX_LEVEL 4
+
+struct DmsDecodeQuality {
+    bool enabled;            // 是否自适应，关闭时始终全质量
+    int32_t level;           // 当前档位，0为全质量
+    int32_t maxLevel;        // 码流可用的最高档位
+    bool multiLayer;         // 码流有多个质量层
+    float costUs;            // 当前档位单帧解码耗时的滑动平均（微秒）
+    float ratio[DMS_QUALITY_MAX_LEVEL + 1]; // 各档位与上一档的解码耗时比，未测得为0
+    float pendingCostUs;     // 降档前上一档的耗时，用于计算耗时比
+    float lateUs;            // 显示端最近上报的延后（微秒）
+    bool lateRising;         // 延后比上一次上报增加
+    int32_t settleFrames;    // 切换档位后尚需忽略的帧数（在途帧仍按原档位解码）
+    int32_t overFrames;      // 连续超出预算的帧数
+    int32_t slackFrames;     // 连续有余量可升档的帧数
+    int64_t frames;          // 已评估的帧数
+    int64_t degradedFrames;  // 降质解码的帧数
+    int32_t degradeCount;    // 降档次数
+    int32_t restoreCount;    // 升档次数
+};
+
+void dms_decode_quality_reset(struct DmsDecodeQuality* quality, bool enabled); // 重置为全质量
+void dms_decode_quality_set_layers(struct DmsDecodeQuality* quality,
+                                   int32_t layers);                 // 设置码流的质量层数
+void dms_decode_quality_report_late(struct DmsDecodeQuality* quality,
+                                    int64_t lateUs);                // 上报显示端的延后
+int32_t dms_decode_quality_report(struct DmsDecodeQuality* quality, int64_t costUs, int64_t budgetUs,
+                                  int64_t intervalUs, bool degraded); // 上报一帧的解码耗时，返回新档位
+void dms_decode_quality_params(const struct DmsDecodeQuality* quality, int32_t* outLayers,
+                               int32_t* outExtraReduce);            // 当前档位的解码参数
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_DECODE_QUALITY_H
@@ -0,0 +1,278 @@
+#include "dms_frame_cache.h"
+#include "dms_log.h"
+#include <string.h>
+#include <time.h>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#define LOG_TAG "DmsFrameCache"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int64_t kPressureHoldUs = 30000000;  // 30秒内没有新的内存警告后恢复配置容量
+
+struct CacheEntry {
+    DmsCachedFrame info;
+    std::vector<uint32_t> pixels;
+};
+
+struct DmsFrameCache {
+    int64_t capacityBytes;           // 配置容量
+    int64_t limitBytes;              // 当前容量
+    int64_t pressureUs;              // 最近一次内存警告的时刻，无为-1
+    std::list<CacheEntry> entries;   // 按最近使用排序，表头最新
+    std::unordered_map<int64_t, std::list<CacheEntry>::iterator> index;
+    std::vector<uint32_t> spare;     // 最近淘汰的像素缓冲，供下一次放入复用，避免反复分配数MB内存
+    struct DmsFrameCacheStats stats;
+};
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+// 键：帧号×8 + 丢弃的小波层数（最多3层）
+static inline int64_t make_key(int64_t frame, int32_t reduce) {
+    return frame * 8 + (reduce & 7);
+}
+
+static inline int64_t entry_bytes(const CacheEntry& entry) {
+    return (int64_t)entry.pixels.size() * sizeof(uint32_t);
+}
+
+/**
+ * @brief 淘汰最久未用的帧，直到占用不超过limit
+ * @param cache 缓存
+ * @param limit 字节数上限
+ * @param keepSpare 是否保留一个淘汰的像素缓冲供复用
+ */
+static void evict_to(DmsFrameCache* cache, int64_t limit, bool keepSpare) {
+    while (!cache->entries.empty() && cache->stats.bytes > limit) {
+        CacheEntry& victim = cache->entries.back();
+        cache->stats.bytes -= entry_bytes(victim);
+        cache->index.erase(make_key(victim.info.frame, victim.info.reduce));
+        if (keepSpare && victim.pixels.capacity() > cache->spare.capacity()) {
+            cache->spare.swap(victim.pixels);
+        }
+        cache->entries.pop_back();
+        cache->stats.evictions++;
+    }
+    cache->stats.frames = (int32_t)cache->entries.size();
+}
+
+/**
+ * @brief 内存警告过去一段时间后恢复配置容量
+ * @param cache 缓存
+ */
+static void relax_pressure(DmsFrameCache* cache) {
+    if (cache->pressureUs >= 0 && now_us() - cache->pressureUs >= kPressureHoldUs) {
+        cache->pressureUs = -1;
+        cache->limitBytes = cache->capacityBytes;
+        cache->stats.limitBytes = cache->limitBytes;
+        LOGI("Memory pressure relieved, capacity restored to %lld bytes", (long long)cache->limitBytes);
+    }
+}
+
+/**
+ * @brief 创建解码帧缓存
+ * @param capacityBytes 最大字节数
+ * @return 成功返回缓存指针，失败返回NULL
+ */
+struct DmsFrameCache* dms_frame_cache_create(int64_t capacityBytes) {
+    if (capacityBytes <= 0) {
+        LOGE("Invalid capacity: %lld", (long long)capacityBytes);
+        return nullptr;
+    }
+    DmsFrameCache* cache = new DmsFrameCache();
+    cache->capacityBytes = capacityBytes;
+    cache->limitBytes = capacityBytes;
+    cache->pressureUs = -1;
+    cache->stats = {};
+    cache->stats.limitBytes = capacityBytes;
+    return cache;
+}
+
+/**
+ * @brief 释放缓存
+ * @param cache 缓存
+ */
+void dms_frame_cache_destroy(struct DmsFrameCache* cache) {
+    if (!cache) {
+        return;
+    }
+    LOGI("Frame cache: %lld lookups, %lld hits, %lld evictions, %lld trims", (long long)cache->stats.lookups,
+         (long long)cache->stats.hits, (long long)cache->stats.evictions, (long long)cache->stats.trims);
+    delete cache;
+}
+
+/**
+ * @brief 清空缓存并释放像素内存，统计保留
+ * @param cache 缓存
+ */
+void dms_frame_cache_clear(struct DmsFrameCache* cache) {
+    if (!cache) {
+        return;
+    }
+    cache->entries.clear();
+    cache->index.clear();
+    std::vector<uint32_t>().swap(cache->spare);
+    cache->stats.bytes = 0;
+    cache->stats.frames = 0;
+}
+
+/**
+ * @brief 设置容量并解除内存紧张的限制，超出时淘汰最久未用的帧
+ * @param cache 缓存
+ * @param capacityBytes 最大字节数
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_frame_cache_set_capacity(struct DmsFrameCache* cache, int64_t capacityBytes) {
+    if (!cache || capacityBytes <= 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    cache->capacityBytes = capacityBytes;
+    cache->limitBytes = capacityBytes;
+    cache->pressureUs = -1;
+    cache->stats.limitBytes = capacityBytes;
+    evict_to(cache, capacityBytes, false);
+    return 0;
+}
+
+/**
+ * @brief 放入帧并复制像素，放在最近使用端；同一帧号与分辨率层的旧帧被替换，
+ *        超出容量时淘汰最久未用的帧
+ * @param cache 缓存
+ * @param frame 帧
+ * @return 成功返回0，参数错误返回-1，帧大于当前容量返回-3
+ */
+int dms_frame_cache_put(struct DmsFrameCache* cache, const struct DmsCachedFrame* frame) {
+    if (!cache || !frame || !frame->pixels || frame->width <= 0 || frame->height <= 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    relax_pressure(cache);
+    size_t count = (size_t)frame->width * frame->height;
+    int64_t bytes = (int64_t)(count * sizeof(uint32_t));
+    if (bytes > cache->limitBytes) {
+        return -3;
+    }
+
+    int64_t key = make_key(frame->frame, frame->reduce);
+    auto found = cache->index.find(key);
+    if (found != cache->index.end()) {
+        cache->stats.bytes -= entry_bytes(*found->second);
+        cache->spare.swap(found->second->pixels);
+        cache->entries.erase(found->second);
+        cache->index.erase(found);
+    }
+    evict_to(cache, cache->limitBytes - bytes, true);
+
+    cache->entries.emplace_front();
+    CacheEntry& entry = cache->entries.front();
+    entry.pixels.swap(cache->spare);
+    entry.pixels.resize(count);
+    memcpy(entry.pixels.data(), frame->pixels, count * sizeof(uint32_t));
+    entry.info = *frame;
+    entry.info.pixels = entry.pixels.data();
+    cache->index[key] = cache->entries.begin();
+    cache->stats.bytes += entry_bytes(entry);
+    cache->stats.frames = (int32_t)cache->entries.size();
+    cache->stats.insertions++;
+    return 0;
+}
+
+/**
+ * @brief 查询帧，命中时移到最近使用端
+ * @param cache 缓存
+ * @param frame 帧号
+ * @param reduce 丢弃的小波层数
+ * @return 命中返回缓存帧（下一次修改缓存前有效），未命中返回NULL
+ */
+const struct DmsCachedFrame* dms_frame_cache_get(struct DmsFrameCache* cache, int64_t frame, int32_t reduce) {
+    if (!cache) {
+        return nullptr;
+    }
+    cache->stats.lookups++;
+    auto found = cache->index.find(make_key(frame, reduce));
+    if (found == cache->index.end()) {
+        return nullptr;
+    }
+    cache->stats.hits++;
+    cache->entries.splice(cache->entries.begin(), cache->entries, found->second);
+    return &found->second->info;
+}
+
+/**
+ * @brief 是否有该帧，用于规划预解码，不计入命中率、不调整顺序
+ * @param cache 缓存
+ * @param frame 帧号
+ * @param reduce 丢弃的小波层数
+ * @return 有返回true
+ */
+bool dms_frame_cache_contains(struct DmsFrameCache* cache, int64_t frame, int32_t reduce) {
+    return cache && cache->index.count(make_key(frame, reduce)) > 0;
+}
+
+/**
+ * @brief 当前容量，内存紧张时小于配置容量
+ * @param cache 缓存
+ * @return 字节数
+ */
+int64_t dms_frame_cache_get_limit(struct DmsFrameCache* cache) {
+    if (!cache) {
+        return 0;
+    }
+    relax_pressure(cache);
+    return cache->limitBytes;
+}
+
+/**
+ * @brief 内存警告：按等级缩小容量并立即淘汰超出的帧，30秒内没有新的警告后恢复
+ * @param cache 缓存
+ * @param level 内存紧张等级，DmsTrimLevel
+ */
+void dms_frame_cache_trim(struct DmsFrameCache* cache, int level) {
+    if (!cache || level < DMS_TRIM_RUNNING_MODERATE) {
+        return;
+    }
+    int64_t limit;
+    if (level >= DMS_TRIM_COMPLETE) {
+        limit = 0;
+    } else if (level >= DMS_TRIM_RUNNING_CRITICAL) {
+        limit = cache->capacityBytes / 4;
+    } else if (level >= DMS_TRIM_RUNNING_LOW) {
+        limit = cache->capacityBytes / 2;
+    } else {
+        limit = cache->capacityBytes * 3 / 4;
+    }
+    // 连续警告取较严的限制
+    if (cache->pressureUs >= 0 && cache->limitBytes < limit) {
+        limit = cache->limitBytes;
+    }
+    cache->limitBytes = limit;
+    cache->pressureUs = now_us();
+    cache->stats.limitBytes = limit;
+    cache->stats.trims++;
+    evict_to(cache, limit, false);
+    std::vector<uint32_t>().swap(cache->spare);
+    LOGI("Memory pressure level %d: capacity %lld bytes, %d frames kept", level, (long long)limit,
+         cache->stats.frames);
+}
+
+/**
+ * @brief 获取统计信息
+ * @param cache 缓存
+ * @param outStats 输出统计信息
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_frame_cache_get_stats(struct DmsFrameCache* cache, struct DmsFrameCacheStats* outStats) {
+    if (!cache || !outStats) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outStats = cache->stats;
+    return 0;
+}
@@ -0,0 +1,78 @@
+#ifndef DMS_FRAME_CACHE_H
+#define DMS_FRAME_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 解码帧缓存
+ *
+ * 按字节数限定容量的LRU缓存，保存最近显示的帧和暂停时预先解码的后续帧（已转换的RGB像素，
+ * 只在进程内存中）。键为帧号与解码分辨率层（丢弃的小波层数），不同分辨率的同一帧互不替代。
+ * 暂停后逐帧后退、小范围回退和继续播放时直接取缓存，不必重新定位与解码。
+ *
+ * 缓存由单一线程（渲染器的生产线程）使用，不加锁；get返回的帧在下一次put、clear、
+ * trim或set_capacity之前有效。内存紧张时按系统的内存等级（与Android
+ * ComponentCallbacks2.onTrimMemory一致）缩小容量，一段时间没有新的内存警告后恢复。
+ */
+
+#define DMS_FRAME_CACHE_DEFAULT_BYTES (96LL * 1024 * 1024)
+
+// 内存紧张等级（取值与Android ComponentCallbacks2一致）
+enum DmsTrimLevel {
+    DMS_TRIM_RUNNING_MODERATE = 5,   // 容量降为3/4
+    DMS_TRIM_RUNNING_LOW = 10,       // 容量降为1/2
+    DMS_TRIM_RUNNING_CRITICAL = 15,  // 容量降为1/4（含退到后台等更高等级）
+    DMS_TRIM_COMPLETE = 80,          // 清空，暂停缓存
+};
+
+// 缓存帧
+struct DmsCachedFrame {
+    int64_t frame;           // 帧号（整部影片）
+    int32_t reduce;          // 解码时丢弃的小波层数
+    int32_t width;           // 宽度（像素）
+    int32_t height;          // 高度（像素）
+    int64_t timeUs;          // 显示时间戳（微秒）
+    int64_t durationUs;      // 显示时长（微秒）
+    const uint32_t* pixels;  // 像素，行优先，每行width个
+};
+
+// 缓存统计信息
+struct DmsFrameCacheStats {
+    int64_t lookups;         // 查询次数
+    int64_t hits;            // 命中次数
+    int64_t insertions;      // 放入次数
+    int64_t evictions;       // 因容量淘汰的帧数
+    int64_t trims;           // 收到内存警告的次数
+    int64_t bytes;           // 当前占用的字节数
+    int64_t limitBytes;      // 当前容量（内存紧张时小于配置容量）
+    int32_t frames;          // 当前帧数
+};
+
+struct DmsFrameCache;
+
+struct DmsFrameCache* dms_frame_cache_create(int64_t capacityBytes); // 创建缓存，capacityBytes为最大字节数
+void dms_frame_cache_destroy(struct DmsFrameCache* cache);           // 释放缓存
+void dms_frame_cache_clear(struct DmsFrameCache* cache);             // 清空缓存
+int dms_frame_cache_set_capacity(struct DmsFrameCache* cache,
+                                 int64_t capacityBytes);             // 设置容量，超出时淘汰最久未用的帧
+int dms_frame_cache_put(struct DmsFrameCache* cache,
+                        const struct DmsCachedFrame* frame);         // 放入帧（复制像素），同键替换
+const struct DmsCachedFrame* dms_frame_cache_get(struct DmsFrameCache* cache, int64_t frame,
+                                                 int32_t reduce);    // 查询帧并计入命中率，未命中返回NULL
+bool dms_frame_cache_contains(struct DmsFrameCache* cache, int64_t frame,
+                              int32_t reduce);                       // 是否有该帧，不计入统计、不调整顺序
+int64_t dms_frame_cache_get_limit(struct DmsFrameCache* cache);      // 当前容量（字节）
+void dms_frame_cache_trim(struct DmsFrameCache* cache, int level);   // 内存警告，level为DmsTrimLevel
+int dms_frame_cache_get_stats(struct DmsFrameCache* cache,
+                              struct DmsFrameCacheStats* outStats);  // 获取统计信息
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_FRAME_CACHE_H
@@ -0,0 +1,813 @@
+#include "dms_frame_index.h"
+#include "dms_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define LOG_TAG "DmsFrameIndex"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static_assert(sizeof(DmsIndexHeader) == 64, "DmsIndexHeader must be 64 bytes");
+static_assert(sizeof(DmsIndexBlockRef) == 32, "DmsIndexBlockRef must be 32 bytes");
+
+// Pos列编码方式（列首字节）
+enum {
+    POS_MODE_SIZE_PREDICT = 0,   // 残差 = Pos差 - 上一帧长度（Pos为字节偏移时接近常数）
+    POS_MODE_DOUBLE_DELTA = 1,   // 二阶差分（Pos为帧序号等线性递增时为0）
+};
+
+/* ---------------- varint 编解码 ---------------- */
+
+static inline uint64_t zigzag_encode(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t zigzag_decode(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline void varint_put(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+/**
+ * @brief 读取一个varint
+ * @param p 读指针，成功后前移
+ * @param end 缓冲区结尾
+ * @param out 输出值
+ * @return 成功返回true，数据越界或损坏返回false
+ */
+static inline bool varint_get(const uint8_t*& p, const uint8_t* end, uint64_t* out) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p >= end) {
+            return false;
+        }
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ---------------- 块编解码 ---------------- */
+
+struct RawEntry {
+    int64_t  pos;
+    int64_t  pts;
+    uint32_t size;
+};
+
+/**
+ * @brief 将连续帧编码为一个块
+ * @param entries 帧数组
+ * @param count 帧数（>=1）
+ * @param ref 输出顶层表项（offset由调用者填写）
+ * @param out 输出块数据
+ */
+static void encode_block(const RawEntry* entries, int count, DmsIndexBlockRef* ref, std::vector<uint8_t>* out) {
+    std::vector<uint8_t> posPredict, posDelta, sizeCol, ptsCol;
+    posPredict.push_back(POS_MODE_SIZE_PREDICT);
+    posDelta.push_back(POS_MODE_DOUBLE_DELTA);
+
+    int64_t prevPosDelta = 0;
+    int64_t prevPtsDelta = 0;
+    for (int i = 1; i < count; i++) {
+        int64_t posDiff = entries[i].pos - entries[i - 1].pos;
+        int64_t ptsDiff = entries[i].pts - entries[i - 1].pts;
+        varint_put(posPredict, zigzag_encode(posDiff - (int64_t)entries[i - 1].size));
+        varint_put(posDelta, zigzag_encode(posDiff - prevPosDelta));
+        varint_put(sizeCol, zigzag_encode((int64_t)entries[i].size - (int64_t)entries[i - 1].size));
+        varint_put(ptsCol, zigzag_encode(ptsDiff - prevPtsDelta));
+        prevPosDelta = posDiff;
+        prevPtsDelta = ptsDiff;
+    }
+
+    const std::vector<uint8_t>& posCol = (posDelta.size() < posPredict.size()) ? posDelta : posPredict;
+
+    memset(ref, 0, sizeof(*ref));
+    ref->firstPos = entries[0].pos;
+    ref->firstPts = entries[0].pts;
+    ref->firstSize = entries[0].size;
+    ref->count = (uint16_t)count;
+    ref->posBytes = (uint16_t)posCol.size();
+    ref->sizeBytes = (uint16_t)sizeCol.size();
+    ref->ptsBytes = (uint16_t)ptsCol.size();
+
+    out->clear();
+    out->reserve(posCol.size() + sizeCol.size() + ptsCol.size());
+    out->insert(out->end(), posCol.begin(), posCol.end());
+    out->insert(out->end(), sizeCol.begin(), sizeCol.end());
+    out->insert(out->end(), ptsCol.begin(), ptsCol.end());
+}
+
+/**
+ * @brief 解码块内前 upTo+1 帧，逐帧回调
+ * @param ref 顶层表项
+ * @param data 块数据起始地址
+ * @param upTo 解码到块内第几帧（含）
+ * @param fn 回调，返回false时提前结束
+ * @return 成功返回true，数据损坏返回false
+ */
+template <typename Fn>
+static bool decode_block(const DmsIndexBlockRef* ref, const uint8_t* data, int upTo, Fn&& fn) {
+    const uint8_t* posP = data;
+    const uint8_t* posEnd = posP + ref->posBytes;
+    const uint8_t* sizeP = posEnd;
+    const uint8_t* sizeEnd = sizeP + ref->sizeBytes;
+    const uint8_t* ptsP = sizeEnd;
+    const uint8_t* ptsEnd = ptsP + ref->ptsBytes;
+
+    if (posP >= posEnd) {
+        return false;
+    }
+    uint8_t posMode = *posP++;
+
+    RawEntry e = { ref->firstPos, ref->firstPts, ref->firstSize };
+    if (!fn(0, e)) {
+        return true;
+    }
+
+    int64_t posDiff = 0;
+    int64_t ptsDiff = 0;
+    for (int i = 1; i <= upTo; i++) {
+        uint64_t vPos, vSize, vPts;
+        if (!varint_get(posP, posEnd, &vPos) ||
+            !varint_get(sizeP, sizeEnd, &vSize) ||
+            !varint_get(ptsP, ptsEnd, &vPts)) {
+            return false;
+        }
+        if (posMode == POS_MODE_SIZE_PREDICT) {
+            posDiff = zigzag_decode(vPos) + (int64_t)e.size;
+        } else {
+            posDiff += zigzag_decode(vPos);
+        }
+        ptsDiff += zigzag_decode(vPts);
+        e.pos += posDiff;
+        e.pts += ptsDiff;
+        e.size = (uint32_t)((int64_t)e.size + zigzag_decode(vSize));
+        if (!fn(i, e)) {
+            break;
+        }
+    }
+    return true;
+}
+
+/* ---------------- 只读索引 ---------------- */
+
+struct DmsFrameIndex {
+    const uint8_t* base;              // mmap起始地址
+    size_t size;                      // 文件大小
+    const DmsIndexHeader* header;
+    const DmsIndexBlockRef* table;
+};
+
+/**
+ * @brief 以只读mmap方式打开索引文件
+ * @param path 索引文件路径
+ * @param outIndex 输出索引句柄
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_frame_index_open(const char* path, struct DmsFrameIndex** outIndex) {
+    if (!path || !outIndex) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outIndex = nullptr;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -2;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(DmsIndexHeader)) {
+        close(fd);
+        LOGE("Index file too small: %s", path);
+        return -3;
+    }
+
+    void* map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        LOGE("Failed to mmap index: %s", path);
+        return -4;
+    }
+    // 查询是随机访问，关闭预读，避免把无关页面带入内存
+    madvise(map, (size_t)st.st_size, MADV_RANDOM);
+
+    const uint8_t* base = (const uint8_t*)map;
+    const DmsIndexHeader* header = (const DmsIndexHeader*)base;
+    uint64_t tableEnd = header->tableOffset + (uint64_t)header->blockCount * sizeof(DmsIndexBlockRef);
+    if (header->magic != DMS_INDEX_MAGIC || header->version != DMS_INDEX_VERSION ||
+        header->blockShift == 0 || header->blockShift > 15 ||
+        header->tableOffset < sizeof(DmsIndexHeader) || (header->tableOffset & 7) != 0 ||
+        tableEnd > (uint64_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        LOGE("Invalid index file: %s", path);
+        return -5;
+    }
+
+    DmsFrameIndex* index = new DmsFrameIndex();
+    index->base = base;
+    index->size = (size_t)st.st_size;
+    index->header = header;
+    index->table = (const DmsIndexBlockRef*)(base + header->tableOffset);
+    *outIndex = index;
+    return 0;
+}
+
+/**
+ * @brief 关闭索引并解除映射
+ * @param index 索引句柄
+ */
+void dms_frame_index_close(struct DmsFrameIndex* index) {
+    if (!index) {
+        return;
+    }
+    munmap((void*)index->base, index->size);
+    delete index;
+}
+
+/**
+ * @brief 获取块数据地址并校验边界
+ * @return 块有效返回数据地址，否则返回nullptr
+ */
+static const uint8_t* block_data(const DmsFrameIndex* index, const DmsIndexBlockRef* ref) {
+    if (ref->count == 0) {
+        return nullptr;
+    }
+    uint64_t end = (uint64_t)ref->offset + ref->posBytes + ref->sizeBytes + ref->ptsBytes;
+    if (ref->offset < sizeof(DmsIndexHeader) || end > index->header->tableOffset) {
+        return nullptr;
+    }
+    return index->base + ref->offset;
+}
+
+/**
+ * @brief 按帧号查询索引项
+ * @param index 索引句柄
+ * @param frame 帧号
+ * @param outEntry 输出索引项
+ * @return 成功返回0，该帧未覆盖返回1，失败返回负数错误码
+ */
+int dms_frame_index_lookup(const struct DmsFrameIndex* index, int64_t frame, struct DmsFrameEntry* outEntry) {
+    if (!index || !outEntry || frame < 0) {
+        return -1;
+    }
+
+    uint32_t shift = index->header->blockShift;
+    uint64_t blockNo = (uint64_t)frame >> shift;
+    if (blockNo >= index->header->blockCount) {
+        return 1;
+    }
+
+    const DmsIndexBlockRef* ref = &index->table[blockNo];
+    int slot = (int)(frame & ((1 << shift) - 1));
+    if (slot >= ref->count) {
+        return 1;
+    }
+
+    const uint8_t* data = block_data(index, ref);
+    if (!data) {
+        return -2;
+    }
+
+    RawEntry found = {};
+    bool ok = decode_block(ref, data, slot, [&](int i, const RawEntry& e) {
+        found = e;
+        return i < slot;
+    });
+    if (!ok) {
+        LOGE("Corrupted index block %llu", (unsigned long long)blockNo);
+        return -3;
+    }
+
+    outEntry->frame = frame;
+    outEntry->pos = found.pos;
+    outEntry->pts = found.pts;
+    outEntry->size = found.size;
+    return 0;
+}
+
+/**
+ * @brief 按Pos反查帧号
+ * @param index 索引句柄
+ * @param pos 码流位置
+ * @return 找到返回帧号，否则返回-1
+ */
+int64_t dms_frame_index_find_pos(const struct DmsFrameIndex* index, int64_t pos) {
+    if (!index) {
+        return -1;
+    }
+
+    // 二分查找 firstPos <= pos 的最后一个非空块
+    int64_t lo = 0;
+    int64_t hi = (int64_t)index->header->blockCount - 1;
+    int64_t best = -1;
+    while (lo <= hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        int64_t m = mid;
+        while (m >= lo && index->table[m].count == 0) {
+            m--;
+        }
+        if (m < lo) {
+            lo = mid + 1;
+            continue;
+        }
+        if (index->table[m].firstPos <= pos) {
+            best = m;
+            lo = mid + 1;
+        } else {
+            hi = m - 1;
+        }
+    }
+    if (best < 0) {
+        return -1;
+    }
+
+    const DmsIndexBlockRef* ref = &index->table[best];
+    const uint8_t* data = block_data(index, ref);
+    if (!data) {
+        return -1;
+    }
+
+    int64_t frame = -1;
+    decode_block(ref, data, ref->count - 1, [&](int i, const RawEntry& e) {
+        if (e.pos == pos) {
+            frame = (best << index->header->blockShift) + i;
+            return false;
+        }
+        return e.pos < pos;
+    });
+    return frame;
+}
+
+/**
+ * @brief 获取总帧数
+ * @param index 索引句柄
+ * @return 总帧数，失败返回-1
+ */
+int64_t dms_frame_index_get_frame_count(const struct DmsFrameIndex* index) {
+    return index ? index->header->frameCount : -1;
+}
+
+/**
+ * @brief 获取索引文件头
+ * @param index 索引句柄
+ * @return 文件头指针（指向映射内存），失败返回nullptr
+ */
+const struct DmsIndexHeader* dms_frame_index_get_header(const struct DmsFrameIndex* index) {
+    return index ? index->header : nullptr;
+}
+
+/**
+ * @brief 获取索引统计信息
+ * @param index 索引句柄
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_frame_index_get_stats(const struct DmsFrameIndex* index, struct DmsFrameIndexStats* outStats) {
+    if (!index || !outStats) {
+        return -1;
+    }
+    outStats->frameCount = index->header->frameCount;
+    outStats->coveredFrames = index->header->coveredFrames;
+    outStats->blockCount = index->header->blockCount;
+    outStats->fileBytes = index->size;
+    outStats->bytesPerFrame = index->header->coveredFrames > 0
+            ? (double)index->size / (double)index->header->coveredFrames : 0.0;
+    return 0;
+}
+
+/* ---------------- 索引构建 ---------------- */
+
+// 构建中的块：完整块只保留编码结果，未完成的块保留原始帧
+struct WriterBlock {
+    DmsIndexBlockRef ref;                      // 编码结果对应的表项，count为0表示尚无编码结果
+    std::vector<uint8_t> encoded;              // 编码后的块数据
+    std::unique_ptr<RawEntry[]> pending;       // 未完成块的原始帧
+    std::vector<bool> filled;                  // 未完成块各帧是否已写入
+    int filledCount;
+};
+
+struct DmsFrameIndexWriter {
+    int64_t basePts;
+    int64_t ptsStep;
+    int64_t frameCount;                        // 已知总帧数，未知为-1
+    int64_t maxFrame;                          // 已写入的最大帧号
+    int64_t covered;                           // 已覆盖帧数
+    std::vector<WriterBlock> blocks;
+};
+
+static int writer_block_frames(const DmsFrameIndexWriter* writer, size_t blockNo) {
+    const int full = 1 << DMS_INDEX_BLOCK_SHIFT;
+    if (writer->frameCount < 0) {
+        return full;
+    }
+    int64_t remain = writer->frameCount - ((int64_t)blockNo << DMS_INDEX_BLOCK_SHIFT);
+    return remain < full ? (int)(remain > 0 ? remain : 0) : full;
+}
+
+/**
+ * @brief 创建索引构建器
+ * @param basePts 第0帧的PTS
+ * @param ptsStep 相邻帧PTS间隔，未知填0
+ * @return 构建器指针，失败返回nullptr
+ */
+struct DmsFrameIndexWriter* dms_frame_index_writer_create(int64_t basePts, int64_t ptsStep) {
+    DmsFrameIndexWriter* writer = new DmsFrameIndexWriter();
+    writer->basePts = basePts;
+    writer->ptsStep = ptsStep;
+    writer->frameCount = -1;
+    writer->maxFrame = -1;
+    writer->covered = 0;
+    return writer;
+}
+
+/**
+ * @brief 销毁索引构建器
+ * @param writer 构建器指针
+ */
+void dms_frame_index_writer_destroy(struct DmsFrameIndexWriter* writer) {
+    delete writer;
+}
+
+/**
+ * @brief 写入一帧，块内所有帧写齐后立即编码并释放原始数据
+ * @param writer 构建器指针
+ * @param frame 帧号
+ * @param pos 码流位置
+ * @param pts 显示时间戳
+ * @param size 数据单元长度
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_frame_index_writer_put(struct DmsFrameIndexWriter* writer, int64_t frame,
+                               int64_t pos, int64_t pts, uint32_t size) {
+    if (!writer || frame < 0) {
+        return -1;
+    }
+    if (writer->frameCount >= 0 && frame >= writer->frameCount) {
+        return -2;
+    }
+
+    size_t blockNo = (size_t)(frame >> DMS_INDEX_BLOCK_SHIFT);
+    int slot = (int)(frame & ((1 << DMS_INDEX_BLOCK_SHIFT) - 1));
+    if (blockNo >= writer->blocks.size()) {
+        writer->blocks.resize(blockNo + 1);
+    }
+    WriterBlock& block = writer->blocks[blockNo];
+    int blockFrames = writer_block_frames(writer, blockNo);
+
+    if (block.ref.count > slot) {
+        return 0; // 已覆盖
+    }
+
+    if (!block.pending) {
+        block.pending.reset(new RawEntry[1 << DMS_INDEX_BLOCK_SHIFT]);
+        block.filled.assign(1 << DMS_INDEX_BLOCK_SHIFT, false);
+        block.filledCount = 0;
+        // 已有部分编码结果时先还原为原始帧
+        if (block.ref.count > 0) {
+            decode_block(&block.ref, block.encoded.data(), block.ref.count - 1, [&](int i, const RawEntry& e) {
+                block.pending[i] = e;
+                block.filled[i] = true;
+                block.filledCount++;
+                return true;
+            });
+        }
+    }
+
+    if (!block.filled[slot]) {
+        block.pending[slot] = { pos, pts, size };
+        block.filled[slot] = true;
+        block.filledCount++;
+        writer->covered++;
+    }
+    if (frame > writer->maxFrame) {
+        writer->maxFrame = frame;
+    }
+
+    if (block.filledCount >= blockFrames) {
+        encode_block(block.pending.get(), blockFrames, &block.ref, &block.encoded);
+        block.pending.reset();
+        block.filled.clear();
+        block.filled.shrink_to_fit();
+        block.filledCount = 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief 设置码流真实总帧数（码流读到结尾时调用）
+ * @param writer 构建器指针
+ * @param frameCount 总帧数
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_frame_index_writer_set_frame_count(struct DmsFrameIndexWriter* writer, int64_t frameCount) {
+    if (!writer || frameCount < 0 || frameCount <= writer->maxFrame) {
+        return -1;
+    }
+    writer->frameCount = frameCount;
+
+    // 最后一块可能因此变为完整块
+    size_t lastBlock = (size_t)((frameCount + (1 << DMS_INDEX_BLOCK_SHIFT) - 1) >> DMS_INDEX_BLOCK_SHIFT);
+    if (writer->blocks.size() > lastBlock) {
+        writer->blocks.resize(lastBlock);
+    }
+    if (lastBlock > 0 && writer->blocks.size() == lastBlock) {
+        WriterBlock& block = writer->blocks[lastBlock - 1];
+        int blockFrames = writer_block_frames(writer, lastBlock - 1);
+        if (block.pending && block.filledCount >= blockFrames) {
+            encode_block(block.pending.get(), blockFrames, &block.ref, &block.encoded);
+            block.pending.reset();
+            block.filled.clear();
+            block.filledCount = 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 将索引原子写入文件（先写临时文件再重命名），未完成的块只保存从块首开始的连续部分
+ * @param writer 构建器指针
+ * @param path 索引文件路径
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_frame_index_writer_save(struct DmsFrameIndexWriter* writer, const char* path) {
+    if (!writer || !path) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+
+    std::vector<DmsIndexBlockRef> table(writer->blocks.size());
+    std::vector<const std::vector<uint8_t>*> payloads(writer->blocks.size(), nullptr);
+    std::vector<std::vector<uint8_t>> partials;
+    partials.reserve(writer->blocks.size());
+
+    int64_t covered = 0;
+    for (size_t i = 0; i < writer->blocks.size(); i++) {
+        WriterBlock& block = writer->blocks[i];
+        memset(&table[i], 0, sizeof(table[i]));
+        if (block.pending) {
+            int prefix = 0;
+            while (prefix < (int)block.filled.size() && block.filled[prefix]) {
+                prefix++;
+            }
+            if (prefix > 0) {
+                partials.emplace_back();
+                encode_block(block.pending.get(), prefix, &table[i], &partials.back());
+                payloads[i] = &partials.back();
+            }
+        } else if (block.ref.count > 0) {
+            table[i] = block.ref;
+            payloads[i] = &block.encoded;
+        }
+        covered += table[i].count;
+    }
+
+    std::string tmpPath = std::string(path) + ".tmp";
+    FILE* fp = fopen(tmpPath.c_str(), "wb");
+    if (!fp) {
+        LOGE("Failed to create index file: %s", tmpPath.c_str());
+        return -2;
+    }
+
+    uint64_t offset = sizeof(DmsIndexHeader);
+    bool ok = fseek(fp, (long)offset, SEEK_SET) == 0;
+    for (size_t i = 0; ok && i < payloads.size(); i++) {
+        if (!payloads[i]) {
+            continue;
+        }
+        table[i].offset = (uint32_t)offset;
+        ok = fwrite(payloads[i]->data(), 1, payloads[i]->size(), fp) == payloads[i]->size();
+        offset += payloads[i]->size();
+    }
+
+    // 顶层表按8字节对齐，保证mmap后可直接按结构体访问
+    static const uint8_t kPadding[8] = { 0 };
+    size_t padding = (size_t)((8 - (offset & 7)) & 7);
+    if (ok && padding > 0) {
+        ok = fwrite(kPadding, 1, padding, fp) == padding;
+        offset += padding;
+    }
+
+    DmsIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = DMS_INDEX_MAGIC;
+    header.version = DMS_INDEX_VERSION;
+    header.blockShift = DMS_INDEX_BLOCK_SHIFT;
+    header.frameCount = writer->frameCount >= 0 ? writer->frameCount : writer->maxFrame + 1;
+    header.basePts = writer->basePts;
+    header.ptsStep = writer->ptsStep;
+    header.tableOffset = offset;
+    header.blockCount = (uint32_t)table.size();
+    header.flags = writer->frameCount >= 0 ? DMS_INDEX_FLAG_COMPLETE : 0;
+    header.coveredFrames = covered;
+
+    if (ok && !table.empty()) {
+        ok = fwrite(table.data(), sizeof(DmsIndexBlockRef), table.size(), fp) == table.size();
+    }
+    if (ok) {
+        ok = fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, fp) == 1;
+    }
+    if (ok) {
+        ok = fflush(fp) == 0 && fdatasync(fileno(fp)) == 0;
+    }
+    ok = (fclose(fp) == 0) && ok;
+
+    if (!ok || rename(tmpPath.c_str(), path) != 0) {
+        LOGE("Failed to write index file: %s", path);
+        unlink(tmpPath.c_str());
+        return -3;
+    }
+    return 0;
+}
+
+/**
+ * @brief 载入已有索引的覆盖范围，用于中断后继续构建
+ * @param writer 构建器指针（应为新创建、尚未写入数据）
+ * @param index 已打开的只读索引
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_frame_index_writer_load(struct DmsFrameIndexWriter* writer, const struct DmsFrameIndex* index) {
+    if (!writer || !index || writer->maxFrame >= 0) {
+        return -1;
+    }
+    if (index->header->blockShift != DMS_INDEX_BLOCK_SHIFT) {
+        LOGE("Index block size mismatch: %u", index->header->blockShift);
+        return -2;
+    }
+
+    writer->basePts = index->header->basePts;
+    writer->ptsStep = index->header->ptsStep;
+    writer->frameCount = (index->header->flags & DMS_INDEX_FLAG_COMPLETE) ? index->header->frameCount : -1;
+    writer->blocks.resize(index->header->blockCount);
+    for (uint32_t i = 0; i < index->header->blockCount; i++) {
+        const DmsIndexBlockRef* ref = &index->table[i];
+        const uint8_t* data = block_data(index, ref);
+        if (!data) {
+            continue;
+        }
+        WriterBlock& block = writer->blocks[i];
+        block.ref = *ref;
+        block.ref.offset = 0;
+        block.encoded.assign(data, data + ref->posBytes + ref->sizeBytes + ref->ptsBytes);
+        writer->covered += ref->count;
+        writer->maxFrame = ((int64_t)i << DMS_INDEX_BLOCK_SHIFT) + ref->count - 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 设置PTS时基（第0帧PTS与帧间隔）
+ * @param writer 构建器指针
+ * @param basePts 第0帧的PTS
+ * @param ptsStep 相邻帧PTS间隔
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_frame_index_writer_set_timebase(struct DmsFrameIndexWriter* writer, int64_t basePts, int64_t ptsStep) {
+    if (!writer) {
+        return -1;
+    }
+    writer->basePts = basePts;
+    writer->ptsStep = ptsStep;
+    return 0;
+}
+
+/**
+ * @brief 判断块内某帧是否已覆盖
+ */
+static bool writer_has(const WriterBlock& block, int slot) {
+    if (block.pending) {
+        return block.filled[slot];
+    }
+    return slot < block.ref.count;
+}
+
+/**
+ * @brief 按帧号查询，包括尚未写满的块
+ * @param writer 构建器指针
+ * @param frame 帧号
+ * @param outEntry 输出索引项
+ * @return 成功返回0，该帧未覆盖返回1，失败返回负数错误码
+ */
+int dms_frame_index_writer_lookup(const struct DmsFrameIndexWriter* writer, int64_t frame,
+                                  struct DmsFrameEntry* outEntry) {
+    if (!writer || !outEntry || frame < 0) {
+        return -1;
+    }
+    size_t blockNo = (size_t)(frame >> DMS_INDEX_BLOCK_SHIFT);
+    int slot = (int)(frame & ((1 << DMS_INDEX_BLOCK_SHIFT) - 1));
+    if (blockNo >= writer->blocks.size() || !writer_has(writer->blocks[blockNo], slot)) {
+        return 1;
+    }
+
+    const WriterBlock& block = writer->blocks[blockNo];
+    RawEntry found = {};
+    if (block.pending) {
+        found = block.pending[slot];
+    } else {
+        decode_block(&block.ref, block.encoded.data(), slot, [&](int i, const RawEntry& e) {
+            found = e;
+            return i < slot;
+        });
+    }
+    outEntry->frame = frame;
+    outEntry->pos = found.pos;
+    outEntry->pts = found.pts;
+    outEntry->size = found.size;
+    return 0;
+}
+
+/**
+ * @brief 查找不大于frame的最近已覆盖帧
+ * @param writer 构建器指针
+ * @param frame 帧号
+ * @return 找到返回帧号，否则返回-1
+ */
+int64_t dms_frame_index_writer_floor(const struct DmsFrameIndexWriter* writer, int64_t frame) {
+    if (!writer || frame < 0) {
+        return -1;
+    }
+    int64_t last = (int64_t)(writer->blocks.size() << DMS_INDEX_BLOCK_SHIFT) - 1;
+    for (int64_t f = frame < last ? frame : last; f >= 0;) {
+        const WriterBlock& block = writer->blocks[(size_t)(f >> DMS_INDEX_BLOCK_SHIFT)];
+        int slot = (int)(f & ((1 << DMS_INDEX_BLOCK_SHIFT) - 1));
+        if (!block.pending) {
+            if (block.ref.count > 0) {
+                return f - slot + (slot < block.ref.count ? slot : block.ref.count - 1);
+            }
+            f -= slot + 1;
+            continue;
+        }
+        if (block.filled[slot]) {
+            return f;
+        }
+        f--;
+    }
+    return -1;
+}
+
+/**
+ * @brief 查找不小于fromFrame的第一个未覆盖帧
+ * @param writer 构建器指针
+ * @param fromFrame 起始帧号
+ * @return 第一个未覆盖帧号；已知总帧数且全部覆盖时返回-1
+ */
+int64_t dms_frame_index_writer_first_gap(const struct DmsFrameIndexWriter* writer, int64_t fromFrame) {
+    if (!writer || fromFrame < 0) {
+        return -1;
+    }
+    int64_t f = fromFrame;
+    while (writer->frameCount < 0 || f < writer->frameCount) {
+        size_t blockNo = (size_t)(f >> DMS_INDEX_BLOCK_SHIFT);
+        if (blockNo >= writer->blocks.size()) {
+            return f;
+        }
+        const WriterBlock& block = writer->blocks[blockNo];
+        int slot = (int)(f & ((1 << DMS_INDEX_BLOCK_SHIFT) - 1));
+        if (!writer_has(block, slot)) {
+            return f;
+        }
+        if (!block.pending) {
+            f += block.ref.count - slot;
+        } else {
+            f++;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 获取已覆盖帧数
+ * @param writer 构建器指针
+ * @return 已覆盖帧数
+ */
+int64_t dms_frame_index_writer_get_covered(const struct DmsFrameIndexWriter* writer) {
+    return writer ? writer->covered : 0;
+}
+
+/**
+ * @brief 获取已知总帧数
+ * @param writer 构建器指针
+ * @return 总帧数，未知返回-1
+ */
+int64_t dms_frame_index_writer_get_frame_count(const struct DmsFrameIndexWriter* writer) {
+    return writer ? writer->frameCount : -1;
+}
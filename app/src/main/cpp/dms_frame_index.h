@@ -0,0 +1,114 @@
+#ifndef DMS_FRAME_INDEX_H
+#define DMS_FRAME_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 紧凑帧索引
+ *
+ * 索引文件按块（默认每块128帧）存放 Pos、size、PTS 三列数据，每列做差分后以 varint 编码；
+ * 文件尾部为稀疏顶层表，每块一项，按帧号右移即可 O(1) 定位块。读取端以只读方式 mmap，
+ * 只有实际访问过的页面才会驻留内存。
+ *
+ * 文件布局（小端）：
+ *   DmsIndexHeader | 块数据 ... | DmsIndexBlockRef[blockCount]
+ */
+
+#define DMS_INDEX_MAGIC         0x58534D44u   // "DMSX"
+#define DMS_INDEX_VERSION       1
+#define DMS_INDEX_BLOCK_SHIFT   7             // 每块 1 << 7 = 128 帧
+
+// 索引文件头（64字节）
+struct DmsIndexHeader {
+    uint32_t magic;          // DMS_INDEX_MAGIC
+    uint16_t version;        // DMS_INDEX_VERSION
+    uint16_t blockShift;     // 块大小（2的幂）
+    int64_t  frameCount;     // 码流总帧数，未知时为已覆盖的最大帧号+1
+    int64_t  basePts;        // 第0帧的PTS
+    int64_t  ptsStep;        // 相邻帧PTS间隔，0表示未知
+    uint64_t tableOffset;    // 顶层表在文件中的偏移
+    uint32_t blockCount;     // 顶层表项数
+    uint32_t flags;          // DMS_INDEX_FLAG_*
+    int64_t  coveredFrames;  // 已覆盖的帧数
+    uint8_t  reserved[8];
+};
+
+#define DMS_INDEX_FLAG_COMPLETE 0x0001u       // frameCount 为码流真实总帧数
+
+// 顶层表项（32字节），count为0表示该块尚未覆盖
+struct DmsIndexBlockRef {
+    int64_t  firstPos;       // 块内第一帧的Pos
+    int64_t  firstPts;       // 块内第一帧的PTS
+    uint32_t offset;         // 块数据在文件中的偏移
+    uint32_t firstSize;      // 块内第一帧的数据长度
+    uint16_t count;          // 块内从第0帧起连续覆盖的帧数
+    uint16_t posBytes;       // Pos列字节数
+    uint16_t sizeBytes;      // size列字节数
+    uint16_t ptsBytes;       // PTS列字节数
+};
+
+// 单帧索引项
+struct DmsFrameEntry {
+    int64_t  frame;          // 帧号（从0开始）
+    int64_t  pos;            // 码流位置，用于 _dms_goto_pos
+    int64_t  pts;            // 显示时间戳
+    uint32_t size;           // 数据单元长度
+};
+
+// 索引统计信息
+struct DmsFrameIndexStats {
+    int64_t  frameCount;     // 总帧数
+    int64_t  coveredFrames;  // 已覆盖帧数
+    uint32_t blockCount;     // 块数
+    uint64_t fileBytes;      // 索引文件大小
+    double   bytesPerFrame;  // 每个已覆盖帧平均占用字节数
+};
+
+struct DmsFrameIndex;        // 只读索引（mmap）
+struct DmsFrameIndexWriter;  // 索引构建器
+
+/* ---------------- 只读索引 ---------------- */
+
+int dms_frame_index_open(const char* path, struct DmsFrameIndex** outIndex);   // 以只读mmap方式打开索引文件
+void dms_frame_index_close(struct DmsFrameIndex* index);                       // 关闭索引并解除映射
+int dms_frame_index_lookup(const struct DmsFrameIndex* index, int64_t frame,
+                           struct DmsFrameEntry* outEntry);                    // 按帧号查询
+int64_t dms_frame_index_find_pos(const struct DmsFrameIndex* index, int64_t pos); // 按Pos反查帧号
+int64_t dms_frame_index_get_frame_count(const struct DmsFrameIndex* index);    // 获取总帧数
+const struct DmsIndexHeader* dms_frame_index_get_header(const struct DmsFrameIndex* index); // 获取文件头
+int dms_frame_index_get_stats(const struct DmsFrameIndex* index,
+                              struct DmsFrameIndexStats* outStats);            // 获取统计信息
+
+/* ---------------- 索引构建 ---------------- */
+
+struct DmsFrameIndexWriter* dms_frame_index_writer_create(int64_t basePts, int64_t ptsStep); // 创建构建器
+void dms_frame_index_writer_destroy(struct DmsFrameIndexWriter* writer);       // 销毁构建器
+int dms_frame_index_writer_put(struct DmsFrameIndexWriter* writer, int64_t frame,
+                               int64_t pos, int64_t pts, uint32_t size);       // 写入一帧（帧号可乱序、可稀疏）
+int dms_frame_index_writer_set_frame_count(struct DmsFrameIndexWriter* writer,
+                                           int64_t frameCount);                // 设置码流真实总帧数
+int dms_frame_index_writer_save(struct DmsFrameIndexWriter* writer, const char* path); // 原子写入文件
+int dms_frame_index_writer_load(struct DmsFrameIndexWriter* writer,
+                                const struct DmsFrameIndex* index);            // 载入已有索引的覆盖范围
+int dms_frame_index_writer_set_timebase(struct DmsFrameIndexWriter* writer,
+                                        int64_t basePts, int64_t ptsStep);     // 设置PTS时基
+int dms_frame_index_writer_lookup(const struct DmsFrameIndexWriter* writer, int64_t frame,
+                                  struct DmsFrameEntry* outEntry);             // 按帧号查询（含未完成块）
+int64_t dms_frame_index_writer_floor(const struct DmsFrameIndexWriter* writer,
+                                     int64_t frame);                           // 不大于frame的最近已覆盖帧
+int64_t dms_frame_index_writer_first_gap(const struct DmsFrameIndexWriter* writer,
+                                         int64_t fromFrame);                   // 不小于fromFrame的第一个未覆盖帧
+int64_t dms_frame_index_writer_get_covered(const struct DmsFrameIndexWriter* writer); // 已覆盖帧数
+int64_t dms_frame_index_writer_get_frame_count(const struct DmsFrameIndexWriter* writer); // 已知总帧数，未知返回-1
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_FRAME_INDEX_H
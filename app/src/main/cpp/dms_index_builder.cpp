@@ -0,0 +1,455 @@
+#include "dms_index_builder.h"
+#include "dms_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define LOG_TAG "DmsIndexBuilder"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int64_t kIdleNs = 1000000000LL;             // 取帧停止超过1秒视为空闲
+static const int64_t kPersistIntervalNs = 30000000000LL; // 至少每30秒保存一次新增覆盖
+static const int64_t kPersistFrames = 1440;              // 新增覆盖达到1440帧（24fps一分钟）立即保存
+static const int kWalkUnits = 4;                         // 后台补全每次持有libdms的最大读取数
+static const int kWalkerNice = 10;                       // 后台线程nice值
+
+struct DmsIndexBuilder {
+    std::string path;
+
+    // 取帧路径只往队列里追加，避免与保存文件争用同一把锁
+    std::mutex queueMutex;
+    std::vector<DmsFrameEntry> queue;
+    bool calibrated;                 // PTS时基是否已知
+    bool timebaseDirty;
+    int64_t basePts;
+    int64_t ptsStep;
+    int64_t prevFrame;
+    int64_t prevPts;
+    int64_t pendingEnd;              // 待写入的总帧数，-1表示无
+
+    std::mutex writerMutex;
+    DmsFrameIndexWriter* writer;
+    DmsFrameIndex* complete;         // 已完整的索引直接mmap使用，不再构建
+    int64_t dirtyFrames;
+    int64_t lastPersistNs;
+
+    std::thread thread;
+    std::mutex threadMutex;
+    std::condition_variable cv;
+    bool stopping;
+    DmsIndexWalkFun walkFun;
+    void* walkUser;
+    std::atomic<bool> walking;
+    std::atomic<int64_t> lastActivityNs;
+
+    std::atomic<int64_t> observedFrames;
+    std::atomic<int64_t> walkedFrames;
+    std::atomic<int32_t> persistCount;
+};
+
+static int64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief 将队列中的记录写入构建器，调用者需持有writerMutex
+ * @param builder 构建器指针
+ */
+static void drain_locked(DmsIndexBuilder* builder) {
+    std::vector<DmsFrameEntry> entries;
+    int64_t end;
+    bool timebaseDirty;
+    int64_t basePts, ptsStep;
+    {
+        std::lock_guard<std::mutex> lock(builder->queueMutex);
+        entries.swap(builder->queue);
+        end = builder->pendingEnd;
+        builder->pendingEnd = -1;
+        timebaseDirty = builder->timebaseDirty;
+        builder->timebaseDirty = false;
+        basePts = builder->basePts;
+        ptsStep = builder->ptsStep;
+    }
+
+    if (timebaseDirty) {
+        dms_frame_index_writer_set_timebase(builder->writer, basePts, ptsStep);
+    }
+    int64_t before = dms_frame_index_writer_get_covered(builder->writer);
+    for (const DmsFrameEntry& e : entries) {
+        dms_frame_index_writer_put(builder->writer, e.frame, e.pos, e.pts, e.size);
+    }
+    builder->dirtyFrames += dms_frame_index_writer_get_covered(builder->writer) - before;
+    if (end >= 0 && dms_frame_index_writer_get_frame_count(builder->writer) < 0) {
+        if (dms_frame_index_writer_set_frame_count(builder->writer, end) == 0) {
+            builder->dirtyFrames++;
+            LOGI("Stream end detected: %lld frames", (long long)end);
+        }
+    }
+}
+
+/**
+ * @brief 保存覆盖范围，调用者需持有writerMutex
+ * @param builder 构建器指针
+ * @return 成功返回0，失败返回错误码
+ */
+static int persist_locked(DmsIndexBuilder* builder) {
+    drain_locked(builder);
+    if (builder->dirtyFrames == 0) {
+        return 0;
+    }
+    int result = dms_frame_index_writer_save(builder->writer, builder->path.c_str());
+    if (result == 0) {
+        builder->dirtyFrames = 0;
+        builder->persistCount++;
+    }
+    builder->lastPersistNs = now_ns();
+    return result;
+}
+
+/**
+ * @brief 后台线程：定期保存覆盖范围，空闲时补全索引
+ * @param builder 构建器指针
+ */
+static void walker_main(DmsIndexBuilder* builder) {
+    setpriority(PRIO_PROCESS, gettid(), kWalkerNice);
+
+    int64_t backoffUntil = 0;
+    std::unique_lock<std::mutex> threadLock(builder->threadMutex);
+    while (!builder->stopping) {
+        int64_t now = now_ns();
+        bool idle = now - builder->lastActivityNs.load() >= kIdleNs && now >= backoffUntil;
+        builder->cv.wait_for(threadLock, std::chrono::milliseconds(idle ? 10 : 200));
+        if (builder->stopping) {
+            break;
+        }
+        threadLock.unlock();
+
+        DmsFrameEntry anchor;
+        bool haveAnchor = false;
+        bool fromStart = false;
+        {
+            std::lock_guard<std::mutex> lock(builder->writerMutex);
+            now = now_ns();
+            drain_locked(builder);
+            if (builder->dirtyFrames >= kPersistFrames ||
+                (builder->dirtyFrames > 0 && now - builder->lastPersistNs >= kPersistIntervalNs)) {
+                persist_locked(builder);
+            }
+
+            if (builder->walkFun && now - builder->lastActivityNs.load() >= kIdleNs && now >= backoffUntil) {
+                int64_t gap = dms_frame_index_writer_first_gap(builder->writer, 0);
+                // 第一帧未覆盖（刚打开、断点续播到分本中部）时从分本开头补全
+                fromStart = gap == 0;
+                haveAnchor = gap > 0 && dms_frame_index_writer_lookup(builder->writer, gap - 1, &anchor) == 0;
+            }
+        }
+
+        if (haveAnchor || fromStart) {
+            builder->walking = true;
+            int n = builder->walkFun(builder->walkUser, haveAnchor ? &anchor : nullptr, kWalkUnits);
+            builder->walking = false;
+            if (n <= 0) {
+                // 码流结束、未打开或出错，稍后再试
+                backoffUntil = now_ns() + 5 * kIdleNs;
+            }
+        }
+
+        threadLock.lock();
+    }
+}
+
+/**
+ * @brief 创建构建器，若索引文件已存在则载入其覆盖范围
+ * @param indexPath 索引文件路径
+ * @return 构建器指针，失败返回nullptr
+ */
+struct DmsIndexBuilder* dms_index_builder_create(const char* indexPath) {
+    if (!indexPath) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+
+    DmsIndexBuilder* builder = new DmsIndexBuilder();
+    builder->path = indexPath;
+    builder->calibrated = false;
+    builder->timebaseDirty = false;
+    builder->basePts = 0;
+    builder->ptsStep = 0;
+    builder->prevFrame = -1;
+    builder->prevPts = 0;
+    builder->pendingEnd = -1;
+    builder->writer = dms_frame_index_writer_create(0, 0);
+    builder->complete = nullptr;
+    builder->dirtyFrames = 0;
+    builder->lastPersistNs = now_ns();
+    builder->stopping = false;
+    builder->walkFun = nullptr;
+    builder->walkUser = nullptr;
+    builder->walking = false;
+    builder->lastActivityNs = now_ns();
+    builder->observedFrames = 0;
+    builder->walkedFrames = 0;
+    builder->persistCount = 0;
+
+    DmsFrameIndex* index = nullptr;
+    if (dms_frame_index_open(indexPath, &index) == 0) {
+        const DmsIndexHeader* header = dms_frame_index_get_header(index);
+        builder->basePts = header->basePts;
+        builder->ptsStep = header->ptsStep;
+        builder->calibrated = header->ptsStep > 0;
+
+        LOGI("Index loaded: %lld/%lld frames covered", (long long)header->coveredFrames,
+             (long long)header->frameCount);
+        if ((header->flags & DMS_INDEX_FLAG_COMPLETE) && header->coveredFrames == header->frameCount) {
+            builder->complete = index;
+        } else {
+            dms_frame_index_writer_load(builder->writer, index);
+            dms_frame_index_close(index);
+        }
+    }
+    return builder;
+}
+
+/**
+ * @brief 停止后台线程、保存覆盖范围并销毁构建器
+ * @param builder 构建器指针
+ */
+void dms_index_builder_destroy(struct DmsIndexBuilder* builder) {
+    if (!builder) {
+        return;
+    }
+    if (builder->thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(builder->threadMutex);
+            builder->stopping = true;
+        }
+        builder->cv.notify_all();
+        builder->thread.join();
+    }
+    if (!builder->complete) {
+        std::lock_guard<std::mutex> lock(builder->writerMutex);
+        persist_locked(builder);
+    }
+    dms_frame_index_close(builder->complete);
+    dms_frame_index_writer_destroy(builder->writer);
+    delete builder;
+}
+
+/**
+ * @brief 记录一个已读取的数据单元
+ * @param builder 构建器指针
+ * @param frameHint 调用者已知的帧号，未知填-1（此时由PTS推算）
+ * @param unit 数据单元
+ * @return 该数据单元的帧号，无法确定时返回-1
+ */
+int64_t dms_index_builder_observe(struct DmsIndexBuilder* builder, int64_t frameHint, const DmsDataUnit* unit) {
+    if (!builder || !unit) {
+        return -1;
+    }
+
+    bool walking = builder->walking.load();
+    if (walking) {
+        builder->walkedFrames++;
+    } else {
+        builder->observedFrames++;
+        builder->lastActivityNs = now_ns();
+    }
+
+    std::lock_guard<std::mutex> lock(builder->queueMutex);
+    int64_t frame = frameHint;
+    if (frame < 0 && builder->calibrated) {
+        int64_t delta = unit->PTS - builder->basePts;
+        if (delta >= 0 && delta % builder->ptsStep == 0) {
+            frame = delta / builder->ptsStep;
+        }
+    }
+    if (frame < 0) {
+        builder->prevFrame = -1;
+        return -1;
+    }
+
+    // 由两个相邻帧确定PTS时基，之后随机定位落点也能识别帧号
+    if (!builder->calibrated && builder->prevFrame >= 0 && frame == builder->prevFrame + 1 &&
+        unit->PTS > builder->prevPts) {
+        builder->ptsStep = unit->PTS - builder->prevPts;
+        builder->basePts = unit->PTS - frame * builder->ptsStep;
+        builder->calibrated = true;
+        builder->timebaseDirty = true;
+    }
+    builder->prevFrame = frame;
+    builder->prevPts = unit->PTS;
+
+    if (!builder->complete) {
+        builder->queue.push_back({ frame, unit->Pos, unit->PTS, unit->Length });
+    }
+    return frame;
+}
+
+/**
+ * @brief 码流读到结尾时记录总帧数
+ * @param builder 构建器指针
+ * @param frameCount 总帧数
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_index_builder_mark_end(struct DmsIndexBuilder* builder, int64_t frameCount) {
+    if (!builder || frameCount <= 0) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(builder->queueMutex);
+    builder->pendingEnd = frameCount;
+    return 0;
+}
+
+/**
+ * @brief 按帧号查询当前覆盖范围（包括尚未保存的记录）
+ * @param builder 构建器指针
+ * @param frame 帧号
+ * @param outEntry 输出索引项
+ * @return 成功返回0，未覆盖返回1，失败返回负数错误码
+ */
+int dms_index_builder_lookup(struct DmsIndexBuilder* builder, int64_t frame, struct DmsFrameEntry* outEntry) {
+    if (!builder) {
+        return -1;
+    }
+    if (builder->complete) {
+        return dms_frame_index_lookup(builder->complete, frame, outEntry);
+    }
+    std::lock_guard<std::mutex> lock(builder->writerMutex);
+    drain_locked(builder);
+    return dms_frame_index_writer_lookup(builder->writer, frame, outEntry);
+}
+
+/**
+ * @brief 查找不大于frame的最近已覆盖帧
+ * @param builder 构建器指针
+ * @param frame 帧号
+ * @return 找到返回帧号，否则返回-1
+ */
+int64_t dms_index_builder_floor(struct DmsIndexBuilder* builder, int64_t frame) {
+    if (!builder || frame < 0) {
+        return -1;
+    }
+    if (builder->complete) {
+        int64_t count = dms_frame_index_get_frame_count(builder->complete);
+        return frame < count ? frame : count - 1;
+    }
+    std::lock_guard<std::mutex> lock(builder->writerMutex);
+    drain_locked(builder);
+    return dms_frame_index_writer_floor(builder->writer, frame);
+}
+
+/**
+ * @brief 由PTS推算帧号
+ * @param builder 构建器指针
+ * @param pts 显示时间戳
+ * @return 帧号，时基未知时返回-1
+ */
+int64_t dms_index_builder_frame_of_pts(struct DmsIndexBuilder* builder, int64_t pts) {
+    if (!builder) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(builder->queueMutex);
+    if (!builder->calibrated || pts < builder->basePts) {
+        return -1;
+    }
+    return (pts - builder->basePts) / builder->ptsStep;
+}
+
+/**
+ * @brief 获取已知总帧数
+ * @param builder 构建器指针
+ * @return 总帧数，未知返回-1
+ */
+int64_t dms_index_builder_get_frame_count(struct DmsIndexBuilder* builder) {
+    if (!builder) {
+        return -1;
+    }
+    if (builder->complete) {
+        return dms_frame_index_get_frame_count(builder->complete);
+    }
+    std::lock_guard<std::mutex> lock(builder->writerMutex);
+    drain_locked(builder);
+    return dms_frame_index_writer_get_frame_count(builder->writer);
+}
+
+/**
+ * @brief 启动后台线程：定期保存覆盖范围，取帧空闲时通过walkFun补全索引
+ * @param builder 构建器指针
+ * @param walkFun 补全回调，为nullptr时只做定期保存
+ * @param user 回调用户数据
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_index_builder_start_walker(struct DmsIndexBuilder* builder, DmsIndexWalkFun walkFun, void* user) {
+    if (!builder) {
+        return -1;
+    }
+    if (builder->complete || builder->thread.joinable()) {
+        return 0;
+    }
+    builder->walkFun = walkFun;
+    builder->walkUser = user;
+    builder->thread = std::thread(walker_main, builder);
+    return 0;
+}
+
+/**
+ * @brief 通知播放正在取帧，后台补全将推迟到下一次空闲
+ * @param builder 构建器指针
+ */
+void dms_index_builder_touch(struct DmsIndexBuilder* builder) {
+    if (builder) {
+        builder->lastActivityNs = now_ns();
+    }
+}
+
+/**
+ * @brief 立即保存覆盖范围
+ * @param builder 构建器指针
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_index_builder_persist(struct DmsIndexBuilder* builder) {
+    if (!builder) {
+        return -1;
+    }
+    if (builder->complete) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(builder->writerMutex);
+    return persist_locked(builder);
+}
+
+/**
+ * @brief 获取统计信息
+ * @param builder 构建器指针
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_index_builder_get_stats(struct DmsIndexBuilder* builder, struct DmsIndexBuilderStats* outStats) {
+    if (!builder || !outStats) {
+        return -1;
+    }
+    if (builder->complete) {
+        outStats->frameCount = dms_frame_index_get_frame_count(builder->complete);
+        outStats->coveredFrames = outStats->frameCount;
+    } else {
+        std::lock_guard<std::mutex> lock(builder->writerMutex);
+        drain_locked(builder);
+        outStats->coveredFrames = dms_frame_index_writer_get_covered(builder->writer);
+        outStats->frameCount = dms_frame_index_writer_get_frame_count(builder->writer);
+    }
+    outStats->observedFrames = builder->observedFrames.load();
+    outStats->walkedFrames = builder->walkedFrames.load();
+    outStats->persistCount = builder->persistCount.load();
+    return 0;
+}
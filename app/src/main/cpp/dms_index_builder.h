@@ -0,0 +1,63 @@
+#ifndef DMS_INDEX_BUILDER_H
+#define DMS_INDEX_BUILDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dms_frame_index.h"
+#include "libdms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 增量帧索引构建
+ *
+ * 播放取帧时顺带记录每个数据单元的 Pos/PTS/长度（不产生额外的 libdms 调用）；
+ * 取帧空闲时由低优先级后台线程从第一个未覆盖帧开始向后补全；
+ * 覆盖范围定期原子写入索引文件，中断后下次打开可继续使用和补全。
+ */
+
+/**
+ * @brief 后台补全回调，由播放器实现：定位到anchor后顺序读取数据单元并逐个交给
+ *        dms_index_builder_observe，完成后恢复播放读取位置
+ * @param user 用户数据
+ * @param anchor 已覆盖的起点帧（补全从anchor之后开始），为NULL时从分本第一帧开始
+ * @param maxUnits 本次最多读取的数据单元数
+ * @return 读取到的数据单元数，码流结束返回0，失败返回负数错误码
+ */
+typedef int (*DmsIndexWalkFun)(void* user, const struct DmsFrameEntry* anchor, int maxUnits);
+
+// 构建统计信息
+struct DmsIndexBuilderStats {
+    int64_t coveredFrames;   // 已覆盖帧数
+    int64_t frameCount;      // 已知总帧数，未知为-1
+    int64_t observedFrames;  // 播放取帧时记录的帧数
+    int64_t walkedFrames;    // 后台补全读取的帧数
+    int32_t persistCount;    // 写入索引文件次数
+};
+
+struct DmsIndexBuilder;
+
+struct DmsIndexBuilder* dms_index_builder_create(const char* indexPath);      // 创建构建器，载入已有索引
+void dms_index_builder_destroy(struct DmsIndexBuilder* builder);              // 停止后台线程、保存并销毁
+int64_t dms_index_builder_observe(struct DmsIndexBuilder* builder, int64_t frameHint,
+                                  const DmsDataUnit* unit);                   // 记录一个已读取的数据单元
+int dms_index_builder_mark_end(struct DmsIndexBuilder* builder, int64_t frameCount); // 码流读到结尾
+int dms_index_builder_lookup(struct DmsIndexBuilder* builder, int64_t frame,
+                             struct DmsFrameEntry* outEntry);                 // 按帧号查询当前覆盖范围
+int64_t dms_index_builder_floor(struct DmsIndexBuilder* builder, int64_t frame); // 不大于frame的最近已覆盖帧
+int64_t dms_index_builder_frame_of_pts(struct DmsIndexBuilder* builder, int64_t pts); // 由PTS推算帧号
+int64_t dms_index_builder_get_frame_count(struct DmsIndexBuilder* builder);  // 已知总帧数，未知返回-1
+int dms_index_builder_start_walker(struct DmsIndexBuilder* builder,
+                                   DmsIndexWalkFun walkFun, void* user);     // 启动后台补全线程
+void dms_index_builder_touch(struct DmsIndexBuilder* builder);               // 通知播放正在取帧（推迟后台补全）
+int dms_index_builder_persist(struct DmsIndexBuilder* builder);              // 立即保存覆盖范围
+int dms_index_builder_get_stats(struct DmsIndexBuilder* builder,
+                                struct DmsIndexBuilderStats* outStats);      // 获取统计信息
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_INDEX_BUILDER_H
@@ -0,0 +1,387 @@
+#include "dms_j2k_decoder.h"
+#include "dms_j2k_header.h"
+#include "dms_scaler.h"
+#include "dms_log.h"
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#ifdef DMS_HAVE_OPENJPEG
+#include <openjpeg.h>
+#endif
+
+#define LOG_TAG "DmsJ2kDecoder"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int kMaxThreads = 16;
+static const float kEwmaAlpha = 0.1f;
+
+struct DmsJ2kDecoder {
+    int32_t threads;
+    int32_t reduce;
+    std::atomic<int32_t> outputWidth;
+    std::atomic<int32_t> outputHeight;
+    std::atomic<int32_t> layers;       // 解码的质量层数，0表示全部
+    std::atomic<int32_t> extraReduce;  // 在按画面尺寸选择的分辨率层之上多丢弃的层数
+
+    std::mutex mutex;
+    int64_t frames;
+    int64_t failures;
+    int64_t levelFrames[DMS_J2K_MAX_REDUCE + 1];
+    int64_t degradedFrames;
+    float decodeCostUs;
+};
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static void ewma_update(float* value, float sample) {
+    *value = (*value <= 0.0f) ? sample : *value + kEwmaAlpha * (sample - *value);
+}
+
+#ifdef DMS_HAVE_OPENJPEG
+/**
+ * @brief 选择不低于输出尺寸的最小分辨率层：原图保持宽高比放入输出画面（见 dms_scaler_fit），
+ *        分辨率层的宽、高均不小于适配尺寸；恰好相等时显示端无需缩放，只加黑边
+ * @param width 原图宽度
+ * @param height 原图高度
+ * @param outputWidth 输出画面宽度，不大于0表示未设置
+ * @param outputHeight 输出画面高度
+ * @return 丢弃的小波层数
+ */
+static int choose_reduce(uint32_t width, uint32_t height, int32_t outputWidth, int32_t outputHeight) {
+    if (outputWidth <= 0 || outputHeight <= 0) {
+        return 0;
+    }
+    int32_t fitWidth, fitHeight;
+    dms_scaler_fit((int32_t)width, (int32_t)height, outputWidth, outputHeight, &fitWidth, &fitHeight);
+    int reduce = 0;
+    while (reduce < DMS_J2K_MAX_REDUCE) {
+        // 与OpenJPEG一致，降一级后的尺寸向上取整
+        uint32_t next = 1u << (reduce + 1);
+        if ((width + next - 1) / next < (uint32_t)fitWidth || (height + next - 1) / next < (uint32_t)fitHeight) {
+            break;
+        }
+        reduce++;
+    }
+    return reduce;
+}
+
+// 内存中的码流，供OpenJPEG按流读取
+struct MemoryStream {
+    const uint8_t* data;
+    OPJ_SIZE_T length;
+    OPJ_SIZE_T offset;
+};
+
+static OPJ_SIZE_T stream_read(void* buffer, OPJ_SIZE_T bytes, void* user) {
+    MemoryStream* stream = (MemoryStream*)user;
+    if (stream->offset >= stream->length) {
+        return (OPJ_SIZE_T)-1;
+    }
+    OPJ_SIZE_T remain = stream->length - stream->offset;
+    bytes = bytes < remain ? bytes : remain;
+    memcpy(buffer, stream->data + stream->offset, bytes);
+    stream->offset += bytes;
+    return bytes;
+}
+
+static OPJ_OFF_T stream_skip(OPJ_OFF_T bytes, void* user) {
+    MemoryStream* stream = (MemoryStream*)user;
+    OPJ_OFF_T target = (OPJ_OFF_T)stream->offset + bytes;
+    if (target < 0 || target > (OPJ_OFF_T)stream->length) {
+        return -1;
+    }
+    stream->offset = (OPJ_SIZE_T)target;
+    return bytes;
+}
+
+static OPJ_BOOL stream_seek(OPJ_OFF_T offset, void* user) {
+    MemoryStream* stream = (MemoryStream*)user;
+    if (offset < 0 || offset > (OPJ_OFF_T)stream->length) {
+        return OPJ_FALSE;
+    }
+    stream->offset = (OPJ_SIZE_T)offset;
+    return OPJ_TRUE;
+}
+
+static void log_error(const char* msg, void* user) {
+    LOGE("OpenJPEG: %s", msg);
+}
+
+/**
+ * @brief 用OpenJPEG解码一帧，每次使用独立的编解码器对象以便多线程同时调用
+ * @param threads 单帧解码线程数
+ * @param reduce 丢弃的小波层数，DMS_J2K_REDUCE_AUTO表示按输出尺寸选择
+ * @param extraReduce 降质时多丢弃的小波层数
+ * @param layers 解码的质量层数，0表示全部
+ * @param outputWidth 输出画面宽度
+ * @param outputHeight 输出画面高度
+ * @param data 码流
+ * @param length 码流长度
+ * @param outImage 输出解码图像
+ * @param outReduce 输出实际丢弃的小波层数
+ * @param outDegraded 输出是否降质解码
+ * @return 成功返回0，失败返回-3
+ */
+static int decode_openjpeg(int threads, int reduce, int extraReduce, int layers, int32_t outputWidth,
+                           int32_t outputHeight, const uint8_t* data, uint32_t length, opj_image_t** outImage,
+                           int* outReduce, bool* outDegraded) {
+    *outImage = nullptr;
+    *outReduce = 0;
+    *outDegraded = false;
+    opj_codec_t* codec = opj_create_decompress(OPJ_CODEC_J2K);
+    if (!codec) {
+        return -3;
+    }
+    opj_set_error_handler(codec, log_error, nullptr);
+    opj_dparameters_t params;
+    opj_set_default_decoder_parameters(&params);
+    // 只解码前layers个质量层，后续层的包只读包头跳过
+    params.cp_layer = (OPJ_UINT32)(layers > 0 ? layers : 0);
+    if (!opj_setup_decoder(codec, &params)) {
+        opj_destroy_codec(codec);
+        return -3;
+    }
+    if (threads > 1 && opj_has_thread_support()) {
+        opj_codec_set_threads(codec, threads);
+    }
+
+    MemoryStream memory = {data, length, 0};
+    opj_stream_t* stream = opj_stream_create(length, OPJ_TRUE);
+    opj_stream_set_user_data(stream, &memory, nullptr);
+    opj_stream_set_user_data_length(stream, length);
+    opj_stream_set_read_function(stream, stream_read);
+    opj_stream_set_skip_function(stream, stream_skip);
+    opj_stream_set_seek_function(stream, stream_seek);
+
+    opj_image_t* image = nullptr;
+    bool ok = opj_read_header(stream, codec, &image);
+    if (ok) {
+        // 主头已解析出原图尺寸，在解码tile之前设置丢弃的分辨率层：
+        // 被丢弃分辨率的包只读包头跳过，其码块不参与熵解码
+        if (reduce == DMS_J2K_REDUCE_AUTO) {
+            reduce = choose_reduce(image->x1 - image->x0, image->y1 - image->y0, outputWidth, outputHeight);
+        }
+        int baseReduce = reduce;
+        reduce = reduce + extraReduce > DMS_J2K_MAX_REDUCE ? DMS_J2K_MAX_REDUCE : reduce + extraReduce;
+        // 码流的分解级数少于请求时退回到码流支持的最低分辨率
+        while (reduce > 0 && !opj_set_decoded_resolution_factor(codec, (OPJ_UINT32)reduce)) {
+            reduce--;
+        }
+        *outReduce = reduce;
+        *outDegraded = reduce > baseReduce || layers > 0;
+        ok = opj_decode(codec, stream, image) && opj_end_decompress(codec, stream);
+    }
+    opj_stream_destroy(stream);
+    opj_destroy_codec(codec);
+    if (!ok) {
+        opj_image_destroy(image);
+        return -3;
+    }
+    *outImage = image;
+    return 0;
+}
+#endif
+
+/**
+ * @brief 是否编译了J2K解码支持
+ * @return 链接了OpenJPEG返回true
+ */
+bool dms_j2k_decoder_available(void) {
+#ifdef DMS_HAVE_OPENJPEG
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 创建J2K解码器
+ * @param config 解码配置，为空时使用默认配置
+ * @return 成功返回解码器指针，未编译J2K解码支持时返回NULL
+ */
+struct DmsJ2kDecoder* dms_j2k_decoder_create(const struct DmsJ2kDecoderConfig* config) {
+    if (!dms_j2k_decoder_available()) {
+        LOGE("Built without OpenJPEG, J2K decoding unavailable");
+        return nullptr;
+    }
+    int threads = (config && config->threads > 0) ? config->threads : (int)std::thread::hardware_concurrency();
+    threads = threads < 1 ? 1 : (threads > kMaxThreads ? kMaxThreads : threads);
+
+    int reduce = config ? config->reduce : DMS_J2K_REDUCE_AUTO;
+    if (reduce != DMS_J2K_REDUCE_AUTO) {
+        reduce = reduce < 0 ? 0 : (reduce > DMS_J2K_MAX_REDUCE ? DMS_J2K_MAX_REDUCE : reduce);
+    }
+
+    DmsJ2kDecoder* decoder = new DmsJ2kDecoder();
+    decoder->threads = threads;
+    decoder->reduce = reduce;
+    decoder->outputWidth = 0;
+    decoder->outputHeight = 0;
+    decoder->layers = 0;
+    decoder->extraReduce = 0;
+    decoder->frames = 0;
+    decoder->failures = 0;
+    memset(decoder->levelFrames, 0, sizeof(decoder->levelFrames));
+    decoder->degradedFrames = 0;
+    decoder->decodeCostUs = 0.0f;
+#ifdef DMS_HAVE_OPENJPEG
+    LOGI("J2K decoder created: OpenJPEG %s, %d threads, reduce %d", opj_version(), threads, reduce);
+#endif
+    return decoder;
+}
+
+/**
+ * @brief 销毁解码器
+ * @param decoder 解码器
+ */
+void dms_j2k_decoder_destroy(struct DmsJ2kDecoder* decoder) {
+    if (!decoder) {
+        return;
+    }
+    LOGI("J2K decoder destroyed: %lld frames, %lld failures, %.1f ms/frame",
+         (long long)decoder->frames, (long long)decoder->failures, decoder->decodeCostUs / 1000.0f);
+    delete decoder;
+}
+
+/**
+ * @brief 设置输出画面尺寸，自动模式下据此选择分辨率层，下一帧起生效
+ * @param decoder 解码器
+ * @param width 画面宽度（像素），0表示按原图尺寸解码
+ * @param height 画面高度（像素）
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_j2k_decoder_set_output_size(struct DmsJ2kDecoder* decoder, int32_t width, int32_t height) {
+    if (!decoder || width < 0 || height < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    decoder->outputWidth = width;
+    decoder->outputHeight = height;
+    LOGI("Output size set to %dx%d", width, height);
+    return 0;
+}
+
+/**
+ * @brief 设置降质解码参数，下一帧起生效
+ * @param decoder 解码器
+ * @param layers 解码的质量层数，0表示全部
+ * @param extraReduce 在按画面尺寸选择的分辨率层之上多丢弃的小波层数（0~3）
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_j2k_decoder_set_quality(struct DmsJ2kDecoder* decoder, int32_t layers, int32_t extraReduce) {
+    if (!decoder || layers < 0 || extraReduce < 0 || extraReduce > DMS_J2K_MAX_REDUCE) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    decoder->layers = layers;
+    decoder->extraReduce = extraReduce;
+    LOGI("Decode quality set to %d layers, %d extra levels", layers, extraReduce);
+    return 0;
+}
+
+/**
+ * @brief 解码一帧J2K码流，可被多个线程同时调用
+ * @param decoder 解码器
+ * @param data 码流（DmsDataUnit::Data）
+ * @param length 码流长度
+ * @param outPicture 输出图像，使用后由dms_picture_release释放
+ * @return 成功返回0，参数错误返回-1，解码失败返回-3
+ */
+int dms_j2k_decoder_decode(struct DmsJ2kDecoder* decoder, const uint8_t* data, uint32_t length,
+                           struct DmsPicture* outPicture) {
+    if (!decoder || !data || length == 0 || !outPicture) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    memset(outPicture, 0, sizeof(*outPicture));
+    int result = -3;
+    int64_t startUs = now_us();
+#ifdef DMS_HAVE_OPENJPEG
+    opj_image_t* image = nullptr;
+    int reduce = 0;
+    bool degraded = false;
+    int32_t layers = decoder->layers;
+    struct DmsJ2kStreamInfo info;
+    int32_t totalLayers = dms_j2k_parse_header(data, length, &info) == 0 ? info.layers : 0;
+    if (totalLayers > 0 && layers >= totalLayers) {
+        layers = 0;
+    }
+    result = decode_openjpeg(decoder->threads, decoder->reduce, decoder->extraReduce, layers, decoder->outputWidth,
+                             decoder->outputHeight, data, length, &image, &reduce, &degraded);
+    if (result == 0 && (image->numcomps == 0 || image->numcomps > DMS_PICTURE_MAX_COMPONENTS)) {
+        LOGE("Unsupported component count %u", image->numcomps);
+        opj_image_destroy(image);
+        result = -3;
+    }
+    if (result == 0) {
+        // DCI码流各分量尺寸相同，以第一个分量为准
+        outPicture->width = (int32_t)image->comps[0].w;
+        outPicture->height = (int32_t)image->comps[0].h;
+        outPicture->components = (int32_t)image->numcomps;
+        outPicture->precision = (int32_t)image->comps[0].prec;
+        outPicture->reduce = reduce;
+        outPicture->layers = totalLayers;
+        outPicture->degraded = degraded;
+        for (OPJ_UINT32 i = 0; i < image->numcomps; i++) {
+            outPicture->planes[i] = image->comps[i].data;
+        }
+        outPicture->handle = image;
+    }
+#endif
+    int64_t costUs = now_us() - startUs;
+    outPicture->costUs = costUs;
+
+    std::lock_guard<std::mutex> lock(decoder->mutex);
+    if (result == 0) {
+        decoder->frames++;
+        decoder->levelFrames[outPicture->reduce]++;
+        if (outPicture->degraded) {
+            decoder->degradedFrames++;
+        }
+        ewma_update(&decoder->decodeCostUs, (float)costUs);
+    } else {
+        decoder->failures++;
+    }
+    return result;
+}
+
+/**
+ * @brief 获取解码统计信息
+ * @param decoder 解码器
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回-1
+ */
+int dms_j2k_decoder_get_stats(struct DmsJ2kDecoder* decoder, struct DmsJ2kDecoderStats* outStats) {
+    if (!decoder || !outStats) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(decoder->mutex);
+    outStats->threads = decoder->threads;
+    outStats->frames = decoder->frames;
+    outStats->failures = decoder->failures;
+    memcpy(outStats->levelFrames, decoder->levelFrames, sizeof(outStats->levelFrames));
+    outStats->degradedFrames = decoder->degradedFrames;
+    outStats->decodeCostUs = decoder->decodeCostUs;
+    return 0;
+}
+
+/**
+ * @brief 释放解码输出图像
+ * @param picture 图像
+ */
+void dms_picture_release(struct DmsPicture* picture) {
+    if (!picture) {
+        return;
+    }
+#ifdef DMS_HAVE_OPENJPEG
+    opj_image_destroy((opj_image_t*)picture->handle);
+#endif
+    memset(picture, 0, sizeof(*picture));
+}
@@ -0,0 +1,81 @@
+#ifndef DMS_J2K_DECODER_H
+#define DMS_J2K_DECODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * JPEG 2000 图像解码
+ *
+ * 把 libdms 输出的DCI J2K码流（12位 X'Y'Z'）解码为各分量的整数采样。解码由
+ * OpenJPEG 完成（编译时定义 DMS_HAVE_OPENJPEG），码块与tile的熵解码、反量化和
+ * 小波逆变换分配到OpenJPEG的线程池中并行执行；未链接OpenJPEG时创建解码器失败。
+ *
+ * 每次解码使用独立的OpenJPEG编解码器对象，同一解码器可被多个线程同时调用。
+ *
+ * 降分辨率解码：丢弃最高的reduce级小波分解，直接得到1/2、1/4或1/8尺寸的图像。
+ * 被丢弃分辨率的包只解析包头后跳过，不做熵解码、反量化和逆变换。自动模式下按
+ * 输出画面尺寸选择不低于画面尺寸的最小分辨率层，之后只需缩小不需放大。
+ *
+ * 降质解码：赶不上显示时刻时可只解码前若干个质量层，或在上述分辨率层之上再多丢弃
+ * 若干级小波分解（见 dms_decode_quality.h），输出图像标记为降质。
+ */
+
+#define DMS_PICTURE_MAX_COMPONENTS 4
+#define DMS_J2K_REDUCE_AUTO (-1)   // 按输出尺寸自动选择分辨率层
+#define DMS_J2K_MAX_REDUCE 3       // 最多丢弃的小波层数（1/8分辨率）
+
+// 解码配置
+struct DmsJ2kDecoderConfig {
+    int32_t threads;         // 单帧解码使用的线程数，0表示按CPU核数
+    int32_t reduce;          // 丢弃的小波层数（0~3），DMS_J2K_REDUCE_AUTO表示按输出尺寸自动选择
+};
+
+// 解码输出图像
+struct DmsPicture {
+    int32_t width;           // 宽度（像素）
+    int32_t height;          // 高度（像素）
+    int32_t components;      // 分量数（DCI为3：X'Y'Z'）
+    int32_t precision;       // 每分量位数（DCI为12）
+    int32_t reduce;          // 实际丢弃的小波层数，尺寸为原图的1/2^reduce
+    int32_t layers;          // 码流的质量层数，未知为0
+    bool degraded;           // 为赶上显示时刻降低了质量（少解码质量层或多丢弃分辨率层）
+    int64_t costUs;          // 该帧的解码耗时（微秒）
+    const int32_t* planes[DMS_PICTURE_MAX_COMPONENTS]; // 各分量采样，行优先，每行width个
+    void* handle;            // 内部持有的解码图像，由dms_picture_release释放
+};
+
+// 解码统计信息
+struct DmsJ2kDecoderStats {
+    int32_t threads;         // 单帧解码线程数
+    int64_t frames;          // 成功解码的帧数
+    int64_t failures;        // 解码失败的帧数
+    int64_t levelFrames[DMS_J2K_MAX_REDUCE + 1]; // 按丢弃层数统计的解码帧数
+    int64_t degradedFrames;  // 降质解码的帧数
+    float decodeCostUs;      // 单帧解码耗时的滑动平均（微秒）
+};
+
+struct DmsJ2kDecoder;
+
+bool dms_j2k_decoder_available(void);                         // 是否编译了J2K解码支持
+struct DmsJ2kDecoder* dms_j2k_decoder_create(const struct DmsJ2kDecoderConfig* config); // 创建解码器
+void dms_j2k_decoder_destroy(struct DmsJ2kDecoder* decoder);  // 销毁解码器
+int dms_j2k_decoder_set_output_size(struct DmsJ2kDecoder* decoder, int32_t width,
+                                    int32_t height);          // 设置输出画面尺寸，用于自动选择分辨率层
+int dms_j2k_decoder_set_quality(struct DmsJ2kDecoder* decoder, int32_t layers,
+                                int32_t extraReduce);         // 设置降质解码参数
+int dms_j2k_decoder_decode(struct DmsJ2kDecoder* decoder, const uint8_t* data, uint32_t length,
+                           struct DmsPicture* outPicture);    // 解码一帧J2K码流
+int dms_j2k_decoder_get_stats(struct DmsJ2kDecoder* decoder,
+                              struct DmsJ2kDecoderStats* outStats); // 获取统计信息
+void dms_picture_release(struct DmsPicture* picture);         // 释放解码输出图像
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_J2K_DECODER_H
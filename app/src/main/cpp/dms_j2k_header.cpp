@@ -0,0 +1,288 @@
+#include "dms_j2k_header.h"
+#include <string.h>
+
+// 标记（第二个字节，第一个字节为0xFF）
+static const uint8_t kMarkerSoc = 0x4F;
+static const uint8_t kMarkerSiz = 0x51;
+static const uint8_t kMarkerCod = 0x52;
+static const uint8_t kMarkerCoc = 0x53;
+static const uint8_t kMarkerQcd = 0x5C;
+static const uint8_t kMarkerQcc = 0x5D;
+static const uint8_t kMarkerRgn = 0x5E;
+static const uint8_t kMarkerPoc = 0x5F;
+static const uint8_t kMarkerSot = 0x90;
+
+static const uint32_t kFnvOffset = 2166136261u;
+static const uint32_t kFnvPrime = 16777619u;
+
+static inline uint32_t read16(const uint8_t* p) {
+    return ((uint32_t)p[0] << 8) | p[1];
+}
+
+static inline uint32_t read32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// 是否为参与指纹计算的参数段
+static inline bool is_parameter_marker(uint8_t marker) {
+    return marker == kMarkerSiz || marker == kMarkerCod || marker == kMarkerCoc || marker == kMarkerQcd ||
+           marker == kMarkerQcc || marker == kMarkerRgn || marker == kMarkerPoc;
+}
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t* data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * kFnvPrime;
+    }
+    return hash;
+}
+
+/**
+ * @brief 解析SIZ标记段
+ * @param body 段内容（Lsiz之后）
+ * @param length 段内容长度
+ * @param info 输出码流参数
+ * @return 成功返回true
+ */
+static bool parse_siz(const uint8_t* body, uint32_t length, struct DmsJ2kStreamInfo* info) {
+    if (length < 36) {
+        return false;
+    }
+    info->rsiz = (uint16_t)read16(body);
+    uint32_t xsiz = read32(body + 2);
+    uint32_t ysiz = read32(body + 6);
+    info->offsetX = read32(body + 10);
+    info->offsetY = read32(body + 14);
+    info->tileWidth = read32(body + 18);
+    info->tileHeight = read32(body + 22);
+    info->tileOffsetX = read32(body + 26);
+    info->tileOffsetY = read32(body + 30);
+    uint32_t components = read16(body + 34);
+    if (xsiz <= info->offsetX || ysiz <= info->offsetY || info->tileWidth == 0 || info->tileHeight == 0 ||
+        info->tileOffsetX > info->offsetX || info->tileOffsetY > info->offsetY || components == 0 ||
+        length < 36 + 3 * components) {
+        return false;
+    }
+    info->width = xsiz - info->offsetX;
+    info->height = ysiz - info->offsetY;
+    info->tilesX = (uint32_t)(((uint64_t)xsiz - info->tileOffsetX + info->tileWidth - 1) / info->tileWidth);
+    info->tilesY = (uint32_t)(((uint64_t)ysiz - info->tileOffsetY + info->tileHeight - 1) / info->tileHeight);
+    info->components = (int32_t)components;
+    for (uint32_t i = 0; i < components && i < DMS_J2K_MAX_COMPONENTS; i++) {
+        const uint8_t* c = body + 36 + 3 * i;
+        info->precision[i] = (uint8_t)((c[0] & 0x7F) + 1);
+        info->isSigned[i] = (c[0] & 0x80) != 0;
+        info->dx[i] = c[1];
+        info->dy[i] = c[2];
+    }
+    return true;
+}
+
+/**
+ * @brief 解析COD标记段
+ * @param body 段内容（Lcod之后）
+ * @param length 段内容长度
+ * @param info 输出码流参数
+ * @return 成功返回true
+ */
+static bool parse_cod(const uint8_t* body, uint32_t length, struct DmsJ2kStreamInfo* info) {
+    // 分解级数最多32级
+    if (length < 10 || body[5] > 32) {
+        return false;
+    }
+    uint8_t scod = body[0];
+    info->progression = body[1];
+    info->layers = (int32_t)read16(body + 2);
+    info->mct = body[4] != 0;
+    info->levels = body[5];
+    info->codeBlockWidth = 1 << ((body[6] & 0x0F) + 2);
+    info->codeBlockHeight = 1 << ((body[7] & 0x0F) + 2);
+    info->codeBlockStyle = body[8];
+    info->reversible = body[9] == 1;
+    info->precincts = (scod & 0x01) != 0;
+    if (info->precincts) {
+        if (length < 10 + (uint32_t)info->levels + 1) {
+            return false;
+        }
+        memcpy(info->precinctSizes, body + 10, (size_t)info->levels + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief 解析QCD标记段
+ * @param body 段内容（Lqcd之后）
+ * @param length 段内容长度
+ * @param info 输出码流参数
+ * @return 成功返回true
+ */
+static bool parse_qcd(const uint8_t* body, uint32_t length, struct DmsJ2kStreamInfo* info) {
+    if (length < 1) {
+        return false;
+    }
+    info->quantStyle = body[0] & 0x1F;
+    info->guardBits = body[0] >> 5;
+    return true;
+}
+
+/**
+ * @brief 解析码流主头的SIZ、COD、QCD标记段，不分配内存
+ * @param data 码流（DmsDataUnit::Data）
+ * @param length 码流长度
+ * @param outInfo 输出码流参数
+ * @return 成功返回0，参数错误返回-1，不是J2K码流或主头不完整返回-3
+ */
+int dms_j2k_parse_header(const uint8_t* data, uint32_t length, struct DmsJ2kStreamInfo* outInfo) {
+    if (!data || !outInfo) {
+        return -1;
+    }
+    memset(outInfo, 0, sizeof(*outInfo));
+    // SOC之后第一个标记段必须是SIZ
+    if (length < 4 || data[0] != 0xFF || data[1] != kMarkerSoc || data[2] != 0xFF || data[3] != kMarkerSiz) {
+        return -3;
+    }
+    bool siz = false, cod = false, qcd = false;
+    uint32_t hash = kFnvOffset;
+    uint32_t offset = 2;
+    while (offset + 4 <= length && data[offset] == 0xFF) {
+        uint8_t marker = data[offset + 1];
+        if (marker == kMarkerSot) {
+            break;
+        }
+        uint32_t segment = read16(data + offset + 2);
+        if (segment < 2 || offset + 2 + segment > length) {
+            return -3;
+        }
+        const uint8_t* body = data + offset + 4;
+        uint32_t bodyLength = segment - 2;
+        if (marker == kMarkerSiz) {
+            siz = parse_siz(body, bodyLength, outInfo);
+        } else if (marker == kMarkerCod) {
+            cod = parse_cod(body, bodyLength, outInfo);
+        } else if (marker == kMarkerQcd) {
+            qcd = parse_qcd(body, bodyLength, outInfo);
+        }
+        if (is_parameter_marker(marker)) {
+            hash = fnv1a(hash, data + offset, 2 + segment);
+        }
+        offset += 2 + segment;
+    }
+    if (!siz || !cod || !qcd || offset + 2 > length || data[offset] != 0xFF || data[offset + 1] != kMarkerSot) {
+        return -3;
+    }
+    outInfo->headerBytes = offset;
+    outInfo->fingerprint = hash;
+    return 0;
+}
+
+/**
+ * @brief 计算主头参数段（SIZ/COD/COC/QCD/QCC/RGN/POC）的指纹，只遍历标记段不解析字段
+ * @param data 码流
+ * @param length 码流长度
+ * @return 指纹，与dms_j2k_parse_header输出的fingerprint一致；不是J2K码流返回0
+ */
+uint32_t dms_j2k_header_fingerprint(const uint8_t* data, uint32_t length) {
+    if (!data || length < 4 || data[0] != 0xFF || data[1] != kMarkerSoc) {
+        return 0;
+    }
+    uint32_t hash = kFnvOffset;
+    uint32_t offset = 2;
+    while (offset + 4 <= length && data[offset] == 0xFF) {
+        uint8_t marker = data[offset + 1];
+        if (marker == kMarkerSot) {
+            return hash;
+        }
+        uint32_t segment = read16(data + offset + 2);
+        if (segment < 2 || offset + 2 + segment > length) {
+            return 0;
+        }
+        if (is_parameter_marker(marker)) {
+            hash = fnv1a(hash, data + offset, 2 + segment);
+        }
+        offset += 2 + segment;
+    }
+    return 0;
+}
+
+/**
+ * @brief 按DCI 2K/4K档次（ISO/IEC 15444-1 附录A.10）检查码流参数
+ * @param info 码流参数
+ * @return 不符合项的DmsJ2kViolation组合，0表示符合
+ */
+uint32_t dms_j2k_check_dci(const struct DmsJ2kStreamInfo* info) {
+    if (!info) {
+        return 0;
+    }
+    uint32_t violations = 0;
+    bool is4k = info->rsiz == DMS_J2K_PROFILE_CINEMA_4K;
+    if (info->rsiz != DMS_J2K_PROFILE_CINEMA_2K && !is4k) {
+        violations |= DMS_J2K_VIOLATION_RSIZ;
+    }
+    uint32_t maxWidth = is4k ? 4096 : 2048;
+    uint32_t maxHeight = is4k ? 2160 : 1080;
+    if (info->width > maxWidth || info->height > maxHeight || info->offsetX != 0 || info->offsetY != 0) {
+        violations |= DMS_J2K_VIOLATION_SIZE;
+    }
+    if (info->components != 3) {
+        violations |= DMS_J2K_VIOLATION_COMPONENTS;
+    } else {
+        for (int i = 0; i < 3; i++) {
+            if (info->precision[i] != 12 || info->isSigned[i] || info->dx[i] != 1 || info->dy[i] != 1) {
+                violations |= DMS_J2K_VIOLATION_COMPONENTS;
+            }
+        }
+    }
+    if (info->tilesX != 1 || info->tilesY != 1 || info->tileOffsetX != 0 || info->tileOffsetY != 0) {
+        violations |= DMS_J2K_VIOLATION_TILING;
+    }
+    if (info->progression != DMS_J2K_CPRL) {
+        violations |= DMS_J2K_VIOLATION_PROGRESSION;
+    }
+    if (info->layers != 1) {
+        violations |= DMS_J2K_VIOLATION_LAYERS;
+    }
+    if (info->levels < 1 || info->levels > (is4k ? 6 : 5)) {
+        violations |= DMS_J2K_VIOLATION_LEVELS;
+    }
+    if (info->codeBlockWidth != 32 || info->codeBlockHeight != 32 || info->codeBlockStyle != 0) {
+        violations |= DMS_J2K_VIOLATION_CODEBLOCK;
+    }
+    if (info->reversible) {
+        violations |= DMS_J2K_VIOLATION_TRANSFORM;
+    }
+    // 最低分辨率（LL）的分区为128x128，其余分辨率为256x256
+    if (!info->precincts) {
+        violations |= DMS_J2K_VIOLATION_PRECINCTS;
+    } else {
+        for (int32_t r = 0; r <= info->levels && r < (int32_t)sizeof(info->precinctSizes); r++) {
+            if (info->precinctSizes[r] != (r == 0 ? 0x77 : 0x88)) {
+                violations |= DMS_J2K_VIOLATION_PRECINCTS;
+            }
+        }
+    }
+    if (info->quantStyle != 2 || info->guardBits != 1) {
+        violations |= DMS_J2K_VIOLATION_QUANTIZATION;
+    }
+    return violations;
+}
+
+/**
+ * @brief 档次名称
+ * @param rsiz SIZ中的Rsiz
+ * @return 名称
+ */
+const char* dms_j2k_profile_name(uint16_t rsiz) {
+    switch (rsiz) {
+        case DMS_J2K_PROFILE_NONE:
+            return "Part 1";
+        case DMS_J2K_PROFILE_0:
+            return "Profile 0";
+        case DMS_J2K_PROFILE_1:
+            return "Profile 1";
+        case DMS_J2K_PROFILE_CINEMA_2K:
+            return "DCI 2K";
+        case DMS_J2K_PROFILE_CINEMA_4K:
+            return "DCI 4K";
+        default:
+            return "Other";
+    }
+}
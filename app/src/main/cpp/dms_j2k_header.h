@@ -0,0 +1,101 @@
+#ifndef DMS_J2K_HEADER_H
+#define DMS_J2K_HEADER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * J2K码流主头解析
+ *
+ * 只读取主头（SOC到第一个SOT之间）的SIZ、COD、QCD标记段，得到图像尺寸、分量位深、
+ * tile划分、小波分解级数、质量层数与DCI档次（Rsiz），不分配内存、不经过OpenJPEG，
+ * 一个2K码流的主头约一百余字节，解析耗时在微秒以下。
+ *
+ * 逐帧检测主头变化：DCI要求主头带TLM标记段，其内容（各tile-part长度）每帧不同，
+ * 因此只对SIZ/COD/COC/QCD/QCC/RGN/POC这些参数段计算指纹，指纹不同时才重新解析。
+ */
+
+#define DMS_J2K_MAX_COMPONENTS 4
+
+// Rsiz 档次
+enum DmsJ2kProfile {
+    DMS_J2K_PROFILE_NONE = 0x0000,       // 无限制（Part 1）
+    DMS_J2K_PROFILE_0 = 0x0001,          // Profile 0
+    DMS_J2K_PROFILE_1 = 0x0002,          // Profile 1
+    DMS_J2K_PROFILE_CINEMA_2K = 0x0003,  // DCI 2K
+    DMS_J2K_PROFILE_CINEMA_4K = 0x0004,  // DCI 4K
+};
+
+// 进展顺序
+enum DmsJ2kProgression {
+    DMS_J2K_LRCP = 0,
+    DMS_J2K_RLCP = 1,
+    DMS_J2K_RPCL = 2,
+    DMS_J2K_PCRL = 3,
+    DMS_J2K_CPRL = 4,
+};
+
+// 不符合DCI档次的项（按位组合）
+enum DmsJ2kViolation {
+    DMS_J2K_VIOLATION_RSIZ = 1 << 0,         // Rsiz不是DCI 2K/4K
+    DMS_J2K_VIOLATION_SIZE = 1 << 1,         // 图像尺寸超出档次上限或有偏移
+    DMS_J2K_VIOLATION_COMPONENTS = 1 << 2,   // 不是3个无符号12位、无下采样的分量
+    DMS_J2K_VIOLATION_TILING = 1 << 3,       // 不是单tile
+    DMS_J2K_VIOLATION_PROGRESSION = 1 << 4,  // 进展顺序不是CPRL
+    DMS_J2K_VIOLATION_LAYERS = 1 << 5,       // 质量层数不是1
+    DMS_J2K_VIOLATION_LEVELS = 1 << 6,       // 分解级数超出范围（2K为1~5，4K为1~6）
+    DMS_J2K_VIOLATION_CODEBLOCK = 1 << 7,    // 码块不是32x32或启用了码块模式开关
+    DMS_J2K_VIOLATION_TRANSFORM = 1 << 8,    // 不是9/7不可逆小波
+    DMS_J2K_VIOLATION_PRECINCTS = 1 << 9,    // 分区尺寸不是最低分辨率128、其余256
+    DMS_J2K_VIOLATION_QUANTIZATION = 1 << 10, // 不是显式标量量化或保护位不是1
+};
+
+// 码流参数
+struct DmsJ2kStreamInfo {
+    uint16_t rsiz;           // 档次，DmsJ2kProfile
+    uint32_t width;          // 图像宽度（Xsiz - XOsiz）
+    uint32_t height;         // 图像高度（Ysiz - YOsiz）
+    uint32_t offsetX;        // 图像在参考网格上的偏移
+    uint32_t offsetY;
+    uint32_t tileWidth;      // tile尺寸
+    uint32_t tileHeight;
+    uint32_t tileOffsetX;    // 第一个tile的偏移
+    uint32_t tileOffsetY;
+    uint32_t tilesX;         // 横向tile数
+    uint32_t tilesY;         // 纵向tile数
+    int32_t components;      // 分量数
+    uint8_t precision[DMS_J2K_MAX_COMPONENTS]; // 各分量位数
+    bool isSigned[DMS_J2K_MAX_COMPONENTS];     // 各分量是否有符号
+    uint8_t dx[DMS_J2K_MAX_COMPONENTS];        // 各分量的水平/垂直下采样
+    uint8_t dy[DMS_J2K_MAX_COMPONENTS];
+    int32_t progression;     // 进展顺序，DmsJ2kProgression
+    int32_t layers;          // 质量层数
+    bool mct;                // 是否使用多分量变换
+    int32_t levels;          // 小波分解级数
+    int32_t codeBlockWidth;  // 码块尺寸（像素）
+    int32_t codeBlockHeight;
+    uint8_t codeBlockStyle;  // 码块模式开关
+    bool reversible;         // true为5/3可逆小波，false为9/7不可逆小波
+    bool precincts;          // 是否显式指定分区尺寸
+    uint8_t precinctSizes[33]; // 各分辨率的分区尺寸（低4位PPx、高4位PPy），从最低分辨率起
+    int32_t quantStyle;      // 量化方式：0无量化，1标量导出，2标量显式
+    int32_t guardBits;       // 保护位数
+    uint32_t headerBytes;    // 主头长度（到第一个SOT）
+    uint32_t fingerprint;    // 参数段指纹，用于检测逐帧变化
+};
+
+int dms_j2k_parse_header(const uint8_t* data, uint32_t length,
+                         struct DmsJ2kStreamInfo* outInfo);  // 解析主头
+uint32_t dms_j2k_header_fingerprint(const uint8_t* data, uint32_t length); // 参数段指纹，不是码流返回0
+uint32_t dms_j2k_check_dci(const struct DmsJ2kStreamInfo* info); // 检查DCI档次，返回DmsJ2kViolation组合，0为符合
+const char* dms_j2k_profile_name(uint16_t rsiz);               // 档次名称
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_J2K_HEADER_H
@@ -1,13 +1,25 @@
 #include <jni.h>
 #include <android/log.h>
+#include <android/native_window_jni.h>
+#include <stdlib.h>
+#include <string.h>
 #include <string>
 
 #include "dms_player.h"
+#include "dms_decode_pipeline.h"
+#include "dms_renderer.h"
+#include "dms_thumbnail.h"
+#include "dms_codestream_ring.h"
+#include "dms_video_sink.h"
+#include "dms_color.h"
+#include "dms_scaler.h"
+#include "dms_stereo.h"
 #include "../include/libdms.h"
 
 // 定义日志标签和宏
 #define LOG_TAG "DMS_JNI"
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 extern "C" {
@@ -15,6 +27,7 @@ extern "C" {
 // 全局引用Java类
 static jclass gKdmInfoClass = nullptr;     // KDM信息类的全局引用
 static jclass gMxfInfoClass = nullptr;     // MXF信息类的全局引用
+static jclass gStreamInfoClass = nullptr;  // 码流参数类的全局引用
 
 // KdmInfo类的字段ID
 static jfieldID gKdmInfo_id;                    // KDM ID字段
@@ -36,6 +49,25 @@ static jfieldID gMxfInfo_duration;       // 持续时间字段
 static jfieldID gMxfInfo_codec;          // 编解码器字段
 static jfieldID gMxfInfo_isEncrypted;    // 是否加密字段
 
+// StreamInfo类的字段ID
+static jfieldID gStreamInfo_width;               // 图像宽度字段
+static jfieldID gStreamInfo_height;              // 图像高度字段
+static jfieldID gStreamInfo_components;          // 分量数字段
+static jfieldID gStreamInfo_bitDepth;            // 分量位数字段
+static jfieldID gStreamInfo_isSigned;            // 分量是否有符号字段
+static jfieldID gStreamInfo_tileWidth;           // tile宽度字段
+static jfieldID gStreamInfo_tileHeight;          // tile高度字段
+static jfieldID gStreamInfo_tilesX;              // 横向tile数字段
+static jfieldID gStreamInfo_tilesY;              // 纵向tile数字段
+static jfieldID gStreamInfo_decompositionLevels; // 小波分解级数字段
+static jfieldID gStreamInfo_qualityLayers;       // 质量层数字段
+static jfieldID gStreamInfo_progression;         // 进展顺序字段
+static jfieldID gStreamInfo_reversible;          // 是否可逆小波字段
+static jfieldID gStreamInfo_rsiz;                // Rsiz字段
+static jfieldID gStreamInfo_profile;             // 档次名称字段
+static jfieldID gStreamInfo_dciViolations;       // DCI档次不符合项字段
+static jfieldID gStreamInfo_headerChanges;       // 主头参数变化次数字段
+
 /**
  * 初始化DMS播放器
  * @param env JNI环境指针
@@ -44,20 +76,13 @@ static jfieldID gMxfInfo_isEncrypted;    // 是否加密字段
  */
 JNIEXPORT jboolean JNICALL
 Java_com_djs_djsdmsplayer_DmsPlayer_initialize(JNIEnv* env, jobject thiz) {
-    // 初始化DMS库
-    int result = _dms_library_initialize(DMS_MODE_PLAY, nullptr, true);
-
-    if (result != DMS_RESULT_SUCCESS) {
-        LOGE("Failed to initialize DMS library: 0x%08x", result);
+    // 创建本地上下文，成员初始值与DMS库初始化统一由dms_player_init完成
+    DmsContext* context = new DmsContext();
+    if (dms_player_init(context) != 0) {
+        delete context;
         return JNI_FALSE;
     }
 
-    // 创建并存储本地上下文
-    DmsContext* context = new DmsContext();
-    context->isInitialized = true;
-    context->hasActiveMxf = false;
-    context->currentPosition = 0;
-
     jclass clazz = env->GetObjectClass(thiz);
     jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
     env->SetLongField(thiz, fieldId, reinterpret_cast<jlong>(context));
@@ -93,6 +118,30 @@ Java_com_djs_djsdmsplayer_DmsPlayer_initialize(JNIEnv* env, jobject thiz) {
         gMxfInfo_isEncrypted = env->GetFieldID(gMxfInfoClass, "isEncrypted", "Z");
     }
 
+    if (gStreamInfoClass == nullptr) {
+        jclass localStreamInfoClass = env->FindClass("com/djs/djsdmsplayer/DmsPlayer$StreamInfo");
+        gStreamInfoClass = static_cast<jclass>(env->NewGlobalRef(localStreamInfoClass));
+        env->DeleteLocalRef(localStreamInfoClass);
+
+        gStreamInfo_width = env->GetFieldID(gStreamInfoClass, "width", "I");
+        gStreamInfo_height = env->GetFieldID(gStreamInfoClass, "height", "I");
+        gStreamInfo_components = env->GetFieldID(gStreamInfoClass, "components", "I");
+        gStreamInfo_bitDepth = env->GetFieldID(gStreamInfoClass, "bitDepth", "I");
+        gStreamInfo_isSigned = env->GetFieldID(gStreamInfoClass, "isSigned", "Z");
+        gStreamInfo_tileWidth = env->GetFieldID(gStreamInfoClass, "tileWidth", "I");
+        gStreamInfo_tileHeight = env->GetFieldID(gStreamInfoClass, "tileHeight", "I");
+        gStreamInfo_tilesX = env->GetFieldID(gStreamInfoClass, "tilesX", "I");
+        gStreamInfo_tilesY = env->GetFieldID(gStreamInfoClass, "tilesY", "I");
+        gStreamInfo_decompositionLevels = env->GetFieldID(gStreamInfoClass, "decompositionLevels", "I");
+        gStreamInfo_qualityLayers = env->GetFieldID(gStreamInfoClass, "qualityLayers", "I");
+        gStreamInfo_progression = env->GetFieldID(gStreamInfoClass, "progression", "I");
+        gStreamInfo_reversible = env->GetFieldID(gStreamInfoClass, "reversible", "Z");
+        gStreamInfo_rsiz = env->GetFieldID(gStreamInfoClass, "rsiz", "I");
+        gStreamInfo_profile = env->GetFieldID(gStreamInfoClass, "profile", "Ljava/lang/String;");
+        gStreamInfo_dciViolations = env->GetFieldID(gStreamInfoClass, "dciViolations", "I");
+        gStreamInfo_headerChanges = env->GetFieldID(gStreamInfoClass, "headerChanges", "J");
+    }
+
     return JNI_TRUE;
 }
 
@@ -108,11 +157,18 @@ Java_com_djs_djsdmsplayer_DmsPlayer_uninitialize(JNIEnv* env, jobject thiz) {
     DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
 
     if (context != nullptr) {
+        // 先停止渲染与后台读取再关闭DCP，其余资源与DMS库由dms_player_uninit释放
+        dms_renderer_destroy(context->renderer);
+        context->renderer = nullptr;
+        dms_thumbnail_destroy(context->thumbnails);
+        context->thumbnails = nullptr;
+        dms_player_close_index(context);
+        dms_player_close_journal(context);
+        dms_player_stop_decode(context);
         if (context->hasActiveMxf) {
             _dms_close_dcp(); // 暂时使用DCP关闭函数
         }
-
-        _dms_library_uninitialize();
+        dms_player_uninit(context);
         delete context;
         env->SetLongField(thiz, fieldId, 0LL);
     }
@@ -127,6 +183,11 @@ Java_com_djs_djsdmsplayer_DmsPlayer_uninitialize(JNIEnv* env, jobject thiz) {
         env->DeleteGlobalRef(gMxfInfoClass);
         gMxfInfoClass = nullptr;
     }
+
+    if (gStreamInfoClass != nullptr) {
+        env->DeleteGlobalRef(gStreamInfoClass);
+        gStreamInfoClass = nullptr;
+    }
 }
 
 /**
@@ -240,7 +301,9 @@ Java_com_djs_djsdmsplayer_DmsPlayer_openMxf(JNIEnv* env, jobject thiz, jstring m
 
 // 暂时使用DCP函数打开MXF文件
 // 这是一个临时解决方案，直到我们有直接的MXF支持
-    int result = _dms_open_dcp(mxfPath, "dummy-session-id", false);
+// 每次打开为新的放映场次，场次标识同时写入断点续播日志
+    const char* sessionId = dms_player_begin_session(context);
+    int result = _dms_open_dcp(mxfPath, sessionId ? sessionId : "", false);
 
     if (result != DMS_RESULT_SUCCESS) {
         LOGE("Failed to open MXF file: 0x%08x", result);
@@ -251,15 +314,29 @@ Java_com_djs_djsdmsplayer_DmsPlayer_openMxf(JNIEnv* env, jobject thiz, jstring m
     context->hasActiveMxf = true;
     env->ReleaseStringUTFChars(mxf_path, mxfPath);
 
-// 创建Java MxfInfo对象并设置默认数据
-// 在实际实现中，我们会从MXF文件中提取这些信息
+// 建立分本时间轴并载入第一个分本的帧索引，播放过程中增量补全、跨分本自动切换
+    dms_player_open_timeline(context);
+
+// 图像尺寸取自第一帧J2K主头；码流加密且尚未绑定KDM时无法解析，沿用1920x1080，
+// 首次取帧后可通过getStreamInfo获取
+    DmsJ2kStreamInfo info;
+    bool probed = dms_player_probe_stream(context, &info) == 0;
+    if (probed) {
+        uint32_t violations = dms_j2k_check_dci(&info);
+        LOGI("Codestream %ux%u, %d components %d-bit, %d levels, %d layers, %s%s", info.width, info.height,
+             info.components, info.precision[0], info.levels, info.layers, dms_j2k_profile_name(info.rsiz),
+             violations ? " (not DCI compliant)" : "");
+    }
+
     jobject mxfInfo = env->NewObject(gMxfInfoClass,
                                      env->GetMethodID(gMxfInfoClass, "<init>", "()V"));
 
-    env->SetIntField(mxfInfo, gMxfInfo_width, 1920);
-    env->SetIntField(mxfInfo, gMxfInfo_height, 1080);
-    env->SetFloatField(mxfInfo, gMxfInfo_frameRate, 24.0f);
-    env->SetLongField(mxfInfo, gMxfInfo_duration, 120 * 1000000L); // 120秒，单位为微秒
+    env->SetIntField(mxfInfo, gMxfInfo_width, probed ? (jint)info.width : 1920);
+    env->SetIntField(mxfInfo, gMxfInfo_height, probed ? (jint)info.height : 1080);
+    env->SetFloatField(mxfInfo, gMxfInfo_frameRate, context->frameRate > 0 ? context->frameRate : 24.0f);
+    // 单位为微秒，时间轴尚无帧数时沿用120秒
+    env->SetLongField(mxfInfo, gMxfInfo_duration,
+                      context->duration > 0 ? context->duration * 1000L : 120 * 1000000L);
     env->SetBooleanField(mxfInfo, gMxfInfo_isEncrypted, true);
 
     jstring codec = env->NewStringUTF("JPEG2000");
@@ -281,9 +358,21 @@ Java_com_djs_djsdmsplayer_DmsPlayer_closeMxf(JNIEnv* env, jobject thiz) {
     DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
 
     if (context != nullptr && context->hasActiveMxf) {
+        dms_renderer_destroy(context->renderer);
+        context->renderer = nullptr;
+        dms_thumbnail_destroy(context->thumbnails);
+        context->thumbnails = nullptr;
+        dms_player_stop_decode(context);
+        dms_player_close_index(context);
+        dms_player_end_session(context);
+        // 码流缓存中是解密后的码流，关闭时清零
+        dms_codestream_ring_clear(context->codestreamRing);
+        context->ringFrame = -1;
         _dms_close_dcp();
         context->hasActiveMxf = false;
         context->currentPosition = 0;
+        context->duration = 0;
+        dms_reel_timeline_reset(&context->timeline);
     }
 }
 
@@ -337,29 +426,32 @@ Java_com_djs_djsdmsplayer_DmsPlayer_getNextFrame(JNIEnv* env, jobject thiz, jbyt
         LOGE("No active MXF file");
         return -1;
     }
+    if (context->renderer != nullptr) {
+        LOGE("Frames are consumed by the native renderer");
+        return -1;
+    }
 
     jbyte* bufferPtr = env->GetByteArrayElements(buffer, nullptr);
     jsize bufferLength = env->GetArrayLength(buffer);
 
-    DmsDataUnitPtr dataUnit = nullptr;
-    int result = _dms_get_next_picture_unit(&dataUnit);
+    DmsFrame frame;
+    int result = dms_player_next_frame(context, &frame);
 
-    if (result != DMS_RESULT_SUCCESS || dataUnit == nullptr) {
+    if (result != DMS_RESULT_SUCCESS || frame.unit == nullptr) {
         env->ReleaseByteArrayElements(buffer, bufferPtr, 0);
         return -1; // 流结束或出错
     }
 
 // 将帧数据复制到Java缓冲区
-    int bytesToCopy = dataUnit->Length;
+    int bytesToCopy = frame.unit->Length;
     if (bytesToCopy > bufferLength) {
         LOGE("Buffer too small for frame data: %d > %d", bytesToCopy, bufferLength);
         bytesToCopy = bufferLength;
     }
 
-    memcpy(bufferPtr, dataUnit->Data, bytesToCopy);
-    context->currentPosition = dataUnit->Pos;
+    memcpy(bufferPtr, frame.unit->Data, bytesToCopy);
 
-    _dms_free_data_unit(&dataUnit);
+    dms_player_release_frame(&frame);
     env->ReleaseByteArrayElements(buffer, bufferPtr, 0);
 
     return bytesToCopy;
@@ -381,17 +473,822 @@ Java_com_djs_djsdmsplayer_DmsPlayer_seekTo(JNIEnv* env, jobject thiz, jlong posi
         LOGE("No active MXF file");
         return;
     }
+    if (context->renderer != nullptr) {
+        dms_renderer_seek(context->renderer, positionUs);
+        return;
+    }
 
-// 将微秒转换为字节位置（这是一个简化的处理方式）
-// 在实际实现中，我们需要将时间映射到文件位置
-    int64_t targetPosition = (positionUs * 1000000) / 24; // 假设24fps和恒定比特率
-
-    int result = _dms_goto_pos(targetPosition, false);
-    if (result == DMS_RESULT_SUCCESS) {
-        context->currentPosition = targetPosition;
-    } else {
+// 按帧率换算为帧号，由帧索引定位到对应的Pos
+    int result = dms_player_seek_frame(context, (int64_t)((double)positionUs * context->frameRate / 1000000.0));
+    if (result != DMS_RESULT_SUCCESS) {
         LOGE("Seek failed: 0x%08x", result);
     }
+    context->outputTimeUs = positionUs;
+}
+
+/**
+ * 设置播放速度
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param speed 1为正常播放，-1为倒放，±2~±32为快进/快退
+ * @return 设置成功返回JNI_TRUE，失败返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setPlaybackSpeed(JNIEnv* env, jobject thiz, jfloat speed) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        LOGE("DMS player not initialized");
+        return JNI_FALSE;
+    }
+    if (context->renderer != nullptr) {
+        LOGE("Speed changes are not supported by the native renderer");
+        return JNI_FALSE;
+    }
+
+    return dms_player_set_speed(context, speed) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 获取最近一次getNextFrame返回帧的时间戳，倍速播放时已按墙钟节奏改写
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 时间戳（微秒）
+ */
+JNIEXPORT jlong JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_getLastFrameTimeUs(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    return context != nullptr ? context->lastFrameTimeUs : 0;
+}
+
+/**
+ * 将逐帧模式下的数据单元复制到Java缓冲区
+ * @param env JNI环境指针
+ * @param buffer Java字节数组缓冲区
+ * @param unit 数据单元
+ * @return 实际复制的字节数
+ */
+static jint copy_step_unit(JNIEnv* env, jbyteArray buffer, const DmsDataUnit* unit) {
+    jsize bufferLength = env->GetArrayLength(buffer);
+    jint bytesToCopy = unit->Length;
+    if (bytesToCopy > bufferLength) {
+        LOGE("Buffer too small for frame data: %d > %d", bytesToCopy, bufferLength);
+        bytesToCopy = bufferLength;
+    }
+    env->SetByteArrayRegion(buffer, 0, bytesToCopy, reinterpret_cast<const jbyte*>(unit->Data));
+    return bytesToCopy;
+}
+
+/**
+ * 逐帧前进或后退一帧，之后getNextFrame从当前帧的下一帧继续；附加Surface后由渲染器取帧，不可调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param direction 1前进，-1后退
+ * @param buffer Java字节数组缓冲区
+ * @return 实际复制的字节数，越过片头/片尾或出错返回-1
+ */
+JNIEXPORT jint JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_stepFrame(JNIEnv* env, jobject thiz, jint direction, jbyteArray buffer) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || !context->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -1;
+    }
+    if (context->renderer != nullptr) {
+        LOGE("Frames are consumed by the native renderer");
+        return -1;
+    }
+
+    const DmsDataUnit* unit = nullptr;
+    if (dms_player_step_frame(context, direction, &unit, nullptr) != DMS_RESULT_SUCCESS) {
+        return -1;
+    }
+    return copy_step_unit(env, buffer, unit);
+}
+
+/**
+ * 精确定位并取出指定帧，进入逐帧模式；附加Surface后由渲染器取帧，不可调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param frame 目标帧号
+ * @param buffer Java字节数组缓冲区
+ * @return 实际复制的字节数，超出范围或出错返回-1
+ */
+JNIEXPORT jint JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_seekToFrame(JNIEnv* env, jobject thiz, jlong frame, jbyteArray buffer) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || !context->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -1;
+    }
+    if (context->renderer != nullptr) {
+        LOGE("Frames are consumed by the native renderer");
+        return -1;
+    }
+
+    const DmsDataUnit* unit = nullptr;
+    if (dms_player_seek_to_frame(context, frame, &unit) != DMS_RESULT_SUCCESS) {
+        return -1;
+    }
+    return copy_step_unit(env, buffer, unit);
+}
+
+/**
+ * 获取当前帧号：逐帧模式下为当前显示帧，播放时为最近取出的帧
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 帧号，未知返回-1
+ */
+JNIEXPORT jlong JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_getCurrentFrame(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    return dms_player_get_current_frame(context);
+}
+
+/**
+ * 打开断点续播日志，应在openMxf之前调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param path 日志文件路径（应用私有的持久目录）
+ * @param syncIntervalMs 落盘周期（毫秒），0表示每帧同步落盘
+ * @return 成功返回JNI_TRUE，失败返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setBreakpointJournal(JNIEnv* env, jobject thiz, jstring path,
+                                                          jint syncIntervalMs) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        LOGE("DMS player not initialized");
+        return JNI_FALSE;
+    }
+
+    const char* journalPath = env->GetStringUTFChars(path, nullptr);
+    int result = dms_player_open_journal(context, journalPath, syncIntervalMs);
+    env->ReleaseStringUTFChars(path, journalPath);
+    return result == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 帧已显示：以其时间戳记录断点。取帧领先于显示，断点只在帧真正上屏后前进，
+ * 由ExoPlayer的视频帧元数据回调在播放线程调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param presentationTimeUs 已显示帧的时间戳（与getLastFrameTimeUs同一时间轴）
+ */
+JNIEXPORT void JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_onFramePresented(JNIEnv* env, jobject thiz, jlong presentationTimeUs) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        return;
+    }
+    dms_player_frame_presented(context, presentationTimeUs);
+}
+
+/**
+ * 检查是否有断电前未正常结束的放映可以续播
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 有可续播断点返回JNI_TRUE，否则返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_hasBreakpoint(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    struct DmsBreakpointRecord record;
+    return (context != nullptr && dms_player_get_breakpoint(context, &record) == 0) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 断电后的断点续播，代替bindKdm与openMxf：以原放映场次打开DCP、绑定KDM、
+ * 登记断点并定位，预读到最小缓冲后返回
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param mxf_path DCP包路径
+ * @param kdm_path KDM文件路径，未加密影片可为null
+ * @param minBufferSeconds 开始显示前至少缓冲的秒数
+ * @return 各阶段耗时（微秒）：读取断点、打开DCP、绑定KDM、载入索引、登记断点、定位、缓冲、总耗时，
+ *         以及已缓冲帧数、续播帧号；没有断点或失败返回nullptr
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_resumeFromBreakpoint(JNIEnv* env, jobject thiz, jstring mxf_path,
+                                                          jstring kdm_path, jfloat minBufferSeconds) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || !context->isInitialized) {
+        LOGE("DMS player not initialized");
+        return nullptr;
+    }
+
+    const char* mxfPath = env->GetStringUTFChars(mxf_path, nullptr);
+    const char* kdmPath = kdm_path != nullptr ? env->GetStringUTFChars(kdm_path, nullptr) : nullptr;
+    DmsResumeStats stats;
+    int result = dms_player_resume_breakpoint(context, mxfPath, kdmPath, minBufferSeconds, &stats);
+    env->ReleaseStringUTFChars(mxf_path, mxfPath);
+    if (kdmPath != nullptr) {
+        env->ReleaseStringUTFChars(kdm_path, kdmPath);
+    }
+    if (result != 0) {
+        return nullptr;
+    }
+
+    jlong values[] = {
+        stats.recoverUs, stats.openUs, stats.bindUs, stats.indexUs, stats.breakUs,
+        stats.seekUs, stats.bufferUs, stats.totalUs, stats.bufferedFrames, stats.frame
+    };
+    jsize count = sizeof(values) / sizeof(values[0]);
+    jlongArray array = env->NewLongArray(count);
+    env->SetLongArrayRegion(array, 0, count, values);
+    return array;
+}
+
+/**
+ * 设置帧索引目录，应在openMxf之前调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param dir 应用私有的持久目录
+ */
+JNIEXPORT void JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setIndexDirectory(JNIEnv* env, jobject thiz, jstring dir) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        LOGE("DMS player not initialized");
+        return;
+    }
+
+    const char* indexDir = env->GetStringUTFChars(dir, nullptr);
+    dms_player_set_index_dir(context, indexDir);
+    env->ReleaseStringUTFChars(dir, indexDir);
+}
+
+/**
+ * 设置输出画面尺寸，解码时按画面尺寸丢弃多余的小波分辨率层；附加Surface后由attachSurface的尺寸决定
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param width 画面宽度（像素），0表示按原图尺寸解码
+ * @param height 画面高度（像素）
+ */
+JNIEXPORT void JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setOutputSize(JNIEnv* env, jobject thiz, jint width, jint height) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        LOGE("DMS player not initialized");
+        return;
+    }
+    if (context->renderer != nullptr) {
+        LOGE("Output size is set by attachSurface while a surface is attached");
+        return;
+    }
+
+    dms_player_set_output_size(context, width, height);
+}
+
+/**
+ * 设置帧级并行解码的线程数，应在attachSurface之前调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param workers 解码线程数，0表示按CPU核数
+ * @return 设置成功返回JNI_TRUE，失败返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setDecodeWorkers(JNIEnv* env, jobject thiz, jint workers) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        LOGE("DMS player not initialized");
+        return JNI_FALSE;
+    }
+    if (context->renderer != nullptr) {
+        LOGE("Decode workers must be set before attaching a surface");
+        return JNI_FALSE;
+    }
+
+    return dms_player_set_decode_workers(context, workers) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 获取各解码线程的利用率，用于按芯片选择并行解码线程数
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 各线程解码占用的CPU时间占比（0~1），尚未开始并行解码返回nullptr
+ */
+JNIEXPORT jfloatArray JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_getDecodeUtilization(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        return nullptr;
+    }
+    // 渲染器存在时解码流水线由其生产线程独占，取渲染器保存的副本
+    DmsDecodePipelineStats stats;
+    int found = context->renderer != nullptr ? dms_renderer_get_decode_stats(context->renderer, &stats)
+                                             : dms_player_get_decode_stats(context, &stats);
+    if (found != 0) {
+        return nullptr;
+    }
+
+    jfloatArray result = env->NewFloatArray(stats.workers);
+    env->SetFloatArrayRegion(result, 0, stats.workers, stats.utilization);
+    return result;
+}
+
+/**
+ * 设置码流缓存：保留最近读取的码流，小范围后退与重放时不定位、不读存储。应在attachSurface之前调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param seconds 保留的秒数，0为不限
+ * @param megabytes 占用内存上限（MB），0为不限；两者均为0时停用
+ * @return 设置成功返回JNI_TRUE，失败返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setCodestreamCache(JNIEnv* env, jobject thiz, jfloat seconds, jint megabytes) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        LOGE("DMS player not initialized");
+        return JNI_FALSE;
+    }
+    if (context->renderer != nullptr) {
+        LOGE("Codestream cache must be set before attaching a surface");
+        return JNI_FALSE;
+    }
+
+    return dms_player_set_codestream_cache(context, seconds, (int64_t)megabytes * 1024 * 1024) == 0 ? JNI_TRUE
+                                                                                                     : JNI_FALSE;
+}
+
+/**
+ * 创建进度条缩略图图集：后台按帧索引每intervalFrames帧取一个样本，以最低分辨率层解码。
+ * 尚未被索引覆盖的样本待后台补全后生成。已有图集时先销毁，关闭MXF时随之销毁
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param intervalFrames 取样间隔（帧）
+ * @param width 缩略图宽度（像素）
+ * @param height 缩略图高度（像素）
+ * @return 成功返回JNI_TRUE，未打开MXF或未编译J2K解码返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_createThumbnails(JNIEnv* env, jobject thiz, jint intervalFrames, jint width,
+                                                     jint height) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || !context->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return JNI_FALSE;
+    }
+
+    dms_thumbnail_destroy(context->thumbnails);
+    struct DmsThumbnailConfig config = {intervalFrames, width, height, 0};
+    context->thumbnails = dms_thumbnail_create_j2k(context, &config);
+    return context->thumbnails != nullptr ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 取离frame最近的已生成缩略图，同时把frame作为后台取样的优先位置（悬停处最先生成）
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param frame 整部影片帧号
+ * @param argb 输出ARGB_8888像素，至少width x height个
+ * @return 缩略图对应的帧号，未创建图集、尚无已生成的缩略图或数组过小返回-1
+ */
+JNIEXPORT jlong JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_getThumbnail(JNIEnv* env, jobject thiz, jlong frame, jintArray argb) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    struct DmsThumbnailStats stats;
+    if (context == nullptr || argb == nullptr || dms_thumbnail_get_stats(context->thumbnails, &stats) != 0) {
+        return -1;
+    }
+    if (env->GetArrayLength(argb) < stats.width * stats.height) {
+        LOGE("Thumbnail buffer too small");
+        return -1;
+    }
+    jint* pixels = env->GetIntArrayElements(argb, nullptr);
+    int64_t sampleFrame = -1;
+    int result = dms_thumbnail_get(context->thumbnails, frame, reinterpret_cast<uint32_t*>(pixels), &sampleFrame);
+    env->ReleaseIntArrayElements(argb, pixels, result == 0 ? 0 : JNI_ABORT);
+    return result == 0 ? sampleFrame : -1;
+}
+
+/**
+ * 附加Surface，之后由原生渲染器解码并直接显示，Java层只控制播放、暂停与跳转
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param surface 显示用的Surface
+ * @param width 视图宽度（像素），用于选择解码分辨率层，帧按原宽高比缩放到该尺寸并加黑边
+ * @param height 视图高度（像素）
+ * @return 附加成功返回JNI_TRUE，失败返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_attachSurface(JNIEnv* env, jobject thiz, jobject surface, jint width,
+                                                  jint height) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || !context->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return JNI_FALSE;
+    }
+
+    ANativeWindow* window = ANativeWindow_fromSurface(env, surface);
+    if (window == nullptr) {
+        LOGE("Failed to get native window");
+        return JNI_FALSE;
+    }
+    DmsVideoSink* sink = dms_video_sink_create_window(window, DMS_COLOR_RGBA_8888);
+    ANativeWindow_release(window); // 输出端持有自己的引用
+    if (sink == nullptr) {
+        return JNI_FALSE;
+    }
+
+    dms_renderer_destroy(context->renderer);
+    context->renderer = nullptr;
+    dms_player_set_output_size(context, width, height);
+    // 原生缩放到视图尺寸并加黑边，窗口缓冲区与视图1:1，不再由SurfaceFlinger缩放
+    DmsRendererConfig config = {DMS_COLOR_SRGB, DMS_COLOR_RGBA_8888, true, 0, width, height, DMS_SCALE_BICUBIC,
+                                context->stereoMode};
+    context->renderer = dms_renderer_create(context, sink, &config);
+    if (context->renderer == nullptr) {
+        dms_video_sink_destroy(sink);
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+/**
+ * 分离Surface并停止原生渲染，之后可恢复getNextFrame取帧
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ */
+JNIEXPORT void JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_detachSurface(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context != nullptr && context->renderer != nullptr) {
+        dms_renderer_destroy(context->renderer);
+        context->renderer = nullptr;
+    }
+}
+
+/**
+ * 原生渲染开始/继续播放
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 成功返回JNI_TRUE，未附加Surface返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_play(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || context->renderer == nullptr) {
+        LOGE("No surface attached");
+        return JNI_FALSE;
+    }
+    return dms_renderer_play(context->renderer) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 原生渲染暂停，保留当前画面
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 成功返回JNI_TRUE，未附加Surface返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_pause(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || context->renderer == nullptr) {
+        LOGE("No surface attached");
+        return JNI_FALSE;
+    }
+    return dms_renderer_pause(context->renderer) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 开关自适应解码质量：赶不上显示时刻时自动丢弃质量层或分辨率层，余量恢复后回到全质量
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param enabled 是否自适应
+ * @return 设置成功返回JNI_TRUE，失败返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setAdaptiveQuality(JNIEnv* env, jobject thiz, jboolean enabled) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        LOGE("DMS player not initialized");
+        return JNI_FALSE;
+    }
+    // 渲染器存在期间播放器由其生产线程独占
+    int result = context->renderer != nullptr
+                     ? dms_renderer_set_adaptive_quality(context->renderer, enabled == JNI_TRUE)
+                     : dms_player_set_adaptive_quality(context, enabled == JNI_TRUE);
+    return result == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 设置立体（3D）素材的输出方式，可在attachSurface之前或播放中调用；2D素材忽略
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param mode 0只显示左眼，1左右并排（附加Surface时为半宽），2帧序列单闪（24fps时48Hz），3帧序列双闪（96Hz）
+ * @return 设置成功返回JNI_TRUE，失败返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setStereoMode(JNIEnv* env, jobject thiz, jint mode) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr) {
+        LOGE("DMS player not initialized");
+        return JNI_FALSE;
+    }
+    // 渲染器存在期间播放器由其生产线程独占
+    int result = context->renderer != nullptr ? dms_renderer_set_stereo_mode(context->renderer, mode)
+                                              : dms_player_set_stereo_mode(context, mode);
+    return result == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 当前DCP是否为立体（3D）素材，打开MXF时识别
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 是立体素材返回JNI_TRUE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_isStereo(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    return dms_player_is_stereo(context) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 设置屏幕刷新率，原生渲染按影片帧率规划显示节奏（如24fps@60Hz为2:3）
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param refreshHz 屏幕刷新率（Display.getRefreshRate），0为关闭
+ * @return 设置成功返回JNI_TRUE，未附加Surface或无法规划返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setDisplayRefreshRate(JNIEnv* env, jobject thiz, jfloat refreshHz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || context->renderer == nullptr) {
+        LOGE("No surface attached");
+        return JNI_FALSE;
+    }
+    return dms_renderer_set_display_refresh(context->renderer, refreshHz) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 设置3D LUT：由.cube文件载入，输入为P3-D65（伽马2.6），输出为sRGB显示码值
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param cube_path .cube文件路径，null为取消LUT
+ * @return 设置成功返回JNI_TRUE，未附加Surface或文件无法载入返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setColorLut(JNIEnv* env, jobject thiz, jstring cube_path) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || context->renderer == nullptr) {
+        LOGE("No surface attached");
+        return JNI_FALSE;
+    }
+    DmsColorLut* lut = nullptr;
+    if (cube_path != nullptr) {
+        const char* cubePath = env->GetStringUTFChars(cube_path, nullptr);
+        lut = dms_color_lut_load(cubePath, DMS_COLOR_P3_D65);
+        env->ReleaseStringUTFChars(cube_path, cubePath);
+        if (lut == nullptr) {
+            return JNI_FALSE;
+        }
+    }
+    return dms_renderer_set_color_lut(context->renderer, lut) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 开关内置的色域压缩：P3母版在Rec.709（sRGB）屏幕上平滑压缩到色域内，而不是逐分量截断
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param enabled 是否开启，关闭时同时取消setColorLut设置的LUT
+ * @return 设置成功返回JNI_TRUE，未附加Surface返回JNI_FALSE
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_setGamutMapping(JNIEnv* env, jobject thiz, jboolean enabled) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || context->renderer == nullptr) {
+        LOGE("No surface attached");
+        return JNI_FALSE;
+    }
+    DmsColorLut* lut = enabled == JNI_TRUE ? dms_color_lut_create_gamut_map(33, DMS_COLOR_SRGB) : nullptr;
+    return dms_renderer_set_color_lut(context->renderer, lut) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * 屏幕刷新回调，由Choreographer.FrameCallback的doFrame调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param frameTimeNanos 刷新时间戳（System.nanoTime时间基准）
+ */
+JNIEXPORT void JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_onVsync(JNIEnv* env, jobject thiz, jlong frameTimeNanos) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context != nullptr && context->renderer != nullptr) {
+        dms_renderer_on_vsync(context->renderer, frameTimeNanos / 1000);
+    }
+}
+
+/**
+ * 内存警告：缩小原生渲染器的解码帧缓存，由Application/Activity的onTrimMemory调用
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @param level ComponentCallbacks2的内存等级
+ */
+JNIEXPORT void JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_trimMemory(JNIEnv* env, jobject thiz, jint level) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context != nullptr && context->renderer != nullptr) {
+        dms_renderer_trim_memory(context->renderer, level);
+    }
+}
+
+/**
+ * 获取原生渲染统计信息
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 依次为显示帧数、丢弃帧数、失败帧数、起播耗时、跳转耗时、端到端耗时、显示延后、
+ *         转换耗时、提交耗时（以上耗时均为微秒）、CPU负载（千分比）、当前位置（微秒）、
+ *         是否已播完（0/1）、解码质量档位、降质解码帧数、解码帧缓存的查询次数、命中次数、
+ *         淘汰帧数与占用字节数，码流缓存的取帧次数、占用字节数与免定位跳转次数，以及重复显示
+ *         次数、媒体时钟重同步次数、显示抖动与最大延后（微秒），刷新节奏的滑移次数、重新锁定
+ *         次数与漏掉的刷新次数，缩放帧数与未缩放（只加黑边）帧数，以及立体帧数、缺右眼帧数与
+ *         帧序列提交的其余眼图像数；未附加Surface返回nullptr
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_getRenderStats(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    DmsRendererStats stats;
+    if (context == nullptr || context->renderer == nullptr ||
+        dms_renderer_get_stats(context->renderer, &stats) != 0) {
+        return nullptr;
+    }
+
+    jlong values[33] = {
+        stats.presented,
+        stats.dropped,
+        stats.failures,
+        stats.startLatencyUs,
+        stats.seekLatencyUs,
+        (jlong)stats.latencyUs,
+        (jlong)stats.lateUs,
+        (jlong)stats.convertCostUs,
+        (jlong)stats.presentCostUs,
+        (jlong)(stats.cpuLoad * 1000.0f),
+        stats.positionUs,
+        stats.ended ? 1 : 0,
+        stats.qualityLevel,
+        stats.degradedFrames,
+        stats.cacheLookups,
+        stats.cacheHits,
+        stats.cacheEvictions,
+        stats.cacheBytes,
+        stats.codestreamHits,
+        stats.codestreamBytes,
+        stats.codestreamSeeks,
+        stats.repeated,
+        stats.resyncs,
+        (jlong)stats.jitterUs,
+        stats.maxLateUs,
+        stats.cadenceSlips,
+        stats.cadenceRelocks,
+        stats.missedVsyncs,
+        stats.scaledFrames,
+        stats.unscaledFrames,
+        stats.stereoFrames,
+        stats.missingEyeFrames,
+        stats.eyeFields,
+    };
+    jlongArray result = env->NewLongArray(33);
+    env->SetLongArrayRegion(result, 0, 33, values);
+    return result;
+}
+
+/**
+ * 获取码流参数
+ * @param env JNI环境指针
+ * @param thiz Java对象引用
+ * @return 码流参数对象，无法解析（未打开MXF、码流加密未绑定KDM或不是J2K）时返回nullptr
+ */
+JNIEXPORT jobject JNICALL
+Java_com_djs_djsdmsplayer_DmsPlayer_getStreamInfo(JNIEnv* env, jobject thiz) {
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+    if (context == nullptr || !context->isInitialized) {
+        LOGE("DMS player not initialized");
+        return nullptr;
+    }
+    // 渲染器线程独占读取位置，此时只返回取帧时已解析的参数
+    if (context->renderer != nullptr && !context->streamInfoValid) {
+        return nullptr;
+    }
+    DmsJ2kStreamInfo info;
+    if (dms_player_probe_stream(context, &info) != 0) {
+        return nullptr;
+    }
+
+    jobject streamInfo = env->NewObject(gStreamInfoClass,
+                                        env->GetMethodID(gStreamInfoClass, "<init>", "()V"));
+    env->SetIntField(streamInfo, gStreamInfo_width, (jint)info.width);
+    env->SetIntField(streamInfo, gStreamInfo_height, (jint)info.height);
+    env->SetIntField(streamInfo, gStreamInfo_components, info.components);
+    env->SetIntField(streamInfo, gStreamInfo_bitDepth, info.precision[0]);
+    env->SetBooleanField(streamInfo, gStreamInfo_isSigned, info.isSigned[0] ? JNI_TRUE : JNI_FALSE);
+    env->SetIntField(streamInfo, gStreamInfo_tileWidth, (jint)info.tileWidth);
+    env->SetIntField(streamInfo, gStreamInfo_tileHeight, (jint)info.tileHeight);
+    env->SetIntField(streamInfo, gStreamInfo_tilesX, (jint)info.tilesX);
+    env->SetIntField(streamInfo, gStreamInfo_tilesY, (jint)info.tilesY);
+    env->SetIntField(streamInfo, gStreamInfo_decompositionLevels, info.levels);
+    env->SetIntField(streamInfo, gStreamInfo_qualityLayers, info.layers);
+    env->SetIntField(streamInfo, gStreamInfo_progression, info.progression);
+    env->SetBooleanField(streamInfo, gStreamInfo_reversible, info.reversible ? JNI_TRUE : JNI_FALSE);
+    env->SetIntField(streamInfo, gStreamInfo_rsiz, info.rsiz);
+    env->SetIntField(streamInfo, gStreamInfo_dciViolations, (jint)dms_j2k_check_dci(&info));
+    env->SetLongField(streamInfo, gStreamInfo_headerChanges, context->headerChanges);
+
+    jstring profile = env->NewStringUTF(dms_j2k_profile_name(info.rsiz));
+    env->SetObjectField(streamInfo, gStreamInfo_profile, profile);
+    env->DeleteLocalRef(profile);
+
+    return streamInfo;
 }
 
 /**
@@ -402,7 +1299,14 @@ Java_com_djs_djsdmsplayer_DmsPlayer_seekTo(JNIEnv* env, jobject thiz, jlong posi
  */
 JNIEXPORT jlong JNICALL
 Java_com_djs_djsdmsplayer_DmsPlayer_getDuration(JNIEnv* env, jobject thiz) {
-// 返回持续时间（微秒）- 示例为2分钟
+    jclass clazz = env->GetObjectClass(thiz);
+    jfieldID fieldId = env->GetFieldID(clazz, "nativePtr", "J");
+    DmsContext* context = reinterpret_cast<DmsContext*>(env->GetLongField(thiz, fieldId));
+
+// 整部影片（全部分本）的时长，时间轴尚未建立时返回示例值2分钟
+    if (context != nullptr && context->duration > 0) {
+        return context->duration * 1000L;
+    }
     return 120 * 1000000L;
 }
 
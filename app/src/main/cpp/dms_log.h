@@ -0,0 +1,31 @@
+#ifndef DMS_LOG_H
+#define DMS_LOG_H
+
+// 日志输出适配：Android平台直接使用logcat；
+// 其他平台（主机上编译的基准测试、命令行工具）输出到stderr，接口保持与logcat一致
+#ifdef __ANDROID__
+#include <android/log.h>
+#else
+#include <stdarg.h>
+#include <stdio.h>
+
+enum {
+    ANDROID_LOG_DEBUG = 3,
+    ANDROID_LOG_INFO  = 4,
+    ANDROID_LOG_WARN  = 5,
+    ANDROID_LOG_ERROR = 6,
+};
+
+static inline int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+    static const char kLevel[] = "??VDIWEF";
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "%c/%s: ", kLevel[(prio >= 0 && prio < 8) ? prio : 0], tag);
+    int n = vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    return n;
+}
+#endif
+
+#endif // DMS_LOG_H
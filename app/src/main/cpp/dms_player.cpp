@@ -1,13 +1,114 @@
 #include "dms_player.h"
+#include "dms_index_builder.h"
+#include "dms_reverse_play.h"
+#include "dms_step_window.h"
+#include "dms_readahead.h"
+#include "dms_decode_pipeline.h"
+#include "dms_renderer.h"
+#include "dms_thumbnail.h"
+#include "dms_frame_index.h"
+#include "dms_codestream_ring.h"
+#include "dms_stereo.h"
+#include "dms_log.h"
 #include "libdms.h"
 #include <stdlib.h>
 #include <string.h>
-#include <android/log.h>
+#include <time.h>
+#include <math.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #define LOG_TAG "DmsPlayer"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
+// libdms 为进程级全局状态（同一时刻只有一个DCP和一个读取位置），所有读取与定位都需串行
+static std::mutex gDmsLibMutex;
+// 最近输出的帧号由取帧线程写入、JNI线程读取；不用gDmsLibMutex，避免取帧等待后台线程的libdms读取
+static std::mutex gEmittedMutex;
+
+static const int64_t kMaxSkipFrames = 96;    // 定位目标未覆盖时，从最近覆盖帧向后顺读的最大帧数
+static const int64_t kReverseMemoryBudget = 96LL * 1024 * 1024; // 倒放缓冲内存预算
+static const int kStepWindowFrames = 16;     // 逐帧步进保留的邻近帧数
+static const int64_t kResumeBufferTimeoutUs = 5000000; // 断点续播等待缓冲的最长时间
+static const int kReelTransitionFrames = 48; // 多分本影片至少预读的帧数，覆盖切换分本的耗时
+static const int32_t kStereoPairFrames = 512; // 配对表暂存的右眼单元上限，覆盖预读缓冲与并行解码中的帧
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief 当前分本内帧号换算为整部影片中的帧号
+ * @param ctx DMS播放器上下文指针
+ * @param frame 分本内帧号
+ * @return 全局帧号，frame未知(小于0)时返回-1
+ */
+static int64_t to_global(const struct DmsContext* ctx, int64_t frame) {
+    return frame >= 0 ? frame + dms_reel_timeline_start(&ctx->timeline, ctx->reel) : -1;
+}
+
+/**
+ * @brief 由播放位置推算当前分本内的帧号
+ * @param ctx DMS播放器上下文指针
+ * @return 分本内帧号
+ */
+static int64_t position_frame(const struct DmsContext* ctx) {
+    int64_t frame = (int64_t)((double)ctx->currentPosition * ctx->frameRate / 1000.0)
+            - dms_reel_timeline_start(&ctx->timeline, ctx->reel);
+    return frame > 0 ? frame : 0;
+}
+
+/**
+ * @brief 播放位置移到当前分本内的指定帧
+ * @param ctx DMS播放器上下文指针
+ * @param frame 分本内帧号，未知时不更新
+ */
+static void set_position(struct DmsContext* ctx, int64_t frame) {
+    if (frame >= 0 && ctx->frameRate > 0) {
+        ctx->currentPosition = (int64_t)((double)to_global(ctx, frame) * 1000.0 / ctx->frameRate);
+    }
+}
+
+/**
+ * @brief 记录最近输出的帧号，供其他线程（JNI）查询当前帧
+ * @param ctx DMS播放器上下文指针
+ * @param frame 整部影片中的帧号，未知为-1
+ */
+static void set_emitted_frame(struct DmsContext* ctx, int64_t frame) {
+    std::lock_guard<std::mutex> lock(gEmittedMutex);
+    ctx->emittedFrame = frame;
+}
+
+/**
+ * @brief 媒体时钟当前的播放位置，限制在[0, 总时长]内
+ * @param ctx DMS播放器上下文指针
+ * @return 播放位置（毫秒）
+ */
+static int64_t clock_position(const struct DmsContext* ctx) {
+    int64_t position = dms_media_clock_get(&ctx->clock, now_us()) / 1000;
+    if (ctx->duration > 0 && position > ctx->duration) {
+        position = ctx->duration;
+    }
+    return position > 0 ? position : 0;
+}
+
+/**
+ * @brief 码流缓存的帧数上限：保留秒数按当前帧率换算
+ * @param ctx DMS播放器上下文指针
+ * @return 帧数，0为不限
+ */
+static int32_t ring_limit_frames(const struct DmsContext* ctx) {
+    if (ctx->codestreamSeconds <= 0 || ctx->frameRate <= 0) {
+        return 0;
+    }
+    return (int32_t)ceil(ctx->codestreamSeconds * ctx->frameRate);
+}
+
 // Implementation of DMS player functions
 
 /**
@@ -30,6 +131,49 @@ int dms_player_init(struct DmsContext* ctx) {
     ctx->mxfPath = nullptr;
     ctx->kdmPath = nullptr;
     ctx->playerHandle = nullptr;
+    ctx->frameRate = 24.0f;
+    dms_reel_timeline_reset(&ctx->timeline);
+    ctx->reel = 0;
+    ctx->readerReel = 0;
+    ctx->nextFrame = -1;
+    ctx->lastPos = -1;
+    ctx->reelFirstPos = -1;
+    ctx->emittedFrame = -1;
+    ctx->indexDir = nullptr;
+    ctx->indexBuilder = nullptr;
+    ctx->reversePlay = nullptr;
+    ctx->stepFrame = -1;
+    ctx->stepWindow = nullptr;
+    ctx->journal = nullptr;
+    ctx->sessionId[0] = '\0';
+    ctx->readahead = nullptr;
+    ctx->nextReadahead = nullptr;
+    ctx->readaheadFrames = 0;
+    memset(&ctx->trick, 0, sizeof(ctx->trick));
+    dms_trick_play_reset(&ctx->trick, 1.0f);
+    ctx->outputTimeUs = 0;
+    ctx->lastFrameTimeUs = 0;
+    ctx->decoder = nullptr;
+    ctx->outputWidth = 0;
+    ctx->outputHeight = 0;
+    ctx->decodePipeline = nullptr;
+    ctx->decodeWorkers = 0;
+    ctx->decodeEndResult = DMS_RESULT_SUCCESS;
+    dms_decode_quality_reset(&ctx->quality, true);
+    ctx->renderer = nullptr;
+    ctx->thumbnails = nullptr;
+    memset(&ctx->streamInfo, 0, sizeof(ctx->streamInfo));
+    ctx->streamInfoValid = false;
+    ctx->headerChanges = 0;
+    ctx->codestreamRing = nullptr;
+    ctx->codestreamSeconds = DMS_CODESTREAM_RING_DEFAULT_SECONDS;
+    ctx->codestreamBytes = DMS_CODESTREAM_RING_DEFAULT_BYTES;
+    ctx->ringFrame = -1;
+    ctx->ringSeeks = 0;
+    dms_media_clock_init(&ctx->clock);
+    ctx->stereo = false;
+    ctx->stereoMode = DMS_STEREO_LEFT_ONLY;
+    ctx->stereoPairs = nullptr;
 
     // 初始化DMS库
     int result = _dms_library_initialize(DMS_MODE_PLAY, nullptr, true);
@@ -65,6 +209,28 @@ int dms_player_uninit(struct DmsContext* ctx) {
         ctx->kdmPath = nullptr;
     }
 
+    dms_renderer_destroy(ctx->renderer);
+    ctx->renderer = nullptr;
+    dms_thumbnail_destroy(ctx->thumbnails);
+    ctx->thumbnails = nullptr;
+    dms_player_close_index(ctx);
+    dms_step_window_destroy(ctx->stepWindow);
+    ctx->stepWindow = nullptr;
+    dms_player_close_journal(ctx);
+    dms_player_stop_decode(ctx);
+    dms_j2k_decoder_destroy(ctx->decoder);
+    ctx->decoder = nullptr;
+    dms_codestream_ring_destroy(ctx->codestreamRing);
+    ctx->codestreamRing = nullptr;
+    ctx->ringFrame = -1;
+    dms_stereo_pairs_destroy(ctx->stereoPairs);
+    ctx->stereoPairs = nullptr;
+    ctx->stereo = false;
+    if (ctx->indexDir) {
+        free(ctx->indexDir);
+        ctx->indexDir = nullptr;
+    }
+
     // 反初始化DMS库
     if (ctx->isInitialized) {
         _dms_library_uninitialize();
@@ -122,6 +288,7 @@ int dms_player_load_mxf(struct DmsContext* ctx, const char* mxfPath) {
     }
 
     ctx->hasActiveMxf = true;
+    dms_player_open_timeline(ctx);
     LOGI("MXF file loaded successfully: %s", mxfPath);
     return 0;
 }
@@ -189,9 +356,12 @@ int dms_player_play(struct DmsContext* ctx) {
         return -3;
     }
 
-    // 在实际实现中，这里应该启动播放线程或调用播放函数
+    // 媒体时钟从当前播放位置开始走时（打开后为0，断点续播或跳转后为该位置），
+    // 与 dms_player_resume 一致；取帧与显示节奏由调用者（或渲染器）按时钟进行
+    int64_t nowUs = now_us();
     ctx->isPlaying = true;
-    ctx->currentPosition = 0;
+    dms_media_clock_reset(&ctx->clock, ctx->currentPosition * 1000, nowUs);
+    dms_media_clock_set_running(&ctx->clock, true, nowUs);
 
     LOGI("Playback started");
     return 0;
@@ -213,9 +383,11 @@ int dms_player_stop(struct DmsContext* ctx) {
         return -2;
     }
 
-    // 在实际实现中，这里应该停止播放线程并重置播放状态
+    int64_t nowUs = now_us();
     ctx->isPlaying = false;
     ctx->currentPosition = 0;
+    dms_media_clock_set_running(&ctx->clock, false, nowUs);
+    dms_media_clock_reset(&ctx->clock, 0, nowUs);
 
     LOGI("Playback stopped");
     return 0;
@@ -242,7 +414,9 @@ int dms_player_pause(struct DmsContext* ctx) {
         return 0;
     }
 
-    // 在实际实现中，这里应该暂停播放线程
+    // 时钟停在暂停时刻，播放位置取时钟的读数
+    ctx->currentPosition = clock_position(ctx);
+    dms_media_clock_set_running(&ctx->clock, false, now_us());
     ctx->isPlaying = false;
 
     LOGI("Playback paused");
@@ -270,7 +444,10 @@ int dms_player_resume(struct DmsContext* ctx) {
         return 0;
     }
 
-    // 在实际实现中，这里应该恢复播放线程
+    // 从暂停位置（期间可能跳转过）继续走时
+    int64_t nowUs = now_us();
+    dms_media_clock_reset(&ctx->clock, ctx->currentPosition * 1000, nowUs);
+    dms_media_clock_set_running(&ctx->clock, true, nowUs);
     ctx->isPlaying = true;
 
     LOGI("Playback resumed");
@@ -299,15 +476,21 @@ int dms_player_seek(struct DmsContext* ctx, int64_t position) {
         return -3;
     }
 
-    // 在实际实现中，这里应该跳转到指定位置
+    if (ctx->hasActiveMxf) {
+        int result = dms_player_seek_frame(ctx, (int64_t)((double)position * ctx->frameRate / 1000.0));
+        if (result != 0) {
+            return result;
+        }
+    }
     ctx->currentPosition = position;
+    dms_media_clock_reset(&ctx->clock, position * 1000, now_us());
 
     LOGI("Seek to position: %lld ms", (long long)position);
     return 0;
 }
 
 /**
- * @brief 获取当前播放位置
+ * @brief 获取当前播放位置：播放中为媒体时钟的读数，否则为暂停、跳转或最近取帧的位置
  * @param ctx DMS播放器上下文指针
  * @return 当前播放位置（毫秒）
  */
@@ -317,6 +500,9 @@ int64_t dms_player_get_position(struct DmsContext* ctx) {
         return -1;
     }
 
+    if (ctx->isPlaying && ctx->clock.running) {
+        return clock_position(ctx);
+    }
     return ctx->currentPosition;
 }
 
@@ -347,3 +533,2193 @@ bool dms_player_is_playing(struct DmsContext* ctx) {
 
     return ctx->isPlaying;
 }
+
+/**
+ * @brief 设置帧索引文件目录（应为应用私有的持久目录）
+ * @param ctx DMS播放器上下文指针
+ * @param indexDir 目录路径
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_player_set_index_dir(struct DmsContext* ctx, const char* indexDir) {
+    if (!ctx || !indexDir) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+
+    if (ctx->indexDir) {
+        free(ctx->indexDir);
+    }
+    ctx->indexDir = strdup(indexDir);
+    if (!ctx->indexDir) {
+        LOGE("Failed to allocate memory for index directory");
+        return -3;
+    }
+    return 0;
+}
+
+/**
+ * @brief 正常速度连续播放且输出方式需要右眼时，读取左眼的同时保留右眼
+ * @param ctx DMS播放器上下文指针
+ * @return 需要保留右眼返回true
+ */
+static bool keep_right(const struct DmsContext* ctx) {
+    return ctx->stereo && ctx->stereoPairs && dms_stereo_mode_both_eyes(ctx->stereoMode) && ctx->trick.speed == 1.0f;
+}
+
+/**
+ * @brief 立体素材读出左眼后读取紧随其后的右眼，调用者需持有gDmsLibMutex。
+ *        下一单元与左眼PTS不同时说明左眼实为定位落点处的右眼：丢弃它，以下一单元为左眼重新配对
+ * @param ctx DMS播放器上下文指针
+ * @param unit 输入输出左眼单元
+ * @param keepRight 右眼放入配对表，否则释放
+ */
+static void read_right_locked(struct DmsContext* ctx, DmsDataUnitPtr* unit, bool keepRight) {
+    DmsDataUnitPtr right = nullptr;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (_dms_get_next_picture_unit(&right) != DMS_RESULT_SUCCESS || !right) {
+            // 码流结尾：最后一帧缺右眼，只保留左眼
+            if (right) {
+                _dms_free_data_unit(&right);
+            }
+            return;
+        }
+        if (dms_stereo_is_pair(*unit, right)) {
+            break;
+        }
+        if (attempt > 0) {
+            LOGE("Stereo unit at pos %lld has no right eye", (long long)(*unit)->Pos);
+            _dms_free_data_unit(&right);
+            return;
+        }
+        _dms_free_data_unit(unit);
+        *unit = right;
+        right = nullptr;
+    }
+    if (keepRight) {
+        dms_stereo_pairs_put(ctx->stereoPairs, ctx->readerReel, (*unit)->Pos, right);
+    } else {
+        _dms_free_data_unit(&right);
+    }
+}
+
+/**
+ * @brief 读取一个数据单元并计入索引，调用者需持有gDmsLibMutex。
+ *        立体素材按帧读取左右眼两个单元，只有左眼计入索引
+ * @param ctx DMS播放器上下文指针
+ * @param frameHint 已知帧号，未知填-1
+ * @param outUnit 输出数据单元（立体素材为左眼）
+ * @param outFrame 输出帧号，无法确定时为-1
+ * @param keepRight 立体素材的右眼放入配对表，否则丢弃
+ * @return 正确返回DMS_RESULT_SUCCESS，否则返回libdms错误码
+ */
+static int read_unit_locked(struct DmsContext* ctx, int64_t frameHint, DmsDataUnitPtr* outUnit, int64_t* outFrame,
+                            bool keepRight) {
+    DmsDataUnitPtr unit = nullptr;
+    int result = _dms_get_next_picture_unit(&unit);
+    if (result != DMS_RESULT_SUCCESS || unit == nullptr) {
+        if (frameHint > 0 && (result == (int)DMS_RESULT_NO_PICTURE_ESSENCE_FOUND ||
+                              result == (int)DMS_RESULT_PLAY_FINISHED)) {
+            dms_index_builder_mark_end(ctx->indexBuilder, frameHint);
+        }
+        if (unit) {
+            _dms_free_data_unit(&unit);
+        }
+        *outUnit = nullptr;
+        *outFrame = -1;
+        return result != DMS_RESULT_SUCCESS ? result : (int)DMS_RESULT_NULL_POINTER_ERROR;
+    }
+    if (ctx->stereo) {
+        read_right_locked(ctx, &unit, keepRight);
+    }
+
+    int64_t frame = frameHint;
+    if (ctx->indexBuilder) {
+        frame = dms_index_builder_observe(ctx->indexBuilder, frameHint, unit);
+    }
+    if (frame == 0) {
+        ctx->reelFirstPos = unit->Pos;
+    }
+    *outUnit = unit;
+    *outFrame = frame;
+    return DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 将libdms读取位置移到读取所在分本的第一个数据单元，调用者需持有gDmsLibMutex。
+ *        第一个单元的Pos已知时直接定位，否则重新选择该分本（只有一个分本时不切换，见build_timeline）
+ * @param ctx DMS播放器上下文指针
+ * @return 正确返回DMS_RESULT_SUCCESS，否则返回libdms错误码
+ */
+static int rewind_reel_locked(struct DmsContext* ctx) {
+    if (ctx->reelFirstPos >= 0) {
+        return _dms_goto_pos(ctx->reelFirstPos, false);
+    }
+    if (ctx->timeline.reelCount > 1) {
+        return _dms_select_reel(dms_reel_timeline_number(&ctx->timeline, ctx->readerReel));
+    }
+    return (int)DMS_RESULT_UNKNOWN_ERROR;
+}
+
+/**
+ * @brief 播放读取位置能否在后台读取后恢复：已读取过数据单元、位于分本开头或下一帧已覆盖
+ * @param ctx DMS播放器上下文指针
+ * @return 能恢复返回true
+ */
+static bool cursor_restorable_locked(struct DmsContext* ctx) {
+    struct DmsFrameEntry resume;
+    return ctx->lastPos >= 0 || ctx->nextFrame == 0 ||
+           (ctx->nextFrame > 0 && dms_index_builder_lookup(ctx->indexBuilder, ctx->nextFrame, &resume) == 0);
+}
+
+/**
+ * @brief 后台读取后恢复播放读取位置（nextFrame/lastPos不变），调用者需持有gDmsLibMutex。
+ *        下一帧已覆盖时直接定位，否则定位到上一帧并丢弃该帧的单元；尚未读取时回到分本开头
+ * @param ctx DMS播放器上下文指针
+ */
+static void restore_cursor_locked(struct DmsContext* ctx) {
+    struct DmsFrameEntry resume;
+    if (ctx->nextFrame >= 0 && dms_index_builder_lookup(ctx->indexBuilder, ctx->nextFrame, &resume) == 0) {
+        _dms_goto_pos(resume.pos, false);
+    } else if (ctx->lastPos >= 0 && _dms_goto_pos(ctx->lastPos, false) == DMS_RESULT_SUCCESS) {
+        // 立体素材跳过上一帧的左右眼两个单元
+        for (int i = 0; i < (ctx->stereo ? 2 : 1); i++) {
+            DmsDataUnitPtr unit = nullptr;
+            if (_dms_get_next_picture_unit(&unit) == DMS_RESULT_SUCCESS && unit) {
+                _dms_free_data_unit(&unit);
+            }
+        }
+    } else if (ctx->nextFrame == 0) {
+        rewind_reel_locked(ctx);
+    }
+}
+
+/**
+ * @brief 后台补全索引回调：从anchor处（为NULL时从分本开头）顺读若干数据单元，结束后恢复播放读取位置
+ * @param user DMS播放器上下文指针
+ * @param anchor 已覆盖的起点帧，NULL表示第一帧尚未覆盖
+ * @param maxUnits 本次最多读取的数据单元数
+ * @return 新读取的数据单元数，码流结束返回0，失败返回负数错误码
+ */
+static int walk_index(void* user, const struct DmsFrameEntry* anchor, int maxUnits) {
+    struct DmsContext* ctx = (struct DmsContext*)user;
+    std::lock_guard<std::mutex> lock(gDmsLibMutex);
+    if (!ctx->hasActiveMxf || !ctx->indexBuilder || !cursor_restorable_locked(ctx)) {
+        return -1;
+    }
+
+    int result = anchor ? _dms_goto_pos(anchor->pos, false) : rewind_reel_locked(ctx);
+    if (result != DMS_RESULT_SUCCESS) {
+        restore_cursor_locked(ctx);
+        return -2;
+    }
+
+    // 有anchor时先重读anchor本身，核对落点
+    int64_t first = anchor ? anchor->frame : 0;
+    int units = anchor ? maxUnits + 1 : maxUnits;
+    int walked = 0;
+    for (int i = 0; i < units; i++) {
+        DmsDataUnitPtr unit = nullptr;
+        int64_t frame = -1;
+        if (read_unit_locked(ctx, first + i, &unit, &frame, false) != DMS_RESULT_SUCCESS) {
+            break;
+        }
+        bool aligned = !anchor || i > 0 || unit->Pos == anchor->pos;
+        _dms_free_data_unit(&unit);
+        if (!aligned) {
+            LOGE("Index walk landed off anchor, pos %lld", (long long)anchor->pos);
+            walked = -3;
+            break;
+        }
+        if (!anchor || i > 0) {
+            walked++;
+        }
+    }
+
+    restore_cursor_locked(ctx);
+    return walked;
+}
+
+/**
+ * @brief 当前DCP的帧索引文件路径：以图像MXF的UUID命名，同一影片在不同会话间复用
+ * @param ctx DMS播放器上下文指针
+ * @param outPath 输出路径
+ * @return 成功返回0，未设置索引目录返回1，失败返回错误码
+ */
+static int index_path(struct DmsContext* ctx, std::string* outPath) {
+    if (!ctx->indexDir) {
+        return 1;
+    }
+    const char* mxfId = _dms_get_picture_mxf_id();
+    if (!mxfId || !*mxfId) {
+        LOGE("Failed to get picture MXF id, frame index disabled");
+        return -4;
+    }
+    *outPath = std::string(ctx->indexDir) + "/";
+    for (const char* p = mxfId; *p; p++) {
+        *outPath += (*p == ':' || *p == '/') ? '_' : *p;
+    }
+    *outPath += ".dmsidx";
+    return 0;
+}
+
+/**
+ * @brief 载入/创建当前分本的帧索引，并启动后台补全；读取位置视为在分本开头
+ * @param ctx DMS播放器上下文指针
+ * @return 成功返回0，未设置索引目录时返回0且不建立索引，失败返回错误码
+ */
+int dms_player_open_index(struct DmsContext* ctx) {
+    if (!ctx) {
+        LOGE("Invalid context pointer");
+        return -1;
+    }
+
+    dms_player_close_index(ctx);
+    ctx->nextFrame = 0;
+    ctx->lastPos = -1;
+
+    std::string path;
+    int result = index_path(ctx, &path);
+    if (result != 0) {
+        return result > 0 ? 0 : result;
+    }
+
+    ctx->indexBuilder = dms_index_builder_create(path.c_str());
+    if (!ctx->indexBuilder) {
+        return -3;
+    }
+    dms_index_builder_start_walker(ctx->indexBuilder, walk_index, ctx);
+    LOGI("Frame index opened: %s", path.c_str());
+    return 0;
+}
+
+/**
+ * @brief 保存并关闭帧索引
+ * @param ctx DMS播放器上下文指针
+ */
+void dms_player_close_index(struct DmsContext* ctx) {
+    if (!ctx) {
+        return;
+    }
+    // 倒放预取依赖索引定位，随索引一同停止；预读缓冲与逐帧窗口中是当前影片的帧，一并释放
+    if (ctx->reversePlay) {
+        dms_reverse_play_destroy(ctx->reversePlay);
+        ctx->reversePlay = nullptr;
+    }
+    if (ctx->readahead) {
+        dms_readahead_destroy(ctx->readahead, nullptr);
+        ctx->readahead = nullptr;
+    }
+    if (ctx->nextReadahead) {
+        dms_readahead_destroy(ctx->nextReadahead, nullptr);
+        ctx->nextReadahead = nullptr;
+    }
+    dms_step_window_clear(ctx->stepWindow);
+    ctx->stepFrame = -1;
+    if (!ctx->indexBuilder) {
+        return;
+    }
+    // 先停止后台补全线程（不持有gDmsLibMutex，避免与补全回调互相等待）
+    dms_index_builder_destroy(ctx->indexBuilder);
+    ctx->indexBuilder = nullptr;
+}
+
+/**
+ * @brief 按时间轴更新媒体总时长
+ * @param ctx DMS播放器上下文指针
+ */
+static void update_duration(struct DmsContext* ctx) {
+    if (ctx->timeline.totalFrames > 0 && ctx->frameRate > 0) {
+        ctx->duration = (int64_t)((double)ctx->timeline.totalFrames * 1000.0 / ctx->frameRate);
+    }
+}
+
+/**
+ * @brief 把libdms当前分本帧索引中已知的帧数记入时间轴：读到过结尾时为实际帧数，否则为已覆盖帧数
+ * @param ctx DMS播放器上下文指针
+ */
+static void note_reel_frames(struct DmsContext* ctx) {
+    struct DmsIndexBuilderStats stats;
+    if (dms_index_builder_get_stats(ctx->indexBuilder, &stats) != 0) {
+        return;
+    }
+    if (stats.frameCount >= 0) {
+        dms_reel_timeline_set_known(&ctx->timeline, ctx->readerReel, stats.frameCount, true);
+    } else {
+        dms_reel_timeline_set_known(&ctx->timeline, ctx->readerReel, stats.coveredFrames, false);
+    }
+    update_duration(ctx);
+}
+
+/**
+ * @brief 切换到指定分本开头：停止当前分本的预取与索引补全，选择分本后载入其帧索引，
+ *        输出时间轴保持连续
+ * @param ctx DMS播放器上下文指针
+ * @param reel 分本序号
+ * @return 成功返回0，失败返回错误码
+ */
+static int select_reel(struct DmsContext* ctx, int reel) {
+    if (reel < 0 || reel >= ctx->timeline.reelCount) {
+        return -1;
+    }
+    note_reel_frames(ctx);
+    int64_t outputTimeUs = ctx->outputTimeUs;
+    dms_player_close_index(ctx);
+
+    int result;
+    {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        result = _dms_select_reel(dms_reel_timeline_number(&ctx->timeline, reel));
+    }
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Failed to select reel %d: 0x%08x", reel, result);
+        // libdms仍停留在原分本，恢复其索引
+        ctx->reel = ctx->readerReel;
+        dms_player_open_index(ctx);
+        ctx->outputTimeUs = outputTimeUs;
+        return result;
+    }
+    ctx->reel = reel;
+    ctx->readerReel = reel;
+    ctx->reelFirstPos = -1;
+    ctx->ringFrame = -1;
+    dms_player_open_index(ctx);
+    ctx->outputTimeUs = outputTimeUs;
+    note_reel_frames(ctx);
+    LOGI("Reel %d/%d selected, frames %lld-%lld%s", reel + 1, ctx->timeline.reelCount,
+         (long long)dms_reel_timeline_start(&ctx->timeline, reel),
+         (long long)(dms_reel_timeline_start(&ctx->timeline, reel) + dms_reel_timeline_count(&ctx->timeline, reel)),
+         ctx->timeline.reels[reel].exact ? "" : " (estimated)");
+    return 0;
+}
+
+/**
+ * @brief 读取当前分本开头的两个数据单元识别立体素材（PTS相同即同一帧的左右眼），
+ *        之后移回第一个单元，调用者需持有gDmsLibMutex
+ * @param ctx DMS播放器上下文指针
+ */
+static void detect_stereo_locked(struct DmsContext* ctx) {
+    dms_stereo_pairs_clear(ctx->stereoPairs);
+    DmsDataUnitPtr first = nullptr;
+    DmsDataUnitPtr second = nullptr;
+    ctx->reelFirstPos = -1;
+    if (_dms_get_next_picture_unit(&first) == DMS_RESULT_SUCCESS && first) {
+        ctx->stereo = _dms_get_next_picture_unit(&second) == DMS_RESULT_SUCCESS && dms_stereo_is_pair(first, second);
+        if (_dms_goto_pos(first->Pos, false) == DMS_RESULT_SUCCESS) {
+            ctx->reelFirstPos = first->Pos;
+        }
+    } else {
+        ctx->stereo = false;
+    }
+    if (first) {
+        _dms_free_data_unit(&first);
+    }
+    if (second) {
+        _dms_free_data_unit(&second);
+    }
+    if (ctx->stereo && !ctx->stereoPairs) {
+        ctx->stereoPairs = dms_stereo_pairs_create(kStereoPairFrames);
+    }
+    if (ctx->stereo) {
+        LOGI("Stereoscopic essence detected, output %s", dms_stereo_mode_name(ctx->stereoMode));
+    }
+}
+
+/**
+ * @brief 枚举分本建立时间轴：逐个选择分本，从其帧索引文件取帧数（不读取码流），
+ *        帧数未知的分本按片长估算；完成后选择指定分本。调用前需关闭帧索引
+ * @param ctx DMS播放器上下文指针
+ * @param reel 完成后选择的分本序号
+ * @return 成功返回0，失败返回错误码
+ */
+static int build_timeline(struct DmsContext* ctx, int reel) {
+    std::lock_guard<std::mutex> lock(gDmsLibMutex);
+    int count = _dms_get_reel_count();
+    if (count <= 0) {
+        LOGE("Failed to get reel count: 0x%08x", count);
+        count = 1;
+    } else if (count > DMS_REEL_MAX) {
+        LOGE("Too many reels: %d, only the first %d are played", count, DMS_REEL_MAX);
+        count = DMS_REEL_MAX;
+    }
+    // 分本编号的起点以能否选择0号分本判断；只有一个分本时不切换，保持libdms默认选择
+    int firstNumber = (count > 1 && _dms_select_reel(0) != DMS_RESULT_SUCCESS) ? 1 : 0;
+    // 新打开的DCP，码流参数在首次取帧或探测时重新解析
+    ctx->streamInfoValid = false;
+    ctx->headerChanges = 0;
+    // 码流缓存按分本内帧号保存，换片后全部作废
+    dms_codestream_ring_clear(ctx->codestreamRing);
+    if (ctx->codestreamRing) {
+        dms_codestream_ring_set_limits(ctx->codestreamRing, ctx->codestreamBytes, ring_limit_frames(ctx));
+    }
+    ctx->ringFrame = -1;
+    dms_reel_timeline_init(&ctx->timeline, count, firstNumber);
+
+    for (int i = 0; i < count; i++) {
+        if (count > 1 && _dms_select_reel(dms_reel_timeline_number(&ctx->timeline, i)) != DMS_RESULT_SUCCESS) {
+            LOGE("Failed to select reel %d while building timeline", i);
+            continue;
+        }
+        std::string path;
+        struct DmsFrameIndex* index = nullptr;
+        if (index_path(ctx, &path) != 0 || dms_frame_index_open(path.c_str(), &index) != 0) {
+            continue;
+        }
+        const struct DmsIndexHeader* header = dms_frame_index_get_header(index);
+        if (header->flags & DMS_INDEX_FLAG_COMPLETE) {
+            dms_reel_timeline_set_known(&ctx->timeline, i, header->frameCount, true);
+        } else {
+            dms_reel_timeline_set_known(&ctx->timeline, i, header->coveredFrames, false);
+        }
+        dms_frame_index_close(index);
+    }
+
+    int64_t durationFrames = 0;
+    DmsMovieExtensionPtr extension = _dms_get_movie_extension();
+    if (extension) {
+        durationFrames = (int64_t)((double)extension->Duration * ctx->frameRate);
+        _dms_free_movie_extension(&extension);
+    }
+    dms_reel_timeline_estimate(&ctx->timeline, durationFrames, ctx->frameRate);
+    update_duration(ctx);
+
+    reel = reel >= 0 && reel < count ? reel : 0;
+    int result = DMS_RESULT_SUCCESS;
+    if (count > 1) {
+        result = _dms_select_reel(dms_reel_timeline_number(&ctx->timeline, reel));
+    }
+    ctx->reel = reel;
+    ctx->readerReel = reel;
+    detect_stereo_locked(ctx);
+    for (int i = 0; i < count; i++) {
+        LOGI("Reel %d: frames %lld-%lld%s", i + 1, (long long)ctx->timeline.reels[i].startFrame,
+             (long long)(ctx->timeline.reels[i].startFrame + ctx->timeline.reels[i].frameCount),
+             ctx->timeline.reels[i].exact ? "" : " (estimated)");
+    }
+    return result;
+}
+
+/**
+ * @brief DCP打开后建立分本时间轴，选择第一个分本并载入其帧索引；
+ *        之后的取帧、定位均使用整部影片的帧号与时间，跨分本时自动切换
+ * @param ctx DMS播放器上下文指针
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_player_open_timeline(struct DmsContext* ctx) {
+    if (!ctx) {
+        LOGE("Invalid context pointer");
+        return -1;
+    }
+
+    dms_player_close_index(ctx);
+    int result = build_timeline(ctx, 0);
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Failed to select first reel: 0x%08x", result);
+        return result;
+    }
+    ctx->currentPosition = 0;
+    ctx->outputTimeUs = 0;
+    set_emitted_frame(ctx, -1);
+    return dms_player_open_index(ctx);
+}
+
+/**
+ * @brief 读取下一个图像数据单元，同时计入帧索引并更新播放位置
+ * @param ctx DMS播放器上下文指针
+ * @param outUnit 输出数据单元，使用后由调用者通过_dms_free_data_unit释放
+ * @return 正确返回DMS_RESULT_SUCCESS，否则返回错误码
+ */
+int dms_player_read_unit(struct DmsContext* ctx, DmsDataUnitPtr* outUnit) {
+    if (!ctx || !outUnit) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outUnit = nullptr;
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -3;
+    }
+
+    dms_index_builder_touch(ctx->indexBuilder);
+    std::lock_guard<std::mutex> lock(gDmsLibMutex);
+    int64_t frame = -1;
+    int result = read_unit_locked(ctx, ctx->nextFrame, outUnit, &frame, keep_right(ctx));
+    if (result != DMS_RESULT_SUCCESS) {
+        return result;
+    }
+
+    ctx->lastPos = (*outUnit)->Pos;
+    ctx->nextFrame = frame >= 0 ? frame + 1 : -1;
+    set_position(ctx, frame);
+    return DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 从读取位置所在的帧顺读到目标帧之前，途经的帧顺带计入索引，调用者需持有gDmsLibMutex
+ * @param ctx DMS播放器上下文指针
+ * @param from 读取位置所在的帧号
+ * @param frame 目标帧号
+ * @return 正确返回DMS_RESULT_SUCCESS，否则返回libdms错误码
+ */
+static int skip_to_frame_locked(struct DmsContext* ctx, int64_t from, int64_t frame) {
+    int result = DMS_RESULT_SUCCESS;
+    for (int64_t f = from; result == DMS_RESULT_SUCCESS && f < frame; f++) {
+        DmsDataUnitPtr unit = nullptr;
+        int64_t got = -1;
+        result = read_unit_locked(ctx, f, &unit, &got, false);
+        if (unit) {
+            _dms_free_data_unit(&unit);
+        }
+    }
+    ctx->nextFrame = frame;
+    return result;
+}
+
+/**
+ * @brief 将读取位置移动到指定帧，只更新nextFrame/lastPos，调用者需持有gDmsLibMutex。
+ *        已覆盖的帧精确定位；未覆盖时从最近覆盖帧顺读到目标（距离较近），
+ *        或按已覆盖部分的平均码流增量估算位置（距离较远）。目标之前没有覆盖时从当前读取位置
+ *        或分本开头顺读不超过kMaxSkipFrames帧，其他目标返回失败，待后台补全覆盖到目标后再定位
+ * @param ctx DMS播放器上下文指针
+ * @param frame 目标帧号
+ * @return 正确返回DMS_RESULT_SUCCESS，否则返回libdms错误码，目标尚不可定位返回-3
+ */
+static int seek_frame_locked(struct DmsContext* ctx, int64_t frame) {
+    int result;
+    struct DmsFrameEntry entry;
+
+    if (ctx->indexBuilder && dms_index_builder_lookup(ctx->indexBuilder, frame, &entry) == 0) {
+        result = _dms_goto_pos(entry.pos, false);
+        if (result == DMS_RESULT_SUCCESS) {
+            ctx->nextFrame = frame;
+            ctx->lastPos = -1;
+        }
+    } else {
+        int64_t floor = ctx->indexBuilder ? dms_index_builder_floor(ctx->indexBuilder, frame) : -1;
+        struct DmsFrameEntry first;
+        if (floor < 0 || dms_index_builder_lookup(ctx->indexBuilder, floor, &entry) != 0) {
+            // 目标之前没有覆盖（刚打开分本、断点续播到分本中部）：没有可用的Pos，从读取位置或分本开头顺读
+            if (ctx->nextFrame >= 0 && frame >= ctx->nextFrame && frame - ctx->nextFrame <= kMaxSkipFrames) {
+                result = skip_to_frame_locked(ctx, ctx->nextFrame, frame);
+            } else if (frame <= kMaxSkipFrames && rewind_reel_locked(ctx) == DMS_RESULT_SUCCESS) {
+                result = skip_to_frame_locked(ctx, 0, frame);
+            } else {
+                LOGE("Frame %lld not indexed yet, cannot seek", (long long)frame);
+                return -3;
+            }
+        } else if (frame - floor <= kMaxSkipFrames) {
+            // 距离较近：定位到最近覆盖帧后顺读，途经的帧顺带计入索引
+            result = _dms_goto_pos(entry.pos, false);
+            if (result == DMS_RESULT_SUCCESS) {
+                result = skip_to_frame_locked(ctx, floor, frame);
+            }
+        } else if (floor > 0 && dms_index_builder_lookup(ctx->indexBuilder, 0, &first) == 0 &&
+                   entry.pos > first.pos) {
+            // 距离较远：按已覆盖部分的平均码流增量外推，落点帧号由PTS确定
+            double perFrame = (double)(entry.pos - first.pos) / (double)floor;
+            int64_t estimate = entry.pos + (int64_t)(perFrame * (double)(frame - floor));
+            result = _dms_goto_pos(estimate, false);
+            if (result != DMS_RESULT_SUCCESS) {
+                result = _dms_goto_pos(entry.pos, false);
+                ctx->nextFrame = floor;
+            } else {
+                ctx->nextFrame = -1;
+            }
+        } else {
+            result = _dms_goto_pos(entry.pos, false);
+            ctx->nextFrame = floor;
+        }
+        ctx->lastPos = -1;
+    }
+    return result;
+}
+
+/**
+ * @brief 抽帧模式下将读取位置移到指定帧或其附近，只更新nextFrame/lastPos，调用者需持有gDmsLibMutex。
+ *        已覆盖的帧精确定位。未覆盖时不像seek_frame_locked那样顺读途经的帧（倍速扫过未播放的内容会
+ *        读取每个数据单元）：快进落在读取位置与目标之间最近的已覆盖帧，之间没有覆盖时从读取位置继续
+ *        读下一帧（同时补入索引）；快退落在目标之前最近的已覆盖帧
+ * @param ctx DMS播放器上下文指针
+ * @param frame 目标帧号
+ * @return 正确返回DMS_RESULT_SUCCESS，否则返回libdms错误码，目标尚不可定位返回-3
+ */
+static int seek_trick_locked(struct DmsContext* ctx, int64_t frame) {
+    struct DmsFrameEntry entry;
+    if (!ctx->indexBuilder || dms_index_builder_lookup(ctx->indexBuilder, frame, &entry) == 0) {
+        return seek_frame_locked(ctx, frame);
+    }
+    int64_t floor = dms_index_builder_floor(ctx->indexBuilder, frame);
+    bool forward = ctx->nextFrame >= 0 && frame >= ctx->nextFrame;
+    if (floor >= 0 && (!forward || floor >= ctx->nextFrame) &&
+        dms_index_builder_lookup(ctx->indexBuilder, floor, &entry) == 0) {
+        int result = _dms_goto_pos(entry.pos, false);
+        if (result == DMS_RESULT_SUCCESS) {
+            ctx->nextFrame = floor;
+            ctx->lastPos = -1;
+        }
+        return result;
+    }
+    if (forward) {
+        return DMS_RESULT_SUCCESS;
+    }
+    return seek_frame_locked(ctx, frame);
+}
+
+/**
+ * @brief 从码流缓存取ringFrame处的帧并前移ringFrame
+ * @param ctx DMS播放器上下文指针
+ * @param outUnit 输出数据单元（缓存的副本），使用后由dms_codestream_ring_release_unit释放
+ * @param outFrame 输出分本内帧号
+ * @return 命中返回true，缓存中没有该帧返回false
+ */
+static bool take_ring_unit(struct DmsContext* ctx, DmsDataUnitPtr* outUnit, int64_t* outFrame) {
+    if (ctx->ringFrame < 0 || dms_codestream_ring_take(ctx->codestreamRing, ctx->reel, ctx->ringFrame, outUnit) != 0) {
+        return false;
+    }
+    *outFrame = ctx->ringFrame++;
+    return true;
+}
+
+/**
+ * @brief 停止从码流缓存取帧：libdms读取位置不在ringFrame时定位过去，使后续读取从该帧继续。
+ *        读取位置恰好在缓存末尾之后（缓存内的跳转未移动它）时无需定位
+ * @param ctx DMS播放器上下文指针
+ */
+static void leave_ring(struct DmsContext* ctx) {
+    if (ctx->ringFrame < 0) {
+        return;
+    }
+    int64_t frame = ctx->ringFrame;
+    ctx->ringFrame = -1;
+    if (ctx->nextFrame != frame && ctx->hasActiveMxf) {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        int result = seek_frame_locked(ctx, frame);
+        if (result != DMS_RESULT_SUCCESS) {
+            LOGE("Failed to leave codestream cache at frame %lld: 0x%08x", (long long)frame, result);
+        }
+    }
+}
+
+/**
+ * @brief 停止倒放，必要时将读取位置移到最近倒放输出帧的下一帧，使正向播放从该处继续
+ * @param ctx DMS播放器上下文指针
+ * @param reposition 是否移动读取位置
+ */
+static void stop_reverse(struct DmsContext* ctx, bool reposition) {
+    if (!ctx->reversePlay) {
+        return;
+    }
+    // 先停止预取线程（不持有gDmsLibMutex，避免与其读取互相等待）
+    int64_t resume = dms_reverse_play_get_resume_frame(ctx->reversePlay);
+    dms_reverse_play_destroy(ctx->reversePlay);
+    ctx->reversePlay = nullptr;
+    if (reposition && resume >= 0 && ctx->hasActiveMxf) {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        seek_frame_locked(ctx, resume);
+    }
+}
+
+/**
+ * @brief 停止正向预读，必要时将读取位置移回第一个未取出的数据单元。
+ *        已预取下一分本时：当前分本已全部取出则直接进入下一分本，否则切回当前分本
+ * @param ctx DMS播放器上下文指针
+ * @param reposition 是否移动读取位置
+ */
+static void stop_readahead(struct DmsContext* ctx, bool reposition) {
+    if (!ctx->readahead && !ctx->nextReadahead) {
+        return;
+    }
+    struct DmsReadaheadCursor cursor;
+    dms_readahead_destroy(ctx->readahead, &cursor);
+    ctx->readahead = nullptr;
+    if (ctx->nextReadahead) {
+        struct DmsReadaheadCursor nextCursor;
+        dms_readahead_destroy(ctx->nextReadahead, &nextCursor);
+        ctx->nextReadahead = nullptr;
+        if (ctx->readerReel != ctx->reel && cursor.nextPos < 0) {
+            if (cursor.lastFrame >= 0) {
+                dms_reel_timeline_set_known(&ctx->timeline, ctx->reel, cursor.lastFrame + 1, true);
+            }
+            ctx->reel = ctx->readerReel;
+            update_duration(ctx);
+            cursor = nextCursor;
+        } else if (ctx->readerReel != ctx->reel) {
+            select_reel(ctx, ctx->reel);
+        }
+    }
+    // 缓冲中未取出的左眼已丢弃，暂存的右眼随之作废
+    dms_stereo_pairs_clear(ctx->stereoPairs);
+    if (reposition && cursor.nextPos >= 0 && ctx->hasActiveMxf) {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        if (_dms_goto_pos(cursor.nextPos, false) == DMS_RESULT_SUCCESS) {
+            ctx->nextFrame = cursor.nextFrame;
+            ctx->lastPos = cursor.lastPos;
+        }
+    }
+}
+
+/**
+ * @brief 丢弃并行解码中未输出的帧。取帧阶段领先于显示，需要时把读取位置与输出时间轴
+ *        移回被丢弃的第一帧，即下一应显示帧
+ * @param ctx DMS播放器上下文指针
+ * @param reposition 是否移动读取位置
+ */
+static void flush_decode(struct DmsContext* ctx, bool reposition) {
+    if (!ctx->decodePipeline) {
+        return;
+    }
+    int64_t timeUs = -1;
+    int64_t first = dms_decode_pipeline_flush(ctx->decodePipeline, &timeUs);
+    ctx->decodeEndResult = DMS_RESULT_SUCCESS;
+    if (reposition && first >= 0 && dms_player_seek_frame(ctx, first) == 0 && timeUs >= 0) {
+        // 保持输出时间戳连续（倍速播放时时间戳按墙钟改写，与帧号不对应）
+        ctx->outputTimeUs = timeUs;
+    }
+}
+
+/**
+ * @brief 退出逐帧模式：读取位置移到当前显示帧的下一帧，使连续播放从该处继续
+ * @param ctx DMS播放器上下文指针
+ */
+static void leave_step(struct DmsContext* ctx) {
+    int64_t resume = ctx->stepFrame + 1;
+    const DmsDataUnit* shown = dms_step_window_get(ctx->stepWindow, ctx->stepFrame);
+    int64_t shownPos = shown ? shown->Pos : -1;
+    ctx->stepFrame = -1;
+    dms_step_window_clear(ctx->stepWindow);
+    if (ctx->nextFrame != resume && ctx->hasActiveMxf) {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        if (seek_frame_locked(ctx, resume) == DMS_RESULT_SUCCESS && ctx->nextFrame == resume) {
+            // 当前显示帧即读取位置的上一帧
+            ctx->lastPos = shownPos;
+        }
+    }
+}
+
+/**
+ * @brief 跳转到指定帧，不丢弃并行解码中已提交的帧（见dms_player_seek_frame）。
+ *        抽帧模式每输出一帧定位一次，之前提交的帧仍按序解码输出
+ * @param ctx DMS播放器上下文指针
+ * @param frame 目标帧号（整部影片）
+ * @param exact 是否必须落在目标帧；否则按seek_trick_locked落在附近不需顺读的帧
+ * @return 成功返回0，失败返回错误码
+ */
+static int seek_global_frame(struct DmsContext* ctx, int64_t frame, bool exact) {
+    // 倒放与预读线程会移动读取位置，定位前先停止；之后取帧时从新位置重新开始
+    stop_reverse(ctx, false);
+    stop_readahead(ctx, false);
+    dms_stereo_pairs_clear(ctx->stereoPairs);
+    ctx->stepFrame = -1;
+    ctx->ringFrame = -1;
+    int result;
+    int reel = ctx->reel;
+    int64_t local = frame;
+    if (dms_reel_timeline_locate(&ctx->timeline, frame, &reel, &local) == 0 && reel != ctx->reel) {
+        result = select_reel(ctx, reel);
+        if (result != 0) {
+            return result;
+        }
+    }
+    dms_index_builder_touch(ctx->indexBuilder);
+    if (dms_codestream_ring_contains(ctx->codestreamRing, ctx->reel, local)) {
+        // 目标在码流缓存内：之后从缓存取帧，libdms读取位置不动，离开缓存时才定位
+        ctx->ringFrame = local;
+        ctx->ringSeeks++;
+        result = DMS_RESULT_SUCCESS;
+    } else {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        result = exact ? seek_frame_locked(ctx, local) : seek_trick_locked(ctx, local);
+    }
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Seek failed: 0x%08x", result);
+        return result;
+    }
+    if (ctx->frameRate > 0) {
+        ctx->currentPosition = (int64_t)((double)frame * 1000.0 / ctx->frameRate);
+        ctx->outputTimeUs = (int64_t)((double)frame * 1000000.0 / ctx->frameRate);
+    }
+    // 下一次输出目标帧，之前视为已输出其前一帧
+    set_emitted_frame(ctx, frame - 1);
+    return 0;
+}
+
+/**
+ * @brief 跳转到指定帧，并将播放位置与输出时间轴移到该帧；目标在其他分本时先切换分本
+ * @param ctx DMS播放器上下文指针
+ * @param frame 目标帧号（整部影片）
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_player_seek_frame(struct DmsContext* ctx, int64_t frame) {
+    if (!ctx) {
+        LOGE("Invalid context pointer");
+        return -1;
+    }
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -3;
+    }
+    if (frame < 0) {
+        LOGE("Invalid frame");
+        return -3;
+    }
+
+    flush_decode(ctx, false);
+    return seek_global_frame(ctx, frame, true);
+}
+
+/**
+ * @brief 当前帧号：逐帧模式下为当前显示帧，播放时为最近由dms_player_next_frame输出的帧。
+ *        预读、倒放与预取下一分本的线程会移动读取位置，读取位置不代表已输出的帧
+ * @param ctx DMS播放器上下文指针
+ * @return 整部影片中的帧号，未知返回-1
+ */
+int64_t dms_player_get_current_frame(struct DmsContext* ctx) {
+    if (!ctx) {
+        return -1;
+    }
+    if (ctx->stepFrame >= 0) {
+        return to_global(ctx, ctx->stepFrame);
+    }
+    std::lock_guard<std::mutex> lock(gEmittedMutex);
+    return ctx->emittedFrame;
+}
+
+/**
+ * @brief 从startFrame开始在当前分本内连续读取多个数据单元，定位与读取在一次持锁内完成。
+ *        只移动读取位置，不改变播放位置与输出时间轴，供倒放等后台取帧使用
+ * @param ctx DMS播放器上下文指针
+ * @param startFrame 分本内起始帧号，小于0时从当前读取位置继续
+ * @param count 读取帧数
+ * @param outUnits 输出数据单元数组（至少count个），使用后由调用者通过_dms_free_data_unit释放
+ * @param outFrames 输出帧号数组（至少count个），无法确定时为-1
+ * @param outCount 实际读取的帧数
+ * @param outSeekUs 输出定位耗时（微秒），读取位置已在startFrame而无需定位时为-1，可为空
+ * @return 至少读取到一帧返回DMS_RESULT_SUCCESS，否则返回错误码
+ */
+int dms_player_fetch_frames(struct DmsContext* ctx, int64_t startFrame, int count,
+                            DmsDataUnitPtr* outUnits, int64_t* outFrames, int* outCount,
+                            int64_t* outSeekUs) {
+    if (!ctx || !outUnits || !outFrames || !outCount || count <= 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outCount = 0;
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -3;
+    }
+
+    dms_index_builder_touch(ctx->indexBuilder);
+    std::lock_guard<std::mutex> lock(gDmsLibMutex);
+    int result = DMS_RESULT_SUCCESS;
+    int64_t seekUs = -1;
+    if (startFrame >= 0 && ctx->nextFrame != startFrame) {
+        int64_t start = now_us();
+        result = seek_frame_locked(ctx, startFrame);
+        seekUs = now_us() - start;
+    }
+    if (outSeekUs) {
+        *outSeekUs = seekUs;
+    }
+
+    int got = 0;
+    while (result == DMS_RESULT_SUCCESS && got < count) {
+        DmsDataUnitPtr unit = nullptr;
+        int64_t frame = -1;
+        result = read_unit_locked(ctx, ctx->nextFrame, &unit, &frame, keep_right(ctx));
+        if (result != DMS_RESULT_SUCCESS) {
+            break;
+        }
+        ctx->lastPos = unit->Pos;
+        ctx->nextFrame = frame >= 0 ? frame + 1 : -1;
+        outUnits[got] = unit;
+        outFrames[got] = frame;
+        got++;
+    }
+    *outCount = got;
+    return got > 0 ? (int)DMS_RESULT_SUCCESS : result;
+}
+
+/**
+ * @brief 读取指定帧的数据单元供缩略图等后台任务使用，定位、读取与恢复播放读取位置在一次持锁内完成。
+ *        只读取libdms当前选择的分本中已被帧索引覆盖的帧，不切换分本、不估算位置
+ * @param ctx DMS播放器上下文指针
+ * @param frame 整部影片帧号
+ * @param outUnit 输出数据单元，使用后由调用者通过_dms_free_data_unit释放
+ * @return 成功返回DMS_RESULT_SUCCESS；帧不在当前分本或尚未被索引覆盖返回1（可稍后重试）；
+ *         超出分本实际帧数返回DMS_RESULT_PLAY_FINISHED；失败返回错误码
+ */
+int dms_player_fetch_sample(struct DmsContext* ctx, int64_t frame, DmsDataUnitPtr* outUnit) {
+    if (!ctx || !outUnit || frame < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outUnit = nullptr;
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -3;
+    }
+
+    std::lock_guard<std::mutex> lock(gDmsLibMutex);
+    int reel = 0;
+    int64_t local = frame;
+    if (ctx->timeline.reelCount > 1 && dms_reel_timeline_locate(&ctx->timeline, frame, &reel, &local) != 0) {
+        return -1;
+    }
+    if (reel != ctx->readerReel || !ctx->indexBuilder) {
+        return 1;
+    }
+    int64_t count = dms_index_builder_get_frame_count(ctx->indexBuilder);
+    if (count >= 0 && local >= count) {
+        return DMS_RESULT_PLAY_FINISHED;
+    }
+    struct DmsFrameEntry entry;
+    if (dms_index_builder_lookup(ctx->indexBuilder, local, &entry) != 0) {
+        return 1;
+    }
+
+    int result = _dms_goto_pos(entry.pos, false);
+    DmsDataUnitPtr unit = nullptr;
+    if (result == DMS_RESULT_SUCCESS) {
+        result = _dms_get_next_picture_unit(&unit);
+    }
+    if (result == DMS_RESULT_SUCCESS && (!unit || unit->Pos != entry.pos)) {
+        LOGE("Sample fetch landed off frame %lld", (long long)frame);
+        result = DMS_RESULT_UNKNOWN_ERROR;
+    }
+    if (result != DMS_RESULT_SUCCESS && unit) {
+        _dms_free_data_unit(&unit);
+    }
+    restore_cursor_locked(ctx);
+    *outUnit = unit;
+    return result;
+}
+
+/**
+ * @brief 整部影片的实际总帧数：所有分本帧数均已确定时才有效
+ * @param ctx DMS播放器上下文指针
+ * @return 总帧数，未知返回-1
+ */
+static int64_t total_frames(struct DmsContext* ctx) {
+    if (ctx->timeline.reelCount <= 1) {
+        return dms_index_builder_get_frame_count(ctx->indexBuilder);
+    }
+    for (int i = 0; i < ctx->timeline.reelCount; i++) {
+        if (!ctx->timeline.reels[i].exact) {
+            return -1;
+        }
+    }
+    return ctx->timeline.totalFrames;
+}
+
+/**
+ * @brief 当前分本读到结尾时切换到下一分本开头，输出时间轴保持连续
+ * @param ctx DMS播放器上下文指针
+ * @return 已切换返回true，已是最后一个分本或切换失败返回false
+ */
+static bool advance_reel(struct DmsContext* ctx) {
+    // 读取失败不移动读取位置，此时nextFrame即分本的实际帧数
+    if (ctx->nextFrame > 0) {
+        dms_reel_timeline_set_known(&ctx->timeline, ctx->reel, ctx->nextFrame, true);
+        update_duration(ctx);
+    }
+    if (ctx->reel + 1 >= ctx->timeline.reelCount) {
+        return false;
+    }
+    return select_reel(ctx, ctx->reel + 1) == 0;
+}
+
+/**
+ * @brief 正常速度播放的预读深度：多分本影片始终至少预读kReelTransitionFrames帧，
+ *        首次播放分本帧数未知时也能在缓冲取完之前读到分本结尾，在后台切换下一分本
+ * @param ctx DMS播放器上下文指针
+ * @return 预读帧数，0表示不预读
+ */
+static int readahead_depth(const struct DmsContext* ctx) {
+    int depth = ctx->readaheadFrames;
+    if (depth < kReelTransitionFrames && ctx->timeline.reelCount > 1) {
+        depth = kReelTransitionFrames;
+    }
+    return depth;
+}
+
+/**
+ * @brief 预取下一分本的准备回调，在下一分本的预读线程中执行：保存当前分本的帧索引、
+ *        选择下一分本并载入其帧索引。libdms同一时刻只能读取一个分本，当前分本全部读入
+ *        缓冲时即是最早可切换的时机，切换耗时与缓冲中剩余帧的播放重叠
+ * @param user DMS播放器上下文指针
+ * @return 成功返回0，失败返回错误码
+ */
+static int prepare_next_reel(void* user) {
+    struct DmsContext* ctx = (struct DmsContext*)user;
+    struct DmsIndexBuilder* builder;
+    {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        builder = ctx->indexBuilder;
+        ctx->indexBuilder = nullptr;
+    }
+    // 不持有gDmsLibMutex停止当前分本的补全线程，其回调发现索引已摘下后直接返回
+    dms_index_builder_destroy(builder);
+
+    int reel = ctx->readerReel + 1;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        int result = _dms_select_reel(dms_reel_timeline_number(&ctx->timeline, reel));
+        if (result != DMS_RESULT_SUCCESS) {
+            LOGE("Failed to prefetch reel %d: 0x%08x", reel, result);
+            return result;
+        }
+        ctx->readerReel = reel;
+        ctx->nextFrame = 0;
+        ctx->lastPos = -1;
+        ctx->reelFirstPos = -1;
+        if (index_path(ctx, &path) != 0) {
+            path.clear();
+        }
+    }
+
+    builder = path.empty() ? nullptr : dms_index_builder_create(path.c_str());
+    if (builder) {
+        {
+            std::lock_guard<std::mutex> lock(gDmsLibMutex);
+            ctx->indexBuilder = builder;
+        }
+        dms_index_builder_start_walker(builder, walk_index, ctx);
+    }
+    return 0;
+}
+
+/**
+ * @brief 当前分本已全部读入预读缓冲时，在后台开始切换并预读下一分本
+ * @param ctx DMS播放器上下文指针
+ */
+static void prefetch_next_reel(struct DmsContext* ctx) {
+    if (ctx->nextReadahead || ctx->reel + 1 >= ctx->timeline.reelCount) {
+        return;
+    }
+    int end = dms_readahead_end_result(ctx->readahead);
+    if (end != (int)DMS_RESULT_PLAY_FINISHED && end != (int)DMS_RESULT_NO_PICTURE_ESSENCE_FOUND) {
+        return;
+    }
+    int depth = readahead_depth(ctx);
+    ctx->nextReadahead = dms_readahead_create(ctx, depth > 0 ? depth : kReelTransitionFrames,
+                                              prepare_next_reel, ctx);
+}
+
+/**
+ * @brief 当前分本的缓冲取完后进入已预取的下一分本，并取其第一帧
+ * @param ctx DMS播放器上下文指针
+ * @param outUnit 输出数据单元
+ * @param outFrame 输出分本内帧号
+ * @return 正确返回DMS_RESULT_SUCCESS；预取失败返回其错误码，由调用者同步切换
+ */
+static int enter_next_reel(struct DmsContext* ctx, DmsDataUnitPtr* outUnit, int64_t* outFrame) {
+    int64_t start = now_us();
+    int result = dms_readahead_next(ctx->nextReadahead, outUnit, outFrame);
+    int64_t waitUs = now_us() - start;
+
+    struct DmsReadaheadCursor cursor;
+    dms_readahead_destroy(ctx->readahead, &cursor);
+    ctx->readahead = nullptr;
+    if (cursor.lastFrame >= 0) {
+        dms_reel_timeline_set_known(&ctx->timeline, ctx->reel, cursor.lastFrame + 1, true);
+        update_duration(ctx);
+    }
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Reel prefetch failed: 0x%08x", result);
+        dms_readahead_destroy(ctx->nextReadahead, nullptr);
+        ctx->nextReadahead = nullptr;
+        return result;
+    }
+
+    ctx->readahead = ctx->nextReadahead;
+    ctx->nextReadahead = nullptr;
+    ctx->reel = ctx->readerReel;
+    LOGI("Reel %d/%d entered from prefetch, waited %lldus", ctx->reel + 1, ctx->timeline.reelCount,
+         (long long)waitUs);
+    return DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 设置播放速度
+ * @param ctx DMS播放器上下文指针
+ * @param speed 1为正常播放；-1为分块倒放；绝对值在[2, 32]时按帧索引抽帧快进（正）或快退（负）
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_player_set_speed(struct DmsContext* ctx, float speed) {
+    if (!ctx) {
+        LOGE("Invalid context pointer");
+        return -1;
+    }
+    if (speed != 1.0f && speed != -1.0f && (speed > -DMS_TRICK_MIN_SPEED && speed < DMS_TRICK_MIN_SPEED)) {
+        LOGE("Unsupported playback speed: %.2f", speed);
+        return -3;
+    }
+
+    flush_decode(ctx, true);
+    if (speed != -1.0f) {
+        stop_reverse(ctx, true);
+    }
+    if (speed != 1.0f) {
+        stop_readahead(ctx, true);
+    }
+    dms_trick_play_reset(&ctx->trick, speed);
+    dms_media_clock_set_rate(&ctx->clock, speed, now_us());
+    LOGI("Playback speed: %.2f", ctx->trick.speed);
+    return 0;
+}
+
+/**
+ * @brief 正常速度顺序读取的帧放入码流缓存，首次放入时按配置创建缓存
+ * @param ctx DMS播放器上下文指针
+ * @param unit 数据单元
+ * @param frame 分本内帧号，未知时不放入
+ */
+static void store_ring_unit(struct DmsContext* ctx, const DmsDataUnit* unit, int64_t frame) {
+    if (frame < 0 || (ctx->codestreamSeconds <= 0 && ctx->codestreamBytes <= 0)) {
+        return;
+    }
+    if (!ctx->codestreamRing) {
+        ctx->codestreamRing = dms_codestream_ring_create(ctx->codestreamBytes, ring_limit_frames(ctx));
+    }
+    if (ctx->codestreamRing) {
+        dms_codestream_ring_put(ctx->codestreamRing, ctx->reel, frame, unit);
+    }
+}
+
+/**
+ * @brief 比较数据单元主头参数段的指纹，与已解析的码流参数不同时重新解析（首帧、换分本或码流参数变化）。
+ *        指纹只遍历主头的标记段，每帧约百余字节，不影响取帧耗时
+ * @param ctx DMS播放器上下文指针
+ * @param unit 数据单元
+ * @param frame 分本内帧号
+ */
+static void check_stream_header(struct DmsContext* ctx, const DmsDataUnit* unit, int64_t frame) {
+    uint32_t fingerprint = dms_j2k_header_fingerprint(unit->Data, unit->Length);
+    if (fingerprint == 0 || (ctx->streamInfoValid && fingerprint == ctx->streamInfo.fingerprint)) {
+        return;
+    }
+    struct DmsJ2kStreamInfo info;
+    if (dms_j2k_parse_header(unit->Data, unit->Length, &info) != 0) {
+        return;
+    }
+    if (ctx->streamInfoValid) {
+        ctx->headerChanges++;
+        LOGI("Codestream parameters changed at reel %d frame %lld: %ux%u %d-bit, %d levels, %d layers, %s",
+             ctx->reel, (long long)frame, info.width, info.height, info.precision[0], info.levels, info.layers,
+             dms_j2k_profile_name(info.rsiz));
+    }
+    ctx->streamInfo = info;
+    ctx->streamInfoValid = true;
+}
+
+/**
+ * @brief 按当前播放速度取下一输出帧
+ *        正常速度时顺序读取；抽帧模式下按步长N跳帧定位后只读取一帧，
+ *        输出时间戳按N个源帧在倍速下占用的墙钟时长递增；
+ *        -1倍速时由倒放引擎分块预取并逆序输出，输出时间戳仍单调递增；
+ *        读到分本结尾（倒放时为开头）时切换到相邻分本继续；正向播放时在当前分本读完后
+ *        即于后台预取下一分本，缓冲取完时无缝衔接
+ * @param ctx DMS播放器上下文指针
+ * @param outFrame 输出帧，使用后由dms_player_release_frame释放
+ * @return 正确返回DMS_RESULT_SUCCESS，到达结尾或出错返回错误码
+ */
+int dms_player_next_frame(struct DmsContext* ctx, struct DmsFrame* outFrame) {
+    if (!ctx || !outFrame) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    memset(outFrame, 0, sizeof(*outFrame));
+    outFrame->frame = -1;
+    if (ctx->stepFrame >= 0) {
+        leave_step(ctx);
+    }
+
+    int result;
+    int64_t durationUs;
+    int64_t frame = -1;
+    DmsDataUnitPtr unit = nullptr;
+    bool cached = false;
+
+    if (dms_trick_play_active(&ctx->trick)) {
+        // 按整部影片的帧号跳帧，目标落在其他分本时由定位切换分本
+        int64_t current = dms_player_get_current_frame(ctx);
+        if (current < 0) {
+            current = to_global(ctx, position_frame(ctx));
+        }
+        int64_t target = current + dms_trick_play_update_step(&ctx->trick, ctx->frameRate);
+        int64_t frameCount = total_frames(ctx);
+
+        if (target < 0) {
+            if (current > 0) {
+                target = 0;
+            } else {
+                // 快退到片头后恢复正常播放
+                dms_trick_play_reset(&ctx->trick, 1.0f);
+                return dms_player_next_frame(ctx, outFrame);
+            }
+        }
+        if (frameCount > 0 && target >= frameCount) {
+            return DMS_RESULT_PLAY_FINISHED;
+        }
+
+        // 抽帧定位不改变输出时间轴，也不丢弃已提交并行解码的帧；未建立索引处落在附近可直接定位的帧
+        int64_t outputTimeUs = ctx->outputTimeUs;
+        int64_t start = now_us();
+        result = seek_global_frame(ctx, target, false);
+        if (result == 0) {
+            // 快退落在码流缓存内时不读存储
+            cached = take_ring_unit(ctx, &unit, &frame);
+            if (cached) {
+                set_position(ctx, frame);
+            } else {
+                leave_ring(ctx);
+                result = dms_player_read_unit(ctx, &unit);
+                frame = ctx->nextFrame > 0 ? ctx->nextFrame - 1 : -1;
+            }
+        }
+        ctx->outputTimeUs = outputTimeUs;
+        dms_trick_play_report_fetch(&ctx->trick, now_us() - start);
+        durationUs = dms_trick_play_frame_duration_us(&ctx->trick, ctx->frameRate);
+        ctx->trick.outputFrames++;
+    } else if (ctx->trick.speed < 0) {
+        if (!ctx->reversePlay) {
+            if (!ctx->hasActiveMxf) {
+                LOGE("No active MXF file");
+                return -3;
+            }
+            leave_ring(ctx);
+            // 刚定位过（尚未读取）时从目标帧开始倒放，否则从已输出帧的前一帧开始
+            int64_t next = ctx->nextFrame >= 0 ? ctx->nextFrame : position_frame(ctx) + 1;
+            int64_t first = ctx->lastPos >= 0 ? next - 2 : next;
+            if (first < 0) {
+                dms_trick_play_reset(&ctx->trick, 1.0f);
+                return dms_player_next_frame(ctx, outFrame);
+            }
+            ctx->reversePlay = dms_reverse_play_create(ctx, first, kReverseMemoryBudget);
+            if (!ctx->reversePlay) {
+                return -3;
+            }
+        }
+        result = dms_reverse_play_next(ctx->reversePlay, &unit, &frame);
+        if (result == (int)DMS_RESULT_PLAY_FINISHED) {
+            if (ctx->reel > 0 && ctx->timeline.reels[ctx->reel - 1].exact && select_reel(ctx, ctx->reel - 1) == 0) {
+                // 倒放越过分本开头：从上一分本的最后一帧继续倒放
+                int64_t last = dms_reel_timeline_count(&ctx->timeline, ctx->reel) - 1;
+                ctx->reversePlay = dms_reverse_play_create(ctx, last, kReverseMemoryBudget);
+                if (ctx->reversePlay) {
+                    return dms_player_next_frame(ctx, outFrame);
+                }
+            }
+            // 倒放到片头后恢复正常播放
+            stop_reverse(ctx, true);
+            dms_trick_play_reset(&ctx->trick, 1.0f);
+            return dms_player_next_frame(ctx, outFrame);
+        }
+        if (result == DMS_RESULT_SUCCESS) {
+            set_position(ctx, frame);
+        }
+        durationUs = ctx->frameRate > 0 ? (int64_t)(1000000.0 / ctx->frameRate) : 0;
+    } else if (take_ring_unit(ctx, &unit, &frame)) {
+        // 跳转落在码流缓存内：从缓存取帧，取完缓存中的帧后回到libdms继续读取
+        cached = true;
+        result = DMS_RESULT_SUCCESS;
+        set_position(ctx, frame);
+        durationUs = ctx->frameRate > 0 ? (int64_t)(1000000.0 / ctx->frameRate) : 0;
+    } else {
+        leave_ring(ctx);
+        int depth = readahead_depth(ctx);
+        if (!ctx->readahead && depth > 0 && ctx->hasActiveMxf) {
+            ctx->readahead = dms_readahead_create(ctx, depth, nullptr, nullptr);
+        }
+        if (ctx->readahead) {
+            prefetch_next_reel(ctx);
+            result = dms_readahead_next(ctx->readahead, &unit, &frame);
+            if ((result == (int)DMS_RESULT_PLAY_FINISHED || result == (int)DMS_RESULT_NO_PICTURE_ESSENCE_FOUND) &&
+                ctx->nextReadahead) {
+                result = enter_next_reel(ctx, &unit, &frame);
+            }
+            if (result == DMS_RESULT_SUCCESS) {
+                set_position(ctx, frame);
+            }
+        } else {
+            result = dms_player_read_unit(ctx, &unit);
+            frame = ctx->nextFrame > 0 ? ctx->nextFrame - 1 : -1;
+        }
+        if ((result == (int)DMS_RESULT_PLAY_FINISHED || result == (int)DMS_RESULT_NO_PICTURE_ESSENCE_FOUND) &&
+            advance_reel(ctx)) {
+            return dms_player_next_frame(ctx, outFrame);
+        }
+        durationUs = ctx->frameRate > 0 ? (int64_t)(1000000.0 / ctx->frameRate) : 0;
+        if (result == DMS_RESULT_SUCCESS) {
+            if (keep_right(ctx)) {
+                // 码流缓存只保存左眼，两眼输出时不放入，跳转落在缓存内时也不会缺右眼
+                outFrame->rightUnit = dms_stereo_pairs_take(ctx->stereoPairs, ctx->reel, unit->Pos);
+            } else {
+                store_ring_unit(ctx, unit, frame);
+            }
+        }
+    }
+
+    if (result != DMS_RESULT_SUCCESS) {
+        return result;
+    }
+
+    check_stream_header(ctx, unit, frame);
+
+    // 登记放映点：帧显示后由dms_player_frame_presented追加为记录
+    dms_breakpoint_journal_stage(ctx->journal, ctx->outputTimeUs, ctx->reel, unit->Pos, unit->PTS, frame);
+
+    outFrame->unit = unit;
+    outFrame->cached = cached;
+    outFrame->frame = to_global(ctx, frame);
+    set_emitted_frame(ctx, outFrame->frame);
+    outFrame->timeUs = ctx->outputTimeUs;
+    outFrame->durationUs = durationUs;
+    ctx->lastFrameTimeUs = ctx->outputTimeUs;
+    ctx->outputTimeUs += durationUs;
+    return DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 释放输出帧
+ * @param frame 输出帧
+ */
+void dms_player_release_frame(struct DmsFrame* frame) {
+    if (frame && frame->unit) {
+        if (frame->cached) {
+            dms_codestream_ring_release_unit(&frame->unit);
+        } else {
+            _dms_free_data_unit(&frame->unit);
+        }
+    }
+    if (frame && frame->rightUnit) {
+        _dms_free_data_unit(&frame->rightUnit);
+    }
+}
+
+/**
+ * @brief 上报单帧解码耗时，用于抽帧步长计算
+ * @param ctx DMS播放器上下文指针
+ * @param costUs 耗时（微秒）
+ */
+void dms_player_report_decode_time(struct DmsContext* ctx, int64_t costUs) {
+    if (ctx) {
+        dms_trick_play_report_decode(&ctx->trick, costUs);
+    }
+}
+
+/**
+ * @brief 解码输出帧，解码耗时计入抽帧策略（快进/快退按实际解码能力调整步长）
+ * @param ctx DMS播放器上下文指针
+ * @param frame 输出帧
+ * @param outPicture 输出图像，使用后由dms_picture_release释放
+ * @return 成功返回0，参数错误返回-1，未编译J2K解码支持或解码失败返回-3
+ */
+int dms_player_decode_frame(struct DmsContext* ctx, const struct DmsFrame* frame, struct DmsPicture* outPicture) {
+    if (!ctx || !frame || !frame->unit || !outPicture) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    if (!ctx->decoder) {
+        ctx->decoder = dms_j2k_decoder_create(nullptr);
+        if (!ctx->decoder) {
+            return -3;
+        }
+        dms_j2k_decoder_set_output_size(ctx->decoder, ctx->outputWidth, ctx->outputHeight);
+    }
+    int64_t startUs = now_us();
+    int result = dms_j2k_decoder_decode(ctx->decoder, frame->unit->Data, frame->unit->Length, outPicture);
+    if (result == 0) {
+        dms_trick_play_report_decode(&ctx->trick, now_us() - startUs);
+    }
+    return result;
+}
+
+/**
+ * @brief 设置输出画面尺寸，解码时丢弃高于画面所需的小波分辨率层（1/2、1/4、1/8）
+ * @param ctx DMS播放器上下文指针
+ * @param width 画面宽度（像素），0表示按原图尺寸解码
+ * @param height 画面高度（像素）
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_player_set_output_size(struct DmsContext* ctx, int32_t width, int32_t height) {
+    if (!ctx || width < 0 || height < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    ctx->outputWidth = width;
+    ctx->outputHeight = height;
+    if (ctx->decoder) {
+        dms_j2k_decoder_set_output_size(ctx->decoder, width, height);
+    }
+    return 0;
+}
+
+/**
+ * @brief 按显示顺序取下一解码帧。取帧阶段在调用线程中按当前播放速度读取码流，
+ *        持有帧数未达上限时持续提交给并行解码线程，输出严格按显示顺序
+ * @param ctx DMS播放器上下文指针
+ * @param outFrame 输出帧信息（帧号、时间戳与显示时长），码流已在解码后释放
+ * @param outPicture 输出图像，使用后由dms_picture_release释放；立体素材为左眼
+ * @return 正确返回DMS_RESULT_SUCCESS；该帧解码失败返回-3（outFrame有效，可跳过继续取帧）；
+ *         到达结尾或读取出错时在已提交的帧全部输出后返回对应错误码
+ */
+int dms_player_next_picture(struct DmsContext* ctx, struct DmsFrame* outFrame, struct DmsPicture* outPicture) {
+    struct DmsPicture right;
+    memset(&right, 0, sizeof(right));
+    int result = dms_player_next_stereo_picture(ctx, outFrame, outPicture, &right);
+    dms_picture_release(&right);
+    return result;
+}
+
+/**
+ * @brief 按显示顺序取下一解码帧，立体素材的两眼由不同的解码线程同时解码，两眼都完成后输出。
+ *        只显示左眼、倍速或倒放时不读取右眼，outRight为空
+ * @param ctx DMS播放器上下文指针
+ * @param outFrame 输出帧信息（帧号、时间戳与显示时长），码流已在解码后释放
+ * @param outLeft 输出左眼（2D素材即该帧）图像，使用后由dms_picture_release释放
+ * @param outRight 输出右眼图像，使用后由dms_picture_release释放；没有右眼或右眼解码失败时为空
+ * @return 同dms_player_next_picture
+ */
+int dms_player_next_stereo_picture(struct DmsContext* ctx, struct DmsFrame* outFrame, struct DmsPicture* outLeft,
+                                   struct DmsPicture* outRight) {
+    if (!ctx || !outFrame || !outLeft || !outRight) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -3;
+    }
+    if (!ctx->decodePipeline) {
+        int cores = (int)std::thread::hardware_concurrency();
+        int workers = ctx->decodeWorkers > 0 ? ctx->decodeWorkers : cores;
+        if (!ctx->decoder) {
+            // 帧间并行已占满各核，单帧内只保留剩余的线程
+            struct DmsJ2kDecoderConfig config = {workers < cores ? cores / workers : 1, DMS_J2K_REDUCE_AUTO};
+            ctx->decoder = dms_j2k_decoder_create(&config);
+            if (!ctx->decoder) {
+                return -3;
+            }
+            dms_j2k_decoder_set_output_size(ctx->decoder, ctx->outputWidth, ctx->outputHeight);
+            int32_t layers, extraReduce;
+            dms_decode_quality_params(&ctx->quality, &layers, &extraReduce);
+            dms_j2k_decoder_set_quality(ctx->decoder, layers, extraReduce);
+        }
+        struct DmsDecodePipelineConfig config = {workers, 0};
+        ctx->decodePipeline = dms_decode_pipeline_create(ctx->decoder, &config);
+        ctx->decodeEndResult = DMS_RESULT_SUCCESS;
+        if (!ctx->decodePipeline) {
+            return -3;
+        }
+    }
+
+    while (ctx->decodeEndResult == DMS_RESULT_SUCCESS && !dms_decode_pipeline_full(ctx->decodePipeline)) {
+        struct DmsFrame frame;
+        int result = dms_player_next_frame(ctx, &frame);
+        if (result != DMS_RESULT_SUCCESS) {
+            ctx->decodeEndResult = result;
+            break;
+        }
+        dms_decode_pipeline_submit(ctx->decodePipeline, &frame, -1);
+    }
+    int result = dms_decode_pipeline_receive_stereo(ctx->decodePipeline, outFrame, outLeft, outRight, -1);
+    if (result == 1) {
+        return ctx->decodeEndResult;
+    }
+    if (result == 0) {
+        // M帧同时解码时，单帧占用的解码时间约为单帧耗时的1/M，据此调整抽帧步长
+        struct DmsJ2kDecoderStats stats;
+        struct DmsDecodePipelineStats pipelineStats;
+        dms_decode_pipeline_get_stats(ctx->decodePipeline, &pipelineStats);
+        if (dms_j2k_decoder_get_stats(ctx->decoder, &stats) == 0) {
+            dms_trick_play_report_decode(&ctx->trick, (int64_t)(stats.decodeCostUs / pipelineStats.workers));
+        }
+        // 解码线程多于CPU核数时，同时解码的帧数以核数为限
+        int cores = (int)std::thread::hardware_concurrency();
+        int parallel = cores > 0 && cores < pipelineStats.workers ? cores : pipelineStats.workers;
+        // 立体帧两眼共用解码能力，按两眼耗时之和计
+        int64_t costUs = outLeft->costUs + outRight->costUs;
+        int32_t level = ctx->quality.level;
+        dms_decode_quality_set_layers(&ctx->quality, outLeft->layers);
+        if (dms_decode_quality_report(&ctx->quality, costUs, outFrame->durationUs * parallel, outFrame->durationUs,
+                                      outLeft->degraded || outRight->degraded) != level) {
+            int32_t layers, extraReduce;
+            dms_decode_quality_params(&ctx->quality, &layers, &extraReduce);
+            dms_j2k_decoder_set_quality(ctx->decoder, layers, extraReduce);
+            LOGI("Decode quality level %d -> %d (%.1f ms/frame, budget %.1f ms)", level, ctx->quality.level,
+                 costUs / 1000.0f, outFrame->durationUs * parallel / 1000.0f);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 当前DCP是否为立体（3D）素材
+ * @param ctx DMS播放器上下文指针
+ * @return 是立体素材返回true
+ */
+bool dms_player_is_stereo(struct DmsContext* ctx) {
+    return ctx && ctx->stereo;
+}
+
+/**
+ * @brief 设置立体输出方式。是否读取右眼随之改变：已预读与正在解码的帧丢弃，
+ *        从下一应显示帧起按新方式重新读取；码流缓存只有左眼，一并清空
+ * @param ctx DMS播放器上下文指针
+ * @param mode 输出方式，DmsStereoMode；2D素材上设置后在打开立体素材时生效
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_player_set_stereo_mode(struct DmsContext* ctx, int mode) {
+    if (!ctx || !dms_stereo_mode_valid(mode)) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    if (mode == ctx->stereoMode) {
+        return 0;
+    }
+    bool reread = ctx->stereo && dms_stereo_mode_both_eyes(mode) != dms_stereo_mode_both_eyes(ctx->stereoMode);
+    if (reread) {
+        flush_decode(ctx, true);
+        stop_readahead(ctx, true);
+        leave_ring(ctx);
+        dms_codestream_ring_clear(ctx->codestreamRing);
+    }
+    ctx->stereoMode = mode;
+    LOGI("Stereo output: %s%s", dms_stereo_mode_name(mode), ctx->stereo ? "" : " (2D essence)");
+    return 0;
+}
+
+/**
+ * @brief 开关自适应解码质量，关闭时恢复全质量解码
+ * @param ctx DMS播放器上下文指针
+ * @param enabled 是否按显示时刻自动降低/恢复解码质量
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_player_set_adaptive_quality(struct DmsContext* ctx, bool enabled) {
+    if (!ctx) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    dms_decode_quality_reset(&ctx->quality, enabled);
+    if (ctx->decoder) {
+        dms_j2k_decoder_set_quality(ctx->decoder, 0, 0);
+    }
+    LOGI("Adaptive decode quality %s", enabled ? "enabled" : "disabled");
+    return 0;
+}
+
+/**
+ * @brief 上报显示端的延后，与解码耗时一同决定是否降低解码质量；须在取帧的线程调用
+ * @param ctx DMS播放器上下文指针
+ * @param lateUs 最近一帧实际显示时刻晚于计划时刻的时间（微秒）
+ */
+void dms_player_report_present_late(struct DmsContext* ctx, int64_t lateUs) {
+    if (ctx) {
+        dms_decode_quality_report_late(&ctx->quality, lateUs);
+    }
+}
+
+/**
+ * @brief 获取码流参数。已解析时直接返回；否则读取当前读取位置的数据单元解析主头，
+ *        再把读取位置移回该帧，不改变播放位置
+ * @param ctx DMS播放器上下文指针
+ * @param outInfo 输出码流参数
+ * @return 成功返回0，参数错误返回-1，未打开MXF或读取失败返回-3，不是J2K码流返回-3
+ */
+int dms_player_probe_stream(struct DmsContext* ctx, struct DmsJ2kStreamInfo* outInfo) {
+    if (!ctx || !outInfo) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    if (ctx->streamInfoValid) {
+        *outInfo = ctx->streamInfo;
+        return 0;
+    }
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -3;
+    }
+
+    // 后台读取线程会移动读取位置，探测前先停止，并把读取位置移回下一输出帧
+    flush_decode(ctx, true);
+    stop_reverse(ctx, true);
+    stop_readahead(ctx, true);
+    leave_ring(ctx);
+    dms_index_builder_touch(ctx->indexBuilder);
+    std::lock_guard<std::mutex> lock(gDmsLibMutex);
+    DmsDataUnitPtr unit = nullptr;
+    int64_t frame = -1;
+    int result = read_unit_locked(ctx, ctx->nextFrame, &unit, &frame, false);
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Failed to read unit for stream probe: 0x%08x", result);
+        return -3;
+    }
+    // 移回该数据单元，下一次读取仍从它开始（nextFrame/lastPos不变）
+    struct DmsJ2kStreamInfo info;
+    result = dms_j2k_parse_header(unit->Data, unit->Length, &info);
+    _dms_goto_pos(unit->Pos, false);
+    _dms_free_data_unit(&unit);
+    if (result != 0) {
+        LOGE("Not a JPEG 2000 codestream");
+        return -3;
+    }
+    ctx->streamInfo = info;
+    ctx->streamInfoValid = true;
+    *outInfo = info;
+    return 0;
+}
+
+/**
+ * @brief 设置码流缓存保留的秒数与字节数上限，先达到者生效；两者均为0时停用并释放缓存
+ * @param ctx DMS播放器上下文指针
+ * @param seconds 保留的秒数（按帧率换算为帧数），0为不限
+ * @param bytes 字节数上限，0为不限
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_player_set_codestream_cache(struct DmsContext* ctx, float seconds, int64_t bytes) {
+    if (!ctx || seconds < 0 || bytes < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    ctx->codestreamSeconds = seconds;
+    ctx->codestreamBytes = bytes;
+    if (seconds <= 0 && bytes <= 0) {
+        leave_ring(ctx);
+        dms_codestream_ring_destroy(ctx->codestreamRing);
+        ctx->codestreamRing = nullptr;
+        LOGI("Codestream cache disabled");
+        return 0;
+    }
+    if (ctx->codestreamRing) {
+        int64_t last = ctx->ringFrame;
+        dms_codestream_ring_set_limits(ctx->codestreamRing, bytes, ring_limit_frames(ctx));
+        // 正在取的帧被淘汰时回到libdms读取
+        if (last >= 0 && !dms_codestream_ring_contains(ctx->codestreamRing, ctx->reel, last)) {
+            leave_ring(ctx);
+        }
+    }
+    LOGI("Codestream cache: %.1f s, %lld bytes", seconds, (long long)bytes);
+    return 0;
+}
+
+/**
+ * @brief 获取码流缓存统计信息
+ * @param ctx DMS播放器上下文指针
+ * @param outStats 输出统计信息
+ * @return 成功返回0，参数错误返回-1，尚未开始缓存或已停用返回-2
+ */
+int dms_player_get_codestream_cache_stats(struct DmsContext* ctx, struct DmsCodestreamRingStats* outStats) {
+    if (!ctx || !outStats) {
+        return -1;
+    }
+    if (!ctx->codestreamRing) {
+        return -2;
+    }
+    return dms_codestream_ring_get_stats(ctx->codestreamRing, outStats);
+}
+
+/**
+ * @brief 设置并行解码线程数，下一次取解码帧时按新线程数重建
+ * @param ctx DMS播放器上下文指针
+ * @param workers 解码线程数，0表示按CPU核数
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_player_set_decode_workers(struct DmsContext* ctx, int workers) {
+    if (!ctx || workers < 0 || workers > DMS_DECODE_MAX_WORKERS) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    ctx->decodeWorkers = workers;
+    if (ctx->decodePipeline) {
+        flush_decode(ctx, true);
+        dms_decode_pipeline_destroy(ctx->decodePipeline);
+        ctx->decodePipeline = nullptr;
+    }
+    LOGI("Decode workers: %d", workers);
+    return 0;
+}
+
+/**
+ * @brief 获取并行解码统计信息（各解码线程利用率用于按芯片选择线程数）
+ * @param ctx DMS播放器上下文指针
+ * @param outStats 输出统计信息
+ * @return 成功返回0，参数错误返回-1，尚未开始并行解码返回-2
+ */
+int dms_player_get_decode_stats(struct DmsContext* ctx, struct DmsDecodePipelineStats* outStats) {
+    if (!ctx || !outStats) {
+        return -1;
+    }
+    if (!ctx->decodePipeline) {
+        return -2;
+    }
+    return dms_decode_pipeline_get_stats(ctx->decodePipeline, outStats);
+}
+
+/**
+ * @brief 停止并行解码并丢弃未输出的帧，关闭DCP前调用
+ * @param ctx DMS播放器上下文指针
+ */
+void dms_player_stop_decode(struct DmsContext* ctx) {
+    if (!ctx || !ctx->decodePipeline) {
+        return;
+    }
+    dms_decode_pipeline_destroy(ctx->decodePipeline);
+    ctx->decodePipeline = nullptr;
+    ctx->decodeEndResult = DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 从first开始读取count帧放入逐帧窗口
+ * @param ctx DMS播放器上下文指针
+ * @param first 起始帧号
+ * @param count 读取帧数
+ * @param center 当前目标帧号，决定窗口淘汰顺序
+ * @return 至少读取到一帧返回DMS_RESULT_SUCCESS，否则返回错误码
+ */
+static int fetch_into_window(struct DmsContext* ctx, int64_t first, int count, int64_t center) {
+    std::vector<DmsDataUnitPtr> units(count, nullptr);
+    std::vector<int64_t> frames(count, -1);
+    int got = 0;
+    int64_t seekUs = -1;
+    int64_t start = now_us();
+    int result = dms_player_fetch_frames(ctx, first, count, units.data(), frames.data(), &got, &seekUs);
+    int64_t readUs = now_us() - start - (seekUs > 0 ? seekUs : 0);
+    dms_step_window_report_fetch(ctx->stepWindow, seekUs, readUs, got);
+
+    for (int i = 0; i < got; i++) {
+        if (frames[i] >= 0) {
+            dms_step_window_put(ctx->stepWindow, frames[i], units[i], center);
+        } else {
+            _dms_free_data_unit(&units[i]);
+        }
+    }
+    // 逐帧步进只显示左眼
+    dms_stereo_pairs_clear(ctx->stereoPairs);
+    return result;
+}
+
+/**
+ * @brief 进入逐帧模式并返回当前显示的分本内帧号：停止倒放与倍速，逐帧期间暂停连续取帧
+ * @param ctx DMS播放器上下文指针
+ * @return 当前显示帧号，尚未显示任何帧时为-1
+ */
+static int64_t enter_step(struct DmsContext* ctx) {
+    if (!ctx->stepWindow) {
+        ctx->stepWindow = dms_step_window_create(kStepWindowFrames);
+    }
+    if (ctx->stepFrame >= 0) {
+        return ctx->stepFrame;
+    }
+    flush_decode(ctx, true);
+    stop_reverse(ctx, true);
+    stop_readahead(ctx, true);
+    leave_ring(ctx);
+    dms_trick_play_reset(&ctx->trick, 1.0f);
+    if (ctx->nextFrame >= 0) {
+        return ctx->nextFrame - 1;
+    }
+    return position_frame(ctx);
+}
+
+/**
+ * @brief 逐帧显示目标帧：窗口命中时直接返回；未命中时在时延预算内定位读取一小段，
+ *        前进时多读其后的帧、后退时多读其前的帧，留给后续步进
+ * @param ctx DMS播放器上下文指针
+ * @param target 分本内目标帧号
+ * @param direction 预读方向，1向后、-1向前
+ * @param outUnit 输出数据单元，归窗口所有，下一次步进、定位或取帧前有效
+ * @return 正确返回DMS_RESULT_SUCCESS，否则返回错误码
+ */
+static int show_step_frame(struct DmsContext* ctx, int64_t target, int direction, const DmsDataUnit** outUnit) {
+    int64_t frameCount = dms_index_builder_get_frame_count(ctx->indexBuilder);
+    if (target < 0 || (frameCount > 0 && target >= frameCount)) {
+        return DMS_RESULT_PLAY_FINISHED;
+    }
+    if (!ctx->stepWindow) {
+        return -3;
+    }
+
+    int64_t start = now_us();
+    int result = DMS_RESULT_SUCCESS;
+    const DmsDataUnit* unit = dms_step_window_get(ctx->stepWindow, target);
+    bool hit = unit != nullptr;
+    if (!hit) {
+        int capacity = dms_step_window_get_capacity(ctx->stepWindow);
+        int count = dms_step_window_plan(ctx->stepWindow, ctx->nextFrame != target, capacity / 2);
+        int64_t first = target;
+        if (direction < 0) {
+            first = target - count + 1 > 0 ? target - count + 1 : 0;
+            // 读取位置恰在目标时不必为多读前面的帧而定位
+            if (ctx->nextFrame == target) {
+                first = target;
+            }
+            count = (int)(target - first + 1);
+        }
+        result = fetch_into_window(ctx, first, count, target);
+        unit = dms_step_window_get(ctx->stepWindow, target);
+
+        if (!unit && result == DMS_RESULT_SUCCESS) {
+            // 远距离估算定位未落在目标上：从不大于目标的最近覆盖帧顺读到目标
+            int64_t from = ctx->indexBuilder ? dms_index_builder_floor(ctx->indexBuilder, target) : -1;
+            from = from >= 0 ? from : 0;
+            LOGE("Frame %lld missed by estimated seek, reading forward from %lld",
+                 (long long)target, (long long)from);
+            while (!unit && result == DMS_RESULT_SUCCESS && from <= target) {
+                int n = target - from + 1 < capacity ? (int)(target - from + 1) : capacity;
+                result = fetch_into_window(ctx, from, n, target);
+                from += n;
+                unit = dms_step_window_get(ctx->stepWindow, target);
+            }
+        }
+    }
+    dms_step_window_report_step(ctx->stepWindow, hit, now_us() - start);
+
+    if (!unit) {
+        return result != DMS_RESULT_SUCCESS ? result : (int)DMS_RESULT_NO_PICTURE_ESSENCE_FOUND;
+    }
+    ctx->stepFrame = target;
+    set_position(ctx, target);
+    *outUnit = unit;
+    return DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 逐帧显示整部影片中的目标帧，目标在其他分本时先切换分本
+ * @param ctx DMS播放器上下文指针
+ * @param target 目标帧号（整部影片）
+ * @param direction 预读方向，1向后、-1向前
+ * @param outUnit 输出数据单元
+ * @return 正确返回DMS_RESULT_SUCCESS，否则返回错误码
+ */
+static int show_global_frame(struct DmsContext* ctx, int64_t target, int direction, const DmsDataUnit** outUnit) {
+    int reel = ctx->reel;
+    int64_t local = target;
+    if (dms_reel_timeline_locate(&ctx->timeline, target, &reel, &local) == 0 && reel != ctx->reel) {
+        int result = select_reel(ctx, reel);
+        if (result != 0) {
+            return result;
+        }
+    }
+    return show_step_frame(ctx, local, direction, outUnit);
+}
+
+/**
+ * @brief 逐帧前进或后退一帧，之后调用dms_player_next_frame时从当前帧的下一帧继续播放
+ * @param ctx DMS播放器上下文指针
+ * @param direction 1前进，-1后退
+ * @param outUnit 输出数据单元，归播放器所有，下一次步进、定位或取帧前有效
+ * @param outFrame 输出帧号（整部影片），可为空
+ * @return 正确返回DMS_RESULT_SUCCESS，越过片头/片尾返回DMS_RESULT_PLAY_FINISHED，否则返回错误码
+ */
+int dms_player_step_frame(struct DmsContext* ctx, int direction, const DmsDataUnit** outUnit,
+                          int64_t* outFrame) {
+    if (!ctx || !outUnit || (direction != 1 && direction != -1)) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outUnit = nullptr;
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -3;
+    }
+
+    int64_t current = enter_step(ctx);
+    int64_t target = dms_reel_timeline_start(&ctx->timeline, ctx->reel) + current + direction;
+    int result = show_global_frame(ctx, target, direction, outUnit);
+    if (result == (int)DMS_RESULT_PLAY_FINISHED && direction > 0 && ctx->reel + 1 < ctx->timeline.reelCount) {
+        // 估算的分本帧数偏大：按读到的实际结尾修正后，从下一分本开头显示
+        int64_t frameCount = dms_index_builder_get_frame_count(ctx->indexBuilder);
+        if (frameCount >= 0) {
+            dms_reel_timeline_set_known(&ctx->timeline, ctx->reel, frameCount, true);
+            update_duration(ctx);
+            result = show_global_frame(ctx, dms_reel_timeline_start(&ctx->timeline, ctx->reel + 1),
+                                       direction, outUnit);
+        }
+    }
+    if (outFrame) {
+        *outFrame = result == DMS_RESULT_SUCCESS ? to_global(ctx, ctx->stepFrame) : -1;
+    }
+    return result;
+}
+
+/**
+ * @brief 精确定位并显示指定帧，进入逐帧模式；目标之前的若干帧一并保留，便于随后后退
+ * @param ctx DMS播放器上下文指针
+ * @param frame 目标帧号（整部影片）
+ * @param outUnit 输出数据单元，归播放器所有，下一次步进、定位或取帧前有效
+ * @return 正确返回DMS_RESULT_SUCCESS，超出范围返回DMS_RESULT_PLAY_FINISHED，否则返回错误码
+ */
+int dms_player_seek_to_frame(struct DmsContext* ctx, int64_t frame, const DmsDataUnit** outUnit) {
+    if (!ctx || !outUnit || frame < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outUnit = nullptr;
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return -3;
+    }
+
+    enter_step(ctx);
+    return show_global_frame(ctx, frame, -1, outUnit);
+}
+
+/**
+ * @brief 打开断点续播日志，放映期间每显示一帧追加一条记录（见dms_player_frame_presented）
+ * @param ctx DMS播放器上下文指针
+ * @param path 日志文件路径（应位于断电后仍保留的持久目录）
+ * @param syncIntervalMs 落盘周期（毫秒），0表示每帧同步落盘
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_player_open_journal(struct DmsContext* ctx, const char* path, int syncIntervalMs) {
+    if (!ctx || !path || syncIntervalMs < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    dms_player_close_journal(ctx);
+    ctx->journal = dms_breakpoint_journal_open(path, DMS_BREAKPOINT_DEFAULT_CAPACITY, syncIntervalMs);
+    if (!ctx->journal) {
+        return -3;
+    }
+    if (ctx->sessionId[0]) {
+        dms_breakpoint_journal_begin_session(ctx->journal, ctx->sessionId);
+    }
+    return 0;
+}
+
+/**
+ * @brief 帧已显示：记录其放映点。取帧时只登记，显示端在帧实际显示后以其时间戳确认，断点不会越过
+ *        预读、并行解码、渲染帧槽与ExoPlayer缓冲中观众尚未看到的帧。只访问日志，可在显示线程调用
+ * @param ctx DMS播放器上下文指针
+ * @param timeUs 已显示帧的时间戳（DmsFrame.timeUs）
+ * @return 已记录返回0，没有对应的已取出帧返回1，参数错误返回-1，未打开日志返回-2
+ */
+int dms_player_frame_presented(struct DmsContext* ctx, int64_t timeUs) {
+    if (!ctx) {
+        LOGE("Invalid context pointer");
+        return -1;
+    }
+    if (!ctx->journal) {
+        return -2;
+    }
+    return dms_breakpoint_journal_presented(ctx->journal, timeUs);
+}
+
+/**
+ * @brief 落盘并关闭断点续播日志
+ * @param ctx DMS播放器上下文指针
+ */
+void dms_player_close_journal(struct DmsContext* ctx) {
+    if (!ctx || !ctx->journal) {
+        return;
+    }
+    dms_breakpoint_journal_close(ctx->journal);
+    ctx->journal = nullptr;
+}
+
+/**
+ * @brief 开始新的放映场次：生成场次标识，供_dms_open_dcp使用并写入之后的断点记录
+ * @param ctx DMS播放器上下文指针
+ * @return 场次标识，失败返回NULL
+ */
+const char* dms_player_begin_session(struct DmsContext* ctx) {
+    if (!ctx) {
+        LOGE("Invalid context pointer");
+        return nullptr;
+    }
+    if (dms_breakpoint_make_session_id(ctx->sessionId, sizeof(ctx->sessionId)) != 0) {
+        return nullptr;
+    }
+    dms_breakpoint_journal_begin_session(ctx->journal, ctx->sessionId);
+    LOGI("Session started: %s", ctx->sessionId);
+    return ctx->sessionId;
+}
+
+/**
+ * @brief 记录放映结束（播放完成或主动关闭），再次启动时不再续播
+ * @param ctx DMS播放器上下文指针
+ * @return 成功返回0，失败返回错误码
+ */
+int dms_player_end_session(struct DmsContext* ctx) {
+    if (!ctx) {
+        LOGE("Invalid context pointer");
+        return -1;
+    }
+    ctx->sessionId[0] = '\0';
+    return ctx->journal ? dms_breakpoint_journal_end_session(ctx->journal) : 0;
+}
+
+/**
+ * @brief 取可续播的断点：日志中最后一条有效记录，且该场次未正常结束
+ * @param ctx DMS播放器上下文指针
+ * @param outRecord 输出断点记录
+ * @return 有可续播断点返回0，没有返回1，失败返回错误码
+ */
+int dms_player_get_breakpoint(struct DmsContext* ctx, struct DmsBreakpointRecord* outRecord) {
+    if (!ctx || !outRecord) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    if (!ctx->journal) {
+        return -2;
+    }
+    if (dms_breakpoint_journal_recover(ctx->journal, outRecord) != 0 ||
+        (outRecord->flags & DMS_BREAKPOINT_FLAG_ENDED) || outRecord->pos < 0) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 断电后的断点续播：打开DCP（沿用断点的放映场次）并选择断点所在分本、绑定KDM、登记断点、
+ *        以断点标志定位，并预读到最小缓冲后返回，调用者随后即可开始显示。
+ *        载入帧索引为纯文件操作，与绑定KDM、登记断点并行
+ * @param ctx DMS播放器上下文指针
+ * @param mxfPath DCP包路径
+ * @param kdmPath KDM文件路径，未加密影片可为空
+ * @param minBufferSeconds 开始显示前至少缓冲的秒数
+ * @param outStats 输出各阶段耗时，可为空
+ * @return 成功返回0，没有可续播的断点返回1，失败返回错误码
+ */
+int dms_player_resume_breakpoint(struct DmsContext* ctx, const char* mxfPath, const char* kdmPath,
+                                 float minBufferSeconds, struct DmsResumeStats* outStats) {
+    if (!ctx || !mxfPath || minBufferSeconds < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    if (!ctx->isInitialized) {
+        LOGE("DMS player not initialized");
+        return -2;
+    }
+    if (ctx->hasActiveMxf) {
+        LOGE("Close the active MXF file before resuming");
+        return -3;
+    }
+
+    struct DmsResumeStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.frame = -1;
+    int64_t begin = now_us();
+    int64_t start = begin;
+
+    // 1. 读取断点
+    struct DmsBreakpointRecord record;
+    int result = dms_player_get_breakpoint(ctx, &record);
+    stats.recoverUs = now_us() - start;
+    if (result != 0) {
+        LOGI("No breakpoint to resume");
+        return result > 0 ? 1 : result;
+    }
+    dms_breakpoint_format_session_id(&record, ctx->sessionId, sizeof(ctx->sessionId));
+    dms_breakpoint_journal_begin_session(ctx->journal, ctx->sessionId);
+
+    // 2. 以原场次打开DCP
+    start = now_us();
+    result = _dms_open_dcp(mxfPath, ctx->sessionId, false);
+    stats.openUs = now_us() - start;
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Failed to open DCP for resume: 0x%08x", result);
+        return result;
+    }
+    ctx->hasActiveMxf = true;
+
+    // 建立分本时间轴并选择断点所在分本
+    dms_player_close_index(ctx);
+    start = now_us();
+    result = build_timeline(ctx, DMS_BREAKPOINT_REEL(record.flags));
+    stats.openUs += now_us() - start;
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Failed to select breakpoint reel %d: 0x%08x", DMS_BREAKPOINT_REEL(record.flags), result);
+        _dms_close_dcp();
+        ctx->hasActiveMxf = false;
+        return result;
+    }
+
+    // 3. 绑定KDM、登记断点，同时在另一线程载入帧索引
+    std::string path;
+    struct DmsIndexBuilder* builder = nullptr;
+    std::thread indexThread;
+    if (index_path(ctx, &path) == 0) {
+        indexThread = std::thread([&path, &builder, &stats] {
+            int64_t indexStart = now_us();
+            builder = dms_index_builder_create(path.c_str());
+            stats.indexUs = now_us() - indexStart;
+        });
+    }
+
+    start = now_us();
+    result = (kdmPath && *kdmPath) ? _dms_bind_kdm(kdmPath) : (int)DMS_RESULT_SUCCESS;
+    stats.bindUs = now_us() - start;
+    if (result == DMS_RESULT_SUCCESS) {
+        char datetime[32];
+        dms_breakpoint_format_utc(record.utcMs, datetime, sizeof(datetime));
+        start = now_us();
+        result = _dms_set_playback_break(datetime);
+        stats.breakUs = now_us() - start;
+    }
+    if (indexThread.joinable()) {
+        indexThread.join();
+    }
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Failed to bind KDM or set playback break: 0x%08x", result);
+        dms_index_builder_destroy(builder);
+        _dms_close_dcp();
+        ctx->hasActiveMxf = false;
+        return result;
+    }
+    ctx->indexBuilder = builder;
+    if (builder) {
+        dms_index_builder_start_walker(builder, walk_index, ctx);
+    }
+    note_reel_frames(ctx);
+
+    // 4. 以断点标志定位
+    start = now_us();
+    {
+        std::lock_guard<std::mutex> lock(gDmsLibMutex);
+        result = _dms_goto_pos(record.pos, true);
+        ctx->nextFrame = record.frame;
+        ctx->lastPos = -1;
+    }
+    stats.seekUs = now_us() - start;
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Breakpoint seek failed: 0x%08x", result);
+        dms_player_close_index(ctx);
+        _dms_close_dcp();
+        ctx->hasActiveMxf = false;
+        return result;
+    }
+    stats.frame = to_global(ctx, record.frame);
+    ctx->stepFrame = -1;
+    dms_trick_play_reset(&ctx->trick, 1.0f);
+    if (stats.frame >= 0 && ctx->frameRate > 0) {
+        set_position(ctx, record.frame);
+        ctx->outputTimeUs = (int64_t)((double)stats.frame * 1000000.0 / ctx->frameRate);
+    }
+
+    // 5. 预读到最小缓冲；预读缓冲保留两倍深度，供之后的正常播放使用
+    int minFrames = (int)ceilf(minBufferSeconds * ctx->frameRate);
+    if (ctx->readaheadFrames < minFrames * 2) {
+        ctx->readaheadFrames = minFrames * 2;
+    }
+    start = now_us();
+    if (minFrames > 0) {
+        ctx->readahead = dms_readahead_create(ctx, ctx->readaheadFrames, nullptr, nullptr);
+        stats.bufferedFrames = dms_readahead_wait(ctx->readahead, minFrames, kResumeBufferTimeoutUs);
+    }
+    stats.bufferUs = now_us() - start;
+    stats.totalUs = now_us() - begin;
+
+    LOGI("Resumed frame %lld: recover %lldus, open %lldus, bind %lldus, index %lldus (parallel), "
+         "break %lldus, seek %lldus, buffer %lldus (%d frames), total %lldus",
+         (long long)stats.frame, (long long)stats.recoverUs, (long long)stats.openUs,
+         (long long)stats.bindUs, (long long)stats.indexUs, (long long)stats.breakUs,
+         (long long)stats.seekUs, (long long)stats.bufferUs, stats.bufferedFrames,
+         (long long)stats.totalUs);
+    if (outStats) {
+        *outStats = stats;
+    }
+    return 0;
+}
@@ -3,11 +3,31 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "libdms.h"
+#include "dms_trick_play.h"
+#include "dms_breakpoint_journal.h"
+#include "dms_reel_timeline.h"
+#include "dms_j2k_decoder.h"
+#include "dms_decode_quality.h"
+#include "dms_j2k_header.h"
+#include "dms_present_clock.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct DmsIndexBuilder;
+struct DmsReversePlay;
+struct DmsStepWindow;
+struct DmsReadahead;
+struct DmsDecodePipeline;
+struct DmsDecodePipelineStats;
+struct DmsRenderer;
+struct DmsThumbnailAtlas;
+struct DmsCodestreamRing;
+struct DmsCodestreamRingStats;
+struct DmsStereoPairs;
+
 // DMS player context structure
 struct DmsContext {
     bool isInitialized;      // 标识播放器是否已初始化
@@ -18,9 +38,75 @@ struct DmsContext {
     char* mxfPath;           // MXF文件路径
     char* kdmPath;           // KDM文件路径
     void* playerHandle;      // 播放器句柄
+    float frameRate;         // 帧率
+    struct DmsReelTimeline timeline; // 多分本统一时间轴
+    int32_t reel;            // 当前输出的分本序号（从0开始）
+    int32_t readerReel;      // libdms当前选择的分本，预取下一分本期间领先于reel
+    int64_t nextFrame;       // 下一次读取的数据单元在当前分本内的帧号，未知为-1
+    int64_t lastPos;         // 最近一次读取的数据单元Pos，未读取为-1
+    int64_t reelFirstPos;    // 读取所在分本第一个数据单元的Pos，未知为-1
+    int64_t emittedFrame;    // 最近由dms_player_next_frame输出的帧号（整部影片），跨线程读写加锁，未知为-1
+    char* indexDir;          // 帧索引文件目录，为空时不建立索引
+    struct DmsIndexBuilder* indexBuilder; // 增量帧索引
+    struct DmsTrickPlay trick; // 快进/快退抽帧策略
+    struct DmsReversePlay* reversePlay; // 1倍速倒放引擎，未倒放时为空
+    int64_t stepFrame;       // 逐帧模式下当前显示的分本内帧号，不在逐帧模式时为-1
+    struct DmsStepWindow* stepWindow; // 逐帧步进保留的邻近帧
+    struct DmsBreakpointJournal* journal; // 断点续播日志，未设置时为空
+    char sessionId[DMS_BREAKPOINT_SESSION_ID_LEN]; // 当前放映场次标识
+    struct DmsReadahead* readahead; // 正常速度播放的预读缓冲
+    struct DmsReadahead* nextReadahead; // 当前分本读完后对下一分本的预读（无缝切换）
+    int32_t readaheadFrames; // 预读缓冲帧数，0表示不预读（多分本影片至少预读48帧，用于后台切换分本）
+    int64_t outputTimeUs;    // 下一输出帧的时间戳（微秒），倍速播放时按墙钟节奏改写
+    int64_t lastFrameTimeUs; // 最近一次输出帧的时间戳（微秒）
+    struct DmsJ2kDecoder* decoder; // J2K解码器，首次解码时创建
+    int32_t outputWidth;     // 输出画面宽度，用于选择解码分辨率层，0表示按原图尺寸解码
+    int32_t outputHeight;    // 输出画面高度
+    struct DmsDecodePipeline* decodePipeline; // 帧级并行解码，首次取解码帧时创建
+    int32_t decodeWorkers;   // 并行解码线程数，0表示按CPU核数
+    int32_t decodeEndResult; // 取帧阶段结束的原因，仍在取帧时为DMS_RESULT_SUCCESS
+    struct DmsDecodeQuality quality; // 按显示时刻自适应的解码质量
+    struct DmsRenderer* renderer; // 原生渲染器，存在期间由其线程独占读取与定位，未附加输出端时为空
+    struct DmsThumbnailAtlas* thumbnails; // 进度条缩略图图集，未创建时为空，须在关闭DCP前销毁
+    struct DmsJ2kStreamInfo streamInfo; // 码流参数（主头SIZ/COD/QCD），取帧时逐帧比较指纹
+    bool streamInfoValid;    // streamInfo是否已解析
+    int64_t headerChanges;   // 播放中检测到的主头参数变化次数
+    struct DmsCodestreamRing* codestreamRing; // 最近读取帧的码流缓存，首次取帧时创建，停用时为空
+    float codestreamSeconds; // 码流缓存保留的秒数，0为不限
+    int64_t codestreamBytes; // 码流缓存的字节数上限，0为不限；两者均为0时停用
+    int64_t ringFrame;       // 从码流缓存取帧时下一帧的分本内帧号（libdms读取位置不随之移动），否则为-1
+    int64_t ringSeeks;       // 落在码流缓存内、未定位libdms的跳转次数
+    struct DmsMediaClock clock; // 播放位置的媒体时钟，播放中随系统时刻与播放速度走时
+    bool stereo;             // 立体（3D）素材，每帧左右眼两个数据单元（见 dms_stereo.h），打开DCP时识别
+    int32_t stereoMode;      // 立体输出方式，DmsStereoMode
+    struct DmsStereoPairs* stereoPairs; // 随左眼读出、尚未附到输出帧的右眼单元，识别为立体素材时创建
     // Add other context fields as needed
 };
 
+// 输出帧
+struct DmsFrame {
+    DmsDataUnitPtr unit;     // 数据单元，由dms_player_release_frame释放
+    int64_t frame;           // 整部影片中的帧号，未知为-1
+    int64_t timeUs;          // 输出时间戳（微秒）
+    int64_t durationUs;      // 显示时长（微秒）
+    bool cached;             // 数据单元是码流缓存的副本
+    DmsDataUnitPtr rightUnit; // 立体素材的右眼数据单元，只显示左眼或未读到时为空，由dms_player_release_frame释放
+};
+
+// 断点续播各阶段耗时（微秒）
+struct DmsResumeStats {
+    int64_t recoverUs;       // 读取断点日志
+    int64_t openUs;          // _dms_open_dcp与建立分本时间轴
+    int64_t bindUs;          // _dms_bind_kdm
+    int64_t indexUs;         // 载入帧索引（与绑定KDM并行）
+    int64_t breakUs;         // _dms_set_playback_break
+    int64_t seekUs;          // _dms_goto_pos(pos, true)
+    int64_t bufferUs;        // 预读到最小缓冲
+    int64_t totalUs;         // 总耗时
+    int32_t bufferedFrames;  // 返回时已缓冲的帧数
+    int64_t frame;           // 续播帧号（整部影片），未知为-1
+};
+
 // Function declarations
 int dms_player_init(struct DmsContext* ctx);                    // 初始化DMS播放器
 int dms_player_uninit(struct DmsContext* ctx);                  // 反初始化DMS播放器
@@ -34,6 +120,59 @@ int dms_player_seek(struct DmsContext* ctx, int64_t position);  // 跳转到指
 int64_t dms_player_get_position(struct DmsContext* ctx);        // 获取当前播放位置
 int64_t dms_player_get_duration(struct DmsContext* ctx);        // 获取媒体总时长
 bool dms_player_is_playing(struct DmsContext* ctx);             // 检查是否正在播放
+int dms_player_set_index_dir(struct DmsContext* ctx, const char* indexDir); // 设置帧索引目录
+int dms_player_open_timeline(struct DmsContext* ctx);           // DCP打开后建立分本时间轴，从第一个分本开始
+int dms_player_open_index(struct DmsContext* ctx);              // 载入/创建当前分本的帧索引
+void dms_player_close_index(struct DmsContext* ctx);            // 保存并关闭帧索引
+int dms_player_read_unit(struct DmsContext* ctx, DmsDataUnitPtr* outUnit); // 读取下一个图像数据单元
+int dms_player_seek_frame(struct DmsContext* ctx, int64_t frame); // 跳转到指定帧（整部影片帧号）
+int64_t dms_player_get_current_frame(struct DmsContext* ctx);   // 当前帧号（整部影片，最近输出的帧），未知返回-1
+int dms_player_fetch_frames(struct DmsContext* ctx, int64_t startFrame, int count,
+                            DmsDataUnitPtr* outUnits, int64_t* outFrames, int* outCount,
+                            int64_t* outSeekUs);                // 当前分本内定位后连续读取多帧（不改变播放位置）
+int dms_player_fetch_sample(struct DmsContext* ctx, int64_t frame,
+                            DmsDataUnitPtr* outUnit);           // 后台读取单帧并恢复读取位置（缩略图）
+int dms_player_set_speed(struct DmsContext* ctx, float speed);  // 设置播放速度（1正常，-1倒放，±2~±32快进/快退）
+int dms_player_next_frame(struct DmsContext* ctx, struct DmsFrame* outFrame); // 按当前播放速度取下一输出帧
+void dms_player_release_frame(struct DmsFrame* frame);          // 释放输出帧
+void dms_player_report_decode_time(struct DmsContext* ctx, int64_t costUs); // 上报单帧解码耗时
+int dms_player_decode_frame(struct DmsContext* ctx, const struct DmsFrame* frame,
+                            struct DmsPicture* outPicture);     // 解码输出帧并上报解码耗时
+int dms_player_set_output_size(struct DmsContext* ctx, int32_t width,
+                               int32_t height);                 // 设置输出画面尺寸（选择解码分辨率层）
+int dms_player_next_picture(struct DmsContext* ctx, struct DmsFrame* outFrame,
+                            struct DmsPicture* outPicture);     // 按显示顺序取下一解码帧（帧级并行解码）
+int dms_player_next_stereo_picture(struct DmsContext* ctx, struct DmsFrame* outFrame, struct DmsPicture* outLeft,
+                                   struct DmsPicture* outRight); // 取下一解码帧，立体素材两眼并行解码
+bool dms_player_is_stereo(struct DmsContext* ctx);              // 当前DCP是否为立体（3D）素材
+int dms_player_set_stereo_mode(struct DmsContext* ctx, int mode); // 设置立体输出方式（DmsStereoMode）
+int dms_player_set_decode_workers(struct DmsContext* ctx, int workers); // 设置并行解码线程数
+int dms_player_get_decode_stats(struct DmsContext* ctx,
+                                struct DmsDecodePipelineStats* outStats); // 获取并行解码统计信息
+void dms_player_stop_decode(struct DmsContext* ctx);            // 停止并行解码并丢弃未输出的帧
+int dms_player_set_adaptive_quality(struct DmsContext* ctx, bool enabled); // 开关自适应解码质量
+void dms_player_report_present_late(struct DmsContext* ctx, int64_t lateUs); // 上报显示端的延后
+int dms_player_probe_stream(struct DmsContext* ctx,
+                            struct DmsJ2kStreamInfo* outInfo); // 获取码流参数，未解析时读取当前帧的主头
+int dms_player_set_codestream_cache(struct DmsContext* ctx, float seconds,
+                                    int64_t bytes);             // 设置码流缓存的保留秒数与字节数上限
+int dms_player_get_codestream_cache_stats(struct DmsContext* ctx,
+                                          struct DmsCodestreamRingStats* outStats); // 获取码流缓存统计信息
+int dms_player_step_frame(struct DmsContext* ctx, int direction, const DmsDataUnit** outUnit,
+                          int64_t* outFrame);                   // 逐帧前进(+1)/后退(-1)
+int dms_player_seek_to_frame(struct DmsContext* ctx, int64_t frame,
+                             const DmsDataUnit** outUnit);      // 精确定位并显示指定帧
+int dms_player_open_journal(struct DmsContext* ctx, const char* path,
+                            int syncIntervalMs);                // 打开断点续播日志
+void dms_player_close_journal(struct DmsContext* ctx);          // 落盘并关闭断点续播日志
+int dms_player_frame_presented(struct DmsContext* ctx, int64_t timeUs); // 帧已显示，记录其放映点（可在显示线程调用）
+const char* dms_player_begin_session(struct DmsContext* ctx);   // 开始新的放映场次，返回场次标识
+int dms_player_end_session(struct DmsContext* ctx);             // 记录放映结束，之后不再续播
+int dms_player_get_breakpoint(struct DmsContext* ctx,
+                              struct DmsBreakpointRecord* outRecord); // 取可续播的断点
+int dms_player_resume_breakpoint(struct DmsContext* ctx, const char* mxfPath, const char* kdmPath,
+                                 float minBufferSeconds,
+                                 struct DmsResumeStats* outStats); // 断点续播并预读到最小缓冲
 
 #ifdef __cplusplus
 }
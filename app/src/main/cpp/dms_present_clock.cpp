@@ -0,0 +1,317 @@
+#include "dms_present_clock.h"
+#include <math.h>
+#include <string.h>
+
+static const int kResyncFrames = 2;   // 默认重同步阈值的帧数
+
+/**
+ * @brief 初始化媒体时钟：媒体时间0，速率1，不走时
+ * @param clock 媒体时钟
+ */
+void dms_media_clock_init(struct DmsMediaClock* clock) {
+    clock->anchorSysUs = 0;
+    clock->anchorMediaUs = 0;
+    clock->rate = 1.0f;
+    clock->running = false;
+}
+
+/**
+ * @brief 设置当前媒体时间（跳转、重同步），速率与走时状态不变
+ * @param clock 媒体时钟
+ * @param mediaUs 媒体时间（微秒）
+ * @param sysUs 当前系统时刻（微秒）
+ */
+void dms_media_clock_reset(struct DmsMediaClock* clock, int64_t mediaUs, int64_t sysUs) {
+    clock->anchorSysUs = sysUs;
+    clock->anchorMediaUs = mediaUs;
+}
+
+/**
+ * @brief 开始/停止走时，停止时媒体时间停在当前时刻
+ * @param clock 媒体时钟
+ * @param running 是否走时
+ * @param sysUs 当前系统时刻（微秒）
+ */
+void dms_media_clock_set_running(struct DmsMediaClock* clock, bool running, int64_t sysUs) {
+    if (clock->running == running) {
+        return;
+    }
+    clock->anchorMediaUs = dms_media_clock_get(clock, sysUs);
+    clock->anchorSysUs = sysUs;
+    clock->running = running;
+}
+
+/**
+ * @brief 改变速率，以当前时刻为新锚点，媒体时间连续
+ * @param clock 媒体时钟
+ * @param rate 速率，1为正常速度，负数倒放，0冻结
+ * @param sysUs 当前系统时刻（微秒）
+ */
+void dms_media_clock_set_rate(struct DmsMediaClock* clock, float rate, int64_t sysUs) {
+    clock->anchorMediaUs = dms_media_clock_get(clock, sysUs);
+    clock->anchorSysUs = sysUs;
+    clock->rate = rate;
+}
+
+/**
+ * @brief 系统时刻对应的媒体时间
+ * @param clock 媒体时钟
+ * @param sysUs 系统时刻（微秒）
+ * @return 媒体时间（微秒），不走时为停止时的媒体时间
+ */
+int64_t dms_media_clock_get(const struct DmsMediaClock* clock, int64_t sysUs) {
+    if (!clock->running) {
+        return clock->anchorMediaUs;
+    }
+    return clock->anchorMediaUs + (int64_t)llround((double)(sysUs - clock->anchorSysUs) * clock->rate);
+}
+
+/**
+ * @brief 媒体时间对应的系统时刻
+ * @param clock 媒体时钟
+ * @param mediaUs 媒体时间（微秒）
+ * @return 系统时刻（微秒），不走时或速率为0时返回-1
+ */
+int64_t dms_media_clock_due(const struct DmsMediaClock* clock, int64_t mediaUs) {
+    if (!clock->running || clock->rate == 0.0f) {
+        return -1;
+    }
+    return clock->anchorSysUs + (int64_t)llround((double)(mediaUs - clock->anchorMediaUs) / clock->rate);
+}
+
+/**
+ * @brief 帧在系统时间上的时长：媒体时长按速率缩放
+ * @param scheduler 显示调度器
+ * @param durationUs 帧的媒体时长（微秒）
+ * @return 系统时长（微秒），至少为1
+ */
+static int64_t system_period(const struct DmsFrameScheduler* scheduler, int64_t durationUs) {
+    float rate = fabsf(scheduler->clock.rate);
+    int64_t period = rate > 0.0f ? (int64_t)llround((double)durationUs / rate) : durationUs;
+    return period > 0 ? period : 1;
+}
+
+/**
+ * @brief 统计截至指定时刻因没有新帧而重复显示上一帧的次数：
+ *        上一帧在应被接替的时刻之后每多显示一帧时长计一次
+ * @param scheduler 显示调度器
+ * @param nowUs 当前系统时刻（微秒）
+ * @return 新增的重复次数
+ */
+static int64_t count_repeats(struct DmsFrameScheduler* scheduler, int64_t nowUs) {
+    if (scheduler->repeatMarkUs < 0 || nowUs < scheduler->repeatMarkUs + scheduler->periodUs) {
+        return 0;
+    }
+    int64_t count = (nowUs - scheduler->repeatMarkUs) / scheduler->periodUs;
+    scheduler->repeatMarkUs += count * scheduler->periodUs;
+    scheduler->stats.repeated += count;
+    return count;
+}
+
+/**
+ * @brief 重置调度器与统计，时钟停止、速率为1
+ * @param scheduler 显示调度器
+ * @param config 调度配置，为空时丢弃落后帧并使用默认阈值
+ */
+void dms_frame_scheduler_reset(struct DmsFrameScheduler* scheduler, const struct DmsPaceConfig* config) {
+    memset(scheduler, 0, sizeof(*scheduler));
+    dms_media_clock_init(&scheduler->clock);
+    if (config) {
+        scheduler->config = *config;
+    } else {
+        scheduler->config.dropLate = true;
+    }
+    scheduler->anchored = false;
+    scheduler->repeatMarkUs = -1;
+}
+
+/**
+ * @brief 开始播放：时钟走时，并以下一帧的时间戳重新对齐
+ * @param scheduler 显示调度器
+ * @param nowUs 当前系统时刻（微秒）
+ */
+void dms_frame_scheduler_start(struct DmsFrameScheduler* scheduler, int64_t nowUs) {
+    dms_media_clock_set_running(&scheduler->clock, true, nowUs);
+    dms_frame_scheduler_flush(scheduler);
+}
+
+/**
+ * @brief 暂停：时钟停止，暂停期间不计重复显示
+ * @param scheduler 显示调度器
+ * @param nowUs 当前系统时刻（微秒）
+ */
+void dms_frame_scheduler_pause(struct DmsFrameScheduler* scheduler, int64_t nowUs) {
+    count_repeats(scheduler, nowUs);
+    dms_media_clock_set_running(&scheduler->clock, false, nowUs);
+    scheduler->repeatMarkUs = -1;
+}
+
+/**
+ * @brief 跳转：以下一帧的时间戳重新对齐时钟，跳转期间不计重复显示
+ * @param scheduler 显示调度器
+ */
+void dms_frame_scheduler_flush(struct DmsFrameScheduler* scheduler) {
+    scheduler->anchored = false;
+    scheduler->repeatMarkUs = -1;
+}
+
+/**
+ * @brief 改变播放速率，媒体时间连续，之后的帧按新速率放行
+ * @param scheduler 显示调度器
+ * @param rate 速率，1为正常速度，负数倒放（帧时间戳递减），0冻结
+ * @param nowUs 当前系统时刻（微秒）
+ */
+void dms_frame_scheduler_set_rate(struct DmsFrameScheduler* scheduler, float rate, int64_t nowUs) {
+    count_repeats(scheduler, nowUs);
+    dms_media_clock_set_rate(&scheduler->clock, rate, nowUs);
+    if (scheduler->repeatMarkUs >= 0) {
+        scheduler->periodUs = system_period(scheduler, scheduler->durationUs);
+    }
+}
+
+/**
+ * @brief 按计划显示时刻判断动作：未到时等待，落后超过丢帧阈值且已有后续帧时丢弃
+ * @param scheduler 显示调度器
+ * @param durationUs 帧的媒体时长（微秒）
+ * @param dueUs 计划显示时刻（微秒）
+ * @param hasNext 是否已有后续帧可显示
+ * @param nowUs 当前系统时刻（微秒）
+ * @return DmsPaceAction
+ */
+static int pace_action(struct DmsFrameScheduler* scheduler, int64_t durationUs, int64_t dueUs, bool hasNext,
+                       int64_t nowUs) {
+    if (nowUs < dueUs) {
+        return DMS_PACE_WAIT;
+    }
+    int64_t lateUs = nowUs - dueUs;
+    int64_t dropUs = scheduler->config.dropThresholdUs > 0 ? scheduler->config.dropThresholdUs
+                                                           : system_period(scheduler, durationUs);
+    if (scheduler->config.dropLate && lateUs > dropUs && hasNext) {
+        scheduler->stats.dropped++;
+        return DMS_PACE_DROP;
+    }
+    return DMS_PACE_PRESENT;
+}
+
+/**
+ * @brief 判断队首帧的动作。未对齐时以该帧对齐时钟；未到显示时刻时等待；
+ *        落后超过丢帧阈值且已有后续帧时丢弃；落后超过重同步阈值时把时钟拨回该帧后显示
+ * @param scheduler 显示调度器
+ * @param timeUs 帧的时间戳（微秒）
+ * @param durationUs 帧的媒体时长（微秒）
+ * @param hasNext 是否已有后续帧可显示
+ * @param nowUs 当前系统时刻（微秒）
+ * @param outDueUs 输出该帧的计划显示时刻，时钟不走时为-1
+ * @return DmsPaceAction
+ */
+int dms_frame_scheduler_decide(struct DmsFrameScheduler* scheduler, int64_t timeUs, int64_t durationUs,
+                               bool hasNext, int64_t nowUs, int64_t* outDueUs) {
+    *outDueUs = -1;
+    if (!scheduler->clock.running || scheduler->clock.rate == 0.0f) {
+        return DMS_PACE_WAIT;
+    }
+    if (!scheduler->anchored) {
+        dms_media_clock_reset(&scheduler->clock, timeUs, nowUs);
+        scheduler->anchored = true;
+    }
+    int64_t dueUs = dms_media_clock_due(&scheduler->clock, timeUs);
+    *outDueUs = dueUs;
+    int action = pace_action(scheduler, durationUs, dueUs, hasNext, nowUs);
+    if (action != DMS_PACE_PRESENT) {
+        return action;
+    }
+    int64_t resyncUs = scheduler->config.resyncThresholdUs > 0 ? scheduler->config.resyncThresholdUs
+                                                               : kResyncFrames * system_period(scheduler, durationUs);
+    if (nowUs - dueUs > resyncUs) {
+        // 跟不上且无帧可丢：从该帧重新计时，画面放慢而不是随后加速追赶
+        dms_media_clock_reset(&scheduler->clock, timeUs, nowUs);
+        scheduler->stats.resyncs++;
+    }
+    return DMS_PACE_PRESENT;
+}
+
+/**
+ * @brief 按外部给出的显示时刻（如按刷新节奏排定的时刻）判断队首帧的动作，媒体时钟随之对齐到该帧，
+ *        落后时由外部重新排定，不拨回时钟
+ * @param scheduler 显示调度器
+ * @param timeUs 帧的时间戳（微秒）
+ * @param durationUs 帧的媒体时长（微秒）
+ * @param dueUs 计划显示时刻（微秒）
+ * @param hasNext 是否已有后续帧可显示
+ * @param nowUs 当前系统时刻（微秒）
+ * @return DmsPaceAction，时钟不走时为DMS_PACE_WAIT
+ */
+int dms_frame_scheduler_decide_at(struct DmsFrameScheduler* scheduler, int64_t timeUs, int64_t durationUs,
+                                  int64_t dueUs, bool hasNext, int64_t nowUs) {
+    if (!scheduler->clock.running || scheduler->clock.rate == 0.0f) {
+        return DMS_PACE_WAIT;
+    }
+    int action = pace_action(scheduler, durationUs, dueUs, hasNext, nowUs);
+    if (action == DMS_PACE_PRESENT) {
+        // 媒体时钟跟随实际排定的时刻，切回按时钟显示时不跳变
+        dms_media_clock_reset(&scheduler->clock, timeUs, dueUs);
+        scheduler->anchored = true;
+    }
+    return action;
+}
+
+/**
+ * @brief 记录帧已显示：统计延后与抖动，结算此前的重复显示，下一帧应在一帧时长后接替
+ * @param scheduler 显示调度器
+ * @param durationUs 帧的媒体时长（微秒）
+ * @param dueUs dms_frame_scheduler_decide输出的计划显示时刻，-1表示暂停时显示的静止画面
+ * @param presentUs 实际显示的系统时刻（微秒）
+ */
+void dms_frame_scheduler_presented(struct DmsFrameScheduler* scheduler, int64_t durationUs, int64_t dueUs,
+                                   int64_t presentUs) {
+    struct DmsPaceStats* stats = &scheduler->stats;
+    stats->presented++;
+    if (dueUs < 0 || !scheduler->clock.running) {
+        return;
+    }
+    count_repeats(scheduler, presentUs);
+
+    // 按Welford算法累计延后的均值与方差
+    int64_t lateUs = presentUs - dueUs;
+    int64_t samples = ++scheduler->lateSamples;
+    double delta = (double)lateUs - stats->meanLateUs;
+    double mean = stats->meanLateUs + delta / (double)samples;
+    scheduler->lateM2 += delta * ((double)lateUs - mean);
+    stats->meanLateUs = (float)mean;
+    stats->jitterUs = samples > 1 ? (float)sqrt(scheduler->lateM2 / (double)(samples - 1)) : 0.0f;
+    if (lateUs > stats->maxLateUs) {
+        stats->maxLateUs = lateUs;
+    }
+
+    scheduler->durationUs = durationUs;
+    scheduler->periodUs = system_period(scheduler, durationUs);
+    // 下一帧应在一帧时长后接替；晚于计划的部分累计下来，满一帧时长即计一次重复显示
+    int64_t markUs = scheduler->repeatMarkUs;
+    scheduler->repeatMarkUs = (markUs < 0 || presentUs < markUs ? presentUs : markUs) + scheduler->periodUs;
+}
+
+/**
+ * @brief 播放中没有新帧可显示时调用：统计重复显示上一帧的次数
+ * @param scheduler 显示调度器
+ * @param nowUs 当前系统时刻（微秒）
+ * @param outNextUs 输出下一次计入重复的系统时刻，无需等待时为-1，可为空
+ * @return 新增的重复次数
+ */
+int64_t dms_frame_scheduler_poll_starved(struct DmsFrameScheduler* scheduler, int64_t nowUs, int64_t* outNextUs) {
+    int64_t count = scheduler->clock.running ? count_repeats(scheduler, nowUs) : 0;
+    if (outNextUs) {
+        *outNextUs = (scheduler->clock.running && scheduler->repeatMarkUs >= 0)
+                ? scheduler->repeatMarkUs + scheduler->periodUs : -1;
+    }
+    return count;
+}
+
+/**
+ * @brief 当前媒体时间
+ * @param scheduler 显示调度器
+ * @param nowUs 当前系统时刻（微秒）
+ * @return 媒体时间（微秒），尚未以帧对齐时返回-1
+ */
+int64_t dms_frame_scheduler_position(const struct DmsFrameScheduler* scheduler, int64_t nowUs) {
+    return scheduler->anchored ? dms_media_clock_get(&scheduler->clock, nowUs) : -1;
+}
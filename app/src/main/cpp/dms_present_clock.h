@@ -0,0 +1,110 @@
+#ifndef DMS_PRESENT_CLOCK_H
+#define DMS_PRESENT_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 媒体时钟与显示节奏调度
+ *
+ * 媒体时钟把单调的系统时刻（CLOCK_MONOTONIC，微秒）换算为媒体时间：以锚点（系统时刻，
+ * 媒体时间）为起点按速率走时，暂停时停在暂停时刻的媒体时间，改变速率时以当前时刻为新锚点，
+ * 媒体时间连续。
+ *
+ * 显示调度按媒体时钟在每帧的时间戳对应的系统时刻放行该帧：
+ *   - 开始播放与跳转后，以下一帧为锚点对齐时钟；
+ *   - 落后超过丢帧阈值（默认一帧时长）且已有后续帧时丢弃该帧；
+ *   - 落后超过重同步阈值（默认两帧时长）且无帧可丢时把时钟拨回该帧，画面放慢而不是随后加速追赶；
+ *   - 显示后没有新帧可显示（取帧或解码跟不上）时，每过一帧时长计为一次重复显示上一帧。
+ * 每帧显示后统计实际显示时刻与计划时刻之差（延后）的均值、标准差（抖动）与最大值。
+ *
+ * 所有函数都由调用者传入当前系统时刻，不读取时钟，可在Linux上用模拟时钟驱动。
+ * 调度器不加锁，由调用者串行访问。
+ */
+
+// 媒体时钟
+struct DmsMediaClock {
+    int64_t anchorSysUs;     // 锚点的系统时刻
+    int64_t anchorMediaUs;   // 锚点的媒体时间
+    float rate;              // 速率，1为正常速度，负数倒放，0冻结
+    bool running;            // 是否走时
+};
+
+// 调度动作
+enum DmsPaceAction {
+    DMS_PACE_WAIT = 0,       // 未到显示时刻（或时钟未走时），等待后再判断
+    DMS_PACE_PRESENT = 1,    // 显示该帧
+    DMS_PACE_DROP = 2,       // 落后超过阈值且已有后续帧，丢弃该帧
+};
+
+// 调度配置
+struct DmsPaceConfig {
+    bool dropLate;           // 是否丢弃落后帧，false时逐帧显示
+    int64_t dropThresholdUs; // 落后超过此值时丢弃（微秒），0为一帧时长
+    int64_t resyncThresholdUs; // 落后超过此值且无帧可丢时把时钟拨回该帧（微秒），0为两帧时长
+};
+
+// 调度统计信息
+struct DmsPaceStats {
+    int64_t presented;       // 显示的帧数
+    int64_t dropped;         // 丢弃的帧数
+    int64_t repeated;        // 没有新帧时重复显示上一帧的次数（按帧时长计）
+    int64_t resyncs;         // 把时钟拨回落后帧的次数
+    float meanLateUs;        // 显示延后的均值（微秒）
+    float jitterUs;          // 显示延后的标准差（微秒）
+    int64_t maxLateUs;       // 显示延后的最大值（微秒）
+};
+
+// 显示调度器
+struct DmsFrameScheduler {
+    struct DmsMediaClock clock;
+    struct DmsPaceConfig config;
+    bool anchored;           // 时钟已与帧对齐，开始播放与跳转后为false
+    int64_t repeatMarkUs;    // 最近显示帧应被接替的系统时刻（含已计入的重复），未显示为-1
+    int64_t durationUs;      // 最近显示帧的媒体时长
+    int64_t periodUs;        // 最近显示帧在系统时间上的时长
+    int64_t lateSamples;     // 参与延后统计的帧数（不含暂停时显示的静止画面）
+    double lateM2;           // 延后的方差累计量（Welford）
+    struct DmsPaceStats stats;
+};
+
+void dms_media_clock_init(struct DmsMediaClock* clock);             // 初始化：媒体时间0，速率1，不走时
+void dms_media_clock_reset(struct DmsMediaClock* clock, int64_t mediaUs,
+                           int64_t sysUs);                          // 设置当前媒体时间，速率与走时状态不变
+void dms_media_clock_set_running(struct DmsMediaClock* clock, bool running,
+                                 int64_t sysUs);                    // 开始/停止走时
+void dms_media_clock_set_rate(struct DmsMediaClock* clock, float rate,
+                              int64_t sysUs);                       // 改变速率，媒体时间连续
+int64_t dms_media_clock_get(const struct DmsMediaClock* clock, int64_t sysUs); // 系统时刻对应的媒体时间
+int64_t dms_media_clock_due(const struct DmsMediaClock* clock,
+                            int64_t mediaUs);                       // 媒体时间对应的系统时刻，不走时返回-1
+
+void dms_frame_scheduler_reset(struct DmsFrameScheduler* scheduler,
+                               const struct DmsPaceConfig* config); // 重置调度器与统计，时钟停止
+void dms_frame_scheduler_start(struct DmsFrameScheduler* scheduler, int64_t nowUs); // 开始播放，以下一帧对齐时钟
+void dms_frame_scheduler_pause(struct DmsFrameScheduler* scheduler, int64_t nowUs); // 暂停
+void dms_frame_scheduler_flush(struct DmsFrameScheduler* scheduler); // 跳转后以下一帧重新对齐时钟
+void dms_frame_scheduler_set_rate(struct DmsFrameScheduler* scheduler, float rate,
+                                  int64_t nowUs);                   // 改变播放速率
+int dms_frame_scheduler_decide(struct DmsFrameScheduler* scheduler, int64_t timeUs, int64_t durationUs,
+                               bool hasNext, int64_t nowUs,
+                               int64_t* outDueUs);                  // 判断帧的动作，返回DmsPaceAction
+int dms_frame_scheduler_decide_at(struct DmsFrameScheduler* scheduler, int64_t timeUs, int64_t durationUs,
+                                  int64_t dueUs, bool hasNext,
+                                  int64_t nowUs);                   // 按外部排定的显示时刻判断帧的动作
+void dms_frame_scheduler_presented(struct DmsFrameScheduler* scheduler, int64_t durationUs, int64_t dueUs,
+                                   int64_t presentUs);              // 记录帧已显示
+int64_t dms_frame_scheduler_poll_starved(struct DmsFrameScheduler* scheduler, int64_t nowUs,
+                                         int64_t* outNextUs);       // 没有新帧时统计重复显示，返回新增次数
+int64_t dms_frame_scheduler_position(const struct DmsFrameScheduler* scheduler,
+                                     int64_t nowUs);                // 当前媒体时间，未对齐返回-1
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_PRESENT_CLOCK_H
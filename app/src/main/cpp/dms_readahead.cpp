@@ -0,0 +1,239 @@
+#include "dms_readahead.h"
+#include "dms_player.h"
+#include "dms_log.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#define LOG_TAG "DmsReadahead"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int kReadChunk = 4;   // 每次持有libdms的最大读取数，避免长时间阻塞定位与索引补全
+
+struct ReadaheadItem {
+    DmsDataUnitPtr unit;
+    int64_t frame;
+};
+
+struct DmsReadahead {
+    DmsContext* ctx;
+    int capacity;
+    DmsReadaheadPrepareFun prepare;
+    void* user;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<ReadaheadItem> queue;
+    bool stopping;
+    bool finished;                   // 已读到结尾或出错
+    int error;
+
+    int64_t lastTakenPos;
+    int64_t lastTakenFrame;
+    int64_t bufferedBytes;
+    int64_t readFrames;
+    int64_t underruns;
+};
+
+static void reader_main(DmsReadahead* readahead) {
+    int prepared = readahead->prepare ? readahead->prepare(readahead->user) : 0;
+    std::unique_lock<std::mutex> lock(readahead->mutex);
+    if (prepared != 0) {
+        readahead->error = prepared;
+        readahead->finished = true;
+        readahead->cv.notify_all();
+        return;
+    }
+    while (true) {
+        readahead->cv.wait(lock, [readahead] {
+            return readahead->stopping || (int)readahead->queue.size() < readahead->capacity;
+        });
+        if (readahead->stopping) {
+            break;
+        }
+        int count = readahead->capacity - (int)readahead->queue.size();
+        count = count < kReadChunk ? count : kReadChunk;
+        lock.unlock();
+
+        DmsDataUnitPtr units[kReadChunk] = {};
+        int64_t frames[kReadChunk];
+        int got = 0;
+        int result = dms_player_fetch_frames(readahead->ctx, -1, count, units, frames, &got, nullptr);
+
+        lock.lock();
+        // 即使正在停止也先入队，退出时据此确定读取位置
+        for (int i = 0; i < got; i++) {
+            readahead->queue.push_back({units[i], frames[i]});
+            readahead->bufferedBytes += units[i]->Length;
+        }
+        readahead->readFrames += got;
+        if (got < count) {
+            readahead->error = result != DMS_RESULT_SUCCESS ? result : (int)DMS_RESULT_PLAY_FINISHED;
+            readahead->finished = true;
+        }
+        readahead->cv.notify_all();
+        if (readahead->finished) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 创建预读缓冲并从当前读取位置开始顺序预读
+ * @param ctx DMS播放器上下文指针
+ * @param capacityFrames 最多缓冲的帧数
+ * @param prepare 开始读取前在预读线程中执行的准备回调，可为空
+ * @param user 准备回调的用户数据
+ * @return 成功返回预读缓冲指针，失败返回NULL
+ */
+struct DmsReadahead* dms_readahead_create(struct DmsContext* ctx, int capacityFrames,
+                                         DmsReadaheadPrepareFun prepare, void* user) {
+    if (!ctx || capacityFrames <= 0) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+
+    DmsReadahead* readahead = new DmsReadahead();
+    readahead->ctx = ctx;
+    readahead->capacity = capacityFrames;
+    readahead->prepare = prepare;
+    readahead->user = user;
+    readahead->stopping = false;
+    readahead->finished = false;
+    readahead->error = DMS_RESULT_SUCCESS;
+    readahead->lastTakenPos = -1;
+    readahead->lastTakenFrame = -1;
+    readahead->bufferedBytes = 0;
+    readahead->readFrames = 0;
+    readahead->underruns = 0;
+    readahead->thread = std::thread(reader_main, readahead);
+    return readahead;
+}
+
+/**
+ * @brief 停止预读并释放缓冲
+ * @param readahead 预读缓冲
+ * @param outCursor 输出应恢复的读取位置，可为空
+ */
+void dms_readahead_destroy(struct DmsReadahead* readahead, struct DmsReadaheadCursor* outCursor) {
+    if (outCursor) {
+        outCursor->nextFrame = -1;
+        outCursor->nextPos = -1;
+        outCursor->lastPos = -1;
+        outCursor->lastFrame = -1;
+    }
+    if (!readahead) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(readahead->mutex);
+        readahead->stopping = true;
+    }
+    readahead->cv.notify_all();
+    if (readahead->thread.joinable()) {
+        readahead->thread.join();
+    }
+
+    if (outCursor) {
+        outCursor->lastPos = readahead->lastTakenPos;
+        outCursor->lastFrame = readahead->lastTakenFrame;
+    }
+    if (outCursor && !readahead->queue.empty()) {
+        outCursor->nextFrame = readahead->queue.front().frame;
+        outCursor->nextPos = readahead->queue.front().unit->Pos;
+    }
+    for (ReadaheadItem& item : readahead->queue) {
+        _dms_free_data_unit(&item.unit);
+    }
+    LOGI("Readahead stopped: %lld frames read, %lld underruns",
+         (long long)readahead->readFrames, (long long)readahead->underruns);
+    delete readahead;
+}
+
+/**
+ * @brief 取下一帧，缓冲为空时等待后台读取
+ * @param readahead 预读缓冲
+ * @param outUnit 输出数据单元，使用后由调用者通过_dms_free_data_unit释放
+ * @param outFrame 输出帧号，未知为-1
+ * @return 正确返回DMS_RESULT_SUCCESS，读到结尾或出错时返回读取时的错误码
+ */
+int dms_readahead_next(struct DmsReadahead* readahead, DmsDataUnitPtr* outUnit, int64_t* outFrame) {
+    if (!readahead || !outUnit || !outFrame) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outUnit = nullptr;
+    *outFrame = -1;
+
+    std::unique_lock<std::mutex> lock(readahead->mutex);
+    if (readahead->queue.empty() && !readahead->finished) {
+        readahead->underruns++;
+        readahead->cv.wait(lock, [readahead] { return !readahead->queue.empty() || readahead->finished; });
+    }
+    if (readahead->queue.empty()) {
+        return readahead->error;
+    }
+
+    ReadaheadItem item = readahead->queue.front();
+    readahead->queue.pop_front();
+    readahead->bufferedBytes -= item.unit->Length;
+    readahead->lastTakenPos = item.unit->Pos;
+    readahead->lastTakenFrame = item.frame;
+    readahead->cv.notify_all();
+    *outUnit = item.unit;
+    *outFrame = item.frame;
+    return DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 等待缓冲达到指定帧数（或读到结尾、超时）
+ * @param readahead 预读缓冲
+ * @param frames 目标帧数，超过容量时按容量
+ * @param timeoutUs 超时（微秒）
+ * @return 当前缓冲帧数，参数错误返回-1
+ */
+int dms_readahead_wait(struct DmsReadahead* readahead, int frames, int64_t timeoutUs) {
+    if (!readahead) {
+        return -1;
+    }
+    frames = frames < readahead->capacity ? frames : readahead->capacity;
+    std::unique_lock<std::mutex> lock(readahead->mutex);
+    readahead->cv.wait_for(lock, std::chrono::microseconds(timeoutUs), [readahead, frames] {
+        return (int)readahead->queue.size() >= frames || readahead->finished;
+    });
+    return (int)readahead->queue.size();
+}
+
+/**
+ * @brief 查询后台读取是否已结束（读到结尾或出错），缓冲中可能仍有未取出的帧
+ * @param readahead 预读缓冲
+ * @return 已结束返回结束原因（错误码），仍在读取返回DMS_RESULT_SUCCESS，参数错误返回-1
+ */
+int dms_readahead_end_result(struct DmsReadahead* readahead) {
+    if (!readahead) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(readahead->mutex);
+    return readahead->finished ? readahead->error : (int)DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 获取预读统计信息
+ * @param readahead 预读缓冲
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回-1
+ */
+int dms_readahead_get_stats(struct DmsReadahead* readahead, struct DmsReadaheadStats* outStats) {
+    if (!readahead || !outStats) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(readahead->mutex);
+    outStats->bufferedFrames = (int32_t)readahead->queue.size();
+    outStats->bufferedBytes = readahead->bufferedBytes;
+    outStats->readFrames = readahead->readFrames;
+    outStats->underruns = readahead->underruns;
+    return 0;
+}
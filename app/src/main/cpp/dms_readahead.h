@@ -0,0 +1,66 @@
+#ifndef DMS_READAHEAD_H
+#define DMS_READAHEAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "libdms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 正向预读缓冲
+ *
+ * 正常速度播放时由后台线程从当前读取位置起顺序读取数据单元放入队列，
+ * 取帧直接从队列取出，读取耗时的抖动被缓冲吸收。退出预读时报告第一个
+ * 未取出的数据单元，播放器据此把读取位置移回，不丢帧也不重复。
+ *
+ * 可指定准备回调，在后台线程开始读取前执行（例如切换到下一分本），
+ * 其耗时与当前缓冲的消耗重叠。
+ */
+
+struct DmsContext;
+
+// 预读统计信息
+struct DmsReadaheadStats {
+    int32_t bufferedFrames;  // 当前缓冲帧数
+    int64_t bufferedBytes;   // 当前缓冲数据量（字节）
+    int64_t readFrames;      // 已读取的帧数
+    int64_t underruns;       // 取帧时缓冲为空、需等待读取的次数
+};
+
+// 退出预读时的读取位置
+struct DmsReadaheadCursor {
+    int64_t nextFrame;       // 第一个未取出单元的帧号，未知为-1
+    int64_t nextPos;         // 第一个未取出单元的Pos，缓冲为空时为-1（读取位置已在下一帧，无需移动）
+    int64_t lastPos;         // 最近取出单元的Pos，未取出过为-1
+    int64_t lastFrame;       // 最近取出单元的帧号，未取出过或未知为-1
+};
+
+/**
+ * @brief 准备回调，在预读线程开始读取前执行
+ * @param user 用户数据
+ * @return 成功返回0，失败返回错误码（预读随即以该错误结束）
+ */
+typedef int (*DmsReadaheadPrepareFun)(void* user);
+
+struct DmsReadahead;
+
+struct DmsReadahead* dms_readahead_create(struct DmsContext* ctx, int capacityFrames,
+                                         DmsReadaheadPrepareFun prepare, void* user); // 创建并从当前读取位置开始预读
+void dms_readahead_destroy(struct DmsReadahead* readahead,
+                           struct DmsReadaheadCursor* outCursor);      // 停止预读，输出应恢复的读取位置
+int dms_readahead_next(struct DmsReadahead* readahead, DmsDataUnitPtr* outUnit,
+                       int64_t* outFrame);                             // 取下一帧，缓冲为空时等待
+int dms_readahead_wait(struct DmsReadahead* readahead, int frames,
+                       int64_t timeoutUs);                             // 等待缓冲达到指定帧数，返回当前缓冲帧数
+int dms_readahead_end_result(struct DmsReadahead* readahead);          // 读取已结束时返回结束原因，仍在读取返回DMS_RESULT_SUCCESS
+int dms_readahead_get_stats(struct DmsReadahead* readahead,
+                            struct DmsReadaheadStats* outStats);       // 获取统计信息
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_READAHEAD_H
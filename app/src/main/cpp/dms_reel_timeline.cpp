@@ -0,0 +1,164 @@
+#include "dms_reel_timeline.h"
+#include <string.h>
+
+/**
+ * @brief 按已知与估算帧数重新排列各分本的起始帧：
+ *        未知分本平分片长减去已知分本后的剩余帧数，且不少于已确认存在的帧数
+ * @param timeline 时间轴
+ */
+static void relayout(struct DmsReelTimeline* timeline) {
+    int64_t exactFrames = 0;
+    int unknown = 0;
+    for (int i = 0; i < timeline->reelCount; i++) {
+        if (timeline->reels[i].exact) {
+            exactFrames += timeline->reels[i].frameCount;
+        } else {
+            unknown++;
+        }
+    }
+
+    int64_t share = timeline->defaultFrames;
+    if (timeline->durationFrames > exactFrames && unknown > 0) {
+        share = (timeline->durationFrames - exactFrames) / unknown;
+    }
+
+    int64_t start = 0;
+    for (int i = 0; i < timeline->reelCount; i++) {
+        struct DmsReelSpan* span = &timeline->reels[i];
+        if (!span->exact) {
+            span->frameCount = share > span->knownFrames ? share : span->knownFrames;
+        }
+        span->startFrame = start;
+        start += span->frameCount;
+    }
+    timeline->totalFrames = start;
+}
+
+/**
+ * @brief 按分本数量初始化时间轴，各分本帧数待定
+ * @param timeline 时间轴
+ * @param reelCount 分本数量
+ * @param firstNumber 第一个分本在libdms中的编号
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_reel_timeline_init(struct DmsReelTimeline* timeline, int reelCount, int firstNumber) {
+    if (!timeline || reelCount <= 0 || reelCount > DMS_REEL_MAX) {
+        return -1;
+    }
+    memset(timeline, 0, sizeof(*timeline));
+    timeline->reelCount = reelCount;
+    timeline->firstNumber = firstNumber;
+    return 0;
+}
+
+/**
+ * @brief 清空时间轴
+ * @param timeline 时间轴
+ */
+void dms_reel_timeline_reset(struct DmsReelTimeline* timeline) {
+    if (timeline) {
+        memset(timeline, 0, sizeof(*timeline));
+    }
+}
+
+/**
+ * @brief 记录分本已知帧数并重排起始帧
+ * @param timeline 时间轴
+ * @param reel 分本序号（从0开始）
+ * @param frames 帧数
+ * @param exact 为true时frames为分本实际总帧数，否则只表示至少有这么多帧
+ */
+void dms_reel_timeline_set_known(struct DmsReelTimeline* timeline, int reel, int64_t frames, bool exact) {
+    if (!timeline || reel < 0 || reel >= timeline->reelCount || frames < 0) {
+        return;
+    }
+    struct DmsReelSpan* span = &timeline->reels[reel];
+    if (span->exact) {
+        return;
+    }
+    if (exact) {
+        span->exact = true;
+        span->frameCount = frames;
+        span->knownFrames = frames;
+    } else if (frames > span->knownFrames) {
+        span->knownFrames = frames;
+    }
+    relayout(timeline);
+}
+
+/**
+ * @brief 按片长估算帧数未知的分本并重排起始帧
+ * @param timeline 时间轴
+ * @param durationFrames 片长折算的总帧数，未知填0
+ * @param frameRate 帧率，片长未知时按每本DMS_REEL_DEFAULT_SECONDS估算
+ */
+void dms_reel_timeline_estimate(struct DmsReelTimeline* timeline, int64_t durationFrames, float frameRate) {
+    if (!timeline) {
+        return;
+    }
+    timeline->durationFrames = durationFrames > 0 ? durationFrames : 0;
+    timeline->defaultFrames = (int64_t)(DMS_REEL_DEFAULT_SECONDS * (frameRate > 0 ? frameRate : 24.0f));
+    relayout(timeline);
+}
+
+/**
+ * @brief 全局帧号映射为分本与分本内帧号；超出末尾时落在最后一个分本
+ * @param timeline 时间轴
+ * @param frame 全局帧号
+ * @param outReel 输出分本序号
+ * @param outLocal 输出分本内帧号
+ * @return 成功返回0，参数错误或时间轴未建立返回-1
+ */
+int dms_reel_timeline_locate(const struct DmsReelTimeline* timeline, int64_t frame, int* outReel, int64_t* outLocal) {
+    if (!timeline || !outReel || !outLocal || frame < 0 || timeline->reelCount <= 0) {
+        return -1;
+    }
+    // 分本数量很少，线性查找即可
+    int reel = timeline->reelCount - 1;
+    for (int i = 0; i < timeline->reelCount; i++) {
+        const struct DmsReelSpan* span = &timeline->reels[i];
+        if (frame < span->startFrame + span->frameCount) {
+            reel = i;
+            break;
+        }
+    }
+    *outReel = reel;
+    *outLocal = frame - timeline->reels[reel].startFrame;
+    return 0;
+}
+
+/**
+ * @brief 分本起始帧号
+ * @param timeline 时间轴
+ * @param reel 分本序号
+ * @return 起始帧号，时间轴未建立或序号无效返回0
+ */
+int64_t dms_reel_timeline_start(const struct DmsReelTimeline* timeline, int reel) {
+    if (!timeline || reel < 0 || reel >= timeline->reelCount) {
+        return 0;
+    }
+    return timeline->reels[reel].startFrame;
+}
+
+/**
+ * @brief 分本帧数（可能为估算值，见DmsReelSpan::exact）
+ * @param timeline 时间轴
+ * @param reel 分本序号
+ * @return 帧数，时间轴未建立或序号无效返回-1
+ */
+int64_t dms_reel_timeline_count(const struct DmsReelTimeline* timeline, int reel) {
+    if (!timeline || reel < 0 || reel >= timeline->reelCount) {
+        return -1;
+    }
+    return timeline->reels[reel].frameCount;
+}
+
+/**
+ * @brief 分本在libdms中的编号，用于_dms_select_reel
+ * @param timeline 时间轴
+ * @param reel 分本序号
+ * @return 编号
+ */
+int dms_reel_timeline_number(const struct DmsReelTimeline* timeline, int reel) {
+    return timeline ? timeline->firstNumber + reel : reel;
+}
@@ -0,0 +1,57 @@
+#ifndef DMS_REEL_TIMELINE_H
+#define DMS_REEL_TIMELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 多分本统一时间轴
+ *
+ * libdms 同一时刻只读取一个分本（_dms_select_reel），Pos 与帧号都是分本内的。
+ * 时间轴记录每个分本在整部影片中的起始帧与帧数，把全局帧号映射为（分本, 分本内帧号）。
+ * 分本帧数优先取完整帧索引或读到分本结尾时的实际值，未知时按影片时长估算，
+ * 实际值确定后后续分本的起始帧随之修正。
+ */
+
+#define DMS_REEL_MAX 64
+#define DMS_REEL_DEFAULT_SECONDS 1200    // 既无索引也无片长时按每本20分钟估算
+
+// 单个分本
+struct DmsReelSpan {
+    int64_t startFrame;      // 在整部影片中的起始帧号
+    int64_t frameCount;      // 帧数
+    int64_t knownFrames;     // 已确认存在的帧数（索引覆盖或已读取），估算不小于此值
+    bool exact;              // frameCount为实际帧数
+};
+
+struct DmsReelTimeline {
+    int32_t reelCount;       // 分本数量，0表示未建立（按单分本处理）
+    int32_t firstNumber;     // 第一个分本在libdms中的编号
+    int64_t totalFrames;     // 整部影片帧数（含估算）
+    int64_t durationFrames;  // 按片长折算的总帧数，未知为0
+    int64_t defaultFrames;   // 片长未知时每个分本的估算帧数
+    struct DmsReelSpan reels[DMS_REEL_MAX];
+};
+
+int dms_reel_timeline_init(struct DmsReelTimeline* timeline, int reelCount,
+                           int firstNumber);                           // 按分本数量初始化，帧数待定
+void dms_reel_timeline_reset(struct DmsReelTimeline* timeline);       // 清空
+void dms_reel_timeline_set_known(struct DmsReelTimeline* timeline, int reel,
+                                 int64_t frames, bool exact);          // 记录分本已知帧数，exact为实际总帧数
+void dms_reel_timeline_estimate(struct DmsReelTimeline* timeline, int64_t durationFrames,
+                                float frameRate);                      // 按片长估算未知分本并重排起始帧
+int dms_reel_timeline_locate(const struct DmsReelTimeline* timeline, int64_t frame,
+                             int* outReel, int64_t* outLocal);         // 全局帧号 → 分本与分本内帧号
+int64_t dms_reel_timeline_start(const struct DmsReelTimeline* timeline, int reel); // 分本起始帧号
+int64_t dms_reel_timeline_count(const struct DmsReelTimeline* timeline, int reel); // 分本帧数，未建立返回-1
+int dms_reel_timeline_number(const struct DmsReelTimeline* timeline, int reel);    // 分本在libdms中的编号
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_REEL_TIMELINE_H
@@ -0,0 +1,1089 @@
+#include "dms_renderer.h"
+#include "dms_player.h"
+#include "dms_decode_pipeline.h"
+#include "dms_color.h"
+#include "dms_scaler.h"
+#include "dms_video_sink.h"
+#include "dms_frame_cache.h"
+#include "dms_codestream_ring.h"
+#include "dms_present_clock.h"
+#include "dms_cadence.h"
+#include "dms_stereo.h"
+#include "dms_log.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define LOG_TAG "DmsRenderer"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int kSlotCount = 3;
+static const float kEwmaAlpha = 0.1f;
+static const int kAheadFrames = 24;    // 暂停时最多预先解码的帧数，另受缓存容量一半的限制
+
+// RGB帧槽
+struct RenderSlot {
+    std::vector<uint32_t> pixels;    // 帧序列立体时依次为左、右眼图像
+    int32_t width;
+    int32_t height;
+    int32_t eyes;            // pixels中的眼图像数，帧序列立体为2，其余为1
+    int32_t fields;          // 每帧时长内依次提交的眼图像数（DmsStereoMode），其余为1
+    int64_t timeUs;
+    int64_t durationUs;
+    int64_t fetchUs;         // 开始取帧的墙钟时刻，用于统计端到端耗时
+};
+
+struct DmsRenderer {
+    DmsContext* ctx;
+    DmsVideoSink* sink;
+    DmsRendererConfig config;
+    DmsColorConverter* converter;      // 仅生产线程访问
+    int32_t converterPrecision;
+    DmsColorLut* lut;                  // 3D LUT，无为空，仅生产线程访问
+    DmsScaler* scaler;                 // 缩放到输出尺寸并加黑边，按源尺寸（重）建，仅生产线程访问
+    int32_t scalerWidth;               // 缩放器的源尺寸
+    int32_t scalerHeight;
+    int32_t scalerBoxWidth;            // 缩放器的目标宽度（左右并排时为半屏）与水平压缩倍数
+    int32_t scalerSqueeze;
+    int32_t stereoMode;                // 立体输出方式，仅生产线程访问
+    int64_t scaledFrames;              // 以下各项仅生产线程更新，取帧后复制到统计信息
+    int64_t unscaledFrames;
+    int64_t stereoFrames;
+    int64_t missingEyeFrames;
+    RenderSlot slots[kSlotCount];
+    std::thread producer;
+    std::thread presenter;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<int> ready;             // 待显示的帧槽，按显示顺序
+    std::vector<int> freeSlots;
+    bool stopping;
+    bool playing;
+    bool showStill;                    // 暂停时仍显示下一帧（首帧与跳转后的画面）
+    int64_t seekTargetUs;              // 待执行的跳转位置，无为-1
+    uint64_t epoch;                    // 每次跳转加一，转换中的帧据此判断是否已作废
+    int32_t endResult;                 // 生产线程结束取帧的原因，仍在取帧时为DMS_RESULT_SUCCESS
+    DmsFrameScheduler scheduler;       // 显示调度：媒体时钟、丢帧与重复显示统计
+    DmsCadence cadence;                // 屏幕刷新节奏，未设置刷新率时patternFrames为0
+    float frameRate;                   // 影片帧率，用于由时间戳换算帧号
+    int64_t shownFrame;                // 最近提交的帧号，开始播放、跳转后为-1
+    int64_t shownUs;                   // 最近一帧提交完成的时刻
+    int64_t prevShownFrame;            // 再前一次提交的帧号，无为-1
+    int64_t playRequestUs;             // 最近一次开始播放的墙钟时刻，首帧显示后为-1
+    int64_t seekRequestUs;             // 最近一次跳转请求的墙钟时刻，目标帧显示后为-1
+    int64_t lastLateUs;                // 最近一帧显示的延后，生产线程上报给解码质量策略
+    int32_t adaptiveRequest;           // 待执行的自适应解码质量开关，无为-1
+    int32_t trimRequest;               // 待执行的内存警告等级，无为-1
+    int32_t stereoRequest;             // 待执行的立体输出方式，无为-1
+    bool lutPending;                   // 有待生效的3D LUT
+    DmsColorLut* lutRequest;           // 待生效的3D LUT，为空表示取消LUT
+
+    // 以下仅生产线程访问
+    DmsFrameCache* cache;              // 解码帧缓存，关闭时为空
+    RenderSlot aheadSlot;              // 暂停时预解码帧的转换缓冲
+    int64_t wantFrame;                 // 下一个应送显的帧号，未知为-1
+    int64_t playerFrame;               // 播放器下一次取出的帧号，未知为-1
+    int32_t cacheReduce;               // 最近一帧全质量解码的分辨率层，作为查询缓存的键，未知为-1
+    int64_t aheadBlocked;              // 预解码失败（流结束）的帧号，跳转前不再预解码，无为-1
+
+    int64_t startWallUs;
+    int64_t startCpuUs;
+    DmsRendererStats stats;
+    DmsDecodePipelineStats decodeStats; // 生产线程取帧后复制的并行解码统计
+    bool decodeStatsValid;             // 已开始并行解码
+};
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+// 进程占用的CPU时间，包括解码线程
+static int64_t process_cpu_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static void ewma_update(float* value, float sample) {
+    *value = (*value <= 0.0f) ? sample : *value + kEwmaAlpha * (sample - *value);
+}
+
+/**
+ * @brief 当前的立体输出方式：2D素材按只显示左眼处理
+ * @param renderer 渲染器
+ * @return DmsStereoMode
+ */
+static int stereo_layout(const DmsRenderer* renderer) {
+    return renderer->ctx->stereo ? renderer->stereoMode : DMS_STEREO_LEFT_ONLY;
+}
+
+/**
+ * @brief 把一只眼（或2D帧）的解码图像写入目标区域。未设置输出尺寸时按源尺寸转换；否则按源尺寸、
+ *        目标宽度与压缩倍数（重）建缩放器，缩放、转换与加黑边一次完成
+ * @param renderer 渲染器
+ * @param picture 解码图像
+ * @param boxWidth 目标区域宽度，0为按源尺寸
+ * @param boxHeight 目标区域高度
+ * @param squeeze 水平压缩倍数，半宽左右并排为2
+ * @param out 目标区域左上角
+ * @param stride 目标行跨度（字节）
+ * @return 成功返回0，失败返回错误码
+ */
+static int convert_eye(DmsRenderer* renderer, const DmsPicture* picture, int32_t boxWidth, int32_t boxHeight,
+                       int32_t squeeze, uint32_t* out, int32_t stride) {
+    if (!renderer->converter || renderer->converterPrecision != picture->precision) {
+        dms_color_destroy(renderer->converter);
+        DmsColorConfig config = {renderer->config.colorSpace, renderer->config.format, picture->precision,
+                                 DMS_COLOR_KERNEL_AUTO, renderer->lut};
+        renderer->converter = dms_color_create(&config);
+        renderer->converterPrecision = picture->precision;
+        if (!renderer->converter) {
+            return -3;
+        }
+    }
+    if (boxWidth <= 0 || boxHeight <= 0) {
+        return dms_color_convert(renderer->converter, picture, 0, picture->height, out, stride);
+    }
+    DmsScaler* scaler = renderer->scaler;
+    if (!scaler || renderer->scalerWidth != picture->width || renderer->scalerHeight != picture->height ||
+        renderer->scalerBoxWidth != boxWidth || renderer->scalerSqueeze != squeeze) {
+        dms_scaler_destroy(scaler);
+        DmsScalerConfig config = {picture->width, picture->height, boxWidth, boxHeight, renderer->config.scaleFilter,
+                                  DMS_COLOR_KERNEL_AUTO, squeeze};
+        scaler = dms_scaler_create(&config);
+        renderer->scaler = scaler;
+        renderer->scalerWidth = picture->width;
+        renderer->scalerHeight = picture->height;
+        renderer->scalerBoxWidth = boxWidth;
+        renderer->scalerSqueeze = squeeze;
+        if (!scaler) {
+            return -3;
+        }
+    }
+    return dms_scaler_process(scaler, picture, renderer->converter, 0, boxHeight, out, stride);
+}
+
+/**
+ * @brief 把解码帧转换到帧槽，按输入位数（重）建转换器；设置了输出尺寸时缩放、转换与加黑边一次写入
+ *        输出尺寸的帧槽。立体素材按输出方式排布两眼：左右并排写入同一图像的左右两半（有输出尺寸时
+ *        每眼水平压缩一半），帧序列依次写入左右眼两幅图像；缺右眼时以左眼代替
+ * @param renderer 渲染器
+ * @param left 解码图像（立体素材为左眼）
+ * @param right 右眼图像，没有时为空或尺寸为0
+ * @param slot 帧槽
+ * @return 成功返回0，失败返回错误码
+ */
+static int convert_picture(DmsRenderer* renderer, const DmsPicture* left, const DmsPicture* right, RenderSlot* slot) {
+    int mode = stereo_layout(renderer);
+    const DmsPicture* second = left;
+    if (mode != DMS_STEREO_LEFT_ONLY) {
+        // 两眼尺寸不同（解码质量在两眼之间切换）时同样以左眼代替，保证两眼几何一致
+        if (right && right->width == left->width && right->height == left->height) {
+            second = right;
+            renderer->stereoFrames++;
+        } else {
+            renderer->missingEyeFrames++;
+        }
+    }
+    int32_t boxWidth = renderer->config.outputWidth;
+    int32_t boxHeight = renderer->config.outputHeight;
+    bool scaled = boxWidth > 0 && boxHeight > 0;
+    int32_t eyeWidth = scaled ? boxWidth : left->width;
+    int32_t eyeHeight = scaled ? boxHeight : left->height;
+    if (!scaled) {
+        boxWidth = 0;
+        boxHeight = 0;
+    }
+    slot->eyes = 1;
+    slot->fields = 1;
+    int result;
+    if (mode == DMS_STEREO_SIDE_BY_SIDE) {
+        // 有输出尺寸时为半宽并排（每眼占半屏、水平压缩一半），否则为全宽并排
+        int32_t squeeze = 1;
+        if (scaled) {
+            eyeWidth = boxWidth / 2;
+            boxWidth = eyeWidth;
+            squeeze = 2;
+        }
+        slot->width = eyeWidth * 2;
+        slot->height = eyeHeight;
+        slot->pixels.resize((size_t)slot->width * slot->height);
+        result = convert_eye(renderer, left, boxWidth, boxHeight, squeeze, slot->pixels.data(), slot->width * 4);
+        if (result == 0) {
+            result = convert_eye(renderer, second, boxWidth, boxHeight, squeeze, slot->pixels.data() + eyeWidth,
+                                 slot->width * 4);
+        }
+    } else {
+        slot->width = eyeWidth;
+        slot->height = eyeHeight;
+        if (mode == DMS_STEREO_FRAME_SEQUENTIAL || mode == DMS_STEREO_FRAME_SEQUENTIAL_DOUBLE) {
+            slot->eyes = 2;
+            slot->fields = dms_stereo_mode_fields(mode);
+        }
+        size_t eyePixels = (size_t)eyeWidth * eyeHeight;
+        slot->pixels.resize(eyePixels * slot->eyes);
+        result = convert_eye(renderer, left, boxWidth, boxHeight, 1, slot->pixels.data(), eyeWidth * 4);
+        if (result == 0 && slot->eyes > 1) {
+            result = convert_eye(renderer, second, boxWidth, boxHeight, 1, slot->pixels.data() + eyePixels,
+                                 eyeWidth * 4);
+        }
+    }
+    if (result == 0 && scaled) {
+        // 分辨率层恰好符合输出尺寸时缩放器直接转换源行
+        if (dms_scaler_is_identity(renderer->scaler)) {
+            renderer->unscaledFrames++;
+        } else {
+            renderer->scaledFrames++;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 把播放器定位到指定帧，失败时读取位置视为未知
+ * @param renderer 渲染器
+ * @param frame 帧号
+ */
+static void seek_player(DmsRenderer* renderer, int64_t frame) {
+    int result = dms_player_seek_frame(renderer->ctx, frame);
+    if (result != DMS_RESULT_SUCCESS) {
+        LOGE("Seek failed: 0x%08x", result);
+        renderer->wantFrame = -1;
+        renderer->playerFrame = -1;
+        return;
+    }
+    renderer->playerFrame = frame;
+}
+
+/**
+ * @brief 按帧号与当前分辨率层查询缓存
+ * @param renderer 渲染器
+ * @param frame 帧号
+ * @return 命中返回缓存帧，未命中返回NULL
+ */
+static const DmsCachedFrame* lookup_cache(DmsRenderer* renderer, int64_t frame) {
+    if (!renderer->cache || frame < 0 || renderer->cacheReduce < 0) {
+        return nullptr;
+    }
+    return dms_frame_cache_get(renderer->cache, frame, renderer->cacheReduce);
+}
+
+/**
+ * @brief 把已转换的解码帧放入缓存；降质解码的帧不放入，避免之后代替全质量帧显示
+ * @param renderer 渲染器
+ * @param frame 帧号
+ * @param picture 解码图像
+ * @param slot 已转换的帧槽
+ */
+static void store_cache(DmsRenderer* renderer, int64_t frame, const DmsPicture* picture, const RenderSlot* slot) {
+    if (picture->degraded) {
+        return;
+    }
+    renderer->cacheReduce = picture->reduce;
+    if (!renderer->cache || frame < 0) {
+        return;
+    }
+    // 帧序列立体的两眼上下相接存为一幅图像
+    DmsCachedFrame cached = {frame, picture->reduce, slot->width, slot->height * slot->eyes, slot->timeUs,
+                             slot->durationUs, slot->pixels.data()};
+    dms_frame_cache_put(renderer->cache, &cached);
+}
+
+/**
+ * @brief 从播放器取下一解码帧并转换到帧槽，下一应送显帧不在读取位置时先定位
+ * @param renderer 渲染器
+ * @param slot 帧槽
+ * @param outFrame 输出帧号，未知为-1
+ * @param outConvertUs 输出转换耗时（微秒）
+ * @return 成功返回0，转换失败返回-3，其他为取帧的错误码
+ */
+static int decode_to_slot(DmsRenderer* renderer, RenderSlot* slot, int64_t* outFrame, int64_t* outConvertUs) {
+    *outFrame = -1;
+    *outConvertUs = 0;
+    DmsFrame frame;
+    DmsPicture picture;
+    DmsPicture right;
+    int result = dms_player_next_stereo_picture(renderer->ctx, &frame, &picture, &right);
+    if (result != 0) {
+        return result;
+    }
+    slot->timeUs = frame.timeUs;
+    slot->durationUs = frame.durationUs;
+    *outFrame = frame.frame;
+    dms_player_release_frame(&frame);
+    int64_t convertStart = now_us();
+    result = convert_picture(renderer, &picture, &right, slot);
+    *outConvertUs = now_us() - convertStart;
+    if (result == 0) {
+        store_cache(renderer, *outFrame, &picture, slot);
+    }
+    dms_picture_release(&picture);
+    dms_picture_release(&right);
+    renderer->playerFrame = *outFrame >= 0 ? *outFrame + 1 : -1;
+    return result != 0 ? -3 : 0;
+}
+
+/**
+ * @brief 取下一应送显帧：缓存命中时直接复制像素，否则由播放器解码
+ * @param renderer 渲染器
+ * @param slot 帧槽
+ * @param outConvertUs 输出转换耗时（微秒），缓存命中时为0
+ * @return 成功返回0，转换失败返回-3，其他为取帧的错误码
+ */
+static int produce_frame(DmsRenderer* renderer, RenderSlot* slot, int64_t* outConvertUs) {
+    *outConvertUs = 0;
+    const DmsCachedFrame* cached = lookup_cache(renderer, renderer->wantFrame);
+    if (cached) {
+        // 输出方式改变时缓存已清空，缓存帧的排布即当前方式
+        int mode = stereo_layout(renderer);
+        slot->fields = dms_stereo_mode_fields(mode);
+        slot->eyes = slot->fields > 1 ? 2 : 1;
+        slot->pixels.assign(cached->pixels, cached->pixels + (size_t)cached->width * cached->height);
+        slot->width = cached->width;
+        slot->height = cached->height / slot->eyes;
+        slot->timeUs = cached->timeUs;
+        slot->durationUs = cached->durationUs;
+        renderer->wantFrame++;
+        return 0;
+    }
+    if (renderer->wantFrame >= 0 && renderer->playerFrame != renderer->wantFrame) {
+        seek_player(renderer, renderer->wantFrame);
+    }
+    int64_t frame;
+    int result = decode_to_slot(renderer, slot, &frame, outConvertUs);
+    if (result == 0 || result == -3) {
+        renderer->wantFrame = frame >= 0 ? frame + 1 : -1;
+    }
+    return result;
+}
+
+/**
+ * @brief 暂停时下一个应预先解码的帧：应送显帧之后第一个不在缓存中的帧
+ * @param renderer 渲染器
+ * @return 帧号，已预解码足够的帧或无法预解码返回-1
+ */
+static int64_t next_ahead_frame(DmsRenderer* renderer) {
+    if (!renderer->cache || renderer->wantFrame < 0 || renderer->cacheReduce < 0) {
+        return -1;
+    }
+    int64_t frameBytes = (int64_t)renderer->slots[0].pixels.size() * sizeof(uint32_t);
+    int64_t limit = kAheadFrames;
+    if (frameBytes > 0 && dms_frame_cache_get_limit(renderer->cache) / 2 / frameBytes < limit) {
+        limit = dms_frame_cache_get_limit(renderer->cache) / 2 / frameBytes;
+    }
+    for (int64_t i = 0; i < limit; i++) {
+        int64_t frame = renderer->wantFrame + i;
+        if (frame == renderer->aheadBlocked) {
+            return -1;
+        }
+        if (!dms_frame_cache_contains(renderer->cache, frame, renderer->cacheReduce)) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 暂停时预先解码一帧放入缓存，继续播放时直接取用
+ * @param renderer 渲染器
+ * @param target 帧号
+ */
+static void prefetch_ahead(DmsRenderer* renderer, int64_t target) {
+    if (renderer->playerFrame != target) {
+        seek_player(renderer, target);
+    }
+    int64_t frame, convertUs;
+    if (decode_to_slot(renderer, &renderer->aheadSlot, &frame, &convertUs) != 0 || frame != target) {
+        // 流结束或帧号对不上：跳转前不再预解码，取帧时按需重新定位
+        renderer->aheadBlocked = target;
+    }
+}
+
+/**
+ * @brief 在持有锁时把解码帧缓存与码流缓存的统计复制到渲染统计
+ * @param renderer 渲染器
+ */
+static void update_cache_stats(DmsRenderer* renderer) {
+    DmsFrameCacheStats cacheStats;
+    if (renderer->cache && dms_frame_cache_get_stats(renderer->cache, &cacheStats) == 0) {
+        renderer->stats.cacheLookups = cacheStats.lookups;
+        renderer->stats.cacheHits = cacheStats.hits;
+        renderer->stats.cacheEvictions = cacheStats.evictions;
+        renderer->stats.cacheBytes = cacheStats.bytes;
+    }
+    DmsCodestreamRingStats ringStats;
+    if (dms_player_get_codestream_cache_stats(renderer->ctx, &ringStats) == 0) {
+        renderer->stats.codestreamHits = ringStats.hits;
+        renderer->stats.codestreamBytes = ringStats.bytes;
+    }
+    renderer->stats.codestreamSeeks = renderer->ctx->ringSeeks;
+}
+
+/**
+ * @brief 生产线程：执行跳转请求，取解码帧（优先取缓存）并转换到空闲帧槽；
+ *        暂停且帧槽已满时预先解码后续帧放入缓存
+ * @param renderer 渲染器
+ */
+static void producer_loop(DmsRenderer* renderer) {
+    std::unique_lock<std::mutex> lock(renderer->mutex);
+    while (!renderer->stopping) {
+        if (renderer->trimRequest >= 0) {
+            dms_frame_cache_trim(renderer->cache, renderer->trimRequest);
+            renderer->trimRequest = -1;
+            update_cache_stats(renderer);
+        }
+        if (renderer->lutPending) {
+            // 换用新的LUT后重建转换器，按旧LUT转换的缓存帧作废
+            dms_color_lut_destroy(renderer->lut);
+            renderer->lut = renderer->lutRequest;
+            renderer->lutRequest = nullptr;
+            renderer->lutPending = false;
+            dms_color_destroy(renderer->converter);
+            renderer->converter = nullptr;
+            dms_frame_cache_clear(renderer->cache);
+            update_cache_stats(renderer);
+        }
+        if (renderer->stereoRequest >= 0) {
+            // 是否读取右眼随之改变，播放器从下一应取出的帧重新读取；按旧方式排布的缓存帧作废
+            int mode = renderer->stereoRequest;
+            renderer->stereoRequest = -1;
+            lock.unlock();
+            dms_player_set_stereo_mode(renderer->ctx, mode);
+            lock.lock();
+            renderer->stereoMode = mode;
+            renderer->aheadBlocked = -1;
+            dms_frame_cache_clear(renderer->cache);
+            update_cache_stats(renderer);
+            continue;
+        }
+        if (renderer->seekTargetUs >= 0) {
+            int64_t positionUs = renderer->seekTargetUs;
+            renderer->seekTargetUs = -1;
+            lock.unlock();
+            DmsContext* ctx = renderer->ctx;
+            int64_t frame = (int64_t)((double)positionUs * ctx->frameRate / 1000000.0);
+            renderer->wantFrame = frame;
+            renderer->aheadBlocked = -1;
+            // 目标帧已缓存时暂不定位播放器，取到未缓存的帧时再定位
+            if (!renderer->cache || renderer->cacheReduce < 0 ||
+                !dms_frame_cache_contains(renderer->cache, frame, renderer->cacheReduce)) {
+                seek_player(renderer, frame);
+                ctx->outputTimeUs = positionUs;
+            }
+            lock.lock();
+            renderer->endResult = DMS_RESULT_SUCCESS;
+            continue;
+        }
+        if (renderer->endResult != DMS_RESULT_SUCCESS || renderer->freeSlots.empty()) {
+            int64_t ahead = -1;
+            if (!renderer->playing && renderer->endResult == DMS_RESULT_SUCCESS) {
+                ahead = next_ahead_frame(renderer);
+            }
+            if (ahead < 0) {
+                renderer->cv.wait(lock);
+                continue;
+            }
+            lock.unlock();
+            prefetch_ahead(renderer, ahead);
+            lock.lock();
+            update_cache_stats(renderer);
+            continue;
+        }
+        int index = renderer->freeSlots.back();
+        renderer->freeSlots.pop_back();
+        uint64_t epoch = renderer->epoch;
+        int64_t lateUs = renderer->playing ? renderer->lastLateUs : 0;
+        int32_t adaptive = renderer->adaptiveRequest;
+        renderer->adaptiveRequest = -1;
+        lock.unlock();
+
+        if (adaptive >= 0) {
+            dms_player_set_adaptive_quality(renderer->ctx, adaptive != 0);
+        }
+        // 显示延后与解码耗时一同决定解码质量，在取帧线程上报
+        dms_player_report_present_late(renderer->ctx, lateUs);
+        RenderSlot* slot = &renderer->slots[index];
+        slot->fetchUs = now_us();
+        int64_t convertUs = 0;
+        int result = produce_frame(renderer, slot, &convertUs);
+        // 解码流水线由生产线程创建与销毁，其他线程只读取这里的副本
+        DmsDecodePipelineStats decodeStats;
+        bool decodeStatsValid = dms_player_get_decode_stats(renderer->ctx, &decodeStats) == 0;
+
+        lock.lock();
+        renderer->decodeStats = decodeStats;
+        renderer->decodeStatsValid = decodeStatsValid;
+        renderer->stats.qualityLevel = renderer->ctx->quality.level;
+        renderer->stats.degradedFrames = renderer->ctx->quality.degradedFrames;
+        renderer->stats.scaledFrames = renderer->scaledFrames;
+        renderer->stats.unscaledFrames = renderer->unscaledFrames;
+        renderer->stats.stereoFrames = renderer->stereoFrames;
+        renderer->stats.missingEyeFrames = renderer->missingEyeFrames;
+        update_cache_stats(renderer);
+        if (epoch != renderer->epoch) {
+            // 转换期间发生跳转，丢弃旧位置的帧
+            renderer->freeSlots.push_back(index);
+            continue;
+        }
+        if (result == -3) {
+            renderer->stats.failures++;
+            renderer->freeSlots.push_back(index);
+            continue;
+        }
+        if (result != 0) {
+            renderer->endResult = result;
+            renderer->freeSlots.push_back(index);
+            renderer->cv.notify_all();
+            continue;
+        }
+        if (convertUs > 0) {
+            ewma_update(&renderer->stats.convertCostUs, (float)convertUs);
+        }
+        renderer->ready.push_back(index);
+        renderer->cv.notify_all();
+    }
+}
+
+/**
+ * @brief 帧时间戳换算为帧号
+ * @param renderer 渲染器
+ * @param timeUs 帧时间戳（微秒）
+ * @return 帧号
+ */
+static int64_t frame_of(const DmsRenderer* renderer, int64_t timeUs) {
+    return llround((double)timeUs * renderer->frameRate / 1000000.0);
+}
+
+/**
+ * @brief 解除刷新节奏的锁定并清除已提交帧的记录（开始播放、暂停、跳转），调用者持有互斥锁
+ * @param renderer 渲染器
+ */
+static void reset_cadence(DmsRenderer* renderer) {
+    dms_cadence_unlock(&renderer->cadence);
+    renderer->shownFrame = -1;
+    renderer->prevShownFrame = -1;
+}
+
+/**
+ * @brief 帧序列立体：首个眼图像（左眼）提交后，在该帧时长内按等分的时刻依次提交其余眼图像
+ *        （单闪L R，双闪L R L R）；暂停、跳转或停止时中止。调用者持有互斥锁，等待与提交时释放
+ * @param renderer 渲染器
+ * @param lock 已持有的锁
+ * @param slot 帧槽
+ * @param epoch 提交首个眼图像时的跳转计数
+ * @param startUs 首个眼图像的显示时刻
+ */
+static void present_fields(DmsRenderer* renderer, std::unique_lock<std::mutex>& lock, const RenderSlot* slot,
+                           uint64_t epoch, int64_t startUs) {
+    size_t eyePixels = (size_t)slot->width * slot->height;
+    for (int32_t field = 1; field < slot->fields; field++) {
+        int64_t dueUs = startUs + slot->durationUs * field / slot->fields;
+        int64_t nowUs;
+        while (!renderer->stopping && renderer->playing && epoch == renderer->epoch && (nowUs = now_us()) < dueUs) {
+            renderer->cv.wait_for(lock, std::chrono::microseconds(dueUs - nowUs));
+        }
+        if (renderer->stopping || !renderer->playing || epoch != renderer->epoch) {
+            return;
+        }
+        lock.unlock();
+        int result = renderer->sink->present(renderer->sink, slot->pixels.data() + eyePixels * (field % slot->eyes),
+                                             slot->width, slot->height, slot->width * 4, slot->timeUs);
+        lock.lock();
+        if (result != 0) {
+            renderer->stats.failures++;
+            return;
+        }
+        renderer->stats.eyeFields++;
+    }
+}
+
+/**
+ * @brief 显示线程：在每帧的显示时刻把帧交给输出端
+ * @param renderer 渲染器
+ */
+static void presenter_loop(DmsRenderer* renderer) {
+    std::unique_lock<std::mutex> lock(renderer->mutex);
+    while (!renderer->stopping) {
+        if (renderer->ready.empty() || (!renderer->playing && !renderer->showStill)) {
+            if (renderer->ready.empty() && renderer->endResult != DMS_RESULT_SUCCESS &&
+                renderer->seekTargetUs < 0) {
+                renderer->stats.ended = true;
+            }
+            int64_t repeatUs = -1;
+            if (renderer->playing && renderer->ready.empty() && !renderer->stats.ended) {
+                // 取帧或解码跟不上：输出端保持上一帧，按帧时长统计重复显示
+                dms_frame_scheduler_poll_starved(&renderer->scheduler, now_us(), &repeatUs);
+            }
+            if (repeatUs >= 0) {
+                renderer->cv.wait_for(lock, std::chrono::microseconds(std::max<int64_t>(repeatUs - now_us(), 1)));
+            } else {
+                renderer->cv.wait(lock);
+            }
+            continue;
+        }
+        int index = renderer->ready.front();
+        RenderSlot* slot = &renderer->slots[index];
+        int64_t dueUs = -1;
+        int64_t frame = frame_of(renderer, slot->timeUs);
+        if (renderer->playing) {
+            int64_t nowUs = now_us();
+            bool hasNext = renderer->ready.size() > 1;
+            int64_t vsyncUs = dms_cadence_due_us(&renderer->cadence, frame);
+            int action;
+            if (vsyncUs < 0) {
+                action = dms_frame_scheduler_decide(&renderer->scheduler, slot->timeUs, slot->durationUs, hasNext,
+                                                    nowUs, &dueUs);
+            } else if (dms_cadence_frame_hold(&renderer->cadence, frame) == 0 && hasNext) {
+                // 帧率高于刷新率时按节奏不显示的帧，计入丢弃
+                action = DMS_PACE_DROP;
+            } else {
+                // 按节奏排在固定的刷新上：提前半个刷新周期提交，保证赶上该次刷新
+                dueUs = vsyncUs - (int64_t)(renderer->cadence.periodUs / 2);
+                action = dms_frame_scheduler_decide_at(&renderer->scheduler, slot->timeUs, slot->durationUs, dueUs,
+                                                       hasNext, nowUs);
+            }
+            if (action == DMS_PACE_WAIT) {
+                renderer->cv.wait_for(lock, std::chrono::microseconds(dueUs > nowUs ? dueUs - nowUs : 1000));
+                continue;
+            }
+            if (action == DMS_PACE_DROP) {
+                // 已有后续帧可显示，跳过落后的帧
+                renderer->ready.pop_front();
+                renderer->freeSlots.push_back(index);
+                renderer->stats.dropped++;
+                renderer->cv.notify_all();
+                continue;
+            }
+        }
+        renderer->ready.pop_front();
+        renderer->showStill = false;
+        uint64_t epoch = renderer->epoch;
+        lock.unlock();
+
+        int64_t presentStart = now_us();
+        int result = renderer->sink->present(renderer->sink, slot->pixels.data(), slot->width, slot->height,
+                                             slot->width * 4, slot->timeUs);
+        int64_t presentEnd = now_us();
+        if (result == 0) {
+            // 断点记录已显示的帧，而不是生产线程刚取出的帧
+            dms_player_frame_presented(renderer->ctx, slot->timeUs);
+        }
+
+        lock.lock();
+        if (result == 0 && slot->fields > 1 && renderer->playing) {
+            // 暂停时的静止画面只显示左眼
+            present_fields(renderer, lock, slot, epoch, dueUs >= 0 ? dueUs : presentStart);
+        }
+        renderer->freeSlots.push_back(index);
+        renderer->cv.notify_all();
+        if (result != 0) {
+            renderer->stats.failures++;
+            continue;
+        }
+        renderer->stats.presented++;
+        renderer->stats.positionUs = slot->timeUs;
+        if (epoch == renderer->epoch) {
+            renderer->prevShownFrame = renderer->shownFrame;
+            renderer->shownFrame = frame;
+            renderer->shownUs = presentEnd;
+        }
+        ewma_update(&renderer->stats.presentCostUs, (float)(presentEnd - presentStart));
+        ewma_update(&renderer->stats.latencyUs, (float)(presentEnd - slot->fetchUs));
+        if (epoch == renderer->epoch) {
+            dms_frame_scheduler_presented(&renderer->scheduler, slot->durationUs, renderer->playing ? dueUs : -1,
+                                          presentStart);
+        }
+        if (renderer->playing && dueUs >= 0) {
+            int64_t lateUs = presentStart - dueUs;
+            ewma_update(&renderer->stats.lateUs, (float)lateUs);
+            renderer->lastLateUs = lateUs;
+            if (renderer->playRequestUs >= 0) {
+                renderer->stats.startLatencyUs = presentEnd - renderer->playRequestUs;
+                renderer->playRequestUs = -1;
+            }
+        }
+        if (renderer->seekRequestUs >= 0 && epoch == renderer->epoch) {
+            renderer->stats.seekLatencyUs = presentEnd - renderer->seekRequestUs;
+            renderer->seekRequestUs = -1;
+        }
+    }
+}
+
+/**
+ * @brief 创建渲染器，创建后处于暂停状态并显示首帧
+ * @param ctx 已打开DCP的播放器上下文，渲染器存在期间由渲染器独占
+ * @param sink 输出端，创建成功后归渲染器所有
+ * @param config 渲染器配置，为空时输出sRGB、RGBA_8888并丢弃落后帧
+ * @return 成功返回渲染器指针，失败返回NULL
+ */
+struct DmsRenderer* dms_renderer_create(struct DmsContext* ctx, struct DmsVideoSink* sink,
+                                        const struct DmsRendererConfig* config) {
+    if (!ctx || !sink) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    if (!ctx->hasActiveMxf) {
+        LOGE("No active MXF file");
+        return nullptr;
+    }
+    DmsRenderer* renderer = new DmsRenderer();
+    renderer->ctx = ctx;
+    renderer->sink = sink;
+    if (config) {
+        renderer->config = *config;
+    } else {
+        renderer->config.colorSpace = DMS_COLOR_SRGB;
+        renderer->config.format = DMS_COLOR_RGBA_8888;
+        renderer->config.dropLate = true;
+        renderer->config.cacheBytes = 0;
+        renderer->config.outputWidth = 0;
+        renderer->config.outputHeight = 0;
+        renderer->config.scaleFilter = DMS_SCALE_BICUBIC;
+        renderer->config.stereoMode = DMS_STEREO_LEFT_ONLY;
+    }
+    if (!dms_stereo_mode_valid(renderer->config.stereoMode)) {
+        LOGE("Invalid stereo mode %d, showing left eye only", renderer->config.stereoMode);
+        renderer->config.stereoMode = DMS_STEREO_LEFT_ONLY;
+    }
+    // 生产线程启动前设置，首次取帧即按该方式读取右眼
+    dms_player_set_stereo_mode(ctx, renderer->config.stereoMode);
+    renderer->converter = nullptr;
+    renderer->converterPrecision = 0;
+    renderer->lut = nullptr;
+    renderer->scaler = nullptr;
+    renderer->scalerWidth = 0;
+    renderer->scalerHeight = 0;
+    renderer->scalerBoxWidth = 0;
+    renderer->scalerSqueeze = 0;
+    renderer->stereoMode = renderer->config.stereoMode;
+    renderer->scaledFrames = 0;
+    renderer->unscaledFrames = 0;
+    renderer->stereoFrames = 0;
+    renderer->missingEyeFrames = 0;
+    for (int i = 0; i < kSlotCount; i++) {
+        renderer->freeSlots.push_back(i);
+    }
+    renderer->stopping = false;
+    renderer->playing = false;
+    renderer->showStill = true;
+    renderer->seekTargetUs = -1;
+    renderer->epoch = 0;
+    renderer->endResult = DMS_RESULT_SUCCESS;
+    DmsPaceConfig pace = {renderer->config.dropLate, 0, 0};
+    dms_frame_scheduler_reset(&renderer->scheduler, &pace);
+    memset(&renderer->cadence, 0, sizeof(renderer->cadence));
+    renderer->frameRate = ctx->frameRate > 0 ? ctx->frameRate : 24.0f;
+    renderer->shownFrame = -1;
+    renderer->shownUs = 0;
+    renderer->prevShownFrame = -1;
+    renderer->playRequestUs = -1;
+    renderer->seekRequestUs = -1;
+    renderer->lastLateUs = 0;
+    renderer->adaptiveRequest = -1;
+    renderer->trimRequest = -1;
+    renderer->stereoRequest = -1;
+    renderer->lutPending = false;
+    renderer->lutRequest = nullptr;
+    int64_t cacheBytes = renderer->config.cacheBytes != 0 ? renderer->config.cacheBytes : DMS_FRAME_CACHE_DEFAULT_BYTES;
+    renderer->cache = cacheBytes > 0 ? dms_frame_cache_create(cacheBytes) : nullptr;
+    renderer->wantFrame = -1;
+    renderer->playerFrame = -1;
+    renderer->cacheReduce = -1;
+    renderer->aheadBlocked = -1;
+    renderer->startWallUs = now_us();
+    renderer->startCpuUs = process_cpu_us();
+    memset(&renderer->stats, 0, sizeof(renderer->stats));
+    memset(&renderer->decodeStats, 0, sizeof(renderer->decodeStats));
+    renderer->decodeStatsValid = false;
+    renderer->stats.startLatencyUs = -1;
+    renderer->stats.seekLatencyUs = -1;
+
+    renderer->producer = std::thread(producer_loop, renderer);
+    renderer->presenter = std::thread(presenter_loop, renderer);
+    LOGI("Renderer created");
+    return renderer;
+}
+
+/**
+ * @brief 停止线程并销毁渲染器与输出端，播放器停留在最后取出的帧之后
+ * @param renderer 渲染器
+ */
+void dms_renderer_destroy(struct DmsRenderer* renderer) {
+    if (!renderer) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(renderer->mutex);
+        renderer->stopping = true;
+    }
+    renderer->cv.notify_all();
+    renderer->producer.join();
+    renderer->presenter.join();
+    dms_color_destroy(renderer->converter);
+    dms_color_lut_destroy(renderer->lut);
+    dms_color_lut_destroy(renderer->lutRequest);
+    dms_scaler_destroy(renderer->scaler);
+    dms_frame_cache_destroy(renderer->cache);
+    dms_video_sink_destroy(renderer->sink);
+    LOGI("Renderer destroyed: %lld presented, %lld dropped", (long long)renderer->stats.presented,
+         (long long)renderer->stats.dropped);
+    delete renderer;
+}
+
+/**
+ * @brief 开始/继续播放，媒体时钟以下一帧的时间戳对齐
+ * @param renderer 渲染器
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_renderer_play(struct DmsRenderer* renderer) {
+    if (!renderer) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    if (!renderer->playing) {
+        renderer->playing = true;
+        renderer->playRequestUs = now_us();
+        dms_frame_scheduler_start(&renderer->scheduler, renderer->playRequestUs);
+        reset_cadence(renderer);
+        renderer->cv.notify_all();
+    }
+    return 0;
+}
+
+/**
+ * @brief 暂停，保留当前画面，生产线程填满帧槽后等待
+ * @param renderer 渲染器
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_renderer_pause(struct DmsRenderer* renderer) {
+    if (!renderer) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    if (renderer->playing) {
+        dms_frame_scheduler_pause(&renderer->scheduler, now_us());
+        reset_cadence(renderer);
+    }
+    renderer->playing = false;
+    renderer->playRequestUs = -1;
+    renderer->cv.notify_all();
+    return 0;
+}
+
+/**
+ * @brief 跳转到指定位置：丢弃已转换的帧，由生产线程重新定位（目标帧已缓存时直接取缓存），
+ *        暂停时也显示目标帧
+ * @param renderer 渲染器
+ * @param positionUs 目标位置（微秒）
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_renderer_seek(struct DmsRenderer* renderer, int64_t positionUs) {
+    if (!renderer || positionUs < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    while (!renderer->ready.empty()) {
+        renderer->freeSlots.push_back(renderer->ready.front());
+        renderer->ready.pop_front();
+    }
+    renderer->seekTargetUs = positionUs;
+    renderer->epoch++;
+    dms_frame_scheduler_flush(&renderer->scheduler);
+    reset_cadence(renderer);
+    renderer->showStill = true;
+    renderer->seekRequestUs = now_us();
+    renderer->stats.ended = false;
+    renderer->cv.notify_all();
+    return 0;
+}
+
+/**
+ * @brief 设置屏幕刷新率并按影片帧率规划显示节奏，之后由dms_renderer_on_vsync锁定
+ * @param renderer 渲染器
+ * @param refreshHz 屏幕刷新率（Hz），0为关闭，按媒体时钟连续提交
+ * @return 成功返回0，参数错误返回-1，无法规划返回-3
+ */
+int dms_renderer_set_display_refresh(struct DmsRenderer* renderer, float refreshHz) {
+    if (!renderer || refreshHz < 0.0f) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    if (refreshHz == 0.0f) {
+        memset(&renderer->cadence, 0, sizeof(renderer->cadence));
+        renderer->cv.notify_all();
+        return 0;
+    }
+    int32_t editRateNum = (int32_t)lroundf(renderer->frameRate * 1000.0f);
+    if (dms_cadence_plan(&renderer->cadence, editRateNum, 1000, refreshHz) != 0) {
+        LOGE("Cannot plan cadence for %.3f fps at %.3f Hz", renderer->frameRate, refreshHz);
+        memset(&renderer->cadence, 0, sizeof(renderer->cadence));
+        return -3;
+    }
+    char pattern[64];
+    dms_cadence_pattern_string(&renderer->cadence, pattern, sizeof(pattern));
+    LOGI("Cadence %.3f fps at %.3f Hz: %s (%d frames / %d vsyncs%s)", renderer->frameRate, refreshHz, pattern,
+         renderer->cadence.patternFrames, renderer->cadence.patternVsyncs,
+         renderer->cadence.exact ? "" : ", approximated");
+    renderer->cv.notify_all();
+    return 0;
+}
+
+/**
+ * @brief 屏幕刷新回调（Choreographer帧回调，CLOCK_MONOTONIC时间戳）：核对该次刷新上显示的帧，
+ *        播放中首帧提交后在下一次刷新锁定节奏
+ * @param renderer 渲染器
+ * @param vsyncUs 刷新时间戳（微秒）
+ * @return 成功返回0，参数错误返回-1，未设置刷新率返回-2
+ */
+int dms_renderer_on_vsync(struct DmsRenderer* renderer, int64_t vsyncUs) {
+    if (!renderer || vsyncUs < 0) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    if (renderer->cadence.patternFrames <= 0) {
+        return -2;
+    }
+    // 刷新前已提交完成的最近一帧即该次刷新显示的帧
+    int64_t shown = renderer->shownUs <= vsyncUs ? renderer->shownFrame : renderer->prevShownFrame;
+    bool tracking = renderer->playing && shown >= 0;
+    dms_cadence_vsync(&renderer->cadence, vsyncUs, tracking ? shown : -1);
+    if (tracking && !renderer->cadence.locked) {
+        dms_cadence_lock(&renderer->cadence, shown, vsyncUs);
+    }
+    renderer->cv.notify_all();
+    return 0;
+}
+
+/**
+ * @brief 开关自适应解码质量：生产线程独占播放器，在下一次取帧前执行
+ * @param renderer 渲染器
+ * @param enabled 是否按显示时刻自动降低/恢复解码质量
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_renderer_set_adaptive_quality(struct DmsRenderer* renderer, bool enabled) {
+    if (!renderer) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    renderer->adaptiveRequest = enabled ? 1 : 0;
+    return 0;
+}
+
+/**
+ * @brief 设置3D LUT（色域映射）：转换器由生产线程独占，在其下一次循环时换用并重建，之后转换的帧生效
+ * @param renderer 渲染器
+ * @param lut 3D LUT，输出须为配置的colorSpace的显示码值，归渲染器所有；NULL为取消LUT
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_renderer_set_color_lut(struct DmsRenderer* renderer, struct DmsColorLut* lut) {
+    if (!renderer) {
+        LOGE("Invalid parameters");
+        dms_color_lut_destroy(lut);
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    dms_color_lut_destroy(renderer->lutRequest);
+    renderer->lutRequest = lut;
+    renderer->lutPending = true;
+    renderer->cv.notify_all();
+    return 0;
+}
+
+/**
+ * @brief 设置立体输出方式：播放器由生产线程独占，在其下一次循环时切换，之后取出的帧生效
+ * @param renderer 渲染器
+ * @param mode 输出方式，DmsStereoMode；2D素材上设置后不影响输出
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_renderer_set_stereo_mode(struct DmsRenderer* renderer, int mode) {
+    if (!renderer || !dms_stereo_mode_valid(mode)) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    renderer->stereoRequest = mode;
+    renderer->cv.notify_all();
+    return 0;
+}
+
+/**
+ * @brief 内存警告：缓存由生产线程独占，在其下一次循环时按等级缩小
+ * @param renderer 渲染器
+ * @param level 内存紧张等级（Android ComponentCallbacks2.onTrimMemory的level）
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_renderer_trim_memory(struct DmsRenderer* renderer, int level) {
+    if (!renderer) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    if (level > renderer->trimRequest) {
+        renderer->trimRequest = level;
+    }
+    renderer->cv.notify_all();
+    return 0;
+}
+
+/**
+ * @brief 获取渲染统计信息
+ * @param renderer 渲染器
+ * @param outStats 输出统计信息
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_renderer_get_stats(struct DmsRenderer* renderer, struct DmsRendererStats* outStats) {
+    if (!renderer || !outStats) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    *outStats = renderer->stats;
+    outStats->repeated = renderer->scheduler.stats.repeated;
+    outStats->resyncs = renderer->scheduler.stats.resyncs;
+    outStats->jitterUs = renderer->scheduler.stats.jitterUs;
+    outStats->maxLateUs = renderer->scheduler.stats.maxLateUs;
+    outStats->cadenceSlips = renderer->cadence.stats.slips;
+    outStats->cadenceRelocks = renderer->cadence.stats.relocks;
+    outStats->missedVsyncs = renderer->cadence.stats.missedVsyncs;
+    int64_t elapsedUs = now_us() - renderer->startWallUs;
+    if (elapsedUs > 0) {
+        outStats->cpuLoad = (float)(process_cpu_us() - renderer->startCpuUs) / (float)elapsedUs;
+    }
+    return 0;
+}
+
+/**
+ * @brief 获取并行解码统计信息：播放器由生产线程独占，这里返回其最近一次取帧后的副本
+ * @param renderer 渲染器
+ * @param outStats 输出统计信息
+ * @return 成功返回0，参数错误返回-1，尚未开始并行解码返回-2
+ */
+int dms_renderer_get_decode_stats(struct DmsRenderer* renderer, struct DmsDecodePipelineStats* outStats) {
+    if (!renderer || !outStats) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(renderer->mutex);
+    if (!renderer->decodeStatsValid) {
+        return -2;
+    }
+    *outStats = renderer->decodeStats;
+    return 0;
+}
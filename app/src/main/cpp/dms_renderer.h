@@ -0,0 +1,121 @@
+#ifndef DMS_RENDERER_H
+#define DMS_RENDERER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 原生渲染器
+ *
+ * 绕过ExoPlayer的提取器与解码器路径：解码帧在原生层直接转换为RGB并写入输出端
+ * （Android Surface或共享内存），Java层只控制播放、暂停与跳转。
+ *
+ * 渲染器占用两个线程：
+ *   - 生产线程独占播放器上下文，按显示顺序取解码帧（dms_player_next_picture），
+ *     转换到空闲的RGB帧槽；跳转请求也由生产线程执行。渲染器存在期间其他线程不得再
+ *     读取或定位播放器；
+ *   - 显示线程按媒体时钟在每帧的显示时刻把帧交给输出端，落后超过一帧时丢弃（见 dms_present_clock.h）。
+ * 共3个帧槽（三缓冲）：一个显示中、一个待显示、一个转换中，生产与显示互不等待。
+ *
+ * 设置屏幕刷新率并在每次刷新时调用 dms_renderer_on_vsync 后，显示线程按预先规划的刷新节奏
+ * （如24fps@60Hz的2:3）把每帧排在固定的刷新上提交，见 dms_cadence.h。
+ *
+ * 设置输出尺寸后，帧按原宽高比缩放到屏幕尺寸并加黑边，缩放、色彩转换与打包一次写入帧槽
+ * （见 dms_scaler.h），输出端按屏幕尺寸1:1显示；解码时选择的分辨率层恰好符合时不缩放。
+ *
+ * 立体（3D）素材按stereoMode输出（见 dms_stereo.h）：只显示左眼；左右并排，指定输出尺寸时为半宽；
+ * 帧序列时帧槽依次存放左右眼图像，显示线程在每帧时长内交替提交L R（单闪）或L R L R（双闪）。
+ * 两眼由并行解码的不同线程同时解码。
+ *
+ * 设置3D LUT后色彩转换与色域映射一次完成（见 dms_color.h），如在Rec.709屏幕上以色域压缩
+ * 显示P3母版。
+ *
+ * 已转换的帧同时放入解码帧缓存（见 dms_frame_cache.h）：暂停后逐帧后退、小范围回退时
+ * 直接取缓存；暂停且帧槽已满时生产线程继续预先解码后续帧放入缓存，继续播放时无需等待解码。
+ */
+
+struct DmsContext;
+struct DmsVideoSink;
+struct DmsColorLut;
+struct DmsDecodePipelineStats;
+
+// 渲染器配置
+struct DmsRendererConfig {
+    int32_t colorSpace;      // 输出色彩空间，DmsColorSpace
+    int32_t format;          // 输出像素格式，DmsColorFormat，须与输出端一致
+    bool dropLate;           // 落后超过一帧时丢弃，false时逐帧显示（基准测试）
+    int64_t cacheBytes;      // 解码帧缓存容量（字节），0为默认（DMS_FRAME_CACHE_DEFAULT_BYTES），小于0不缓存
+    int32_t outputWidth;     // 输出（屏幕）宽度，按原宽高比缩放并加黑边；0为按帧尺寸输出，由输出端缩放
+    int32_t outputHeight;    // 输出（屏幕）高度
+    int32_t scaleFilter;     // 缩放滤波器，DmsScaleFilter
+    int32_t stereoMode;      // 立体素材的输出方式，DmsStereoMode，默认只显示左眼；2D素材忽略
+};
+
+// 渲染统计信息
+struct DmsRendererStats {
+    int64_t presented;       // 已显示的帧数
+    int64_t dropped;         // 因落后丢弃的帧数
+    int64_t failures;        // 解码或显示失败的帧数
+    int64_t startLatencyUs;  // 最近一次开始播放到首帧显示的耗时，未显示为-1
+    int64_t seekLatencyUs;   // 最近一次跳转到目标帧显示的耗时，未跳转为-1
+    float latencyUs;         // 取帧到显示的端到端耗时的滑动平均（微秒）
+    float lateUs;            // 实际显示时刻晚于计划时刻的滑动平均（微秒）
+    float convertCostUs;     // 单帧色彩转换耗时的滑动平均（微秒）
+    float presentCostUs;     // 单帧提交输出端耗时的滑动平均（微秒）
+    float cpuLoad;           // 渲染器创建以来进程CPU时间与墙钟时间之比（1表示一个核满载）
+    int64_t positionUs;      // 最近一次显示帧的时间戳
+    int32_t qualityLevel;    // 当前解码质量档位，0为全质量（见 dms_decode_quality.h）
+    int64_t degradedFrames;  // 为赶上显示时刻降质解码的帧数
+    int64_t cacheLookups;    // 解码帧缓存的查询次数
+    int64_t cacheHits;       // 解码帧缓存的命中次数
+    int64_t cacheEvictions;  // 解码帧缓存因容量淘汰的帧数
+    int64_t cacheBytes;      // 解码帧缓存当前占用的字节数
+    int64_t codestreamHits;  // 从码流缓存取帧的次数（见 dms_codestream_ring.h）
+    int64_t codestreamBytes; // 码流缓存当前占用的字节数
+    int64_t codestreamSeeks; // 落在码流缓存内、未定位libdms的跳转次数
+    int64_t repeated;        // 没有新帧时重复显示上一帧的次数（按帧时长计）
+    int64_t resyncs;         // 落后过多且无帧可丢时媒体时钟拨回的次数
+    float jitterUs;          // 显示延后的标准差（微秒）
+    int64_t maxLateUs;       // 显示延后的最大值（微秒）
+    int64_t cadenceSlips;    // 显示的帧不符合刷新节奏的刷新次数（见 dms_cadence.h）
+    int64_t cadenceRelocks;  // 连续滑移后重新锁定节奏的次数
+    int64_t missedVsyncs;    // 按刷新回调间隔推算漏掉的刷新次数
+    int64_t scaledFrames;    // 缩放到输出尺寸的帧数（见 dms_scaler.h）
+    int64_t unscaledFrames;  // 分辨率层恰好符合输出尺寸、只加黑边未缩放的帧数
+    int64_t stereoFrames;    // 两眼输出的立体帧数
+    int64_t missingEyeFrames; // 缺右眼（未读到或解码失败）以左眼代替的立体帧数
+    int64_t eyeFields;       // 帧序列输出时每帧首个眼图像之后提交的眼图像数
+    bool ended;              // 已显示到流结束
+};
+
+struct DmsRenderer;
+
+struct DmsRenderer* dms_renderer_create(struct DmsContext* ctx, struct DmsVideoSink* sink,
+                                        const struct DmsRendererConfig* config); // 创建渲染器（暂停状态）
+void dms_renderer_destroy(struct DmsRenderer* renderer);      // 停止线程并销毁渲染器与输出端
+int dms_renderer_play(struct DmsRenderer* renderer);          // 开始/继续播放
+int dms_renderer_pause(struct DmsRenderer* renderer);         // 暂停，保留当前画面
+int dms_renderer_seek(struct DmsRenderer* renderer, int64_t positionUs); // 跳转到指定位置（微秒）
+int dms_renderer_set_display_refresh(struct DmsRenderer* renderer,
+                                     float refreshHz);        // 设置屏幕刷新率，按帧率规划显示节奏
+int dms_renderer_on_vsync(struct DmsRenderer* renderer, int64_t vsyncUs); // 屏幕刷新回调，核对并锁定节奏
+int dms_renderer_set_adaptive_quality(struct DmsRenderer* renderer,
+                                      bool enabled);  // 开关自适应解码质量，由生产线程执行
+int dms_renderer_set_color_lut(struct DmsRenderer* renderer,
+                               struct DmsColorLut* lut);      // 设置3D LUT（色域映射），LUT归渲染器所有
+int dms_renderer_set_stereo_mode(struct DmsRenderer* renderer, int mode); // 设置立体输出方式，由生产线程执行
+int dms_renderer_trim_memory(struct DmsRenderer* renderer, int level); // 内存警告，缩小解码帧缓存
+int dms_renderer_get_stats(struct DmsRenderer* renderer,
+                           struct DmsRendererStats* outStats); // 获取渲染统计信息
+int dms_renderer_get_decode_stats(struct DmsRenderer* renderer,
+                                  struct DmsDecodePipelineStats* outStats); // 获取并行解码统计信息（生产线程每帧更新）
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_RENDERER_H
@@ -0,0 +1,316 @@
+#include "dms_reverse_play.h"
+#include "dms_player.h"
+#include "dms_log.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define LOG_TAG "DmsReversePlay"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int kChunkBuffers = 2;            // 常驻块数：一块输出、一块预取
+static const int32_t kMinChunkFrames = 4;
+static const int32_t kMaxChunkFrames = 240;    // 24fps十秒，再大只会拖慢首帧
+static const int32_t kInitialChunkFrames = 12; // 尚无实测耗时时的块大小，偏小以尽快输出首帧
+static const float kInitialUnitBytes = 1300000.0f; // 2K DCP 250Mbps下单帧约1.3MB
+static const float kCostMargin = 1.25f;        // 耗时预留25%余量
+static const float kEwmaAlpha = 0.3f;
+
+struct ReverseChunk {
+    std::vector<DmsDataUnitPtr> units;  // 按正向顺序存放，从尾部逆序取出
+    std::vector<int64_t> frames;
+    int64_t bytes;
+};
+
+struct DmsReversePlay {
+    DmsContext* ctx;
+    int64_t memoryBudget;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<ReverseChunk> chunks;
+    bool stopping;
+    bool finished;                   // 已读到片头或出错，不再预取
+    int error;
+    int64_t fetchEnd;                // 下一块的结束帧（不含）
+    int64_t resumeFrame;
+
+    int32_t chunkFrames;
+    float seekCostUs;
+    float fetchCostUs;
+    float unitBytes;
+    int64_t bufferedBytes;
+    int64_t chunkCount;
+    int64_t frameCount;
+    int64_t stalls;
+};
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static void ewma_update(float* value, float sample) {
+    *value = (*value <= 0.0f) ? sample : *value + kEwmaAlpha * (sample - *value);
+}
+
+static void free_chunk(ReverseChunk* chunk) {
+    for (DmsDataUnitPtr& unit : chunk->units) {
+        if (unit) {
+            _dms_free_data_unit(&unit);
+        }
+    }
+    chunk->units.clear();
+    chunk->frames.clear();
+}
+
+/**
+ * @brief 计算下一块大小K，调用者需持有mutex。
+ *        取一块耗时 = 定位 + K×单帧读取，播放一块耗时 = K×帧间隔，
+ *        实时倒放要求 K ≥ 定位耗时 / (帧间隔 − 单帧读取耗时)；同时两块常驻不超过内存预算
+ * @param reverse 倒放引擎
+ * @return 块大小
+ */
+static int32_t choose_chunk_frames(DmsReversePlay* reverse) {
+    int64_t byMemory = (int64_t)((double)reverse->memoryBudget / (kChunkBuffers * reverse->unitBytes));
+    int32_t limit = (int32_t)(byMemory < kMinChunkFrames ? kMinChunkFrames
+            : byMemory > kMaxChunkFrames ? kMaxChunkFrames : byMemory);
+
+    float frameRate = reverse->ctx->frameRate > 0 ? reverse->ctx->frameRate : 24.0f;
+    float intervalUs = 1000000.0f / frameRate;
+    float fetchUs = reverse->fetchCostUs * kCostMargin;
+    int32_t wanted;
+    if (reverse->seekCostUs <= 0.0f) {
+        wanted = kInitialChunkFrames;
+    } else if (fetchUs >= intervalUs) {
+        // 单帧读取已慢于实时，定位开销摊得越薄越好
+        wanted = limit;
+    } else {
+        wanted = (int32_t)ceilf(reverse->seekCostUs * kCostMargin / (intervalUs - fetchUs));
+    }
+
+    if (wanted < kMinChunkFrames) {
+        wanted = kMinChunkFrames;
+    }
+    return wanted > limit ? limit : wanted;
+}
+
+static void reverse_main(DmsReversePlay* reverse) {
+    std::unique_lock<std::mutex> lock(reverse->mutex);
+    while (true) {
+        reverse->cv.wait(lock, [reverse] {
+            return reverse->stopping || (int)reverse->chunks.size() < kChunkBuffers;
+        });
+        if (reverse->stopping) {
+            break;
+        }
+        if (reverse->fetchEnd <= 0) {
+            reverse->finished = true;
+            reverse->cv.notify_all();
+            break;
+        }
+
+        int32_t count = choose_chunk_frames(reverse);
+        int64_t end = reverse->fetchEnd;
+        int64_t start = end > count ? end - count : 0;
+        count = (int32_t)(end - start);
+        reverse->chunkFrames = count;
+        lock.unlock();
+
+        // 读取期间不持有引擎锁，当前块照常输出
+        ReverseChunk chunk;
+        chunk.units.assign(count, nullptr);
+        chunk.frames.assign(count, -1);
+        chunk.bytes = 0;
+        int got = 0;
+        int64_t seekUs = -1;
+        int64_t startUs = now_us();
+        int result = dms_player_fetch_frames(reverse->ctx, start, count, chunk.units.data(),
+                                             chunk.frames.data(), &got, &seekUs);
+        int64_t costUs = now_us() - startUs;
+
+        chunk.units.resize(got);
+        chunk.frames.resize(got);
+        for (int i = 0; i < got; i++) {
+            // 码流定位为估算位置时帧号可能未知，按块内顺序补齐
+            if (chunk.frames[i] < 0) {
+                chunk.frames[i] = start + i;
+            }
+            chunk.bytes += chunk.units[i]->Length;
+        }
+        if (got > 0 && chunk.frames[0] != start) {
+            LOGE("Reverse chunk landed at frame %lld, expected %lld",
+                 (long long)chunk.frames[0], (long long)start);
+        }
+
+        lock.lock();
+        if (got == 0) {
+            LOGE("Reverse fetch at frame %lld failed: 0x%08x", (long long)start, result);
+            reverse->error = result != DMS_RESULT_SUCCESS ? result : (int)DMS_RESULT_PLAY_FINISHED;
+            reverse->finished = true;
+            reverse->cv.notify_all();
+            break;
+        }
+
+        if (seekUs >= 0) {
+            ewma_update(&reverse->seekCostUs, (float)seekUs);
+            costUs -= seekUs;
+        }
+        ewma_update(&reverse->fetchCostUs, (float)costUs / (float)got);
+        ewma_update(&reverse->unitBytes, (float)chunk.bytes / (float)got);
+        reverse->bufferedBytes += chunk.bytes;
+        reverse->chunkCount++;
+        reverse->fetchEnd = start;
+        if (reverse->stopping) {
+            free_chunk(&chunk);
+            break;
+        }
+        reverse->chunks.push_back(std::move(chunk));
+        reverse->cv.notify_all();
+    }
+}
+
+/**
+ * @brief 创建倒放引擎并启动预取线程
+ * @param ctx DMS播放器上下文指针
+ * @param firstFrame 第一个输出帧，之后依次输出firstFrame-1、firstFrame-2……直到第0帧
+ * @param memoryBudget 缓冲内存预算（字节）
+ * @return 成功返回引擎指针，失败返回NULL
+ */
+struct DmsReversePlay* dms_reverse_play_create(struct DmsContext* ctx, int64_t firstFrame,
+                                               int64_t memoryBudget) {
+    if (!ctx || firstFrame < 0 || memoryBudget <= 0) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+
+    DmsReversePlay* reverse = new DmsReversePlay();
+    reverse->ctx = ctx;
+    reverse->memoryBudget = memoryBudget;
+    reverse->stopping = false;
+    reverse->finished = false;
+    reverse->error = DMS_RESULT_SUCCESS;
+    reverse->fetchEnd = firstFrame + 1;
+    reverse->resumeFrame = firstFrame + 1;
+    reverse->chunkFrames = 0;
+    reverse->seekCostUs = 0.0f;
+    reverse->fetchCostUs = 0.0f;
+    reverse->unitBytes = kInitialUnitBytes;
+    reverse->bufferedBytes = 0;
+    reverse->chunkCount = 0;
+    reverse->frameCount = 0;
+    reverse->stalls = 0;
+    reverse->thread = std::thread(reverse_main, reverse);
+
+    LOGI("Reverse playback from frame %lld, budget %lld bytes",
+         (long long)firstFrame, (long long)memoryBudget);
+    return reverse;
+}
+
+/**
+ * @brief 停止预取线程并释放缓冲
+ * @param reverse 倒放引擎
+ */
+void dms_reverse_play_destroy(struct DmsReversePlay* reverse) {
+    if (!reverse) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(reverse->mutex);
+        reverse->stopping = true;
+    }
+    reverse->cv.notify_all();
+    if (reverse->thread.joinable()) {
+        reverse->thread.join();
+    }
+
+    for (ReverseChunk& chunk : reverse->chunks) {
+        free_chunk(&chunk);
+    }
+    LOGI("Reverse playback stopped: %lld frames, %lld chunks, K=%d, seek %.0fus, fetch %.0fus/frame, %lld stalls",
+         (long long)reverse->frameCount, (long long)reverse->chunkCount, reverse->chunkFrames,
+         reverse->seekCostUs, reverse->fetchCostUs, (long long)reverse->stalls);
+    delete reverse;
+}
+
+/**
+ * @brief 取下一倒放帧，缓冲为空时等待后台读取
+ * @param reverse 倒放引擎
+ * @param outUnit 输出数据单元，使用后由调用者通过_dms_free_data_unit释放
+ * @param outFrame 输出帧号
+ * @return 正确返回DMS_RESULT_SUCCESS，已输出第0帧返回DMS_RESULT_PLAY_FINISHED，否则返回错误码
+ */
+int dms_reverse_play_next(struct DmsReversePlay* reverse, DmsDataUnitPtr* outUnit, int64_t* outFrame) {
+    if (!reverse || !outUnit || !outFrame) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    *outUnit = nullptr;
+    *outFrame = -1;
+
+    std::unique_lock<std::mutex> lock(reverse->mutex);
+    if (reverse->chunks.empty() && !reverse->finished) {
+        reverse->stalls++;
+        reverse->cv.wait(lock, [reverse] { return !reverse->chunks.empty() || reverse->finished; });
+    }
+    if (reverse->chunks.empty()) {
+        return reverse->error != DMS_RESULT_SUCCESS ? reverse->error : (int)DMS_RESULT_PLAY_FINISHED;
+    }
+
+    ReverseChunk& chunk = reverse->chunks.front();
+    *outUnit = chunk.units.back();
+    *outFrame = chunk.frames.back();
+    chunk.units.pop_back();
+    chunk.frames.pop_back();
+    reverse->bufferedBytes -= (*outUnit)->Length;
+    reverse->resumeFrame = *outFrame + 1;
+    reverse->frameCount++;
+    if (chunk.units.empty()) {
+        // 当前块输出完毕，腾出的缓冲交给预取线程
+        reverse->chunks.pop_front();
+        reverse->cv.notify_all();
+    }
+    return DMS_RESULT_SUCCESS;
+}
+
+/**
+ * @brief 退出倒放后正向播放应继续的帧号
+ * @param reverse 倒放引擎
+ * @return 最近输出帧的下一帧；尚未输出时为起始帧的下一帧
+ */
+int64_t dms_reverse_play_get_resume_frame(struct DmsReversePlay* reverse) {
+    if (!reverse) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(reverse->mutex);
+    return reverse->resumeFrame;
+}
+
+/**
+ * @brief 获取倒放统计信息
+ * @param reverse 倒放引擎
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回-1
+ */
+int dms_reverse_play_get_stats(struct DmsReversePlay* reverse, struct DmsReversePlayStats* outStats) {
+    if (!reverse || !outStats) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(reverse->mutex);
+    outStats->chunkFrames = reverse->chunkFrames;
+    outStats->chunks = reverse->chunkCount;
+    outStats->frames = reverse->frameCount;
+    outStats->stalls = reverse->stalls;
+    outStats->seekCostUs = reverse->seekCostUs;
+    outStats->fetchCostUs = reverse->fetchCostUs;
+    outStats->bufferedBytes = reverse->bufferedBytes;
+    return 0;
+}
@@ -0,0 +1,49 @@
+#ifndef DMS_REVERSE_PLAY_H
+#define DMS_REVERSE_PLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "libdms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 分块倒放
+ *
+ * libdms 只能顺序读取下一个图像数据单元，因此倒放时每次向前回退K帧定位，
+ * 将这K帧顺序读入缓冲后按逆序输出。后台线程在当前块输出期间预取再往前的
+ * 一块，两块交替。K由内存预算（两块常驻）与实测的定位、单帧读取耗时共同决定：
+ * 定位开销需被K帧摊薄到使取一块的时间不超过播放一块的时间。
+ */
+
+struct DmsContext;
+
+// 倒放统计信息
+struct DmsReversePlayStats {
+    int32_t chunkFrames;     // 当前块大小K
+    int64_t chunks;          // 已读取的块数
+    int64_t frames;          // 已输出的帧数
+    int64_t stalls;          // 取帧时缓冲为空、需等待后台读取的次数
+    float seekCostUs;        // 单次定位耗时的滑动平均（微秒）
+    float fetchCostUs;       // 单帧读取耗时的滑动平均（微秒）
+    int64_t bufferedBytes;   // 当前缓冲的数据量（字节）
+};
+
+struct DmsReversePlay;
+
+struct DmsReversePlay* dms_reverse_play_create(struct DmsContext* ctx, int64_t firstFrame,
+                                               int64_t memoryBudget);  // 创建并开始预取，firstFrame为第一个输出帧
+void dms_reverse_play_destroy(struct DmsReversePlay* reverse);          // 停止预取线程并释放缓冲
+int dms_reverse_play_next(struct DmsReversePlay* reverse, DmsDataUnitPtr* outUnit,
+                          int64_t* outFrame);                           // 取下一倒放帧，到达片头返回DMS_RESULT_PLAY_FINISHED
+int64_t dms_reverse_play_get_resume_frame(struct DmsReversePlay* reverse); // 退出倒放后正向播放应继续的帧号
+int dms_reverse_play_get_stats(struct DmsReversePlay* reverse,
+                               struct DmsReversePlayStats* outStats);   // 获取统计信息
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_REVERSE_PLAY_H
@@ -0,0 +1,509 @@
+#include "dms_scaler.h"
+#include "dms_color.h"
+#include "dms_j2k_decoder.h"
+#include "dms_log.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DMS_SCALER_X86 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define DMS_SCALER_NEON 1
+#endif
+
+#define LOG_TAG "DmsScaler"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int kCoefShift = 12;                // 多相系数为Q12定点
+static const int32_t kCoefOne = 1 << kCoefShift;
+static const int kMidShift = 8;                  // 垂直滤波：Q12系数乘码值后保留4位小数
+static const int32_t kMidRound = 1 << (kMidShift - 1);
+static const int kOutShift = 16;                 // 水平滤波：Q12系数乘Q4中间值后得到码值
+static const int32_t kOutRound = 1 << (kOutShift - 1);
+static const int kMidFraction = kOutShift - kCoefShift;
+static const int32_t kMaxTaps = 64;              // 抽头数上限，对应约10倍的缩小
+
+// 一个方向上的多相系数
+struct ScaleAxis {
+    int32_t taps;                 // 每个输出位置的抽头数，0表示该方向不缩放
+    std::vector<int32_t> start;   // 每个输出位置的首个源采样
+    std::vector<int32_t> coefs;   // 按输出位置排列，每个位置taps个（Q12）
+};
+
+struct DmsScaler {
+    DmsScalerConfig config;
+    int32_t kernel;
+    int32_t fitWidth;             // 画面区域尺寸
+    int32_t fitHeight;
+    int32_t left;                 // 画面区域在目标图像中的位置
+    int32_t top;
+    ScaleAxis horizontal;         // fitWidth个输出位置
+    ScaleAxis vertical;           // fitHeight个输出位置
+};
+
+// Catmull-Rom双三次核
+static double cubic(double x) {
+    x = fabs(x);
+    if (x < 1.0) {
+        return (1.5 * x - 2.5) * x * x + 1.0;
+    }
+    if (x < 2.0) {
+        return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    }
+    return 0.0;
+}
+
+// Lanczos-3核
+static double lanczos3(double x) {
+    x = fabs(x);
+    if (x < 1e-9) {
+        return 1.0;
+    }
+    if (x >= 3.0) {
+        return 0.0;
+    }
+    double px = M_PI * x;
+    return 3.0 * sin(px) * sin(px / 3.0) / (px * px);
+}
+
+/**
+ * @brief 计算一个方向上的多相系数：输出位置o对应源坐标(o+0.5)·src/dst-0.5，缩小时核按倍数展宽；
+ *        窗口超出源图像的抽头折叠到边缘采样，窗口整体移入源图像；系数归一化为Q12，舍入误差计入最大的抽头
+ * @param axis 输出系数
+ * @param srcSize 源尺寸
+ * @param dstSize 输出尺寸
+ * @param filter 缩放滤波器，DmsScaleFilter
+ * @param align 抽头数补齐到此值的倍数
+ * @return 成功返回0，抽头数超过上限或源尺寸不足一个窗口返回-1
+ */
+static int build_axis(ScaleAxis* axis, int32_t srcSize, int32_t dstSize, int filter, int32_t align) {
+    if (srcSize == dstSize) {
+        axis->taps = 0;
+        return 0;
+    }
+    double (*kernel)(double) = filter == DMS_SCALE_LANCZOS3 ? lanczos3 : cubic;
+    double radius = filter == DMS_SCALE_LANCZOS3 ? 3.0 : 2.0;
+    double scale = (double)srcSize / dstSize;
+    double stretch = std::max(1.0, scale);
+    int32_t taps = (int32_t)ceil(radius * stretch) * 2;
+    taps = (taps + align - 1) / align * align;
+    if (taps > kMaxTaps || taps > srcSize) {
+        return -1;
+    }
+    axis->taps = taps;
+    axis->start.resize(dstSize);
+    axis->coefs.assign((size_t)dstSize * taps, 0);
+    std::vector<double> weights(taps);
+    for (int32_t o = 0; o < dstSize; o++) {
+        double center = (o + 0.5) * scale - 0.5;
+        int32_t first = (int32_t)floor(center) - taps / 2 + 1;
+        int32_t start = std::min(std::max(first, 0), srcSize - taps);
+        std::fill(weights.begin(), weights.end(), 0.0);
+        double sum = 0.0;
+        for (int32_t t = 0; t < taps; t++) {
+            double w = kernel((first + t - center) / stretch);
+            int32_t index = std::min(std::max(first + t, 0), srcSize - 1);
+            weights[index - start] += w;
+            sum += w;
+        }
+        int32_t* coefs = &axis->coefs[(size_t)o * taps];
+        int32_t total = 0;
+        int32_t peak = 0;
+        for (int32_t t = 0; t < taps; t++) {
+            coefs[t] = (int32_t)lround(weights[t] / sum * kCoefOne);
+            total += coefs[t];
+            if (abs(coefs[t]) > abs(coefs[peak])) {
+                peak = t;
+            }
+        }
+        coefs[peak] += kCoefOne - total;
+        axis->start[o] = start;
+    }
+    return 0;
+}
+
+// 标量参考实现：垂直滤波，rows为各抽头的源行
+static void vertical_scalar(const int32_t* const* rows, const int32_t* coefs, int32_t taps, int32_t width,
+                            int32_t* out) {
+    for (int32_t x = 0; x < width; x++) {
+        int32_t acc = kMidRound;
+        for (int32_t t = 0; t < taps; t++) {
+            acc += coefs[t] * rows[t][x];
+        }
+        out[x] = acc >> kMidShift;
+    }
+}
+
+// 标量参考实现：水平滤波，mid为垂直滤波后的中间行
+static void horizontal_scalar(const ScaleAxis* axis, const int32_t* mid, int32_t first, int32_t count, int32_t* out) {
+    int32_t taps = axis->taps;
+    for (int32_t x = first; x < first + count; x++) {
+        const int32_t* src = mid + axis->start[x];
+        const int32_t* coefs = &axis->coefs[(size_t)x * taps];
+        int32_t acc = kOutRound;
+        for (int32_t t = 0; t < taps; t++) {
+            acc += coefs[t] * src[t];
+        }
+        out[x] = acc >> kOutShift;
+    }
+}
+
+#ifdef DMS_SCALER_X86
+__attribute__((target("sse4.1")))
+static void vertical_sse41(const int32_t* const* rows, const int32_t* coefs, int32_t taps, int32_t width,
+                           int32_t* out) {
+    int32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i acc = _mm_set1_epi32(kMidRound);
+        for (int32_t t = 0; t < taps; t++) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(rows[t] + x));
+            acc = _mm_add_epi32(acc, _mm_mullo_epi32(v, _mm_set1_epi32(coefs[t])));
+        }
+        _mm_storeu_si128((__m128i*)(out + x), _mm_srai_epi32(acc, kMidShift));
+    }
+    const int32_t* rest[kMaxTaps];
+    for (int32_t t = 0; t < taps; t++) {
+        rest[t] = rows[t] + x;
+    }
+    vertical_scalar(rest, coefs, taps, width - x, out + x);
+}
+
+// 一个输出位置的向量点积，抽头数为4的倍数
+__attribute__((target("sse4.1")))
+static inline __m128i dot_sse41(const ScaleAxis* axis, const int32_t* mid, int32_t x) {
+    int32_t taps = axis->taps;
+    const int32_t* src = mid + axis->start[x];
+    const int32_t* coefs = &axis->coefs[(size_t)x * taps];
+    __m128i acc = _mm_setzero_si128();
+    for (int32_t t = 0; t < taps; t += 4) {
+        acc = _mm_add_epi32(acc, _mm_mullo_epi32(_mm_loadu_si128((const __m128i*)(src + t)),
+                                                 _mm_loadu_si128((const __m128i*)(coefs + t))));
+    }
+    return acc;
+}
+
+// 每次4个输出位置，各自做向量点积后一并横向求和
+__attribute__((target("sse4.1")))
+static void horizontal_sse41(const ScaleAxis* axis, const int32_t* mid, int32_t first, int32_t count, int32_t* out) {
+    int32_t x = first;
+    for (; x + 4 <= first + count; x += 4) {
+        __m128i s01 = _mm_hadd_epi32(dot_sse41(axis, mid, x), dot_sse41(axis, mid, x + 1));
+        __m128i s23 = _mm_hadd_epi32(dot_sse41(axis, mid, x + 2), dot_sse41(axis, mid, x + 3));
+        __m128i sum = _mm_add_epi32(_mm_hadd_epi32(s01, s23), _mm_set1_epi32(kOutRound));
+        _mm_storeu_si128((__m128i*)(out + x), _mm_srai_epi32(sum, kOutShift));
+    }
+    horizontal_scalar(axis, mid, x, first + count - x, out);
+}
+
+__attribute__((target("avx2")))
+static void vertical_avx2(const int32_t* const* rows, const int32_t* coefs, int32_t taps, int32_t width,
+                          int32_t* out) {
+    int32_t x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i acc = _mm256_set1_epi32(kMidRound);
+        for (int32_t t = 0; t < taps; t++) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(rows[t] + x));
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(v, _mm256_set1_epi32(coefs[t])));
+        }
+        _mm256_storeu_si256((__m256i*)(out + x), _mm256_srai_epi32(acc, kMidShift));
+    }
+    const int32_t* rest[kMaxTaps];
+    for (int32_t t = 0; t < taps; t++) {
+        rest[t] = rows[t] + x;
+    }
+    vertical_scalar(rest, coefs, taps, width - x, out + x);
+}
+
+// 一个输出位置的向量点积：8个抽头一组，余下4个用低半部分
+__attribute__((target("avx2")))
+static inline __m256i dot_avx2(const ScaleAxis* axis, const int32_t* mid, int32_t x) {
+    int32_t taps = axis->taps;
+    const int32_t* src = mid + axis->start[x];
+    const int32_t* coefs = &axis->coefs[(size_t)x * taps];
+    __m256i acc = _mm256_setzero_si256();
+    int32_t t = 0;
+    for (; t + 8 <= taps; t += 8) {
+        acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)(src + t)),
+                                                       _mm256_loadu_si256((const __m256i*)(coefs + t))));
+    }
+    if (t < taps) {
+        __m128i rest = _mm_mullo_epi32(_mm_loadu_si128((const __m128i*)(src + t)),
+                                       _mm_loadu_si128((const __m128i*)(coefs + t)));
+        acc = _mm256_add_epi32(acc, _mm256_inserti128_si256(_mm256_setzero_si256(), rest, 0));
+    }
+    return acc;
+}
+
+// 每次8个输出位置，各自做向量点积后一并横向求和
+__attribute__((target("avx2")))
+static void horizontal_avx2(const ScaleAxis* axis, const int32_t* mid, int32_t first, int32_t count, int32_t* out) {
+    int32_t x = first;
+    for (; x + 8 <= first + count; x += 8) {
+        // 两级横向相加后每个128位半部分含4个位置的部分和，高低两半相加得到8个位置
+        __m256i s01 = _mm256_hadd_epi32(dot_avx2(axis, mid, x), dot_avx2(axis, mid, x + 1));
+        __m256i s23 = _mm256_hadd_epi32(dot_avx2(axis, mid, x + 2), dot_avx2(axis, mid, x + 3));
+        __m256i s45 = _mm256_hadd_epi32(dot_avx2(axis, mid, x + 4), dot_avx2(axis, mid, x + 5));
+        __m256i s67 = _mm256_hadd_epi32(dot_avx2(axis, mid, x + 6), dot_avx2(axis, mid, x + 7));
+        __m256i q0 = _mm256_hadd_epi32(s01, s23);
+        __m256i q1 = _mm256_hadd_epi32(s45, s67);
+        __m256i sum = _mm256_add_epi32(_mm256_permute2x128_si256(q0, q1, 0x20), _mm256_permute2x128_si256(q0, q1, 0x31));
+        sum = _mm256_add_epi32(sum, _mm256_set1_epi32(kOutRound));
+        _mm256_storeu_si256((__m256i*)(out + x), _mm256_srai_epi32(sum, kOutShift));
+    }
+    horizontal_scalar(axis, mid, x, first + count - x, out);
+}
+#endif
+
+#ifdef DMS_SCALER_NEON
+static void vertical_neon(const int32_t* const* rows, const int32_t* coefs, int32_t taps, int32_t width,
+                          int32_t* out) {
+    int32_t x = 0;
+    for (; x + 4 <= width; x += 4) {
+        int32x4_t acc = vdupq_n_s32(kMidRound);
+        for (int32_t t = 0; t < taps; t++) {
+            acc = vmlaq_n_s32(acc, vld1q_s32(rows[t] + x), coefs[t]);
+        }
+        vst1q_s32(out + x, vshrq_n_s32(acc, kMidShift));
+    }
+    const int32_t* rest[kMaxTaps];
+    for (int32_t t = 0; t < taps; t++) {
+        rest[t] = rows[t] + x;
+    }
+    vertical_scalar(rest, coefs, taps, width - x, out + x);
+}
+
+// 一个输出位置的向量点积，高低两半相加为2个部分和，抽头数为4的倍数
+static inline int32x2_t dot_neon(const ScaleAxis* axis, const int32_t* mid, int32_t x) {
+    int32_t taps = axis->taps;
+    const int32_t* src = mid + axis->start[x];
+    const int32_t* coefs = &axis->coefs[(size_t)x * taps];
+    int32x4_t acc = vdupq_n_s32(0);
+    for (int32_t t = 0; t < taps; t += 4) {
+        acc = vmlaq_s32(acc, vld1q_s32(src + t), vld1q_s32(coefs + t));
+    }
+    return vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+}
+
+// 每次4个输出位置，各自做向量点积后一并两两相加
+static void horizontal_neon(const ScaleAxis* axis, const int32_t* mid, int32_t first, int32_t count, int32_t* out) {
+    int32_t x = first;
+    for (; x + 4 <= first + count; x += 4) {
+        int32x2_t s01 = vpadd_s32(dot_neon(axis, mid, x), dot_neon(axis, mid, x + 1));
+        int32x2_t s23 = vpadd_s32(dot_neon(axis, mid, x + 2), dot_neon(axis, mid, x + 3));
+        int32x4_t sum = vaddq_s32(vcombine_s32(s01, s23), vdupq_n_s32(kOutRound));
+        vst1q_s32(out + x, vshrq_n_s32(sum, kOutShift));
+    }
+    horizontal_scalar(axis, mid, x, first + count - x, out);
+}
+#endif
+
+/**
+ * @brief 保持宽高比放入目标区域的最大尺寸（另一方向居中加黑边），按整数运算四舍五入
+ * @param srcWidth 源宽度
+ * @param srcHeight 源高度
+ * @param boxWidth 目标区域宽度
+ * @param boxHeight 目标区域高度
+ * @param outWidth 输出适配宽度，参数无效时为0
+ * @param outHeight 输出适配高度，参数无效时为0
+ */
+void dms_scaler_fit(int32_t srcWidth, int32_t srcHeight, int32_t boxWidth, int32_t boxHeight, int32_t* outWidth,
+                    int32_t* outHeight) {
+    int32_t width = 0, height = 0;
+    if (srcWidth > 0 && srcHeight > 0 && boxWidth > 0 && boxHeight > 0) {
+        if ((int64_t)srcHeight * boxWidth <= (int64_t)boxHeight * srcWidth) {
+            width = boxWidth;
+            height = (int32_t)(((int64_t)srcHeight * boxWidth + srcWidth / 2) / srcWidth);
+        } else {
+            height = boxHeight;
+            width = (int32_t)(((int64_t)srcWidth * boxHeight + srcHeight / 2) / srcHeight);
+        }
+        width = std::min(std::max(width, 1), boxWidth);
+        height = std::min(std::max(height, 1), boxHeight);
+    }
+    if (outWidth) {
+        *outWidth = width;
+    }
+    if (outHeight) {
+        *outHeight = height;
+    }
+}
+
+/**
+ * @brief 创建缩放器：计算适配尺寸、画面位置与两个方向的多相系数
+ * @param config 缩放配置
+ * @return 成功返回缩放器指针，参数错误、缩小倍数过大或内核不受支持返回NULL
+ */
+struct DmsScaler* dms_scaler_create(const struct DmsScalerConfig* config) {
+    if (!config || config->srcWidth <= 0 || config->srcHeight <= 0 || config->dstWidth <= 0 ||
+        config->dstHeight <= 0 || config->squeeze < 0 || config->squeeze > 4 ||
+        (config->filter != DMS_SCALE_BICUBIC && config->filter != DMS_SCALE_LANCZOS3)) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    int kernel = config->kernel;
+    if (kernel == DMS_COLOR_KERNEL_AUTO) {
+        const int preferred[] = {DMS_COLOR_KERNEL_AVX2, DMS_COLOR_KERNEL_SSE41, DMS_COLOR_KERNEL_NEON};
+        kernel = DMS_COLOR_KERNEL_SCALAR;
+        for (int candidate : preferred) {
+            if (dms_color_kernel_supported(candidate)) {
+                kernel = candidate;
+                break;
+            }
+        }
+    } else if (!dms_color_kernel_supported(kernel)) {
+        LOGE("Scale kernel %s not supported on this CPU", dms_color_kernel_name(kernel));
+        return nullptr;
+    }
+
+    DmsScaler* scaler = new DmsScaler();
+    scaler->config = *config;
+    scaler->kernel = kernel;
+    // 压缩时按展开后的宽度适配，再把适配宽度按压缩倍数缩小
+    int32_t squeeze = std::max(config->squeeze, 1);
+    dms_scaler_fit(config->srcWidth, config->srcHeight, config->dstWidth * squeeze, config->dstHeight,
+                   &scaler->fitWidth, &scaler->fitHeight);
+    scaler->fitWidth = std::min(std::max((scaler->fitWidth + squeeze / 2) / squeeze, 1), config->dstWidth);
+    scaler->left = (config->dstWidth - scaler->fitWidth) / 2;
+    scaler->top = (config->dstHeight - scaler->fitHeight) / 2;
+    // 水平方向逐像素点积，抽头补齐到4的倍数；垂直方向按行合并，不补齐
+    if (build_axis(&scaler->horizontal, config->srcWidth, scaler->fitWidth, config->filter, 4) != 0 ||
+        build_axis(&scaler->vertical, config->srcHeight, scaler->fitHeight, config->filter, 1) != 0) {
+        LOGE("Scale %dx%d to %dx%d not supported", config->srcWidth, config->srcHeight, scaler->fitWidth,
+             scaler->fitHeight);
+        delete scaler;
+        return nullptr;
+    }
+    LOGI("Scaler created: %dx%d to %dx%d at (%d, %d) in %dx%d, taps %d/%d, kernel %s", config->srcWidth,
+         config->srcHeight, scaler->fitWidth, scaler->fitHeight, scaler->left, scaler->top, config->dstWidth,
+         config->dstHeight, scaler->horizontal.taps, scaler->vertical.taps, dms_color_kernel_name(kernel));
+    return scaler;
+}
+
+/**
+ * @brief 销毁缩放器
+ * @param scaler 缩放器
+ */
+void dms_scaler_destroy(struct DmsScaler* scaler) {
+    delete scaler;
+}
+
+/**
+ * @brief 适配尺寸是否与源尺寸一致（只加黑边，不缩放）
+ * @param scaler 缩放器
+ * @return 不缩放返回true
+ */
+bool dms_scaler_is_identity(const struct DmsScaler* scaler) {
+    return scaler && scaler->horizontal.taps == 0 && scaler->vertical.taps == 0;
+}
+
+/**
+ * @brief 实际使用的内核
+ * @param scaler 缩放器
+ * @return 内核，DmsColorKernel；参数错误返回-1
+ */
+int dms_scaler_get_kernel(const struct DmsScaler* scaler) {
+    return scaler ? scaler->kernel : -1;
+}
+
+/**
+ * @brief 输出目标图像的[firstRow, firstRow + rowCount)行：画面区域内逐行缩放、转换并打包，
+ *        其余填黑。各段使用自己的中间行，可把一帧分成多段在多个线程中同时处理
+ * @param scaler 缩放器
+ * @param picture 解码图像（3分量X'Y'Z'，尺寸须与创建时的源尺寸一致）
+ * @param converter 色彩转换器
+ * @param firstRow 目标图像的起始行
+ * @param rowCount 行数
+ * @param out 目标图像第0行的起始地址
+ * @param outStride 目标每行字节数（不小于dstWidth * 4）
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_scaler_process(struct DmsScaler* scaler, const struct DmsPicture* picture,
+                       struct DmsColorConverter* converter, int32_t firstRow, int32_t rowCount, void* out,
+                       int32_t outStride) {
+    if (!scaler || !picture || !converter || !out || picture->components < 3 ||
+        picture->width != scaler->config.srcWidth || picture->height != scaler->config.srcHeight || firstRow < 0 ||
+        rowCount < 0 || firstRow + rowCount > scaler->config.dstHeight || outStride < scaler->config.dstWidth * 4) {
+        LOGE("Invalid parameters");
+        return -1;
+    }
+    void (*vertical)(const int32_t* const*, const int32_t*, int32_t, int32_t, int32_t*) = vertical_scalar;
+    void (*horizontal)(const ScaleAxis*, const int32_t*, int32_t, int32_t, int32_t*) = horizontal_scalar;
+#ifdef DMS_SCALER_X86
+    if (scaler->kernel == DMS_COLOR_KERNEL_AVX2) {
+        vertical = vertical_avx2;
+        horizontal = horizontal_avx2;
+    } else if (scaler->kernel == DMS_COLOR_KERNEL_SSE41) {
+        vertical = vertical_sse41;
+        horizontal = horizontal_sse41;
+    }
+#endif
+#ifdef DMS_SCALER_NEON
+    if (scaler->kernel == DMS_COLOR_KERNEL_NEON) {
+        vertical = vertical_neon;
+        horizontal = horizontal_neon;
+    }
+#endif
+
+    const int32_t srcWidth = scaler->config.srcWidth;
+    const int32_t dstWidth = scaler->config.dstWidth;
+    const int32_t fitWidth = scaler->fitWidth;
+    const ScaleAxis* h = &scaler->horizontal;
+    const ScaleAxis* v = &scaler->vertical;
+    const uint32_t black = dms_color_black_pixel(converter);
+    std::vector<int32_t> mid[3];
+    std::vector<int32_t> line[3];
+    // 超出码值范围的振铃由色彩转换截断
+    for (int p = 0; p < 3 && !dms_scaler_is_identity(scaler); p++) {
+        mid[p].resize(srcWidth);
+        line[p].resize(fitWidth);
+    }
+    for (int32_t row = firstRow; row < firstRow + rowCount; row++) {
+        uint32_t* dst = (uint32_t*)((uint8_t*)out + (size_t)row * outStride);
+        int32_t o = row - scaler->top;
+        if (o < 0 || o >= scaler->fitHeight) {
+            std::fill(dst, dst + dstWidth, black);
+            continue;
+        }
+        std::fill(dst, dst + scaler->left, black);
+        std::fill(dst + scaler->left + fitWidth, dst + dstWidth, black);
+        const int32_t* xyz[3];
+        for (int p = 0; p < 3; p++) {
+            // 垂直：合并源行得到Q4中间行；不缩放时直接取源行
+            const int32_t* src = picture->planes[p] + (size_t)(v->taps > 0 ? 0 : o) * srcWidth;
+            int32_t shift = 0;
+            if (v->taps > 0) {
+                const int32_t* rows[kMaxTaps];
+                for (int32_t t = 0; t < v->taps; t++) {
+                    rows[t] = picture->planes[p] + (size_t)(v->start[o] + t) * srcWidth;
+                }
+                vertical(rows, &v->coefs[(size_t)o * v->taps], v->taps, srcWidth, mid[p].data());
+                src = mid[p].data();
+                shift = kMidFraction;
+            }
+            // 水平：中间行（或源行左移为Q4）按多相系数合并；不缩放时去掉小数位
+            if (h->taps > 0) {
+                if (shift == 0) {
+                    for (int32_t x = 0; x < srcWidth; x++) {
+                        mid[p][x] = src[x] << kMidFraction;
+                    }
+                    src = mid[p].data();
+                }
+                horizontal(h, src, 0, fitWidth, line[p].data());
+                xyz[p] = line[p].data();
+            } else if (shift > 0) {
+                for (int32_t x = 0; x < fitWidth; x++) {
+                    line[p][x] = (src[x] + (1 << (kMidFraction - 1))) >> kMidFraction;
+                }
+                xyz[p] = line[p].data();
+            } else {
+                xyz[p] = src;
+            }
+        }
+        dms_color_convert_row(converter, xyz[0], xyz[1], xyz[2], fitWidth, dst + scaler->left);
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef DMS_SCALER_H
+#define DMS_SCALER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 缩放与加黑边
+ *
+ * DCI画面（flat 1998x1080、scope 2048x858等）按原宽高比适配任意尺寸的屏幕：居中放置，缩放到
+ * 恰好放入屏幕的尺寸，其余部分填黑。缩放在色彩转换之前、X'Y'Z'码值上进行（与在显示信号上缩放
+ * 等价的非线性域），每个输出行依次完成：
+ *   1. 垂直滤波：按该行的多相系数合并若干源行，得到带4位小数的中间行；
+ *   2. 水平滤波：按每个输出像素的多相系数合并中间行的相邻采样，得到输出宽度的X'Y'Z'行；
+ *   3. 色彩转换（含3D LUT）并打包为输出格式，直接写入目标行的画面区域，左右黑边随之填写。
+ * 目标缓冲区每个像素只写一次；上下黑边行直接填黑。
+ *
+ * 多相系数按输出位置预先计算为Q12定点，缩小时滤波器按缩小倍数展宽（抗混叠），边缘采样向内
+ * 折叠；水平方向抽头数补齐到4的倍数。全为整数运算：垂直滤波一次处理一行中相邻的多个像素，
+ * 水平滤波对相邻的多个输出位置各做向量点积后一并横向求和，AVX2、SSE4.1与NEON内核与标量参考
+ * 实现的输出逐位一致。
+ *
+ * 适配尺寸与源图像尺寸一致（解码时选择的J2K分辨率层恰好符合屏幕，或只需加黑边）时不缩放，
+ * 源行直接转换到目标行。
+ *
+ * 半宽左右格式（立体3D）的每只眼按整屏适配后水平压缩一半放入半屏，由眼镜或显示器还原宽度，见squeeze。
+ */
+
+struct DmsPicture;
+struct DmsColorConverter;
+
+// 缩放滤波器
+enum DmsScaleFilter {
+    DMS_SCALE_BICUBIC = 0,       // 双三次（Catmull-Rom），放大时4抽头
+    DMS_SCALE_LANCZOS3 = 1,      // Lanczos-3，放大时6抽头（补齐为8）
+};
+
+// 缩放配置
+struct DmsScalerConfig {
+    int32_t srcWidth;        // 源图像宽度
+    int32_t srcHeight;       // 源图像高度
+    int32_t dstWidth;        // 目标（屏幕）宽度
+    int32_t dstHeight;       // 目标（屏幕）高度
+    int32_t filter;          // 缩放滤波器，DmsScaleFilter
+    int32_t kernel;          // 缩放内核，DmsColorKernel
+    int32_t squeeze;         // 水平压缩倍数，0或1为不压缩；半宽左右格式3D为2：按dstWidth*squeeze适配后宽度除以squeeze
+};
+
+struct DmsScaler;
+
+void dms_scaler_fit(int32_t srcWidth, int32_t srcHeight, int32_t boxWidth, int32_t boxHeight,
+                    int32_t* outWidth, int32_t* outHeight);         // 保持宽高比放入目标区域的尺寸
+struct DmsScaler* dms_scaler_create(const struct DmsScalerConfig* config); // 创建缩放器（计算多相系数）
+void dms_scaler_destroy(struct DmsScaler* scaler);                 // 销毁缩放器
+bool dms_scaler_is_identity(const struct DmsScaler* scaler);       // 适配尺寸与源尺寸一致，不缩放
+int dms_scaler_get_kernel(const struct DmsScaler* scaler);          // 实际使用的内核
+int dms_scaler_process(struct DmsScaler* scaler, const struct DmsPicture* picture,
+                       struct DmsColorConverter* converter, int32_t firstRow, int32_t rowCount, void* out,
+                       int32_t outStride);                          // 缩放、转换并加黑边，输出目标图像的若干行
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_SCALER_H
@@ -0,0 +1,228 @@
+#include "dms_step_window.h"
+#include "dms_log.h"
+#include <vector>
+
+#define LOG_TAG "DmsStepWindow"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const float kEwmaAlpha = 0.3f;
+static const float kInitialSeekUs = 10000.0f;  // 尚无实测时按10ms定位、5ms单帧读取估算
+static const float kInitialFetchUs = 5000.0f;
+static const float kBudgetShare = 0.8f;        // 读取只占时延目标的80%，余量留给复制与调度
+
+struct StepSlot {
+    int64_t frame;
+    DmsDataUnitPtr unit;
+};
+
+struct DmsStepWindow {
+    int capacity;
+    std::vector<StepSlot> slots;   // 帧数很少，线性查找即可
+    float seekCostUs;
+    float fetchCostUs;
+    struct DmsStepStats stats;
+};
+
+static void ewma_update(float* value, float sample) {
+    *value = (*value <= 0.0f) ? sample : *value + kEwmaAlpha * (sample - *value);
+}
+
+/**
+ * @brief 创建逐帧步进窗口
+ * @param capacity 最多保留的帧数
+ * @return 成功返回窗口指针，失败返回NULL
+ */
+struct DmsStepWindow* dms_step_window_create(int capacity) {
+    if (capacity <= 0) {
+        LOGE("Invalid capacity: %d", capacity);
+        return nullptr;
+    }
+    DmsStepWindow* window = new DmsStepWindow();
+    window->capacity = capacity;
+    window->slots.reserve(capacity);
+    window->seekCostUs = 0.0f;
+    window->fetchCostUs = 0.0f;
+    window->stats = {};
+    return window;
+}
+
+/**
+ * @brief 释放窗口及其中的数据单元
+ * @param window 步进窗口
+ */
+void dms_step_window_destroy(struct DmsStepWindow* window) {
+    if (!window) {
+        return;
+    }
+    dms_step_window_clear(window);
+    LOGI("Step window: %lld steps, %lld hits, %lld over target, max %lldus",
+         (long long)window->stats.steps, (long long)window->stats.hits,
+         (long long)window->stats.overTarget, (long long)window->stats.maxLatencyUs);
+    delete window;
+}
+
+/**
+ * @brief 释放窗口中的全部数据单元，实测耗时保留
+ * @param window 步进窗口
+ */
+void dms_step_window_clear(struct DmsStepWindow* window) {
+    if (!window) {
+        return;
+    }
+    for (StepSlot& slot : window->slots) {
+        _dms_free_data_unit(&slot.unit);
+    }
+    window->slots.clear();
+}
+
+/**
+ * @brief 最多保留的帧数
+ * @param window 步进窗口
+ * @return 帧数
+ */
+int dms_step_window_get_capacity(struct DmsStepWindow* window) {
+    return window ? window->capacity : 0;
+}
+
+/**
+ * @brief 放入数据单元，窗口取得其所有权；帧已存在时替换，窗口满时淘汰离center最远的帧
+ * @param window 步进窗口
+ * @param frame 帧号
+ * @param unit 数据单元
+ * @param center 当前帧号，决定淘汰顺序
+ */
+void dms_step_window_put(struct DmsStepWindow* window, int64_t frame, DmsDataUnitPtr unit, int64_t center) {
+    if (!window || !unit) {
+        return;
+    }
+    for (StepSlot& slot : window->slots) {
+        if (slot.frame == frame) {
+            _dms_free_data_unit(&slot.unit);
+            slot.unit = unit;
+            return;
+        }
+    }
+
+    if ((int)window->slots.size() < window->capacity) {
+        window->slots.push_back({frame, unit});
+        return;
+    }
+
+    size_t farthest = 0;
+    int64_t farthestDistance = -1;
+    for (size_t i = 0; i < window->slots.size(); i++) {
+        int64_t distance = window->slots[i].frame - center;
+        distance = distance < 0 ? -distance : distance;
+        if (distance > farthestDistance) {
+            farthest = i;
+            farthestDistance = distance;
+        }
+    }
+    int64_t distance = frame > center ? frame - center : center - frame;
+    if (distance >= farthestDistance) {
+        // 新帧本身离得最远，不保留
+        _dms_free_data_unit(&unit);
+        return;
+    }
+    _dms_free_data_unit(&window->slots[farthest].unit);
+    window->slots[farthest] = {frame, unit};
+}
+
+/**
+ * @brief 查询窗口中的帧
+ * @param window 步进窗口
+ * @param frame 帧号
+ * @return 命中返回数据单元（仍归窗口所有），未命中返回NULL
+ */
+const DmsDataUnit* dms_step_window_get(struct DmsStepWindow* window, int64_t frame) {
+    if (!window) {
+        return nullptr;
+    }
+    for (const StepSlot& slot : window->slots) {
+        if (slot.frame == frame) {
+            return slot.unit;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 估算时延目标内应读取的帧数：(目标×80% − 定位耗时) / 单帧读取耗时，至少1帧
+ * @param window 步进窗口
+ * @param needSeek 是否需要定位
+ * @param maxFrames 最多读取的帧数
+ * @return 帧数
+ */
+int dms_step_window_plan(struct DmsStepWindow* window, bool needSeek, int maxFrames) {
+    if (!window || maxFrames <= 1) {
+        return 1;
+    }
+    float seekUs = window->seekCostUs > 0.0f ? window->seekCostUs : kInitialSeekUs;
+    float fetchUs = window->fetchCostUs > 0.0f ? window->fetchCostUs : kInitialFetchUs;
+    float budgetUs = (float)DMS_STEP_LATENCY_TARGET_US * kBudgetShare - (needSeek ? seekUs : 0.0f);
+    int frames = (int)(budgetUs / fetchUs);
+    if (frames < 1) {
+        return 1;
+    }
+    return frames > maxFrames ? maxFrames : frames;
+}
+
+/**
+ * @brief 上报一次定位+读取耗时
+ * @param window 步进窗口
+ * @param seekUs 定位耗时（微秒），未定位填负数
+ * @param readUs 读取耗时（微秒）
+ * @param frames 读取帧数
+ */
+void dms_step_window_report_fetch(struct DmsStepWindow* window, int64_t seekUs, int64_t readUs, int frames) {
+    if (!window) {
+        return;
+    }
+    if (seekUs >= 0) {
+        ewma_update(&window->seekCostUs, (float)seekUs);
+    }
+    if (frames > 0) {
+        ewma_update(&window->fetchCostUs, (float)readUs / (float)frames);
+    }
+}
+
+/**
+ * @brief 上报一次步进
+ * @param window 步进窗口
+ * @param hit 是否由窗口直接返回
+ * @param latencyUs 时延（微秒）
+ */
+void dms_step_window_report_step(struct DmsStepWindow* window, bool hit, int64_t latencyUs) {
+    if (!window) {
+        return;
+    }
+    window->stats.steps++;
+    if (hit) {
+        window->stats.hits++;
+    }
+    if (latencyUs > window->stats.maxLatencyUs) {
+        window->stats.maxLatencyUs = latencyUs;
+    }
+    if (latencyUs > DMS_STEP_LATENCY_TARGET_US) {
+        window->stats.overTarget++;
+        LOGI("Step took %lldus (seek %.0fus, fetch %.0fus/frame)",
+             (long long)latencyUs, window->seekCostUs, window->fetchCostUs);
+    }
+}
+
+/**
+ * @brief 获取步进统计信息
+ * @param window 步进窗口
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回-1
+ */
+int dms_step_window_get_stats(struct DmsStepWindow* window, struct DmsStepStats* outStats) {
+    if (!window || !outStats) {
+        return -1;
+    }
+    *outStats = window->stats;
+    outStats->seekCostUs = window->seekCostUs;
+    outStats->fetchCostUs = window->fetchCostUs;
+    return 0;
+}
@@ -0,0 +1,51 @@
+#ifndef DMS_STEP_WINDOW_H
+#define DMS_STEP_WINDOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "libdms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 逐帧步进窗口
+ *
+ * 保留当前帧附近最近读取的若干数据单元，单帧前进/后退优先由窗口直接返回；
+ * 未命中时由播放器定位读取一小段，读取帧数按实测的定位与单帧读取耗时
+ * 限制在时延预算内，多读的帧留在窗口中供后续步进使用。
+ */
+
+#define DMS_STEP_LATENCY_TARGET_US 30000   // 单次步进的时延目标（微秒）
+
+// 步进统计信息
+struct DmsStepStats {
+    int64_t steps;           // 步进/按帧定位次数
+    int64_t hits;            // 由窗口直接返回的次数
+    int64_t overTarget;      // 超出时延目标的次数
+    int64_t maxLatencyUs;    // 最大时延（微秒）
+    float seekCostUs;        // 单次定位耗时的滑动平均（微秒）
+    float fetchCostUs;       // 单帧读取耗时的滑动平均（微秒）
+};
+
+struct DmsStepWindow;
+
+struct DmsStepWindow* dms_step_window_create(int capacity);      // 创建窗口，capacity为最多保留的帧数
+void dms_step_window_destroy(struct DmsStepWindow* window);      // 释放窗口及其中的数据单元
+void dms_step_window_clear(struct DmsStepWindow* window);        // 释放窗口中的全部数据单元
+int dms_step_window_get_capacity(struct DmsStepWindow* window);  // 最多保留的帧数
+void dms_step_window_put(struct DmsStepWindow* window, int64_t frame, DmsDataUnitPtr unit,
+                         int64_t center);                        // 放入数据单元（取得所有权），满时淘汰离center最远的帧
+const DmsDataUnit* dms_step_window_get(struct DmsStepWindow* window, int64_t frame); // 查询帧，未命中返回NULL
+int dms_step_window_plan(struct DmsStepWindow* window, bool needSeek, int maxFrames); // 时延预算内应读取的帧数
+void dms_step_window_report_fetch(struct DmsStepWindow* window, int64_t seekUs, int64_t readUs,
+                                  int frames);                   // 上报一次定位+读取耗时
+void dms_step_window_report_step(struct DmsStepWindow* window, bool hit, int64_t latencyUs); // 上报一次步进
+int dms_step_window_get_stats(struct DmsStepWindow* window, struct DmsStepStats* outStats); // 获取统计信息
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_STEP_WINDOW_H
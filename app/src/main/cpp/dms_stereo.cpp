@@ -0,0 +1,205 @@
+#include "dms_stereo.h"
+#include "dms_log.h"
+#include <deque>
+#include <mutex>
+
+#define LOG_TAG "DmsStereo"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+struct PairEntry {
+    int32_t reel;
+    int64_t leftPos;
+    DmsDataUnitPtr right;
+};
+
+struct DmsStereoPairs {
+    std::mutex mutex;                // 预读线程放入、取帧线程取出
+    std::deque<PairEntry> entries;   // 按读取顺序，表头最早
+    int32_t capacity;
+    struct DmsStereoPairsStats stats;
+};
+
+/**
+ * @brief 是否为有效的立体输出方式
+ * @param mode 输出方式，DmsStereoMode
+ * @return 有效返回true
+ */
+bool dms_stereo_mode_valid(int mode) {
+    return mode >= DMS_STEREO_LEFT_ONLY && mode <= DMS_STEREO_FRAME_SEQUENTIAL_DOUBLE;
+}
+
+/**
+ * @brief 输出方式是否需要右眼，只显示左眼时不读取右眼
+ * @param mode 输出方式，DmsStereoMode
+ * @return 需要返回true
+ */
+bool dms_stereo_mode_both_eyes(int mode) {
+    return dms_stereo_mode_valid(mode) && mode != DMS_STEREO_LEFT_ONLY;
+}
+
+/**
+ * @brief 每帧时长内依次显示的眼图像数
+ * @param mode 输出方式，DmsStereoMode
+ * @return 帧序列单闪为2、双闪为4，其余为1
+ */
+int dms_stereo_mode_fields(int mode) {
+    switch (mode) {
+        case DMS_STEREO_FRAME_SEQUENTIAL:
+            return 2;
+        case DMS_STEREO_FRAME_SEQUENTIAL_DOUBLE:
+            return 4;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief 输出方式名称，用于日志
+ * @param mode 输出方式，DmsStereoMode
+ * @return 名称字符串
+ */
+const char* dms_stereo_mode_name(int mode) {
+    switch (mode) {
+        case DMS_STEREO_LEFT_ONLY:
+            return "left-only";
+        case DMS_STEREO_SIDE_BY_SIDE:
+            return "side-by-side";
+        case DMS_STEREO_FRAME_SEQUENTIAL:
+            return "frame-sequential";
+        case DMS_STEREO_FRAME_SEQUENTIAL_DOUBLE:
+            return "frame-sequential-double";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * @brief 两个相邻数据单元是否同一帧的左右眼：立体MXF中同一帧的两眼PTS相同
+ * @param left 先读出的数据单元
+ * @param right 紧随其后的数据单元
+ * @return 是同一帧返回true
+ */
+bool dms_stereo_is_pair(const DmsDataUnit* left, const DmsDataUnit* right) {
+    return left && right && left->PTS == right->PTS && left->Pos != right->Pos;
+}
+
+/**
+ * @brief 创建配对表
+ * @param capacity 最多暂存的右眼单元数，应覆盖预读缓冲与并行解码中的帧数
+ * @return 成功返回配对表指针，参数错误返回NULL
+ */
+struct DmsStereoPairs* dms_stereo_pairs_create(int32_t capacity) {
+    if (capacity <= 0) {
+        LOGE("Invalid capacity: %d", capacity);
+        return nullptr;
+    }
+    DmsStereoPairs* pairs = new DmsStereoPairs();
+    pairs->capacity = capacity;
+    pairs->stats = {};
+    return pairs;
+}
+
+/**
+ * @brief 释放暂存的右眼单元并销毁配对表
+ * @param pairs 配对表
+ */
+void dms_stereo_pairs_destroy(struct DmsStereoPairs* pairs) {
+    if (!pairs) {
+        return;
+    }
+    dms_stereo_pairs_clear(pairs);
+    delete pairs;
+}
+
+/**
+ * @brief 释放暂存的右眼单元（定位、停止预读或换片时对应的左眼已丢弃）
+ * @param pairs 配对表
+ */
+void dms_stereo_pairs_clear(struct DmsStereoPairs* pairs) {
+    if (!pairs) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(pairs->mutex);
+    for (PairEntry& entry : pairs->entries) {
+        _dms_free_data_unit(&entry.right);
+    }
+    pairs->entries.clear();
+    pairs->stats.held = 0;
+}
+
+/**
+ * @brief 放入右眼单元。同一左眼已有右眼时替换；超出容量时淘汰最早的右眼单元
+ * @param pairs 配对表
+ * @param reel 分本序号
+ * @param leftPos 同一帧左眼单元的Pos
+ * @param right 右眼单元，所有权归配对表（失败时也由配对表释放）
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_stereo_pairs_put(struct DmsStereoPairs* pairs, int32_t reel, int64_t leftPos, DmsDataUnitPtr right) {
+    if (!pairs || !right) {
+        LOGE("Invalid parameters");
+        if (right) {
+            _dms_free_data_unit(&right);
+        }
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(pairs->mutex);
+    for (PairEntry& entry : pairs->entries) {
+        if (entry.reel == reel && entry.leftPos == leftPos) {
+            _dms_free_data_unit(&entry.right);
+            entry.right = right;
+            pairs->stats.puts++;
+            return 0;
+        }
+    }
+    while ((int32_t)pairs->entries.size() >= pairs->capacity) {
+        _dms_free_data_unit(&pairs->entries.front().right);
+        pairs->entries.pop_front();
+        pairs->stats.evictions++;
+    }
+    pairs->entries.push_back({reel, leftPos, right});
+    pairs->stats.puts++;
+    pairs->stats.held = (int32_t)pairs->entries.size();
+    return 0;
+}
+
+/**
+ * @brief 取出左眼对应的右眼单元。按读取顺序取帧时通常位于表头
+ * @param pairs 配对表
+ * @param reel 分本序号
+ * @param leftPos 左眼单元的Pos
+ * @return 右眼单元，使用后由_dms_free_data_unit释放；没有时返回NULL
+ */
+DmsDataUnitPtr dms_stereo_pairs_take(struct DmsStereoPairs* pairs, int32_t reel, int64_t leftPos) {
+    if (!pairs) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(pairs->mutex);
+    for (auto it = pairs->entries.begin(); it != pairs->entries.end(); ++it) {
+        if (it->reel == reel && it->leftPos == leftPos) {
+            DmsDataUnitPtr right = it->right;
+            pairs->entries.erase(it);
+            pairs->stats.takes++;
+            pairs->stats.held = (int32_t)pairs->entries.size();
+            return right;
+        }
+    }
+    pairs->stats.misses++;
+    return nullptr;
+}
+
+/**
+ * @brief 获取配对表统计信息
+ * @param pairs 配对表
+ * @param outStats 输出统计信息
+ * @return 成功返回0，参数错误返回-1
+ */
+int dms_stereo_pairs_get_stats(struct DmsStereoPairs* pairs, struct DmsStereoPairsStats* outStats) {
+    if (!pairs || !outStats) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(pairs->mutex);
+    *outStats = pairs->stats;
+    return 0;
+}
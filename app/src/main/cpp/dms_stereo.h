@@ -0,0 +1,68 @@
+#ifndef DMS_STEREO_H
+#define DMS_STEREO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "libdms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 立体（3D）DCP
+ *
+ * 立体图像MXF中左右眼码流交替存放：每帧先左眼后右眼两个数据单元，PTS相同（libdms的数据单元
+ * 没有眼别标识，按PTS即帧号配对）。打开DCP时比较前两个数据单元的PTS识别立体素材，之后播放器
+ * 按左眼单元计帧：帧号、帧索引、定位与码流缓存只涉及左眼，右眼单元随左眼读出后暂存在配对表，
+ * 取帧时按左眼的Pos取出附在输出帧上（DmsFrame::rightUnit），两眼由不同的解码线程同时解码。
+ * 定位落在右眼单元上时丢弃该单元，从下一帧的左眼开始。
+ *
+ * 输出方式（DmsStereoMode）：
+ *   - 只显示左眼：不读取右眼（2D回退），解码量与2D相同；
+ *   - 左右并排：两眼并排输出在一帧中，指定输出尺寸时为半宽（每眼水平压缩一半）；
+ *   - 帧序列：每帧时长内左右眼交替显示，单闪（24fps时48Hz）或双闪（L R L R，96Hz），
+ *     由快门眼镜或主动式3D显示器同步。
+ * 倒放、倍速、逐帧步进与缩略图只使用左眼。
+ */
+
+// 立体输出方式
+enum DmsStereoMode {
+    DMS_STEREO_LEFT_ONLY = 0,            // 只显示左眼（2D回退）
+    DMS_STEREO_SIDE_BY_SIDE = 1,         // 左右并排
+    DMS_STEREO_FRAME_SEQUENTIAL = 2,     // 帧序列单闪：每帧L R各一次（24fps时48Hz）
+    DMS_STEREO_FRAME_SEQUENTIAL_DOUBLE = 3, // 帧序列双闪：每帧L R L R（24fps时96Hz）
+};
+
+// 配对表统计信息
+struct DmsStereoPairsStats {
+    int64_t puts;            // 放入的右眼单元数
+    int64_t takes;           // 按左眼取出的右眼单元数
+    int64_t misses;          // 取出时没有对应右眼的次数
+    int64_t evictions;       // 因容量淘汰的右眼单元数
+    int32_t held;            // 当前暂存的右眼单元数
+};
+
+struct DmsStereoPairs;
+
+bool dms_stereo_mode_valid(int mode);                        // 是否为有效的输出方式
+bool dms_stereo_mode_both_eyes(int mode);                    // 该输出方式是否需要右眼
+int dms_stereo_mode_fields(int mode);                        // 每帧显示的眼图像数（帧序列为2或4，其余为1）
+const char* dms_stereo_mode_name(int mode);                  // 输出方式名称
+bool dms_stereo_is_pair(const DmsDataUnit* left, const DmsDataUnit* right); // 两个数据单元是否同一帧的左右眼
+
+struct DmsStereoPairs* dms_stereo_pairs_create(int32_t capacity); // 创建配对表，超出容量时淘汰最早的右眼单元
+void dms_stereo_pairs_destroy(struct DmsStereoPairs* pairs);     // 释放暂存的右眼单元并销毁配对表
+void dms_stereo_pairs_clear(struct DmsStereoPairs* pairs);       // 释放暂存的右眼单元
+int dms_stereo_pairs_put(struct DmsStereoPairs* pairs, int32_t reel, int64_t leftPos,
+                         DmsDataUnitPtr right);                  // 放入右眼单元（接管所有权）
+DmsDataUnitPtr dms_stereo_pairs_take(struct DmsStereoPairs* pairs, int32_t reel,
+                                     int64_t leftPos);           // 取出左眼对应的右眼单元，没有返回NULL
+int dms_stereo_pairs_get_stats(struct DmsStereoPairs* pairs,
+                               struct DmsStereoPairsStats* outStats); // 获取统计信息
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_STEREO_H
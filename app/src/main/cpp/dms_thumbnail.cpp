@@ -0,0 +1,490 @@
+#include "dms_thumbnail.h"
+#include "dms_player.h"
+#include "dms_log.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define LOG_TAG "DmsThumbnail"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static const int kMaxThreads = 8;
+static const int kQueuePerThread = 2;          // 每个解码线程最多排队的码流数，限制解密码流占用的内存
+static const int64_t kRetryDelayUs = 500000;   // 样本暂不可取（其他分本/未索引）时的重试间隔
+static const int64_t kFetchGapUs = 2000;       // 两次取样之间让出libdms，避免挤占播放读取
+static const float kEwmaAlpha = 0.3f;
+
+enum SampleState : uint8_t {
+    kSamplePending = 0,
+    kSampleQueued,
+    kSampleReady,
+    kSampleFailed,
+    kSampleSkipped,
+};
+
+struct ThumbnailJob {
+    int32_t sample;
+    DmsDataUnitPtr unit;
+};
+
+struct DmsThumbnailAtlas {
+    DmsContext* ctx;
+    DmsThumbnailConfig config;
+    DmsThumbnailDecodeFun decode;
+    void* user;
+    DmsJ2kDecoder* decoder;             // dms_thumbnail_create_j2k创建的解码器，随图集销毁
+    int32_t sampleCount;
+    int32_t threadCount;
+
+    std::vector<uint16_t> pixels;       // RGB565图集，样本按序首尾相接
+    std::vector<uint8_t> states;
+    std::vector<int64_t> retryAtUs;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<ThumbnailJob> jobs;
+    std::thread fetcher;
+    std::vector<std::thread> decoders;
+    bool stopping;
+    bool fetchDone;
+    int64_t hintFrame;
+    bool hintPending;                   // 查询位置变化后尚未为其取样，允许越过排队上限取一个样本
+    int32_t readyCount;
+    int32_t failedCount;
+    int32_t skippedCount;
+    float fetchCostUs;
+    float decodeCostUs;
+};
+
+static int64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static void ewma_update(float* value, float sample) {
+    *value = (*value <= 0.0f) ? sample : *value + kEwmaAlpha * (sample - *value);
+}
+
+static inline uint16_t argb_to_rgb565(uint32_t argb) {
+    return (uint16_t)(((argb >> 8) & 0xF800) | ((argb >> 5) & 0x07E0) | ((argb >> 3) & 0x001F));
+}
+
+static inline uint32_t rgb565_to_argb(uint16_t p) {
+    uint32_t r = (p >> 11) & 0x1F, g = (p >> 5) & 0x3F, b = p & 0x1F;
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+    return 0xFF000000u | (r << 16) | (g << 8) | b;
+}
+
+/**
+ * @brief 清零并释放数据单元，解密后的码流不在内存中残留
+ * @param unit 数据单元
+ */
+static void wipe_unit(DmsDataUnitPtr* unit) {
+    if (*unit && (*unit)->Data) {
+        memset((*unit)->Data, 0, (*unit)->Length);
+    }
+    _dms_free_data_unit(unit);
+}
+
+/**
+ * @brief 离帧号最近的样本序号
+ * @param atlas 缩略图图集
+ * @param frame 整部影片帧号
+ * @return 样本序号
+ */
+static int32_t sample_of(const DmsThumbnailAtlas* atlas, int64_t frame) {
+    int64_t sample = (frame + atlas->config.intervalFrames / 2) / atlas->config.intervalFrames;
+    return (int32_t)(sample < atlas->sampleCount ? sample : atlas->sampleCount - 1);
+}
+
+/**
+ * @brief 选择下一个要读取的样本：离最近一次查询位置最近、且已到重试时间的待读样本。调用者需持有mutex
+ * @param atlas 缩略图图集
+ * @param nowUs 当前时间
+ * @param outPending 输出是否还有待读样本（含未到重试时间的）
+ * @return 样本序号，没有可读样本返回-1
+ */
+static int32_t pick_sample_locked(DmsThumbnailAtlas* atlas, int64_t nowUs, bool* outPending) {
+    int32_t center = sample_of(atlas, atlas->hintFrame);
+    *outPending = false;
+    for (int32_t d = 0; d < atlas->sampleCount; d++) {
+        int32_t candidates[2] = {center + d, center - d};
+        for (int k = 0; k < (d == 0 ? 1 : 2); k++) {
+            int32_t i = candidates[k];
+            if (i < 0 || i >= atlas->sampleCount || atlas->states[i] != kSamplePending) {
+                continue;
+            }
+            *outPending = true;
+            if (atlas->retryAtUs[i] <= nowUs) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+static void fetch_main(DmsThumbnailAtlas* atlas) {
+    const size_t maxJobs = (size_t)(atlas->threadCount * kQueuePerThread);
+    std::unique_lock<std::mutex> lock(atlas->mutex);
+    while (!atlas->stopping) {
+        atlas->cv.wait(lock, [atlas, maxJobs] {
+            return atlas->stopping || atlas->hintPending || atlas->jobs.size() < maxJobs;
+        });
+        if (atlas->stopping) {
+            break;
+        }
+        atlas->hintPending = false;
+        bool pending = false;
+        int32_t sample = pick_sample_locked(atlas, now_us(), &pending);
+        if (!pending) {
+            break;
+        }
+        if (sample < 0) {
+            // 剩余样本都在其他分本或尚未被索引覆盖，等待播放切换分本或索引补全
+            atlas->cv.wait_for(lock, std::chrono::microseconds(kRetryDelayUs));
+            continue;
+        }
+        lock.unlock();
+
+        int64_t startUs = now_us();
+        DmsDataUnitPtr unit = nullptr;
+        int result = dms_player_fetch_sample(atlas->ctx, (int64_t)sample * atlas->config.intervalFrames, &unit);
+        int64_t costUs = now_us() - startUs;
+
+        lock.lock();
+        if (result == DMS_RESULT_SUCCESS) {
+            ewma_update(&atlas->fetchCostUs, (float)costUs);
+            atlas->states[sample] = kSampleQueued;
+            atlas->jobs.push_back({sample, unit});
+            atlas->cv.notify_all();
+        } else if (result == 1) {
+            atlas->retryAtUs[sample] = now_us() + kRetryDelayUs;
+        } else if (result == (int)DMS_RESULT_PLAY_FINISHED) {
+            atlas->states[sample] = kSampleSkipped;
+            atlas->skippedCount++;
+        } else {
+            atlas->states[sample] = kSampleFailed;
+            atlas->failedCount++;
+        }
+        atlas->cv.wait_for(lock, std::chrono::microseconds(kFetchGapUs), [atlas] { return atlas->stopping; });
+    }
+    atlas->fetchDone = true;
+    atlas->cv.notify_all();
+}
+
+static void decode_main(DmsThumbnailAtlas* atlas) {
+    const int width = atlas->config.width;
+    const int height = atlas->config.height;
+    const size_t tilePixels = (size_t)width * height;
+    std::vector<uint32_t> argb(tilePixels);
+
+    std::unique_lock<std::mutex> lock(atlas->mutex);
+    while (true) {
+        atlas->cv.wait(lock, [atlas] { return atlas->stopping || !atlas->jobs.empty() || atlas->fetchDone; });
+        if (atlas->stopping || atlas->jobs.empty()) {
+            break;
+        }
+        // 优先解码离最近一次查询位置最近的样本
+        int32_t center = sample_of(atlas, atlas->hintFrame);
+        auto nearest = atlas->jobs.begin();
+        for (auto it = atlas->jobs.begin(); it != atlas->jobs.end(); ++it) {
+            if (abs(it->sample - center) < abs(nearest->sample - center)) {
+                nearest = it;
+            }
+        }
+        ThumbnailJob job = *nearest;
+        atlas->jobs.erase(nearest);
+        atlas->cv.notify_all();
+        lock.unlock();
+
+        int64_t startUs = now_us();
+        int result = atlas->decode(atlas->user, job.unit, width, height, argb.data());
+        int64_t costUs = now_us() - startUs;
+        wipe_unit(&job.unit);
+        if (result == 0) {
+            // 每个样本只由一个解码线程写入，写完后在持锁时标记完成
+            uint16_t* tile = atlas->pixels.data() + (size_t)job.sample * tilePixels;
+            for (size_t i = 0; i < tilePixels; i++) {
+                tile[i] = argb_to_rgb565(argb[i]);
+            }
+        }
+
+        lock.lock();
+        if (result == 0) {
+            ewma_update(&atlas->decodeCostUs, (float)costUs);
+            atlas->states[job.sample] = kSampleReady;
+            atlas->readyCount++;
+        } else {
+            atlas->states[job.sample] = kSampleFailed;
+            atlas->failedCount++;
+        }
+    }
+    lock.unlock();
+    memset(argb.data(), 0, tilePixels * sizeof(uint32_t));
+}
+
+/**
+ * @brief 创建缩略图图集并开始后台生成。影片总帧数取自分本时间轴（或片长），
+ *        图集必须在关闭DCP之前销毁
+ * @param ctx DMS播放器上下文指针（已打开DCP）
+ * @param config 缩略图配置
+ * @param decode 解码回调
+ * @param user 解码回调的用户数据
+ * @return 成功返回图集指针，失败返回NULL
+ */
+struct DmsThumbnailAtlas* dms_thumbnail_create(struct DmsContext* ctx, const struct DmsThumbnailConfig* config,
+                                               DmsThumbnailDecodeFun decode, void* user) {
+    if (!ctx || !config || !decode || config->intervalFrames <= 0 || config->width <= 0 || config->height <= 0) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    int64_t totalFrames = ctx->timeline.reelCount > 0 ? ctx->timeline.totalFrames
+                                                      : (int64_t)(ctx->duration * ctx->frameRate / 1000.0f);
+    if (!ctx->hasActiveMxf || totalFrames <= 0) {
+        LOGE("No active MXF file or unknown duration");
+        return nullptr;
+    }
+
+    int threads = config->threads > 0 ? config->threads : (int)std::thread::hardware_concurrency();
+    threads = threads < 1 ? 1 : (threads > kMaxThreads ? kMaxThreads : threads);
+
+    DmsThumbnailAtlas* atlas = new DmsThumbnailAtlas();
+    atlas->ctx = ctx;
+    atlas->config = *config;
+    atlas->decode = decode;
+    atlas->user = user;
+    atlas->decoder = nullptr;
+    atlas->sampleCount = (int32_t)((totalFrames + config->intervalFrames - 1) / config->intervalFrames);
+    atlas->threadCount = threads;
+    atlas->pixels.assign((size_t)atlas->sampleCount * config->width * config->height, 0);
+    atlas->states.assign(atlas->sampleCount, kSamplePending);
+    atlas->retryAtUs.assign(atlas->sampleCount, 0);
+    atlas->stopping = false;
+    atlas->fetchDone = false;
+    atlas->hintFrame = 0;
+    atlas->hintPending = false;
+    atlas->readyCount = 0;
+    atlas->failedCount = 0;
+    atlas->skippedCount = 0;
+    atlas->fetchCostUs = 0.0f;
+    atlas->decodeCostUs = 0.0f;
+
+    atlas->fetcher = std::thread(fetch_main, atlas);
+    for (int i = 0; i < threads; i++) {
+        atlas->decoders.emplace_back(decode_main, atlas);
+    }
+    LOGI("Thumbnail atlas: %d samples every %d frames, %dx%d, %d threads, %lld bytes",
+         atlas->sampleCount, config->intervalFrames, config->width, config->height, threads,
+         (long long)(atlas->pixels.size() * sizeof(uint16_t)));
+    return atlas;
+}
+
+/**
+ * @brief 停止后台生成，清零并释放图集
+ * @param atlas 缩略图图集
+ */
+void dms_thumbnail_destroy(struct DmsThumbnailAtlas* atlas) {
+    if (!atlas) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(atlas->mutex);
+        atlas->stopping = true;
+    }
+    atlas->cv.notify_all();
+    if (atlas->fetcher.joinable()) {
+        atlas->fetcher.join();
+    }
+    for (std::thread& thread : atlas->decoders) {
+        thread.join();
+    }
+    for (ThumbnailJob& job : atlas->jobs) {
+        wipe_unit(&job.unit);
+    }
+    dms_j2k_decoder_destroy(atlas->decoder);
+    memset(atlas->pixels.data(), 0, atlas->pixels.size() * sizeof(uint16_t));
+    LOGI("Thumbnail atlas destroyed: %d/%d ready, %d failed",
+         atlas->readyCount, atlas->sampleCount, atlas->failedCount);
+    delete atlas;
+}
+
+/**
+ * @brief 取离frame最近的已生成缩略图；同时把frame作为取样优先位置
+ * @param atlas 缩略图图集
+ * @param frame 整部影片帧号
+ * @param outArgb 输出ARGB_8888像素（width x height个）
+ * @param outFrame 输出缩略图对应的帧号，可为空
+ * @return 成功返回0，尚无任何已生成的缩略图返回1，参数错误返回-1
+ */
+int dms_thumbnail_get(struct DmsThumbnailAtlas* atlas, int64_t frame, uint32_t* outArgb, int64_t* outFrame) {
+    if (!atlas || !outArgb || frame < 0) {
+        return -1;
+    }
+    int32_t center = sample_of(atlas, frame);
+
+    std::lock_guard<std::mutex> lock(atlas->mutex);
+    if (atlas->hintFrame != frame) {
+        atlas->hintFrame = frame;
+        atlas->hintPending = atlas->states[center] == kSamplePending;
+        atlas->cv.notify_all();
+    }
+    int32_t found = -1;
+    for (int32_t d = 0; d < atlas->sampleCount && found < 0; d++) {
+        if (center + d < atlas->sampleCount && atlas->states[center + d] == kSampleReady) {
+            found = center + d;
+        } else if (center - d >= 0 && atlas->states[center - d] == kSampleReady) {
+            found = center - d;
+        }
+    }
+    if (found < 0) {
+        return 1;
+    }
+
+    const size_t tilePixels = (size_t)atlas->config.width * atlas->config.height;
+    const uint16_t* tile = atlas->pixels.data() + (size_t)found * tilePixels;
+    for (size_t i = 0; i < tilePixels; i++) {
+        outArgb[i] = rgb565_to_argb(tile[i]);
+    }
+    if (outFrame) {
+        *outFrame = (int64_t)found * atlas->config.intervalFrames;
+    }
+    return 0;
+}
+
+/**
+ * @brief 获取缩略图统计信息
+ * @param atlas 缩略图图集
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回-1
+ */
+int dms_thumbnail_get_stats(struct DmsThumbnailAtlas* atlas, struct DmsThumbnailStats* outStats) {
+    if (!atlas || !outStats) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(atlas->mutex);
+    outStats->sampleCount = atlas->sampleCount;
+    outStats->readyCount = atlas->readyCount;
+    outStats->failedCount = atlas->failedCount;
+    outStats->skippedCount = atlas->skippedCount;
+    outStats->threads = atlas->threadCount;
+    outStats->width = atlas->config.width;
+    outStats->height = atlas->config.height;
+    outStats->atlasBytes = (int64_t)(atlas->pixels.size() * sizeof(uint16_t));
+    outStats->fetchCostUs = atlas->fetchCostUs;
+    outStats->decodeCostUs = atlas->decodeCostUs;
+    return 0;
+}
+
+/**
+ * @brief 把12位X'Y'Z'码值转换为sRGB像素（DCI的2.6伽马与52.37/48归一化）
+ * @param x X'码值
+ * @param y Y'码值
+ * @param z Z'码值
+ * @param maxCode 码值上限
+ * @return ARGB_8888像素
+ */
+static uint32_t xyz_to_argb(float x, float y, float z, float maxCode) {
+    const float scale = 52.37f / 48.0f;
+    float lx = scale * powf(x / maxCode, 2.6f);
+    float ly = scale * powf(y / maxCode, 2.6f);
+    float lz = scale * powf(z / maxCode, 2.6f);
+    float rgb[3] = {
+        3.2406f * lx - 1.5372f * ly - 0.4986f * lz,
+        -0.9689f * lx + 1.8758f * ly + 0.0415f * lz,
+        0.0557f * lx - 0.2040f * ly + 1.0570f * lz,
+    };
+    uint32_t argb = 0xFF000000u;
+    for (int i = 0; i < 3; i++) {
+        float v = rgb[i] <= 0.0f ? 0.0f : (rgb[i] >= 1.0f ? 1.0f : powf(rgb[i], 1.0f / 2.2f));
+        argb |= (uint32_t)(v * 255.0f + 0.5f) << (16 - 8 * i);
+    }
+    return argb;
+}
+
+/**
+ * @brief J2K缩略图解码回调：以不小于缩略图尺寸的最低分辨率层解码，盒式滤波缩小并转换为sRGB
+ * @param user 解码器（DmsJ2kDecoder），应以DMS_J2K_REDUCE_AUTO创建并把输出尺寸设为缩略图尺寸
+ * @param unit 图像数据单元（J2K码流）
+ * @param width 缩略图宽度
+ * @param height 缩略图高度
+ * @param outArgb 输出ARGB_8888像素
+ * @return 成功返回0，参数错误返回-1，解码失败返回-3
+ */
+int dms_thumbnail_decode_j2k(void* user, const DmsDataUnit* unit, int width, int height, uint32_t* outArgb) {
+    DmsJ2kDecoder* decoder = (DmsJ2kDecoder*)user;
+    if (!decoder || !unit || !unit->Data || width <= 0 || height <= 0 || !outArgb) {
+        return -1;
+    }
+    DmsPicture picture;
+    int result = dms_j2k_decoder_decode(decoder, unit->Data, unit->Length, &picture);
+    if (result != 0) {
+        return result;
+    }
+    const float maxCode = (float)((1 << picture.precision) - 1);
+    const int32_t* planes[3];
+    for (int c = 0; c < 3; c++) {
+        // 单分量码流按灰度处理
+        planes[c] = picture.planes[c < picture.components ? c : 0];
+    }
+    for (int ty = 0; ty < height; ty++) {
+        int y0 = (int)((int64_t)ty * picture.height / height);
+        int y1 = (int)((int64_t)(ty + 1) * picture.height / height);
+        y1 = y1 > y0 ? y1 : y0 + 1;
+        for (int tx = 0; tx < width; tx++) {
+            int x0 = (int)((int64_t)tx * picture.width / width);
+            int x1 = (int)((int64_t)(tx + 1) * picture.width / width);
+            x1 = x1 > x0 ? x1 : x0 + 1;
+            int64_t sum[3] = {0, 0, 0};
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    size_t offset = (size_t)y * picture.width + x;
+                    for (int c = 0; c < 3; c++) {
+                        sum[c] += planes[c][offset];
+                    }
+                }
+            }
+            float count = (float)((y1 - y0) * (x1 - x0));
+            outArgb[ty * width + tx] = xyz_to_argb(sum[0] / count, sum[1] / count, sum[2] / count, maxCode);
+        }
+    }
+    dms_picture_release(&picture);
+    return 0;
+}
+
+/**
+ * @brief 以J2K解码创建缩略图图集：解码器按缩略图尺寸自动选择分辨率层（DCI 2K/4K的默认缩略图即最低的1/8层），
+ *        每个样本单线程解码，多个样本由解码线程并行，解码器随图集销毁
+ * @param ctx DMS播放器上下文指针（已打开DCP）
+ * @param config 缩略图配置
+ * @return 成功返回图集指针，未编译J2K解码或参数错误返回NULL
+ */
+struct DmsThumbnailAtlas* dms_thumbnail_create_j2k(struct DmsContext* ctx, const struct DmsThumbnailConfig* config) {
+    if (!ctx || !config) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    struct DmsJ2kDecoderConfig decoderConfig = {1, DMS_J2K_REDUCE_AUTO};
+    DmsJ2kDecoder* decoder = dms_j2k_decoder_create(&decoderConfig);
+    if (!decoder) {
+        LOGE("J2K decoder not available for thumbnails");
+        return nullptr;
+    }
+    dms_j2k_decoder_set_output_size(decoder, config->width, config->height);
+    DmsThumbnailAtlas* atlas = dms_thumbnail_create(ctx, config, dms_thumbnail_decode_j2k, decoder);
+    if (!atlas) {
+        dms_j2k_decoder_destroy(decoder);
+        return nullptr;
+    }
+    atlas->decoder = decoder;
+    return atlas;
+}
@@ -0,0 +1,82 @@
+#ifndef DMS_THUMBNAIL_H
+#define DMS_THUMBNAIL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "libdms.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 进度条预览缩略图
+ *
+ * 每隔固定帧数取一个样本：由取样线程按帧索引定位读取码流（libdms为进程全局，
+ * 每个样本的定位、读取与恢复播放读取位置在一次持锁内完成），交给多个解码线程
+ * 以最低可用的J2K分辨率层解码并缩放到缩略图尺寸，结果以RGB565存入内存中的
+ * 连续图集。解密后的码流与图像只存在于内存中，销毁时清零，不写入磁盘。
+ *
+ * 查询任意位置返回最近的已生成样本；请求的样本尚未生成时，取样线程优先处理
+ * 离最近一次查询位置最近的样本。
+ */
+
+struct DmsContext;
+
+#define DMS_THUMBNAIL_DEFAULT_WIDTH 160   // 默认缩略图宽度（像素）
+#define DMS_THUMBNAIL_DEFAULT_HEIGHT 84   // 默认缩略图高度（像素），约为DCI 2K的宽高比
+
+// 缩略图配置
+struct DmsThumbnailConfig {
+    int32_t intervalFrames;  // 取样间隔（帧）
+    int32_t width;           // 缩略图宽度（像素）
+    int32_t height;          // 缩略图高度（像素）
+    int32_t threads;         // 解码线程数，0表示按CPU核数
+};
+
+// 缩略图统计信息
+struct DmsThumbnailStats {
+    int32_t sampleCount;     // 样本总数
+    int32_t readyCount;      // 已生成的样本数
+    int32_t failedCount;     // 读取或解码失败的样本数
+    int32_t skippedCount;    // 超出影片实际长度（按估算时长取样）的样本数
+    int32_t threads;         // 解码线程数
+    int32_t width;           // 缩略图宽度（像素）
+    int32_t height;          // 缩略图高度（像素）
+    int64_t atlasBytes;      // 图集占用内存（字节）
+    float fetchCostUs;       // 单个样本读取耗时的滑动平均（微秒）
+    float decodeCostUs;      // 单个样本解码耗时的滑动平均（微秒）
+};
+
+/**
+ * @brief 解码回调，在解码线程中并发调用，必须可重入。
+ *        应以不小于缩略图尺寸的最低分辨率层解码，并缩放为width x height
+ * @param user 用户数据
+ * @param unit 图像数据单元（J2K码流）
+ * @param width 缩略图宽度
+ * @param height 缩略图高度
+ * @param outArgb 输出ARGB_8888像素，width x height个
+ * @return 成功返回0，失败返回错误码
+ */
+typedef int (*DmsThumbnailDecodeFun)(void* user, const DmsDataUnit* unit, int width, int height,
+                                     uint32_t* outArgb);
+
+struct DmsThumbnailAtlas;
+
+struct DmsThumbnailAtlas* dms_thumbnail_create(struct DmsContext* ctx, const struct DmsThumbnailConfig* config,
+                                               DmsThumbnailDecodeFun decode, void* user); // 创建图集并开始后台生成
+void dms_thumbnail_destroy(struct DmsThumbnailAtlas* atlas);   // 停止生成、清零并释放图集
+int dms_thumbnail_get(struct DmsThumbnailAtlas* atlas, int64_t frame, uint32_t* outArgb,
+                      int64_t* outFrame);                      // 取离frame最近的已生成缩略图
+int dms_thumbnail_get_stats(struct DmsThumbnailAtlas* atlas,
+                            struct DmsThumbnailStats* outStats); // 获取统计信息
+int dms_thumbnail_decode_j2k(void* user, const DmsDataUnit* unit, int width, int height,
+                             uint32_t* outArgb);               // J2K解码回调，user为按缩略图尺寸降分辨率的解码器
+struct DmsThumbnailAtlas* dms_thumbnail_create_j2k(struct DmsContext* ctx,
+                                                   const struct DmsThumbnailConfig* config); // 以最低分辨率层J2K解码创建图集
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_THUMBNAIL_H
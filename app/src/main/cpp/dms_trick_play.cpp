@@ -0,0 +1,116 @@
+#include "dms_trick_play.h"
+#include <math.h>
+#include <string.h>
+
+static const float kEwmaAlpha = 0.2f;     // 耗时滑动平均系数
+static const float kCostMargin = 1.25f;   // 预留25%余量，避免输出节奏被偶发慢帧打乱
+static const float kShrinkRatio = 0.75f;  // 新步长低于当前75%时才缩小，防止来回抖动
+
+/**
+ * @brief 设置倍速并重置步长，倍速绝对值会被限制在[2, 32]，1表示退出抽帧模式
+ * @param trick 抽帧策略
+ * @param speed 播放速度
+ */
+void dms_trick_play_reset(struct DmsTrickPlay* trick, float speed) {
+    float fetchCost = trick->fetchCostUs;
+    float decodeCost = trick->decodeCostUs;
+    memset(trick, 0, sizeof(*trick));
+    // 实测耗时与倍速无关，切换倍速时保留
+    trick->fetchCostUs = fetchCost;
+    trick->decodeCostUs = decodeCost;
+
+    float magnitude = fabsf(speed);
+    if (magnitude < DMS_TRICK_MIN_SPEED) {
+        trick->speed = speed < 0 ? speed : 1.0f;
+        return;
+    }
+    if (magnitude > DMS_TRICK_MAX_SPEED) {
+        magnitude = DMS_TRICK_MAX_SPEED;
+    }
+    trick->speed = speed < 0 ? -magnitude : magnitude;
+    trick->step = (int32_t)ceilf(magnitude) * (speed < 0 ? -1 : 1);
+}
+
+/**
+ * @brief 是否处于抽帧模式
+ * @param trick 抽帧策略
+ * @return 倍速绝对值不小于2时返回true
+ */
+bool dms_trick_play_active(const struct DmsTrickPlay* trick) {
+    return fabsf(trick->speed) >= DMS_TRICK_MIN_SPEED;
+}
+
+static void ewma_update(float* value, int64_t sample) {
+    if (sample < 0) {
+        return;
+    }
+    *value = (*value <= 0.0f) ? (float)sample : *value + kEwmaAlpha * ((float)sample - *value);
+}
+
+/**
+ * @brief 上报单帧定位+读取耗时
+ * @param trick 抽帧策略
+ * @param costUs 耗时（微秒）
+ */
+void dms_trick_play_report_fetch(struct DmsTrickPlay* trick, int64_t costUs) {
+    ewma_update(&trick->fetchCostUs, costUs);
+}
+
+/**
+ * @brief 上报单帧解码耗时
+ * @param trick 抽帧策略
+ * @param costUs 耗时（微秒）
+ */
+void dms_trick_play_report_decode(struct DmsTrickPlay* trick, int64_t costUs) {
+    ewma_update(&trick->decodeCostUs, costUs);
+}
+
+/**
+ * @brief 计算下一次跳帧步长N
+ *        输出帧间隔 = max(1/帧率, 单帧总耗时×余量)，N = 倍速 × 帧率 × 输出帧间隔；
+ *        耗时上升时立即增大N，耗时明显下降时才减小N
+ * @param trick 抽帧策略
+ * @param frameRate 源帧率
+ * @return 带方向的步长，非抽帧模式返回1
+ */
+int32_t dms_trick_play_update_step(struct DmsTrickPlay* trick, float frameRate) {
+    if (!dms_trick_play_active(trick) || frameRate <= 0) {
+        return 1;
+    }
+
+    float magnitude = fabsf(trick->speed);
+    float intervalS = 1.0f / frameRate;
+    float costS = (trick->fetchCostUs + trick->decodeCostUs) * kCostMargin / 1000000.0f;
+    if (costS > intervalS) {
+        intervalS = costS;
+    }
+
+    int32_t wanted = (int32_t)ceilf(magnitude * frameRate * intervalS - 0.001f);
+    if (wanted < (int32_t)ceilf(magnitude)) {
+        wanted = (int32_t)ceilf(magnitude);
+    }
+
+    int32_t current = trick->step < 0 ? -trick->step : trick->step;
+    if (wanted > current || (float)wanted < (float)current * kShrinkRatio) {
+        current = wanted;
+    }
+    trick->step = trick->speed < 0 ? -current : current;
+    return trick->step;
+}
+
+/**
+ * @brief 抽出帧的显示时长：N个源帧在倍速下应占用的墙钟时间
+ * @param trick 抽帧策略
+ * @param frameRate 源帧率
+ * @return 显示时长（微秒）
+ */
+int64_t dms_trick_play_frame_duration_us(const struct DmsTrickPlay* trick, float frameRate) {
+    if (frameRate <= 0) {
+        return 0;
+    }
+    if (!dms_trick_play_active(trick)) {
+        return (int64_t)(1000000.0f / frameRate);
+    }
+    int32_t step = trick->step < 0 ? -trick->step : trick->step;
+    return (int64_t)((double)step * 1000000.0 / ((double)fabsf(trick->speed) * frameRate));
+}
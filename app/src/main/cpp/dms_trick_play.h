@@ -0,0 +1,42 @@
+#ifndef DMS_TRICK_PLAY_H
+#define DMS_TRICK_PLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 快进/快退抽帧策略
+ *
+ * 高倍速时不逐帧读取，而是按帧索引每次跳过N帧只取一帧。N由倍速与实测的
+ * 单帧定位+读取+解码耗时共同决定：耗时越长，输出帧间隔越大、N越大，
+ * 使画面始终以恒定的墙钟节奏扫过影片。
+ */
+
+#define DMS_TRICK_MIN_SPEED 2.0f
+#define DMS_TRICK_MAX_SPEED 32.0f
+
+struct DmsTrickPlay {
+    float speed;             // 播放速度，正数快进、负数快退，1表示正常播放
+    int32_t step;            // 当前每次跳过的源帧数（带方向）
+    float fetchCostUs;       // 定位+读取单帧耗时的滑动平均（微秒）
+    float decodeCostUs;      // 解码单帧耗时的滑动平均（微秒）
+    int64_t outputFrames;    // 抽帧模式下已输出的帧数
+};
+
+void dms_trick_play_reset(struct DmsTrickPlay* trick, float speed);           // 设置倍速并重置步长
+bool dms_trick_play_active(const struct DmsTrickPlay* trick);                 // 是否处于抽帧模式
+void dms_trick_play_report_fetch(struct DmsTrickPlay* trick, int64_t costUs); // 上报定位+读取耗时
+void dms_trick_play_report_decode(struct DmsTrickPlay* trick, int64_t costUs); // 上报解码耗时
+int32_t dms_trick_play_update_step(struct DmsTrickPlay* trick, float frameRate); // 计算下一次跳帧步长
+int64_t dms_trick_play_frame_duration_us(const struct DmsTrickPlay* trick,
+                                         float frameRate);                    // 抽出帧的显示时长
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_TRICK_PLAY_H
@@ -0,0 +1,155 @@
+#include "dms_video_sink.h"
+#include "dms_log.h"
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <atomic>
+#include <mutex>
+
+#define LOG_TAG "DmsVideoSink"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// 内存输出端：共享内存文件或无头模式
+struct MemorySink {
+    DmsVideoSink base;       // 须为第一个成员
+    int32_t maxWidth;
+    int32_t maxHeight;
+    int fd;
+    uint8_t* mapping;
+    size_t mappingBytes;
+    DmsSharedFrameHeader* header;
+
+    std::mutex mutex;
+    DmsMemorySinkStats stats;
+};
+
+/**
+ * @brief 显示一帧：写入下一个帧槽后更新文件头，读取端始终读取最近写完的帧槽，
+ *        写入中的帧槽与读取端正在读取的帧槽不同（三缓冲）
+ */
+static int memory_present(struct DmsVideoSink* base, const void* pixels, int32_t width, int32_t height, int32_t stride,
+                          int64_t timeUs) {
+    MemorySink* sink = (MemorySink*)base;
+    if (!pixels || width <= 0 || height <= 0 || width > sink->maxWidth || height > sink->maxHeight) {
+        return -1;
+    }
+    const uint8_t* src = (const uint8_t*)pixels;
+    uint64_t checksum = 0;
+    if (sink->header) {
+        int32_t slot = (int32_t)((sink->header->sequence + 1) % DMS_SHARED_FRAME_SLOTS);
+        int32_t dstStride = width * 4;
+        uint8_t* dst = sink->mapping + sizeof(DmsSharedFrameHeader) + (size_t)slot * sink->maxWidth * 4 * sink->maxHeight;
+        for (int32_t y = 0; y < height; y++) {
+            memcpy(dst + (size_t)y * dstStride, src + (size_t)y * stride, dstStride);
+        }
+        sink->header->width = width;
+        sink->header->height = height;
+        sink->header->stride = dstStride;
+        sink->header->timeUs = timeUs;
+        sink->header->slot = slot;
+        std::atomic_thread_fence(std::memory_order_release);
+        sink->header->sequence++;
+    }
+    // 每行抽取首尾像素计入校验和，用于比对不同路径输出的帧序列
+    for (int32_t y = 0; y < height; y++) {
+        const uint32_t* row = (const uint32_t*)(src + (size_t)y * stride);
+        checksum = checksum * 31 + row[0] + row[width - 1];
+    }
+
+    std::lock_guard<std::mutex> lock(sink->mutex);
+    sink->stats.frames++;
+    sink->stats.checksum = sink->stats.checksum * 1099511628211ULL + checksum;
+    sink->stats.lastTimeUs = timeUs;
+    return 0;
+}
+
+static void memory_destroy(struct DmsVideoSink* base) {
+    MemorySink* sink = (MemorySink*)base;
+    if (sink->mapping) {
+        munmap(sink->mapping, sink->mappingBytes);
+    }
+    if (sink->fd >= 0) {
+        close(sink->fd);
+    }
+    delete sink;
+}
+
+/**
+ * @brief 创建内存输出端
+ * @param path 共享内存文件路径（如/dev/shm/dms_frames），为空时为无头模式，只统计不保存
+ * @param maxWidth 最大帧宽度
+ * @param maxHeight 最大帧高度
+ * @param format 像素格式，DmsColorFormat
+ * @return 成功返回输出端指针，失败返回NULL
+ */
+struct DmsVideoSink* dms_video_sink_create_memory(const char* path, int32_t maxWidth, int32_t maxHeight,
+                                                  int32_t format) {
+    if (maxWidth <= 0 || maxHeight <= 0) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    MemorySink* sink = new MemorySink();
+    sink->base.format = format;
+    sink->base.present = memory_present;
+    sink->base.destroy = memory_destroy;
+    sink->maxWidth = maxWidth;
+    sink->maxHeight = maxHeight;
+    sink->fd = -1;
+    sink->mapping = nullptr;
+    sink->mappingBytes = 0;
+    sink->header = nullptr;
+    memset(&sink->stats, 0, sizeof(sink->stats));
+
+    if (path && *path) {
+        sink->mappingBytes = sizeof(DmsSharedFrameHeader) +
+                             (size_t)DMS_SHARED_FRAME_SLOTS * maxWidth * 4 * maxHeight;
+        sink->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (sink->fd < 0 || ftruncate(sink->fd, (off_t)sink->mappingBytes) != 0) {
+            LOGE("Failed to create shared frame file %s", path);
+            memory_destroy(&sink->base);
+            return nullptr;
+        }
+        void* mapping = mmap(nullptr, sink->mappingBytes, PROT_READ | PROT_WRITE, MAP_SHARED, sink->fd, 0);
+        if (mapping == MAP_FAILED) {
+            LOGE("Failed to map shared frame file %s", path);
+            memory_destroy(&sink->base);
+            return nullptr;
+        }
+        sink->mapping = (uint8_t*)mapping;
+        sink->header = (DmsSharedFrameHeader*)mapping;
+        sink->header->magic = DMS_SHARED_FRAME_MAGIC;
+        sink->header->format = format;
+        sink->header->slot = -1;
+        sink->header->sequence = 0;
+    }
+    LOGI("Memory sink created: %s, max %dx%d", (path && *path) ? path : "headless", maxWidth, maxHeight);
+    return &sink->base;
+}
+
+/**
+ * @brief 内存输出端统计信息
+ * @param sink 由dms_video_sink_create_memory创建的输出端
+ * @param outStats 输出统计信息
+ * @return 成功返回0，失败返回-1
+ */
+int dms_video_sink_get_memory_stats(struct DmsVideoSink* sink, struct DmsMemorySinkStats* outStats) {
+    if (!sink || sink->present != memory_present || !outStats) {
+        return -1;
+    }
+    MemorySink* memory = (MemorySink*)sink;
+    std::lock_guard<std::mutex> lock(memory->mutex);
+    *outStats = memory->stats;
+    return 0;
+}
+
+/**
+ * @brief 销毁输出端
+ * @param sink 输出端
+ */
+void dms_video_sink_destroy(struct DmsVideoSink* sink) {
+    if (sink) {
+        sink->destroy(sink);
+    }
+}
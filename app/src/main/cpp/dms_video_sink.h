@@ -0,0 +1,72 @@
+#ifndef DMS_VIDEO_SINK_H
+#define DMS_VIDEO_SINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 视频输出端
+ *
+ * 渲染器在显示时刻把转换好的RGB帧交给输出端。Android上为 ANativeWindow（Surface），
+ * 按帧尺寸设置窗口缓冲区几何，由SurfaceFlinger缩放到视图大小；Linux测试时可输出到
+ * 共享内存文件（外部进程映射后读取最新帧），或不输出任何内容只统计（无头模式）。
+ */
+
+struct ANativeWindow;
+
+// 输出端，由各实现填写函数指针
+struct DmsVideoSink {
+    int32_t format;          // 接受的像素格式，DmsColorFormat
+    /**
+     * @brief 显示一帧
+     * @param sink 输出端
+     * @param pixels 像素，RGBA
+     * @param width 宽度（像素）
+     * @param height 高度（像素）
+     * @param stride 每行字节数
+     * @param timeUs 帧时间戳（微秒）
+     * @return 成功返回0，失败返回错误码
+     */
+    int (*present)(struct DmsVideoSink* sink, const void* pixels, int32_t width, int32_t height, int32_t stride,
+                   int64_t timeUs);
+    void (*destroy)(struct DmsVideoSink* sink); // 销毁输出端
+};
+
+// 共享内存输出文件头，其后为3个帧槽，每槽按创建时的最大尺寸占 maxWidth * 4 * maxHeight 字节
+struct DmsSharedFrameHeader {
+    uint32_t magic;          // DMS_SHARED_FRAME_MAGIC
+    int32_t width;           // 最近一帧的宽度
+    int32_t height;          // 最近一帧的高度
+    int32_t stride;          // 每行字节数
+    int32_t slot;            // 最近写完的帧槽（0~2）
+    int32_t format;          // 像素格式
+    uint64_t sequence;       // 已写入的帧数，读取端据此判断是否有新帧
+    int64_t timeUs;          // 最近一帧的时间戳
+};
+
+#define DMS_SHARED_FRAME_MAGIC 0x56534D44u   // "DMSV"
+#define DMS_SHARED_FRAME_SLOTS 3
+
+// 内存输出端统计信息
+struct DmsMemorySinkStats {
+    int64_t frames;          // 已显示的帧数
+    uint64_t checksum;       // 全部已显示帧像素的校验和
+    int64_t lastTimeUs;      // 最近一帧的时间戳
+};
+
+struct DmsVideoSink* dms_video_sink_create_window(struct ANativeWindow* window, int32_t format); // Android Surface输出
+struct DmsVideoSink* dms_video_sink_create_memory(const char* path, int32_t maxWidth, int32_t maxHeight,
+                                                  int32_t format); // 共享内存文件输出，path为空时为无头模式
+int dms_video_sink_get_memory_stats(struct DmsVideoSink* sink,
+                                    struct DmsMemorySinkStats* outStats); // 内存输出端统计信息
+void dms_video_sink_destroy(struct DmsVideoSink* sink);       // 销毁输出端
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMS_VIDEO_SINK_H
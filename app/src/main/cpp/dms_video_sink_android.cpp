@@ -0,0 +1,87 @@
+#include "dms_video_sink.h"
+#include "dms_color.h"
+#include "dms_log.h"
+#include <string.h>
+#ifdef __ANDROID__
+#include <android/native_window.h>
+#endif
+
+#define LOG_TAG "DmsWindowSink"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+#ifdef __ANDROID__
+// Surface输出端
+struct WindowSink {
+    DmsVideoSink base;       // 须为第一个成员
+    ANativeWindow* window;
+    int32_t width;           // 当前缓冲区几何
+    int32_t height;
+};
+
+/**
+ * @brief 显示一帧：帧尺寸变化时重设缓冲区几何，锁定下一个窗口缓冲区，逐行复制后提交。
+ *        窗口的BufferQueue至少有三个缓冲区：一个显示中、一个排队、一个写入
+ */
+static int window_present(struct DmsVideoSink* base, const void* pixels, int32_t width, int32_t height, int32_t stride,
+                          int64_t timeUs) {
+    WindowSink* sink = (WindowSink*)base;
+    if (width != sink->width || height != sink->height) {
+        int32_t windowFormat = base->format == DMS_COLOR_RGBA_1010102 ? AHARDWAREBUFFER_FORMAT_R10G10B10A2_UNORM
+                                                                      : WINDOW_FORMAT_RGBA_8888;
+        if (ANativeWindow_setBuffersGeometry(sink->window, width, height, windowFormat) != 0) {
+            LOGE("Failed to set buffers geometry %dx%d", width, height);
+            return -3;
+        }
+        sink->width = width;
+        sink->height = height;
+    }
+    ANativeWindow_Buffer buffer;
+    if (ANativeWindow_lock(sink->window, &buffer, nullptr) != 0) {
+        LOGE("Failed to lock window");
+        return -3;
+    }
+    const uint8_t* src = (const uint8_t*)pixels;
+    uint8_t* dst = (uint8_t*)buffer.bits;
+    int32_t rows = height < buffer.height ? height : buffer.height;
+    int32_t bytes = (width < buffer.width ? width : buffer.width) * 4;
+    for (int32_t y = 0; y < rows; y++) {
+        memcpy(dst + (size_t)y * buffer.stride * 4, src + (size_t)y * stride, bytes);
+    }
+    return ANativeWindow_unlockAndPost(sink->window) == 0 ? 0 : -3;
+}
+
+static void window_destroy(struct DmsVideoSink* base) {
+    WindowSink* sink = (WindowSink*)base;
+    ANativeWindow_release(sink->window);
+    delete sink;
+}
+#endif
+
+/**
+ * @brief 创建Surface输出端
+ * @param window 由ANativeWindow_fromSurface取得的窗口，输出端持有其引用
+ * @param format 像素格式，DmsColorFormat
+ * @return 成功返回输出端指针，非Android平台或参数错误返回NULL
+ */
+struct DmsVideoSink* dms_video_sink_create_window(struct ANativeWindow* window, int32_t format) {
+#ifdef __ANDROID__
+    if (!window) {
+        LOGE("Invalid parameters");
+        return nullptr;
+    }
+    WindowSink* sink = new WindowSink();
+    sink->base.format = format;
+    sink->base.present = window_present;
+    sink->base.destroy = window_destroy;
+    sink->window = window;
+    sink->width = 0;
+    sink->height = 0;
+    ANativeWindow_acquire(window);
+    LOGI("Window sink created");
+    return &sink->base;
+#else
+    LOGE("Window sink is only available on Android");
+    return nullptr;
+#endif
+}
@@ -61,6 +61,9 @@ public class DmsExtractor implements Extractor {
             sampleData.setPosition(0);
             sampleData.setLimit(bytesRead);
 
+            // 时间戳由原生层给出，快进/快退时已按墙钟节奏改写
+            currentTimeUs = dmsPlayer.getLastFrameTimeUs();
+
             // Output the sample
             trackOutput.sampleData(sampleData, bytesRead);
             trackOutput.sampleMetadata(
@@ -70,9 +73,6 @@ public class DmsExtractor implements Extractor {
                     0,
                     null
             );
-
-            // Calculate next frame time
-            currentTimeUs += (long)(1000000 / frameRate);
         }
 
         return bytesRead > 0 ? RESULT_CONTINUE : RESULT_END_OF_INPUT;
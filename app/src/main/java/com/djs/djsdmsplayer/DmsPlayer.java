@@ -33,6 +33,27 @@ public class DmsPlayer {
         public boolean isEncrypted;
     }
     
+    // 码流参数，取自 J2K 主头（SIZ/COD/QCD）
+    public static class StreamInfo {
+        public int width;
+        public int height;
+        public int components;
+        public int bitDepth;
+        public boolean isSigned;
+        public int tileWidth;
+        public int tileHeight;
+        public int tilesX;
+        public int tilesY;
+        public int decompositionLevels;
+        public int qualityLayers;
+        public int progression;     // 0 LRCP, 1 RLCP, 2 RPCL, 3 PCRL, 4 CPRL
+        public boolean reversible;  // true 为 5/3 可逆小波，false 为 9/7
+        public int rsiz;
+        public String profile;      // 如 "DCI 2K"、"DCI 4K"
+        public int dciViolations;   // 不符合 DCI 档次的项（按位），0 为符合
+        public long headerChanges;  // 播放中检测到的主头参数变化次数
+    }
+    
     // Native methods
     public native boolean initialize();
     public native void uninitialize();
@@ -55,6 +76,110 @@ public class DmsPlayer {
     
     public native void seekTo(long positionUs);
     
+    public native void setIndexDirectory(String path);
+    
+    // 断点续播日志，syncIntervalMs 为落盘周期，0 表示每帧同步落盘
+    public native boolean setBreakpointJournal(String path, int syncIntervalMs);
+    
+    // 帧已显示时调用，断点只记录观众真正看到的帧（原生渲染器自行记录，无需调用）
+    public native void onFramePresented(long presentationTimeUs);
+    
+    public native boolean hasBreakpoint();
+    
+    // 断点续播，代替 bindKdm + openMxf；返回各阶段耗时（微秒）：读取断点、打开DCP、绑定KDM、
+    // 载入索引、登记断点、定位、缓冲、总耗时，以及已缓冲帧数、续播帧号；失败返回 null
+    @Nullable
+    public native long[] resumeFromBreakpoint(String mxfFilePath, @Nullable String kdmFilePath,
+                                              float minBufferSeconds);
+    
+    // 1 为正常播放，-1 为倒放，±2 ~ ±32 为快进/快退
+    public native boolean setPlaybackSpeed(float speed);
+    
+    public native long getLastFrameTimeUs();
+    
+    // 逐帧模式：direction 为 1 前进、-1 后退，返回复制的字节数，失败返回 -1
+    public native int stepFrame(int direction, byte[] buffer);
+    
+    public native int seekToFrame(long frame, byte[] buffer);
+    
+    public native long getCurrentFrame();
+    
+    // 输出画面尺寸（像素），解码时丢弃高于画面所需的分辨率层；0 表示按原图尺寸解码。
+    // 附加 Surface 期间由 attachSurface 的尺寸决定，调用无效
+    public native void setOutputSize(int width, int height);
+    
+    // 帧级并行解码线程数，0 表示按 CPU 核数。需在 attachSurface 之前调用
+    public native boolean setDecodeWorkers(int workers);
+    
+    // 各解码线程解码占用的CPU时间占比（0~1），尚未开始解码返回 null
+    @Nullable
+    public native float[] getDecodeUtilization();
+    
+    // 码流缓存（默认 10 秒、96 MB，先达到者生效）：小范围后退与重放时直接取最近读取的码流，
+    // 不定位、不读存储；两者均为 0 时停用。需在 attachSurface 之前调用
+    public native boolean setCodestreamCache(float seconds, int megabytes);
+    
+    // 进度条缩略图：打开 MXF 后创建，后台每 intervalFrames 帧取一个样本、以最低分辨率层解码，
+    // 尚未被帧索引覆盖的部分待后台补全后生成；关闭 MXF 时销毁。未编译 J2K 解码时返回 false
+    public native boolean createThumbnails(int intervalFrames, int width, int height);
+    
+    // 取离 frame 最近的已生成缩略图，argb 至少 width x height 个（ARGB_8888，可直接
+    // Bitmap.createBitmap）；返回缩略图的帧号，尚无可用缩略图返回 -1
+    public native long getThumbnail(long frame, int[] argb);
+    
+    // 原生渲染：附加 Surface 后由原生层解码并直接显示，Java 只控制播放、暂停与跳转（seekTo）。
+    // 附加期间 getNextFrame、stepFrame、seekToFrame 不可用，setPlaybackSpeed 返回 false；width/height 为视图尺寸
+    public native boolean attachSurface(Surface surface, int width, int height);
+    
+    public native void detachSurface();
+    
+    public native boolean play();
+    
+    public native boolean pause();
+    
+    // 原生渲染统计：显示帧数、丢弃帧数、失败帧数、起播耗时、跳转耗时、端到端耗时、显示延后、
+    // 转换耗时、提交耗时（微秒）、CPU 负载（千分比）、当前位置（微秒）、是否已播完、解码质量档位、
+    // 降质解码帧数、解码帧缓存的查询次数、命中次数、淘汰帧数与占用字节数、码流缓存的取帧次数、
+    // 占用字节数与免定位跳转次数、重复显示次数、时钟重同步次数、显示抖动与最大延后（微秒）、
+    // 刷新节奏的滑移次数、重新锁定次数与漏掉的刷新次数、缩放帧数与未缩放（只加黑边）帧数、
+    // 立体帧数、缺右眼帧数与帧序列提交的其余眼图像数；未附加 Surface 返回 null
+    @Nullable
+    public native long[] getRenderStats();
+    
+    // 显示节奏：attachSurface 后传入 Display.getRefreshRate()，按帧率把每帧排在固定的刷新上
+    // （如 24fps@60Hz 为 2:3）；之后在 Choreographer.FrameCallback.doFrame 中调用 onVsync。0 为关闭
+    public native boolean setDisplayRefreshRate(float refreshHz);
+    
+    public native void onVsync(long frameTimeNanos);
+    
+    // 色域映射：attachSurface 后设置。setColorLut 载入 .cube 3D LUT（输入为 P3-D65 伽马 2.6，输出为 sRGB），
+    // null 为取消；setGamutMapping 使用内置的 P3 到 Rec.709 色域压缩
+    public native boolean setColorLut(@Nullable String cubePath);
+    
+    public native boolean setGamutMapping(boolean enabled);
+    
+    // 立体（3D）输出方式：0 只显示左眼（默认，2D 回退）、1 左右并排（附加 Surface 时为半宽）、
+    // 2 帧序列单闪（24fps 时 48Hz）、3 帧序列双闪（96Hz）；两眼并行解码。2D 素材忽略
+    public static final int STEREO_LEFT_ONLY = 0;
+    public static final int STEREO_SIDE_BY_SIDE = 1;
+    public static final int STEREO_FRAME_SEQUENTIAL = 2;
+    public static final int STEREO_FRAME_SEQUENTIAL_DOUBLE = 3;
+    
+    public native boolean setStereoMode(int mode);
+    
+    public native boolean isStereo();
+    
+    // 内存警告：在 onTrimMemory(level) 中调用，按等级缩小解码帧缓存
+    public native void trimMemory(int level);
+    
+    // 自适应解码质量（默认开启）：赶不上显示时刻时丢弃质量层/分辨率层，余量恢复后回到全质量
+    public native boolean setAdaptiveQuality(boolean enabled);
+    
+    // 码流参数：打开 MXF 后读取当前帧主头解析（加密码流需先绑定 KDM），播放中逐帧检测变化；
+    // 无法解析时返回 null
+    @Nullable
+    public native StreamInfo getStreamInfo();
+    
     public native long getDuration();
     
     public native float getFrameRate();
@@ -12,7 +12,13 @@ import com.google.android.exoplayer2.MediaItem;
 import com.google.android.exoplayer2.source.MediaSource;
 import com.google.android.exoplayer2.source.ProgressiveMediaSource;
 
+import java.io.File;
+
 public class PlayerViewModel extends AndroidViewModel {
+    // 进度条缩略图尺寸，与原生默认值（DCI 2K宽高比）一致
+    public static final int THUMBNAIL_WIDTH = 160;
+    public static final int THUMBNAIL_HEIGHT = 84;
+    
     private final MutableLiveData<String> status = new MutableLiveData<>("Ready");
     private final MutableLiveData<Boolean> isPlaying = new MutableLiveData<>(false);
     
@@ -25,6 +31,15 @@ public class PlayerViewModel extends AndroidViewModel {
         super(application);
         dmsPlayer = new DmsPlayer();
         dmsPlayer.initialize();
+        
+        File indexDir = new File(application.getFilesDir(), "dms_index");
+        if (indexDir.isDirectory() || indexDir.mkdirs()) {
+            dmsPlayer.setIndexDirectory(indexDir.getAbsolutePath());
+        }
+        
+        // 每秒落盘一次放映点，断电最多丢失约一秒
+        File journal = new File(application.getFilesDir(), "dms_breakpoint.journal");
+        dmsPlayer.setBreakpointJournal(journal.getAbsolutePath(), 1000);
     }
     
     public LiveData<String> getStatus() {
@@ -53,6 +68,9 @@ public class PlayerViewModel extends AndroidViewModel {
     
     public void setExoPlayer(ExoPlayer player) {
         this.exoPlayer = player;
+        // 断点跟随实际上屏的帧，而不是提取器领先读取的帧
+        player.setVideoFrameMetadataListener((presentationTimeUs, releaseTimeNs, format, mediaFormat) ->
+                dmsPlayer.onFramePresented(presentationTimeUs));
     }
     
     public void validateKdm() {
@@ -95,6 +113,10 @@ public class PlayerViewModel extends AndroidViewModel {
             
             status.setValue("Playing MXF: " + mxfPath);
             
+            // 进度条缩略图每10秒一个样本，在后台生成
+            dmsPlayer.createThumbnails(Math.max(1, Math.round(mxfInfo.frameRate * 10)),
+                    THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT);
+            
             // Create DMS data source factory
             DmsDataSource.Factory dataSourceFactory = () -> new DmsDataSource(dmsPlayer);
             
@@ -115,6 +137,17 @@ public class PlayerViewModel extends AndroidViewModel {
         }
     }
     
+    // 进度条悬停预览：argb 至少 THUMBNAIL_WIDTH x THUMBNAIL_HEIGHT 个，返回缩略图的帧号，尚无可用缩略图返回 -1
+    public long getThumbnail(long frame, int[] argb) {
+        return dmsPlayer.getThumbnail(frame, argb);
+    }
+    
+    public void setPlaybackSpeed(float speed) {
+        if (!dmsPlayer.setPlaybackSpeed(speed)) {
+            status.setValue("Unsupported speed: " + speed);
+        }
+    }
+    
     public void stopPlayback() {
         if (exoPlayer != null) {
             exoPlayer.stop();